@@ -0,0 +1,379 @@
+/*
+  Elgar Benchmarks
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+/**
+ * @file AABBTreeQueries.cpp
+ * @brief Checks AABBTree against brute force over random creates, moves and destroys: after every
+ *        round the proxies found by QueryAABB and RayCast and the pairs reported by
+ *        EnumeratePairs must be exactly those a loop over every proxy finds. Runs once with 3D
+ *        boxes and once as a 2D world (zero z extent, no margin) where rays run in the z = 0
+ *        plane, along with rays parallel to the x and y axes.
+ *
+ *        Exits with a non-zero code if the tree and the brute force disagree.
+ *
+ *        Usage: AABBTreeQueries [--proxies N] [--rounds N]
+ */
+
+#include "elgar/physics/AABBTree.hpp"
+
+#include "Bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdio.h>
+#include <utility>
+#include <vector>
+
+using namespace elgar;
+
+#define WORLD_SIZE        100.0f  // Proxies live in [-WORLD_SIZE, WORLD_SIZE]
+#define QUERIES_PER_ROUND 20
+#define RAY_EPSILON       1e-4    // Rays closer than this to a box edge are not compared
+
+/**
+ * @brief A ModelProxy is the brute force view of a proxy
+ *
+ */
+struct ModelProxy {
+  int32_t proxy;    // The proxy in the tree
+  AABB    aabb;     // The tight box
+  bool    moved;    // Created or reinserted since the last EnumeratePairs
+};
+
+std::mt19937 random_engine(2019);
+
+/**
+ * @brief Get a random float
+ *
+ * @param min   The smallest value
+ * @param max   The largest value
+ * @return The value
+ */
+float RandomFloat(const float &min, const float &max) {
+  return std::uniform_real_distribution<float>(min, max)(random_engine);
+}
+
+/**
+ * @brief Get a random index
+ *
+ * @param count The number of indices
+ * @return An index below count
+ */
+size_t RandomIndex(const size_t &count) {
+  return std::uniform_int_distribution<size_t>(0, count - 1)(random_engine);
+}
+
+/**
+ * @brief Get a random box
+ *
+ * @param flat  Give the box a zero z extent at z = 0
+ * @return The box
+ */
+AABB RandomBox(const bool &flat) {
+  const glm::vec3 center(
+    RandomFloat(-WORLD_SIZE, WORLD_SIZE),
+    RandomFloat(-WORLD_SIZE, WORLD_SIZE),
+    flat ? 0.0f : RandomFloat(-WORLD_SIZE, WORLD_SIZE)
+  );
+  const glm::vec3 half(RandomFloat(0.1f, 5.0f), RandomFloat(0.1f, 5.0f), flat ? 0.0f : RandomFloat(0.1f, 5.0f));
+
+  return AABB{center - half, center + half};
+}
+
+/**
+ * @brief Clip a segment against a box in double precision, independently of AABB::RayIntersect
+ *
+ * @param aabb          The box
+ * @param origin        Start of the segment
+ * @param direction     Direction of the segment
+ * @param max_fraction  End of the segment as a fraction of the direction
+ * @param margin        Filled with how far the result is from flipping (exit - enter, or how
+ *                      far the origin is from a slab the segment runs parallel to)
+ * @return True if the segment hits the box, false otherwise
+ */
+bool ClipSegment(
+  const AABB &aabb,
+  const glm::vec3 &origin,
+  const glm::vec3 &direction,
+  const float &max_fraction,
+  double &margin
+) {
+  double enter = 0.0;
+  double exit = max_fraction;
+  margin = INFINITY;
+
+  for (int axis = 0; axis < 3; axis++) {
+    if (direction[axis] == 0.0f) {
+      const double inside = std::min((double)origin[axis] - aabb.min[axis], (double)aabb.max[axis] - origin[axis]);
+
+      // The origin on a zero extent slab is inside it
+      if (inside < 0.0) {
+        margin = -inside;
+        return false;
+      }
+
+      if (aabb.max[axis] > aabb.min[axis])
+        margin = std::min(margin, inside);
+
+      continue;
+    }
+
+    const double t1 = ((double)aabb.min[axis] - origin[axis]) / direction[axis];
+    const double t2 = ((double)aabb.max[axis] - origin[axis]) / direction[axis];
+
+    enter = std::max(enter, std::min(t1, t2));
+    exit = std::min(exit, std::max(t1, t2));
+  }
+
+  margin = std::min(margin, std::fabs(exit - enter));
+  return enter <= exit;
+}
+
+/**
+ * @brief Compare two sorted lists of proxies
+ *
+ * @param what      What the lists came from (for the report)
+ * @param tree      The proxies the tree found
+ * @param expected  The proxies the brute force found
+ * @return The number of mismatches (0 or 1)
+ */
+template<typename T>
+size_t CompareLists(const char *what, std::vector<T> &tree, std::vector<T> &expected) {
+  std::sort(tree.begin(), tree.end());
+  std::sort(expected.begin(), expected.end());
+
+  if (tree == expected)
+    return 0;
+
+  // Only the first few, a broken tree fails thousands of queries
+  static size_t reported = 0;
+  if (reported++ < 10)
+    printf("  %s: tree found %zu, brute force %zu\n", what, tree.size(), expected.size());
+
+  return 1;
+}
+
+/**
+ * @brief Run random operations on an AABBTree and compare its queries to brute force after every
+ *        round
+ *
+ * @param flat          Run as a 2D world (zero z extent, no margin, rays in the z = 0 plane)
+ * @param proxy_count   The number of proxies to keep around
+ * @param rounds        The number of rounds
+ * @return The number of mismatches found
+ */
+size_t CheckTree(const bool &flat, const size_t &proxy_count, const long &rounds) {
+  AABBTree tree(flat ? 0.0f : AABB_TREE_MARGIN);
+  std::vector<ModelProxy> model;
+
+  size_t mismatches = 0;
+  size_t ray_hits = 0;
+  size_t pair_count = 0;
+
+  auto create = [&tree, &model, &flat]() {
+    const AABB aabb = RandomBox(flat);
+    model.push_back(ModelProxy{tree.CreateProxy(aabb, nullptr), aabb, true});
+  };
+
+  for (size_t i = 0; i < proxy_count; i++)
+    create();
+
+  for (long round = 0; round < rounds; round++) {
+    // Move about a tenth of the proxies, some only a little so the fat boxes absorb it
+    for (size_t i = 0; i < proxy_count / 10; i++) {
+      ModelProxy &proxy = model[RandomIndex(model.size())];
+
+      const float step = RandomIndex(2) ? 0.01f : 5.0f;
+      const glm::vec3 displacement(RandomFloat(-step, step), RandomFloat(-step, step), flat ? 0.0f : RandomFloat(-step, step));
+
+      proxy.aabb = AABB{proxy.aabb.min + displacement, proxy.aabb.max + displacement};
+
+      if (tree.MoveProxy(proxy.proxy, proxy.aabb, displacement))
+        proxy.moved = true;
+    }
+
+    // Replace a few proxies
+    for (size_t i = 0; i < proxy_count / 50 + 1; i++) {
+      const size_t victim = RandomIndex(model.size());
+
+      tree.DestroyProxy(model[victim].proxy);
+      model[victim] = model.back();
+      model.pop_back();
+
+      create();
+    }
+
+    if (tree.GetProxyCount() != model.size()) {
+      printf("  Tree has %zu proxies, expected %zu\n", tree.GetProxyCount(), model.size());
+      mismatches++;
+    }
+
+    for (const ModelProxy &proxy : model) {
+      if (!tree.GetFatAABB(proxy.proxy).Contains(proxy.aabb)) {
+        printf("  Fat box of proxy %d does not contain its box\n", proxy.proxy);
+        mismatches++;
+      }
+    }
+
+    for (size_t query = 0; query < QUERIES_PER_ROUND; query++) {
+      // Box queries
+      const AABB box = RandomBox(flat);
+
+      std::vector<int32_t> found, expected;
+      tree.QueryAABB(box, [&found](const int32_t &proxy) {
+        found.push_back(proxy);
+        return true;
+      });
+
+      for (const ModelProxy &proxy : model) {
+        if (tree.GetFatAABB(proxy.proxy).Overlaps(box))
+          expected.push_back(proxy.proxy);
+      }
+
+      mismatches += CompareLists("QueryAABB", found, expected);
+
+      // Ray casts, a third of them parallel to an axis
+      glm::vec3 origin(RandomFloat(-WORLD_SIZE, WORLD_SIZE), RandomFloat(-WORLD_SIZE, WORLD_SIZE), 0.0f);
+      glm::vec3 direction(RandomFloat(-WORLD_SIZE, WORLD_SIZE), RandomFloat(-WORLD_SIZE, WORLD_SIZE), 0.0f);
+
+      if (!flat) {
+        origin.z = RandomFloat(-WORLD_SIZE, WORLD_SIZE);
+        direction.z = RandomFloat(-WORLD_SIZE, WORLD_SIZE);
+      }
+
+      const size_t parallel = RandomIndex(3);
+      if (parallel < 2)
+        direction[parallel] = 0.0f;
+
+      const float max_fraction = RandomFloat(0.1f, 1.0f);
+
+      found.clear();
+      expected.clear();
+
+      std::vector<int32_t> borderline;
+
+      tree.RayCast(origin, direction, max_fraction, [&found](const int32_t &proxy, const float &fraction) {
+        found.push_back(proxy);
+        return fraction;
+      });
+
+      for (const ModelProxy &proxy : model) {
+        double margin;
+        const bool hit = ClipSegment(tree.GetFatAABB(proxy.proxy), origin, direction, max_fraction, margin);
+
+        // Leave rays grazing an edge out of the comparison, float and double may round apart
+        if (margin < RAY_EPSILON) {
+          borderline.push_back(proxy.proxy);
+          continue;
+        }
+
+        if (hit)
+          expected.push_back(proxy.proxy);
+      }
+
+      found.erase(std::remove_if(found.begin(), found.end(), [&borderline](const int32_t &proxy) {
+        return std::find(borderline.begin(), borderline.end(), proxy) != borderline.end();
+      }), found.end());
+
+      ray_hits += expected.size();
+      mismatches += CompareLists("RayCast", found, expected);
+    }
+
+    // Pairs where at least one of the two moved
+    std::vector<std::pair<int32_t, int32_t>> pairs, expected_pairs;
+    tree.EnumeratePairs([&pairs](const int32_t &a, const int32_t &b) {
+      pairs.emplace_back(a, b);
+    });
+
+    for (size_t i = 0; i < model.size(); i++) {
+      for (size_t j = i + 1; j < model.size(); j++) {
+        if (!model[i].moved && !model[j].moved)
+          continue;
+
+        if (tree.GetFatAABB(model[i].proxy).Overlaps(tree.GetFatAABB(model[j].proxy)))
+          expected_pairs.emplace_back(std::min(model[i].proxy, model[j].proxy), std::max(model[i].proxy, model[j].proxy));
+      }
+    }
+
+    for (ModelProxy &proxy : model)
+      proxy.moved = false;
+
+    pair_count += expected_pairs.size();
+    mismatches += CompareLists("EnumeratePairs", pairs, expected_pairs);
+  }
+
+  printf("  %-4s %ld rounds, %zu proxies: %zu ray hits, %zu pairs compared, %zu mismatches\n",
+    flat ? "2D" : "3D", rounds, proxy_count, ray_hits, pair_count, mismatches);
+
+  return mismatches;
+}
+
+/**
+ * @brief Check the 2D case of a segment that runs in the plane of zero extent boxes and stops
+ *        short of one
+ *
+ * @return The number of mismatches found
+ */
+size_t CheckFlatSegment() {
+  AABBTree tree(0.0f);
+  tree.CreateProxy(AABB{{10.0f, 0.0f, 0.0f}, {12.0f, 1.0f, 0.0f}}, nullptr);
+
+  size_t mismatches = 0;
+
+  // Reaches x = 5, the box starts at x = 10
+  size_t hits = 0;
+  tree.RayCast({0.0f, 0.5f, 0.0f}, {5.0f, 0.0f, 0.0f}, 1.0f, [&hits](const int32_t &, const float &fraction) {
+    hits++;
+    return fraction;
+  });
+
+  if (hits != 0) {
+    printf("  Segment short of a flat box hit it %zu times\n", hits);
+    mismatches++;
+  }
+
+  // Reaches x = 20
+  hits = 0;
+  tree.RayCast({0.0f, 0.5f, 0.0f}, {20.0f, 0.0f, 0.0f}, 1.0f, [&hits](const int32_t &, const float &fraction) {
+    hits++;
+    return fraction;
+  });
+
+  if (hits != 1) {
+    printf("  Segment through a flat box hit it %zu times\n", hits);
+    mismatches++;
+  }
+
+  // Runs parallel to the box plane, but above it
+  hits = 0;
+  tree.RayCast({0.0f, 0.5f, 1.0f}, {20.0f, 0.0f, 0.0f}, 1.0f, [&hits](const int32_t &, const float &fraction) {
+    hits++;
+    return fraction;
+  });
+
+  if (hits != 0) {
+    printf("  Segment above a flat box hit it %zu times\n", hits);
+    mismatches++;
+  }
+
+  return mismatches;
+}
+
+int main(int argc, char **argv) {
+  const size_t proxy_count = bench::GetOption(argc, argv, "--proxies", 1000);
+  const long rounds = bench::GetOption(argc, argv, "--rounds", 200);
+
+  printf("\nAABBTreeQueries\n");
+
+  size_t mismatches = CheckFlatSegment();
+  mismatches += CheckTree(false, proxy_count, rounds);
+  mismatches += CheckTree(true, proxy_count, rounds);
+
+  printf("%s\n", mismatches ? "FAILED: the AABBTree differs from brute force" : "PASSED");
+
+  return mismatches ? 1 : 0;
+}
@@ -0,0 +1,171 @@
+/*
+  Elgar Benchmarks
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_BENCH_HPP_
+#define _ELGAR_BENCH_HPP_
+
+// INCLUDES //
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace bench {
+
+  /**
+   * @brief A Stopwatch measures the wall clock time since it was started
+   *
+   */
+  class Stopwatch {
+  private:
+    std::chrono::steady_clock::time_point m_start;  // When the stopwatch was started
+
+  public:
+    /**
+     * @brief Construct a new Stopwatch object and start it
+     *
+     */
+    Stopwatch() : m_start(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Start measuring again from now
+     *
+     */
+    void Restart() {
+      m_start = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * @brief Get the time since the stopwatch was started
+     *
+     * @return The elapsed time in milliseconds
+     */
+    double GetElapsedMs() const {
+      return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+  };
+
+  /**
+   * @brief A Samples collects measurements and summarizes them
+   *
+   */
+  class Samples {
+  private:
+    std::vector<double> m_values;   // Every measurement taken
+
+  public:
+    /**
+     * @brief Add a measurement
+     *
+     * @param value The measurement
+     */
+    void Add(const double &value) {
+      m_values.push_back(value);
+    }
+
+    /**
+     * @brief Drop every measurement
+     *
+     */
+    void Clear() {
+      m_values.clear();
+    }
+
+    /**
+     * @brief Get the number of measurements
+     *
+     * @return The number of measurements
+     */
+    size_t GetCount() const {
+      return m_values.size();
+    }
+
+    /**
+     * @brief Get the mean of the measurements
+     *
+     * @return The mean (0 without measurements)
+     */
+    double GetMean() const {
+      if (m_values.empty())
+        return 0.0;
+
+      double sum = 0.0;
+      for (const double &value : m_values)
+        sum += value;
+
+      return sum / m_values.size();
+    }
+
+    /**
+     * @brief Get a percentile of the measurements
+     *
+     * @param percentile  The percentile (0 - 100)
+     * @return The measurement at the percentile (0 without measurements)
+     */
+    double GetPercentile(const double &percentile) const {
+      if (m_values.empty())
+        return 0.0;
+
+      std::vector<double> sorted = m_values;
+      const size_t index = std::min(sorted.size() - 1, (size_t)(percentile / 100.0 * sorted.size()));
+
+      std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+      return sorted[index];
+    }
+
+  };
+
+  /**
+   * @brief Check the command line for a flag
+   *
+   * @param argc  The argument count
+   * @param argv  The arguments
+   * @param flag  The flag to look for (e.g. "--legacy")
+   * @return True if the flag was passed, false otherwise
+   */
+  inline bool HasFlag(int argc, char **argv, const char *flag) {
+    for (int i = 1; i < argc; i++) {
+      if (std::strcmp(argv[i], flag) == 0)
+        return true;
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief Read a numeric option passed as "--name value"
+   *
+   * @param argc      The argument count
+   * @param argv      The arguments
+   * @param name      The option to look for (e.g. "--frames")
+   * @param fallback  The value to use if the option was not passed
+   * @return The value of the option
+   */
+  inline long GetOption(int argc, char **argv, const char *name, const long &fallback) {
+    for (int i = 1; i + 1 < argc; i++) {
+      if (std::strcmp(argv[i], name) == 0)
+        return std::strtol(argv[i + 1], nullptr, 10);
+    }
+
+    return fallback;
+  }
+
+  /**
+   * @brief Keep the compiler from optimizing away the computation of a value
+   *
+   * @param value The value to keep
+   */
+  template<typename T>
+  inline void DoNotOptimize(const T &value) {
+    asm volatile("" : : "r"(&value) : "memory");
+  }
+
+}
+
+#endif
@@ -0,0 +1,291 @@
+/*
+  Elgar Benchmarks
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+/**
+ * @file CullKernels.cpp
+ * @brief Checks every cull kernel the CPU supports (scalar, SSE, AVX2) against Frustum::TestSphere
+ *        and Frustum::TestAABB, one object at a time, and times them. Random spheres, boxes and
+ *        instance matrices are scattered around a few cameras so many of them straddle a plane.
+ *        Batch sizes from 0 to 40 and a large odd batch cover the groups of 4 and 8 and the
+ *        remainder the scalar loop finishes. The kernels do the same float operations in the same
+ *        order as the tests (CullingAVX2.cpp is built without FMA), so spheres and boxes must match
+ *        exactly; the instance reference moves the sphere with glm, which may round the sum
+ *        differently, so instances that touch a plane to within a rounding error are skipped.
+ *
+ *        Exits with a non-zero code if any kernel differs from the frustum tests.
+ *
+ *        Usage: CullKernels [--objects N] [--runs N]
+ */
+
+#include "elgar/physics/Culling.hpp"
+
+#include "Bench.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+using namespace elgar;
+
+#define SMALL_BATCH_MAX   40
+#define CAMERA_COUNT      3
+#define SCENE_SIZE        60.0f   // Objects live in [-SCENE_SIZE, SCENE_SIZE]
+#define NEAR_EPSILON      1e-4    // Instances closer than this (relative) to a plane are not compared
+#define POISON            0xFFFFFFFF
+
+#define KERNEL_COUNT      3
+
+static const CullKernelType kernels[KERNEL_COUNT] = {
+  CULL_KERNEL_SCALAR, CULL_KERNEL_SSE, CULL_KERNEL_AVX2
+};
+
+/**
+ * @brief A Batch holds random objects of every kind the kernels cull
+ *
+ */
+struct Batch {
+  std::vector<glm::vec4> spheres;
+  std::vector<AABB>      boxes;
+  std::vector<glm::mat4> models;
+
+  /**
+   * @brief Fill the batch with random objects
+   *
+   * @param count   The number of objects of each kind
+   * @param random  The random generator
+   */
+  void Generate(const size_t &count, std::mt19937 &random) {
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> size(0.1f, 4.0f);
+
+    spheres.resize(count);
+    boxes.resize(count);
+    models.resize(count);
+
+    for (size_t i = 0; i < count; i++) {
+      spheres[i] = glm::vec4(glm::vec3(unit(random), unit(random), unit(random)) * SCENE_SIZE, size(random));
+
+      const glm::vec3 center = glm::vec3(unit(random), unit(random), unit(random)) * SCENE_SIZE;
+      const glm::vec3 half(size(random), size(random), size(random));
+      boxes[i] = AABB{center - half, center + half};
+
+      glm::mat4 model;
+      model = glm::translate(model, glm::vec3(unit(random), unit(random), unit(random)) * SCENE_SIZE);
+      model = glm::scale(model, glm::vec3(size(random), size(random), size(random)));
+      models[i] = model * glm::toMat4(glm::quat(glm::vec3(unit(random), unit(random), unit(random)) * 3.14159265f));
+    }
+  }
+};
+
+/**
+ * @brief Compare the visible indices a kernel wrote against the expected ones
+ *
+ * @param visible         The kernel output (room for count + 8 indices)
+ * @param visible_count   The number of indices the kernel returned
+ * @param expected        The expected indices
+ * @param skip            Objects whose result is not compared (empty to compare all)
+ * @param count           The number of objects
+ * @return The number of mismatching objects
+ */
+static size_t Compare(
+  const std::vector<uint32_t> &visible,
+  const size_t &visible_count,
+  const std::vector<uint32_t> &expected,
+  const std::vector<bool> &skip,
+  const size_t &count
+) {
+  size_t mismatches = 0;
+
+  // The indices must be ascending and in range
+  for (size_t i = 0; i < visible_count; i++) {
+    if (visible[i] >= count || (i > 0 && visible[i] <= visible[i - 1]))
+      return visible_count;
+  }
+
+  // Nothing past the returned count may be written
+  for (size_t i = visible_count; i < visible.size(); i++) {
+    if (visible[i] != POISON)
+      mismatches++;
+  }
+
+  std::vector<bool> found(count, false), wanted(count, false);
+  for (size_t i = 0; i < visible_count; i++)
+    found[visible[i]] = true;
+  for (const uint32_t &index : expected)
+    wanted[index] = true;
+
+  for (size_t i = 0; i < count; i++) {
+    if (found[i] != wanted[i] && (skip.empty() || !skip[i]))
+      mismatches++;
+  }
+
+  return mismatches;
+}
+
+/**
+ * @brief Run every cull routine of the current kernel over a batch and compare them to the
+ *        frustum tests
+ *
+ * @param frustum   The view
+ * @param batch     The objects
+ * @param sphere    The local bounding sphere of the instances
+ * @param skipped   Incremented by the number of instances too close to a plane to compare
+ * @return The number of mismatching objects
+ */
+static size_t Check(const Frustum &frustum, const Batch &batch, const glm::vec4 &sphere, size_t &skipped) {
+  const size_t count = batch.spheres.size();
+
+  std::vector<uint32_t> visible(count + 8);
+  std::vector<uint32_t> expected;
+  std::vector<bool> skip(count, false);
+
+  size_t mismatches = 0;
+
+  // Spheres
+  for (size_t i = 0; i < count; i++) {
+    if (frustum.TestSphere(glm::vec3(batch.spheres[i]), batch.spheres[i].w) != FRUSTUM_OUTSIDE)
+      expected.push_back(i);
+  }
+
+  std::fill(visible.begin(), visible.end(), POISON);
+  size_t visible_count = CullSpheres(frustum, batch.spheres.data(), count, visible.data());
+  mismatches += Compare(visible, visible_count, expected, std::vector<bool>(), count);
+
+  // Boxes
+  expected.clear();
+  for (size_t i = 0; i < count; i++) {
+    if (frustum.TestAABB(batch.boxes[i]) != FRUSTUM_OUTSIDE)
+      expected.push_back(i);
+  }
+
+  std::fill(visible.begin(), visible.end(), POISON);
+  visible_count = CullAABBs(frustum, batch.boxes.data(), count, visible.data());
+  mismatches += Compare(visible, visible_count, expected, std::vector<bool>(), count);
+
+  // Instances, bounded by the local sphere moved by the model and scaled by its largest axis
+  expected.clear();
+  for (size_t i = 0; i < count; i++) {
+    const glm::mat4 &model = batch.models[i];
+
+    const glm::vec3 center(model * glm::vec4(glm::vec3(sphere), 1.0f));
+    const float scale = std::sqrt(std::max(
+      std::max(glm::dot(glm::vec3(model[0]), glm::vec3(model[0])), glm::dot(glm::vec3(model[1]), glm::vec3(model[1]))),
+      glm::dot(glm::vec3(model[2]), glm::vec3(model[2]))
+    ));
+    const float radius = sphere.w * scale;
+
+    if (frustum.TestSphere(center, radius) != FRUSTUM_OUTSIDE)
+      expected.push_back(i);
+
+    for (int plane = 0; plane < FRUSTUM_PLANE_COUNT; plane++) {
+      const double distance = glm::dot(glm::vec3(frustum.planes[plane]), center) + frustum.planes[plane].w;
+      const double magnitude = std::max(1.0, (double)glm::length(glm::vec3(model[3])) + radius);
+
+      if (std::fabs(distance + radius) <= NEAR_EPSILON * magnitude)
+        skip[i] = true;
+    }
+
+    if (skip[i])
+      skipped++;
+  }
+
+  std::fill(visible.begin(), visible.end(), POISON);
+  visible_count = CullInstances(frustum, batch.models.data(), count, sphere, visible.data());
+  mismatches += Compare(visible, visible_count, expected, skip, count);
+
+  return mismatches;
+}
+
+int main(int argc, char **argv) {
+  const long object_count = bench::GetOption(argc, argv, "--objects", 100001);
+  const long runs = bench::GetOption(argc, argv, "--runs", 50);
+
+  std::mt19937 random(2019);
+
+  // Cameras inside the scene looking different ways, so the planes cut through the objects
+  static const glm::vec3 targets[CAMERA_COUNT] = {
+    glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(1.0f, 0.5f, 0.0f), glm::vec3(-0.3f, -1.0f, 0.2f)
+  };
+
+  const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, SCENE_SIZE);
+
+  Frustum frustums[CAMERA_COUNT];
+  for (size_t camera = 0; camera < CAMERA_COUNT; camera++)
+    frustums[camera] = Frustum::FromMatrix(projection * glm::lookAt(glm::vec3(0.0f), targets[camera], glm::vec3(0.0f, 1.0f, 0.0f)));
+
+  static const glm::vec4 instance_sphere(0.25f, -0.5f, 0.1f, 1.5f);
+
+  // Every small batch size and one large batch whose size is no multiple of 4 or 8
+  std::vector<Batch> small_batches(SMALL_BATCH_MAX + 1);
+  for (size_t count = 0; count <= SMALL_BATCH_MAX; count++)
+    small_batches[count].Generate(count, random);
+
+  Batch large_batch;
+  large_batch.Generate(object_count, random);
+
+  std::vector<uint32_t> visible(object_count);
+
+  printf("\nCullKernels (%ld objects, %ld runs)\n", object_count, runs);
+  printf("%8s %12s %12s %14s %14s %14s\n", "kernel", "mismatches", "skipped", "sphere ns", "aabb ns", "instance ns");
+
+  bool failed = false;
+
+  for (size_t k = 0; k < KERNEL_COUNT; k++) {
+    const CullKernelType kernel = kernels[k];
+
+    if (!IsCullKernelSupported(kernel)) {
+      printf("%8s %12s\n", GetCullKernelName(kernel), "unsupported");
+      continue;
+    }
+
+    SetCullKernel(kernel);
+
+    size_t mismatches = 0;
+    size_t skipped = 0;
+
+    for (const Frustum &frustum : frustums) {
+      for (const Batch &batch : small_batches)
+        mismatches += Check(frustum, batch, instance_sphere, skipped);
+
+      mismatches += Check(frustum, large_batch, instance_sphere, skipped);
+    }
+
+    bench::Samples sphere_times, aabb_times, instance_times;
+    for (long run = 0; run < runs; run++) {
+      const Frustum &frustum = frustums[run % CAMERA_COUNT];
+
+      bench::Stopwatch watch;
+      bench::DoNotOptimize(CullSpheres(frustum, large_batch.spheres.data(), object_count, visible.data()));
+      sphere_times.Add(watch.GetElapsedMs());
+
+      watch.Restart();
+      bench::DoNotOptimize(CullAABBs(frustum, large_batch.boxes.data(), object_count, visible.data()));
+      aabb_times.Add(watch.GetElapsedMs());
+
+      watch.Restart();
+      bench::DoNotOptimize(CullInstances(frustum, large_batch.models.data(), object_count, instance_sphere, visible.data()));
+      instance_times.Add(watch.GetElapsedMs());
+    }
+
+    printf("%8s %12zu %12zu %14.2f %14.2f %14.2f\n",
+      GetCullKernelName(kernel), mismatches, skipped,
+      sphere_times.GetMean() * 1e6 / object_count, aabb_times.GetMean() * 1e6 / object_count,
+      instance_times.GetMean() * 1e6 / object_count);
+
+    if (mismatches > 0)
+      failed = true;
+  }
+
+  printf("%s\n", failed ? "FAILED: a kernel differs from the frustum tests" : "PASSED");
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,238 @@
+/*
+  Elgar Benchmarks
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+/**
+ * @file EcsTransforms.cpp
+ * @brief Measures a fixed step update (store the previous state, move and spin) and the
+ *        interpolation to model matrices over 10k, 100k and 1M entities. The same work runs on
+ *        heap allocated Interpolated objects visited in shuffled order (as they end up after a
+ *        while of spawning and despawning), on the World one chunk at a time and on the World
+ *        through the JobSystem.
+ *
+ *        Usage: EcsTransforms [--runs N] [--max N]
+ */
+
+#include "elgar/Engine.hpp"
+#include "elgar/core/Window.hpp"
+#include "elgar/ecs/Transform.hpp"
+#include "elgar/ecs/World.hpp"
+#include "elgar/physics/Interpolated.hpp"
+#include "elgar/physics/TransformKernel.hpp"
+
+#include "Bench.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+using namespace elgar;
+
+#define FIXED_DELTA_TIME  (1.0f / 50.0f)
+#define ALPHA             0.5f
+
+#define MODE_OBJECTS      0   // Interpolated objects on the heap
+#define MODE_ECS          1   // World, chunk by chunk on the calling thread
+#define MODE_ECS_PARALLEL 2   // World, chunks spread across the JobSystem
+#define MODE_COUNT        3
+
+#define SIZE_COUNT        3
+
+static const size_t entity_counts[SIZE_COUNT] = {10000, 100000, 1000000};
+
+/**
+ * @brief How fast an entity moves and spins
+ *
+ */
+struct Velocity {
+  glm::vec3 linear;     // Units per second
+  glm::vec3 angular;    // Radians per second
+};
+
+/**
+ * @brief The model matrix the interpolation writes for an entity
+ *
+ */
+struct Model {
+  glm::mat4 value;
+};
+
+/**
+ * @brief The starting state of every entity, shared by all modes
+ *
+ */
+struct Spawn {
+  glm::vec3 position;
+  glm::vec3 scale;
+  glm::vec3 rotation;
+  Velocity  velocity;
+};
+
+/**
+ * @brief Move and spin a chunk of entities by one fixed step
+ *
+ */
+static void Integrate(const size_t &count, Position *positions, Rotation *rotations, Velocity *velocities) {
+  for (size_t i = 0; i < count; i++) {
+    positions[i].value += velocities[i].linear * FIXED_DELTA_TIME;
+    rotations[i].value += velocities[i].angular * FIXED_DELTA_TIME;
+  }
+}
+
+/**
+ * @brief Write the model matrices of a chunk of entities
+ *
+ */
+static void Interpolate(
+  const size_t &count,
+  PreviousPosition *prev_positions, Position *positions,
+  PreviousScale *prev_scales, Scale *scales,
+  PreviousRotation *prev_rotations, Rotation *rotations,
+  Model *models
+) {
+  // The components are single vec3 / mat4 wrappers, so their arrays are the kernel's arrays
+  TransformArrays arrays;
+  arrays.prev_positions = &prev_positions[0].value;
+  arrays.positions = &positions[0].value;
+  arrays.prev_scales = &prev_scales[0].value;
+  arrays.scales = &scales[0].value;
+  arrays.prev_rotations = &prev_rotations[0].value;
+  arrays.rotations = &rotations[0].value;
+
+  ComputeInterpolatedMatrices(arrays, count, ALPHA, &models[0].value);
+}
+
+int main(int argc, char **argv) {
+  const long runs = bench::GetOption(argc, argv, "--runs", 20);
+  const size_t max_entities = bench::GetOption(argc, argv, "--max", entity_counts[SIZE_COUNT - 1]);
+
+  // Headless, only for the JobSystem
+  Engine *engine = new Engine("EcsTransforms", 0, 0, HEADLESS);
+
+  static const char *mode_names[MODE_COUNT] = {"objects", "ecs", "ecs parallel"};
+
+  printf("\nEcsTransforms (%ld runs, %s transform kernel)\n", runs, GetTransformKernelName(GetTransformKernel()));
+  printf("%10s %14s %14s %14s %18s\n", "entities", "mode", "update ms", "interp ms", "update+interp ns");
+
+  std::mt19937 random(2019);
+  std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+  for (size_t size = 0; size < SIZE_COUNT && entity_counts[size] <= max_entities; size++) {
+    const size_t count = entity_counts[size];
+
+    std::vector<Spawn> spawns(count);
+    for (Spawn &spawn : spawns) {
+      spawn.position = glm::vec3(unit(random), unit(random), unit(random)) * 500.0f;
+      spawn.scale = glm::vec3(1.0f + unit(random) * 0.5f);
+      spawn.rotation = glm::vec3(unit(random), unit(random), unit(random)) * 3.14f;
+      spawn.velocity.linear = glm::vec3(unit(random), unit(random), unit(random)) * 10.0f;
+      spawn.velocity.angular = glm::vec3(unit(random), unit(random), unit(random));
+    }
+
+    for (size_t mode = 0; mode < MODE_COUNT; mode++) {
+      bench::Samples update_times;
+      bench::Samples interp_times;
+
+      if (mode == MODE_OBJECTS) {
+        std::vector<Interpolated *> objects;
+        std::vector<Velocity> velocities;
+        std::vector<glm::mat4> models(count);
+
+        for (const Spawn &spawn : spawns) {
+          objects.push_back(new Interpolated(spawn.position, spawn.scale, spawn.rotation));
+          velocities.push_back(spawn.velocity);
+        }
+
+        // Scatter the visiting order across the heap
+        std::vector<size_t> order(count);
+        for (size_t i = 0; i < count; i++)
+          order[i] = i;
+        std::shuffle(order.begin(), order.end(), random);
+
+        for (long run = 0; run < runs; run++) {
+          bench::Stopwatch watch;
+
+          for (const size_t &i : order) {
+            objects[i]->ChangePosition(velocities[i].linear * FIXED_DELTA_TIME);
+            objects[i]->ChangeRotation(velocities[i].angular * FIXED_DELTA_TIME);
+            objects[i]->ChangeScale(glm::vec3(0.0f));
+          }
+
+          update_times.Add(watch.GetElapsedMs());
+          watch.Restart();
+
+          for (const size_t &i : order)
+            models[i] = objects[i]->GetMatrix();
+
+          interp_times.Add(watch.GetElapsedMs());
+        }
+
+        bench::DoNotOptimize(models[count - 1]);
+
+        for (Interpolated *object : objects)
+          delete object;
+      }
+      else {
+        World world;
+
+        for (const Spawn &spawn : spawns) {
+          world.CreateEntity(
+            Position{spawn.position}, Scale{spawn.scale}, Rotation{spawn.rotation},
+            PreviousPosition{spawn.position}, PreviousScale{spawn.scale}, PreviousRotation{spawn.rotation},
+            spawn.velocity, Model()
+          );
+        }
+
+        for (long run = 0; run < runs; run++) {
+          bench::Stopwatch watch;
+
+          // StorePreviousTransforms always spreads its copies across the JobSystem
+          if (mode == MODE_ECS_PARALLEL) {
+            StorePreviousTransforms(world);
+            world.ParallelEachChunk<Position, Rotation, Velocity>(Integrate);
+          }
+          else {
+            world.EachChunk<Position, PreviousPosition>([](const size_t &n, Position *current, PreviousPosition *previous) {
+              for (size_t i = 0; i < n; i++)
+                previous[i].value = current[i].value;
+            });
+            world.EachChunk<Scale, PreviousScale>([](const size_t &n, Scale *current, PreviousScale *previous) {
+              for (size_t i = 0; i < n; i++)
+                previous[i].value = current[i].value;
+            });
+            world.EachChunk<Rotation, PreviousRotation>([](const size_t &n, Rotation *current, PreviousRotation *previous) {
+              for (size_t i = 0; i < n; i++)
+                previous[i].value = current[i].value;
+            });
+            world.EachChunk<Position, Rotation, Velocity>(Integrate);
+          }
+
+          update_times.Add(watch.GetElapsedMs());
+          watch.Restart();
+
+          if (mode == MODE_ECS_PARALLEL)
+            world.ParallelEachChunk<PreviousPosition, Position, PreviousScale, Scale, PreviousRotation, Rotation, Model>(Interpolate);
+          else
+            world.EachChunk<PreviousPosition, Position, PreviousScale, Scale, PreviousRotation, Rotation, Model>(Interpolate);
+
+          interp_times.Add(watch.GetElapsedMs());
+        }
+
+        world.EachChunk<Model>([](const size_t &n, Model *models) {
+          bench::DoNotOptimize(models[n - 1]);
+        });
+      }
+
+      printf("%10zu %14s %14.3f %14.3f %18.2f\n",
+        count, mode_names[mode], update_times.GetMean(), interp_times.GetMean(),
+        (update_times.GetMean() + interp_times.GetMean()) * 1e6 / count);
+    }
+  }
+
+  delete engine;
+
+  return 0;
+}
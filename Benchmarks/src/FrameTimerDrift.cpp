@@ -0,0 +1,156 @@
+/*
+  Elgar Benchmarks
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+/**
+ * @file FrameTimerDrift.cpp
+ * @brief Long run test of the FrameTimer accumulator. Writes an input recording of a simulated 24h
+ *        session (60 Hz frames with +-2 ms of jitter on a nanosecond clock), replays it through a
+ *        headless Engine and checks every frame that the elapsed time, the fixed step count and
+ *        the interpolation alpha match exact integer bookkeeping. A float seconds accumulator like
+ *        the one the loop used to run on is carried along for comparison.
+ *
+ *        Exits with a non-zero code if the FrameTimer drifts.
+ *
+ *        Usage: FrameTimerDrift [--hours N]
+ */
+
+#include "elgar/Engine.hpp"
+#include "elgar/core/InputRecording.hpp"
+#include "elgar/core/Window.hpp"
+#include "elgar/timers/FrameTimer.hpp"
+
+#include "Bench.hpp"
+
+#include <cmath>
+#include <random>
+#include <stdio.h>
+
+using namespace elgar;
+
+#define CLOCK_FREQUENCY     1000000000ull   // Nanosecond clock, as SDL reports on Linux
+#define STEPS_PER_SECOND    50ull
+#define FRAME_TICKS         16666667ull     // 60 Hz
+#define FRAME_JITTER        2000000ull      // +-2 ms
+
+#define RECORDING_PATH      "FrameTimerDrift.rec"
+
+#define MAX_ELAPSED_ERROR   1e-9    // Seconds
+#define MAX_ALPHA_ERROR     1e-6
+
+std::mt19937_64 frame_random;   // Replays the jitter of the recording frame by frame
+
+uint64_t frame_count = 0;
+uint64_t total_ticks = 0;       // Clock ticks of every frame so far
+uint64_t steps_taken = 0;       // Fixed updates run so far
+
+double elapsed = 0.0;           // Elapsed time reported by the FrameTimer on the last frame
+uint64_t step_mismatches = 0;   // Frames where the FrameTimer step count was off
+
+double max_elapsed_error = 0.0;
+double max_alpha_error = 0.0;
+
+float naive_elapsed = 0.0f;     // Float seconds summed frame by frame
+float naive_accumulator = 0.0f; // Float seconds waiting to be simulated
+uint64_t naive_steps = 0;       // Steps the float accumulator would have taken
+
+/**
+ * @brief Get the length of the next frame of the session
+ *
+ * @return The frame length in clock ticks
+ */
+uint64_t NextFrameTicks() {
+  return FRAME_TICKS - FRAME_JITTER + frame_random() % (2 * FRAME_JITTER + 1);
+}
+
+void update() {
+  static FrameTimer *frame_timer = FrameTimer::GetInstance();
+
+  const uint64_t frame_ticks = NextFrameTicks();
+  total_ticks += frame_ticks;
+  frame_count++;
+
+  // Exact elapsed time, split the same way so only the final division rounds
+  const uint64_t whole = total_ticks / CLOCK_FREQUENCY;
+  const double expected_elapsed = (double)whole + (double)(total_ticks % CLOCK_FREQUENCY) / CLOCK_FREQUENCY;
+
+  elapsed = frame_timer->GetElapsedTime();
+  max_elapsed_error = std::max(max_elapsed_error, std::fabs(elapsed - expected_elapsed));
+
+  if (frame_timer->GetFixedStepCount() != steps_taken)
+    step_mismatches++;
+
+  // Unsimulated time in ticks * steps per second, before this frame's steps are taken
+  const uint64_t accumulator = total_ticks * STEPS_PER_SECOND - steps_taken * CLOCK_FREQUENCY;
+  const double expected_alpha = (double)accumulator / CLOCK_FREQUENCY;
+
+  max_alpha_error = std::max(max_alpha_error, std::fabs(frame_timer->GetAlpha() - expected_alpha));
+
+  // What a float seconds loop would have made of the same frame
+  const float frame_seconds = (float)((double)frame_ticks / CLOCK_FREQUENCY);
+  naive_elapsed += frame_seconds;
+  naive_accumulator += frame_seconds;
+
+  while (naive_accumulator >= 1.0f / STEPS_PER_SECOND) {
+    naive_accumulator -= 1.0f / STEPS_PER_SECOND;
+    naive_steps++;
+  }
+}
+
+void fixed_update() {
+  steps_taken++;
+}
+
+int main(int argc, char **argv) {
+  const long hours = bench::GetOption(argc, argv, "--hours", 24);
+  const uint64_t session_ticks = (uint64_t)hours * 3600ull * CLOCK_FREQUENCY;
+
+  // Record the session
+  {
+    InputRecorder recorder(RECORDING_PATH, CLOCK_FREQUENCY, STEPS_PER_SECOND);
+
+    frame_random.seed(2019);
+
+    uint64_t ticks = 0;
+    while (ticks < session_ticks) {
+      const uint64_t frame_ticks = NextFrameTicks();
+      recorder.EndFrame(frame_ticks);
+      ticks += frame_ticks;
+    }
+  }
+
+  bench::Stopwatch watch;
+
+  // Replay it with the same jitter so every frame can be checked
+  frame_random.seed(2019);
+
+  Engine *engine = new Engine("FrameTimerDrift", 0, 0, HEADLESS);
+  engine->ReplayInput(RECORDING_PATH);
+  engine->Run(update, fixed_update, nullptr);
+
+  delete engine;
+
+  remove(RECORDING_PATH);
+
+  const uint64_t expected_steps = total_ticks * STEPS_PER_SECOND / CLOCK_FREQUENCY;
+  const double session_seconds = (double)total_ticks / CLOCK_FREQUENCY;
+
+  printf("\nFrameTimerDrift (%llu frames, %.3f simulated hours, replayed in %.1f s)\n",
+    (unsigned long long)frame_count, session_seconds / 3600.0, watch.GetElapsedMs() / 1000.0);
+  printf("  FrameTimer elapsed    %.9f s (max error %.3g s)\n", elapsed, max_elapsed_error);
+  printf("  FrameTimer steps      %llu of %llu expected (%llu frames off)\n",
+    (unsigned long long)steps_taken, (unsigned long long)expected_steps, (unsigned long long)step_mismatches);
+  printf("  FrameTimer alpha      max error %.3g\n", max_alpha_error);
+  printf("  float seconds elapsed %.3f s (off by %.3f s)\n", naive_elapsed, naive_elapsed - session_seconds);
+  printf("  float seconds steps   %llu (off by %lld)\n",
+    (unsigned long long)naive_steps, (long long)naive_steps - (long long)expected_steps);
+
+  const bool drifted = steps_taken != expected_steps || step_mismatches > 0 ||
+    max_elapsed_error > MAX_ELAPSED_ERROR || max_alpha_error > MAX_ALPHA_ERROR;
+
+  printf("%s\n", drifted ? "FAILED: the FrameTimer drifted" : "PASSED");
+
+  return drifted ? 1 : 0;
+}
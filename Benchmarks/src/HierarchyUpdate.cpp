@@ -0,0 +1,366 @@
+/*
+  Elgar Benchmarks
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+/**
+ * @file HierarchyUpdate.cpp
+ * @brief First checks TransformationGroup against a brute force model: random creates, destroys,
+ *        reparents (including attempted cycles), local and group transform changes, and after
+ *        every Update each world transform must match the product of the local transforms up
+ *        its chain. Then measures Update on a 100k node hierarchy where 1% of the nodes move per
+ *        frame, against recomputing every world matrix by hand.
+ *
+ *        Exits with a non-zero code if the check fails.
+ *
+ *        Usage: HierarchyUpdate [--nodes N] [--moving N] [--frames N] [--rounds N]
+ */
+
+#include "elgar/core/Exception.hpp"
+#include "elgar/graphics/groups/TransformationGroup.hpp"
+#include "elgar/physics/TransformKernel.hpp"
+
+#include "Bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+using namespace elgar;
+
+#define CHECK_NODES       2000    // Nodes the check starts with
+#define CHECK_OPERATIONS  25      // Random operations between updates
+#define MAX_ERROR         1e-4    // Relative to the magnitude of the element (at least 1)
+
+/**
+ * @brief A ModelNode is the brute force view of a node (indexed by handle)
+ *
+ */
+struct ModelNode {
+  bool          alive;    // Does the handle belong to a live node?
+  TransformNode parent;   // Parent handle (TRANSFORM_NODE_NONE for roots)
+  glm::mat4     local;    // Transform relative to the parent
+};
+
+std::mt19937 random_engine(2019);
+
+/**
+ * @brief Get a random float
+ *
+ * @param min   The smallest value
+ * @param max   The largest value
+ * @return The value
+ */
+float RandomFloat(const float &min, const float &max) {
+  return std::uniform_real_distribution<float>(min, max)(random_engine);
+}
+
+/**
+ * @brief Get a random index
+ *
+ * @param count The number of indices
+ * @return An index below count
+ */
+size_t RandomIndex(const size_t &count) {
+  return std::uniform_int_distribution<size_t>(0, count - 1)(random_engine);
+}
+
+/**
+ * @brief Get a random local transform (near unit scale, so long chains stay well conditioned)
+ *
+ * @return The transform
+ */
+glm::mat4 RandomLocal() {
+  const glm::vec3 position(RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f), RandomFloat(-10.0f, 10.0f));
+  const glm::vec3 scale(RandomFloat(0.9f, 1.1f), RandomFloat(0.9f, 1.1f), RandomFloat(0.9f, 1.1f));
+  const glm::vec3 rotation(RandomFloat(-3.14f, 3.14f), RandomFloat(-3.14f, 3.14f), RandomFloat(-3.14f, 3.14f));
+
+  return ComputeInterpolatedMatrix(position, position, scale, scale, rotation, rotation, 1.0f);
+}
+
+/**
+ * @brief Compute the world transform of a node by walking up its chain
+ *
+ * @param model   The brute force nodes
+ * @param group   The group transform
+ * @param node    The node
+ * @return The world transform
+ */
+glm::mat4 GetModelWorld(const std::vector<ModelNode> &model, const glm::mat4 &group, const TransformNode &node) {
+  const ModelNode &model_node = model[node];
+
+  if (model_node.parent == TRANSFORM_NODE_NONE)
+    return group * model_node.local;
+
+  return GetModelWorld(model, group, model_node.parent) * model_node.local;
+}
+
+/**
+ * @brief Check if a node is an ancestor of another (or the node itself)
+ *
+ * @param model     The brute force nodes
+ * @param ancestor  The possible ancestor
+ * @param node      The node
+ * @return True if it is, false otherwise
+ */
+bool IsModelAncestor(const std::vector<ModelNode> &model, const TransformNode &ancestor, TransformNode node) {
+  for (; node != TRANSFORM_NODE_NONE; node = model[node].parent) {
+    if (node == ancestor)
+      return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Run random operations on a TransformationGroup and compare it to the brute force model
+ *        after every update
+ *
+ * @param rounds  The number of updates
+ * @return The number of mismatches found
+ */
+size_t CheckEquivalence(const long &rounds) {
+  TransformationGroup group;
+  std::vector<ModelNode> model;
+  std::vector<TransformNode> alive;   // Live handles (rebuilt every round)
+
+  glm::mat4 group_transform(1.0f);
+
+  size_t mismatches = 0;
+  double max_error = 0.0;
+
+  // Create a node in both the group and the model
+  auto create = [&group, &model](const TransformNode &parent) {
+    const glm::mat4 local = RandomLocal();
+    const TransformNode node = group.CreateNode(parent, local);
+
+    if (node >= model.size())
+      model.resize(node + 1, ModelNode{false, TRANSFORM_NODE_NONE, glm::mat4(1.0f)});
+
+    model[node] = ModelNode{true, parent, local};
+  };
+
+  create(TRANSFORM_NODE_NONE);
+  for (size_t i = 1; i < CHECK_NODES; i++) {
+    const TransformNode parent = RandomIndex(10) == 0 ? TRANSFORM_NODE_NONE : (TransformNode)RandomIndex(i);
+    create(parent);
+  }
+
+  for (long round = 0; round < rounds; round++) {
+    for (size_t op = 0; op < CHECK_OPERATIONS; op++) {
+      alive.clear();
+      for (TransformNode node = 0; node < model.size(); node++) {
+        if (model[node].alive)
+          alive.push_back(node);
+      }
+
+      const size_t kind = RandomIndex(100);
+
+      // Keep the group from emptying out
+      if (alive.size() < CHECK_NODES / 4 || kind < 15) {
+        const bool root = alive.empty() || RandomIndex(10) == 0;
+        create(root ? TRANSFORM_NODE_NONE : alive[RandomIndex(alive.size())]);
+      }
+      else if (kind < 20) {
+        // Destroy a node and every descendant
+        const TransformNode victim = alive[RandomIndex(alive.size())];
+        group.DestroyNode(victim);
+
+        std::vector<TransformNode> doomed;
+        for (const TransformNode &node : alive) {
+          if (IsModelAncestor(model, victim, node))
+            doomed.push_back(node);
+        }
+
+        for (const TransformNode &node : doomed)
+          model[node].alive = false;
+      }
+      else if (kind < 35) {
+        // Reparent, sometimes onto a descendant (which must be refused)
+        const TransformNode node = alive[RandomIndex(alive.size())];
+        const TransformNode parent = RandomIndex(10) == 0 ? TRANSFORM_NODE_NONE : alive[RandomIndex(alive.size())];
+
+        const bool cycle = parent != TRANSFORM_NODE_NONE && IsModelAncestor(model, node, parent);
+
+        bool refused = false;
+        try {
+          group.SetParent(node, parent);
+        }
+        catch (const Exception &) {
+          refused = true;
+        }
+
+        if (refused != cycle) {
+          printf("  SetParent %s a cycle it should have %s\n", refused ? "refused" : "accepted", cycle ? "refused" : "accepted");
+          mismatches++;
+        }
+
+        if (!cycle)
+          model[node].parent = parent;
+      }
+      else if (kind < 37) {
+        group_transform = RandomLocal();
+        group.SetGroupTransform(group_transform);
+      }
+      else {
+        const TransformNode node = alive[RandomIndex(alive.size())];
+        const glm::mat4 local = RandomLocal();
+
+        group.SetLocalTransform(node, local);
+        model[node].local = local;
+      }
+    }
+
+    group.Update();
+
+    // Compare every live node against the brute force model
+    size_t model_count = 0;
+    const glm::mat4 *worlds = group.GetWorldTransforms();
+
+    for (TransformNode node = 0; node < model.size(); node++) {
+      if (model[node].alive != group.IsAlive(node)) {
+        printf("  Node %u is %s in the group only\n", node, model[node].alive ? "missing" : "alive");
+        mismatches++;
+        continue;
+      }
+
+      if (!model[node].alive)
+        continue;
+
+      model_count++;
+
+      const TransformNode parent = group.GetParent(node);
+      const GLuint index = group.GetNodeIndex(node);
+
+      // Parents must stay ahead of their children
+      if (parent != model[node].parent || (parent != TRANSFORM_NODE_NONE && group.GetNodeIndex(parent) >= index)) {
+        printf("  Node %u has the wrong parent or order\n", node);
+        mismatches++;
+      }
+
+      const glm::mat4 expected = GetModelWorld(model, group_transform, node);
+      const glm::mat4 &actual = group.GetWorldTransform(node);
+
+      bool mismatch = &worlds[index] != &actual;
+
+      for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+          const double error = std::fabs(actual[column][row] - expected[column][row]) /
+            std::max(1.0, (double)std::fabs(expected[column][row]));
+
+          max_error = std::max(max_error, error);
+
+          if (!(error <= MAX_ERROR))
+            mismatch = true;
+        }
+      }
+
+      if (mismatch) {
+        if (mismatches < 10)
+          printf("  Node %u world transform differs after round %ld\n", node, round);
+        mismatches++;
+      }
+    }
+
+    if (model_count != group.GetNodeCount()) {
+      printf("  Group has %zu nodes, expected %zu\n", group.GetNodeCount(), model_count);
+      mismatches++;
+    }
+  }
+
+  printf("  %ld rounds of %d operations, max error %.3g, %zu mismatches\n",
+    rounds, CHECK_OPERATIONS, max_error, mismatches);
+
+  return mismatches;
+}
+
+int main(int argc, char **argv) {
+  const long node_count = bench::GetOption(argc, argv, "--nodes", 100000);
+  const long moving_count = bench::GetOption(argc, argv, "--moving", node_count / 100);
+  const long frames = bench::GetOption(argc, argv, "--frames", 300);
+  const long rounds = bench::GetOption(argc, argv, "--rounds", 500);
+
+  printf("\nHierarchyUpdate equivalence check\n");
+  const size_t mismatches = CheckEquivalence(rounds);
+
+  // Random tree, every node hangs off an earlier one (1% are roots)
+  TransformationGroup group;
+  std::vector<TransformNode> nodes;
+  std::vector<glm::mat4> locals;
+
+  for (long i = 0; i < node_count; i++) {
+    const bool root = i == 0 || RandomIndex(100) == 0;
+    const TransformNode parent = root ? TRANSFORM_NODE_NONE : nodes[RandomIndex(i)];
+
+    locals.push_back(RandomLocal());
+    nodes.push_back(group.CreateNode(parent, locals.back()));
+  }
+
+  group.Update();
+
+  // The by hand baseline walks the same breadth-first order with its own parent indices
+  std::vector<GLuint> order(node_count);
+  std::vector<GLuint> parents(node_count);
+  std::vector<glm::mat4> hand_locals(node_count);
+  std::vector<glm::mat4> hand_worlds(node_count);
+
+  for (long i = 0; i < node_count; i++) {
+    const GLuint index = group.GetNodeIndex(nodes[i]);
+    const TransformNode parent = group.GetParent(nodes[i]);
+
+    order[i] = index;
+    parents[index] = parent == TRANSFORM_NODE_NONE ? TRANSFORM_NODE_NONE : group.GetNodeIndex(parent);
+    hand_locals[index] = locals[i];
+  }
+
+  const glm::mat4 group_transform = group.GetGroupTransform();
+
+  bench::Samples move_times;
+  bench::Samples update_times;
+  bench::Samples update_counts;
+  bench::Samples hand_times;
+
+  for (long frame = 0; frame < frames; frame++) {
+    bench::Stopwatch watch;
+
+    for (long i = 0; i < moving_count; i++) {
+      const size_t node = RandomIndex(node_count);
+      const glm::mat4 local = RandomLocal();
+
+      group.SetLocalTransform(nodes[node], local);
+      hand_locals[order[node]] = local;
+    }
+
+    move_times.Add(watch.GetElapsedMs());
+    watch.Restart();
+
+    group.Update();
+
+    update_times.Add(watch.GetElapsedMs());
+    update_counts.Add(group.GetUpdateCount());
+    watch.Restart();
+
+    // Recompute every world matrix, as composing by hand had to
+    for (long i = 0; i < node_count; i++) {
+      const GLuint parent = parents[i];
+      hand_worlds[i] = (parent == TRANSFORM_NODE_NONE ? group_transform : hand_worlds[parent]) * hand_locals[i];
+    }
+
+    hand_times.Add(watch.GetElapsedMs());
+  }
+
+  bench::DoNotOptimize(hand_worlds[node_count - 1]);
+
+  printf("\nHierarchyUpdate (%ld nodes, %ld moving per frame, %ld frames)\n", node_count, moving_count, frames);
+  printf("%14s %12s %12s %16s\n", "mode", "ms mean", "ms p95", "recomputed/frame");
+  printf("%14s %12.3f %12.3f %16s\n", "move", move_times.GetMean(), move_times.GetPercentile(95.0), "-");
+  printf("%14s %12.3f %12.3f %16.0f\n", "dirty update", update_times.GetMean(), update_times.GetPercentile(95.0), update_counts.GetMean());
+  printf("%14s %12.3f %12.3f %16ld\n", "full by hand", hand_times.GetMean(), hand_times.GetPercentile(95.0), node_count);
+
+  printf("%s\n", mismatches ? "FAILED: TransformationGroup differs from the brute force model" : "PASSED");
+
+  return mismatches ? 1 : 0;
+}
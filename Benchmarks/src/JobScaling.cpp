@@ -0,0 +1,139 @@
+/*
+  Elgar Benchmarks
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+/**
+ * @file JobScaling.cpp
+ * @brief Measures how a synthetic transform update (integrate position and spin, then build the
+ *        model matrix) scales across 1 to N threads of the JobSystem. A headless Engine is started
+ *        for every thread count with one worker fewer than the threads (the main thread helps).
+ *
+ *        Usage: JobScaling [--transforms N] [--grain N] [--threads N] [--runs N]
+ */
+
+#include "elgar/Engine.hpp"
+#include "elgar/core/JobSystem.hpp"
+#include "elgar/core/Window.hpp"
+
+#include "Bench.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+using namespace elgar;
+
+#define FIXED_DELTA_TIME  (1.0f / 60.0f)
+
+/**
+ * @brief A Body is the per object state the synthetic workload integrates
+ *
+ */
+struct Body {
+  glm::vec3 position;   // World position
+  glm::vec3 velocity;   // Units per second
+  glm::vec3 scale;      // Size of the object
+  float     angle;      // Rotation around z in radians
+  float     spin;       // Radians per second
+};
+
+/**
+ * @brief Integrate a range of bodies by one step and write their model matrices
+ *
+ * @param bodies  The bodies
+ * @param models  The model matrix of each body
+ * @param begin   The first body to update
+ * @param end     One past the last body to update
+ */
+static void UpdateBodies(Body *bodies, glm::mat4 *models, const size_t &begin, const size_t &end) {
+  for (size_t i = begin; i < end; i++) {
+    Body &body = bodies[i];
+
+    body.position += body.velocity * FIXED_DELTA_TIME;
+    body.angle += body.spin * FIXED_DELTA_TIME;
+
+    // Bounce off the edges of a 1000 unit box
+    for (int axis = 0; axis < 3; axis++) {
+      if (std::fabs(body.position[axis]) > 1000.0f)
+        body.velocity[axis] = -body.velocity[axis];
+    }
+
+    const float c = std::cos(body.angle);
+    const float s = std::sin(body.angle);
+
+    models[i] = glm::mat4(
+      glm::vec4(c * body.scale.x, s * body.scale.x, 0.0f, 0.0f),
+      glm::vec4(-s * body.scale.y, c * body.scale.y, 0.0f, 0.0f),
+      glm::vec4(0.0f, 0.0f, body.scale.z, 0.0f),
+      glm::vec4(body.position, 1.0f)
+    );
+  }
+}
+
+int main(int argc, char **argv) {
+  const long transform_count = bench::GetOption(argc, argv, "--transforms", 1000000);
+  const long grain = bench::GetOption(argc, argv, "--grain", 4096);
+  const long runs = bench::GetOption(argc, argv, "--runs", 50);
+
+  const unsigned int cores = std::thread::hardware_concurrency();
+  const long max_threads = bench::GetOption(argc, argv, "--threads", cores > 0 ? cores : 1);
+
+  std::vector<Body> bodies(transform_count);
+  std::vector<glm::mat4> models(transform_count);
+
+  for (long i = 0; i < transform_count; i++) {
+    bodies[i].position = glm::vec3((i % 1000) - 500.0f, ((i / 1000) % 1000) - 500.0f, 0.0f);
+    bodies[i].velocity = glm::vec3((i % 7) - 3.0f, (i % 5) - 2.0f, (i % 3) - 1.0f);
+    bodies[i].scale = glm::vec3(1.0f + (i % 4));
+    bodies[i].angle = 0.0f;
+    bodies[i].spin = (i % 11) * 0.1f;
+  }
+
+  // Serial reference without any job overhead
+  bench::Samples serial_times;
+  for (long run = 0; run < runs; run++) {
+    bench::Stopwatch watch;
+    UpdateBodies(&bodies[0], &models[0], 0, transform_count);
+    serial_times.Add(watch.GetElapsedMs());
+  }
+
+  bench::DoNotOptimize(models[transform_count - 1]);
+
+  printf("\nJobScaling (%ld transforms, grain %ld, %ld runs, %u hardware threads)\n",
+    transform_count, grain, runs, cores);
+  printf("%8s %12s %12s %10s %12s\n", "threads", "ms mean", "ms p95", "speedup", "efficiency");
+  printf("%8s %12.3f %12.3f %10s %12s\n", "serial", serial_times.GetMean(), serial_times.GetPercentile(95.0), "-", "-");
+
+  const double serial_ms = serial_times.GetMean();
+
+  for (long threads = 1; threads <= max_threads; threads++) {
+    Engine *engine = new Engine("JobScaling", 0, 0, HEADLESS, threads - 1);
+    JobSystem *job_system = JobSystem::GetInstance();
+
+    bench::Samples times;
+    for (long run = 0; run < runs; run++) {
+      bench::Stopwatch watch;
+
+      job_system->ParallelFor(transform_count, grain, [&bodies, &models](size_t begin, size_t end) {
+        UpdateBodies(&bodies[0], &models[0], begin, end);
+      });
+
+      times.Add(watch.GetElapsedMs());
+    }
+
+    bench::DoNotOptimize(models[transform_count - 1]);
+
+    const double speedup = serial_ms / times.GetMean();
+    printf("%8ld %12.3f %12.3f %9.2fx %11.0f%%\n",
+      threads, times.GetMean(), times.GetPercentile(95.0), speedup, 100.0 * speedup / threads);
+
+    delete engine;
+  }
+
+  return 0;
+}
@@ -0,0 +1,133 @@
+/*
+  Elgar Benchmarks
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+/**
+ * @file LoggerThroughput.cpp
+ * @brief Measures Logger throughput in messages per second with 1 to N threads logging at once.
+ *        Every thread writes the same four argument message through LOG_WARNING (warnings wait for
+ *        room instead of being dropped, so this is the sustained rate) and the clock stops once
+ *        Flush returns; the rate the callers saw (stopped before the flush) is reported as well.
+ *        The deferred and the caller formatted modes are measured against a bare fprintf per
+ *        message like the old LOG macro. Messages go to a counting sink and the fprintf baseline to
+ *        /dev/null, so the terminal is not what is being measured.
+ *
+ *        Usage: LoggerThroughput [--messages N] [--threads N] [--runs N]
+ */
+
+#include "elgar/core/Logger.hpp"
+#include "elgar/core/Macros.hpp"
+
+#include "Bench.hpp"
+
+#include <atomic>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+using namespace elgar;
+
+#define MODE_DEFERRED   0   // Arguments captured, formatted on the flush thread
+#define MODE_IMMEDIATE  1   // Formatted on the calling thread
+#define MODE_PRINTF     2   // fprintf on the calling thread, as LOG used to
+#define MODE_COUNT      3
+
+std::atomic<size_t> sink_count(0);  // Messages that reached the sink
+
+FILE *null_file = nullptr;
+
+/**
+ * @brief A sink that only counts the messages it is handed
+ *
+ */
+void CountingSink(const LogLevel &, const uint64_t &, const unsigned int &, const char *) {
+  sink_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Log a number of messages from the calling thread
+ *
+ * @param mode      How the messages are written
+ * @param thread    Index of the thread, logged as an argument
+ * @param messages  Number of messages to log
+ */
+void LogMessages(const size_t &mode, const unsigned int &thread, const long &messages) {
+  for (long i = 0; i < messages; i++) {
+    if (mode == MODE_PRINTF)
+      fprintf(null_file, "Frame %ld on thread %u took %f ms in %s\n", i, thread, i * 0.25, "LoggerThroughput");
+    else
+      LOG_WARNING("Frame %ld on thread %u took %f ms in %s\n", i, thread, i * 0.25, "LoggerThroughput");
+  }
+}
+
+int main(int argc, char **argv) {
+  const long messages = bench::GetOption(argc, argv, "--messages", 200000);
+  const long runs = bench::GetOption(argc, argv, "--runs", 5);
+
+  const unsigned int cores = std::thread::hardware_concurrency();
+  const long max_threads = bench::GetOption(argc, argv, "--threads", cores > 0 ? cores : 1);
+
+  null_file = fopen("/dev/null", "w");
+  if (!null_file) {
+    fprintf(stderr, "Could not open /dev/null!\n");
+    return 1;
+  }
+
+  Logger &logger = Logger::Get();
+  logger.SetSink(&CountingSink);
+
+  static const char *mode_names[MODE_COUNT] = {"deferred", "immediate", "printf"};
+
+  printf("\nLoggerThroughput (%ld messages per thread, %ld runs, %u hardware threads)\n", messages, runs, cores);
+  printf("%8s %12s %16s %16s %16s %10s\n", "threads", "mode", "caller msgs/s", "msgs/s mean", "msgs/s worst", "dropped");
+
+  for (long threads = 1; threads <= max_threads; threads++) {
+    for (size_t mode = 0; mode < MODE_COUNT; mode++) {
+      logger.SetDeferred(mode == MODE_DEFERRED);
+
+      bench::Samples caller_rates;
+      bench::Samples rates;
+      const size_t dropped_before = logger.GetDroppedCount();
+
+      for (long run = 0; run < runs; run++) {
+        std::vector<std::thread> producers;
+
+        bench::Stopwatch watch;
+
+        for (long t = 0; t < threads; t++)
+          producers.emplace_back(LogMessages, mode, (unsigned int)t, messages);
+
+        for (std::thread &producer : producers)
+          producer.join();
+
+        caller_rates.Add(threads * messages / (watch.GetElapsedMs() / 1000.0));
+
+        if (mode == MODE_PRINTF)
+          fflush(null_file);
+        else
+          logger.Flush();
+
+        rates.Add(threads * messages / (watch.GetElapsedMs() / 1000.0));
+      }
+
+      printf("%8ld %12s %16.0f %16.0f %16.0f %10zu\n",
+        threads, mode_names[mode], caller_rates.GetMean(), rates.GetMean(), rates.GetPercentile(0.0),
+        logger.GetDroppedCount() - dropped_before);
+    }
+  }
+
+  // Every message written through the Logger must have reached the sink
+  const size_t expected = (size_t)(MODE_COUNT - 1) * runs * messages * max_threads * (max_threads + 1) / 2;
+
+  logger.SetSink(nullptr);
+  fclose(null_file);
+
+  if (sink_count.load() != expected) {
+    printf("FAILED: %zu of %zu messages reached the sink\n", sink_count.load(), expected);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,209 @@
+/*
+  Elgar Benchmarks
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+/**
+ * @file RenderQueue.cpp
+ * @brief Draws 50k sprites spread over a set of textures in shuffled order, first straight through
+ *        SpriteRenderer::Draw and then through the sort-key queue of a RenderGroup, and compares
+ *        the GL state changes (as counted by the StateCache) and the frame time of both.
+ *
+ *        Usage: RenderQueue [--sprites N] [--textures N] [--frames N] [--warmup N]
+ */
+
+#include "elgar/Engine.hpp"
+#include "elgar/core/Window.hpp"
+#include "elgar/graphics/Camera.hpp"
+#include "elgar/graphics/ShaderManager.hpp"
+#include "elgar/graphics/StateCache.hpp"
+#include "elgar/graphics/data/Image.hpp"
+#include "elgar/graphics/data/Texture.hpp"
+#include "elgar/graphics/groups/RenderGroup.hpp"
+#include "elgar/graphics/renderers/SpriteRenderer.hpp"
+
+#include "Bench.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+using namespace elgar;
+
+#define WIDTH   1920
+#define HEIGHT  1080
+
+#define PHASE_DIRECT  0   // Draw in submission order
+#define PHASE_QUEUED  1   // Draw through the RenderGroup
+#define PHASE_COUNT   2
+
+/**
+ * @brief A Sprite is one shuffled draw of the scene
+ *
+ */
+struct Sprite {
+  glm::mat4     model;    // Where the sprite is drawn
+  const Texture *texture; // The texture of the sprite
+  RGBA          color;    // The tint of the sprite (one per texture)
+};
+
+Engine *engine = nullptr;
+
+RenderGroup *group = nullptr;
+
+std::vector<Texture *> textures;
+std::vector<Sprite> sprites;
+
+Camera camera(
+  glm::ortho(0.0f, (float)WIDTH, 0.0f, (float)HEIGHT, -1000.0f, 1000.0f)
+);
+
+long warmup_frames = 0;
+long measured_frames = 0;
+
+size_t phase = PHASE_DIRECT;
+long phase_frame = 0;
+
+bench::Stopwatch frame_watch;
+bench::Samples frame_times[PHASE_COUNT];
+bench::Samples render_times[PHASE_COUNT];
+bench::Samples issued_changes[PHASE_COUNT];
+bench::Samples skipped_changes[PHASE_COUNT];
+bench::Samples draw_counts[PHASE_COUNT];
+
+void update() {
+  static StateCache *state_cache = StateCache::GetInstance();
+
+  const double frame_ms = frame_watch.GetElapsedMs();
+  frame_watch.Restart();
+
+  // The counts and times are those of the frame just presented
+  if (phase_frame > warmup_frames) {
+    frame_times[phase].Add(frame_ms);
+
+    if (state_cache) {
+      issued_changes[phase].Add(state_cache->GetIssuedChanges());
+      skipped_changes[phase].Add(state_cache->GetSkippedChanges());
+    }
+  }
+
+  if (++phase_frame > warmup_frames + measured_frames) {
+    phase_frame = 0;
+
+    if (++phase == PHASE_COUNT) {
+      phase = PHASE_COUNT - 1;
+      engine->SetRunning(false);
+    }
+  }
+}
+
+void render() {
+  static SpriteRenderer *sprite_renderer = SpriteRenderer::GetInstance();
+  static const Shader *shader = ShaderManager::GetInstance()->GetShader(SHADER_BASIC_PROGRAM);
+
+  if (!sprite_renderer || !shader)
+    return;
+
+  bench::Stopwatch render_watch;
+
+  camera.Draw(*shader);
+
+  if (phase == PHASE_DIRECT) {
+    for (const Sprite &sprite : sprites)
+      sprite_renderer->Draw(*shader, sprite.model, sprite.color, sprite.texture);
+
+    draw_counts[phase].Add(sprites.size());
+  }
+  else {
+    for (const Sprite &sprite : sprites)
+      group->SubmitSprite(*shader, sprite.model, sprite.color, sprite.texture);
+
+    group->Flush();
+
+    draw_counts[phase].Add(group->GetDrawCount());
+  }
+
+  if (phase_frame > warmup_frames)
+    render_times[phase].Add(render_watch.GetElapsedMs());
+}
+
+int main(int argc, char **argv) {
+  const long sprite_count = bench::GetOption(argc, argv, "--sprites", 50000);
+  const long texture_count = bench::GetOption(argc, argv, "--textures", 16);
+  measured_frames = bench::GetOption(argc, argv, "--frames", 200);
+  warmup_frames = bench::GetOption(argc, argv, "--warmup", 20);
+
+  engine = new Engine("RenderQueue", WIDTH, HEIGHT, OFFSCREEN);
+  engine->SetFastForward(true);   // Run flat out instead of pacing to the display
+
+  group = new RenderGroup();
+
+  std::mt19937 random(1234);
+
+  // Small solid color textures are enough to force a bind per switch
+  std::vector<unsigned char> pixels(4 * 4 * 4);
+  for (long i = 0; i < texture_count; i++) {
+    std::fill(pixels.begin(), pixels.end(), (unsigned char)(random() & 0xFF));
+
+    Image image;
+    image.data = &pixels[0];
+    image.width = 4;
+    image.height = 4;
+    image.channels = 4;
+
+    textures.push_back(new Texture(image, TEXTURE_DIFFUSE));
+  }
+
+  // Interleave the textures so consecutive sprites rarely share state
+  std::uniform_real_distribution<float> x_dist(0.0f, WIDTH);
+  std::uniform_real_distribution<float> y_dist(0.0f, HEIGHT);
+  std::uniform_real_distribution<float> z_dist(-100.0f, 100.0f);
+
+  for (long i = 0; i < sprite_count; i++) {
+    const size_t texture = i % texture_count;
+
+    Sprite sprite;
+    sprite.model = glm::scale(
+      glm::translate(glm::mat4(), {x_dist(random), y_dist(random), z_dist(random)}),
+      {8.0f, 8.0f, 1.0f}
+    );
+    sprite.texture = textures[texture];
+    sprite.color = RGBA(0xFF, (GLubyte)(texture * 16), 0x80, 0xFF);
+
+    sprites.push_back(sprite);
+  }
+
+  std::shuffle(sprites.begin(), sprites.end(), random);
+
+  engine->Run(update, nullptr, render);
+
+  static const char *phase_names[PHASE_COUNT] = {"direct", "queued"};
+
+  printf("\nRenderQueue (%ld sprites, %ld textures, %ld frames after %ld warmup)\n",
+    sprite_count, texture_count, measured_frames, warmup_frames);
+  printf("%8s %10s %14s %14s %14s %14s\n", "mode", "draws", "issued/frame", "skipped/frame", "render ms", "frame ms");
+
+  for (size_t i = 0; i < PHASE_COUNT; i++) {
+    printf("%8s %10.0f %14.0f %14.0f %14.3f %14.3f\n",
+      phase_names[i],
+      draw_counts[i].GetMean(),
+      issued_changes[i].GetMean(),
+      skipped_changes[i].GetMean(),
+      render_times[i].GetMean(),
+      frame_times[i].GetMean()
+    );
+  }
+
+  delete group;
+
+  for (Texture *texture : textures)
+    delete texture;
+
+  delete engine;
+
+  return 0;
+}
@@ -0,0 +1,202 @@
+/*
+  Elgar Benchmarks
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+/**
+ * @file SpriteInstancing.cpp
+ * @brief Measures the CPU cost per frame of SpriteRenderer::DrawInstanced at 1k, 10k and 100k
+ *        instances. Pass --legacy to draw through a copy of the old path instead, which created,
+ *        filled (GL_STATIC_DRAW) and deleted a buffer object on every call.
+ *
+ *        Usage: SpriteInstancing [--legacy] [--frames N] [--warmup N]
+ */
+
+#include "elgar/Engine.hpp"
+#include "elgar/core/Window.hpp"
+#include "elgar/graphics/Camera.hpp"
+#include "elgar/graphics/ShaderManager.hpp"
+#include "elgar/graphics/buffers/BufferObject.hpp"
+#include "elgar/graphics/buffers/VertexArrayObject.hpp"
+#include "elgar/graphics/renderers/SpriteRenderer.hpp"
+
+#include "Bench.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <stdio.h>
+#include <vector>
+
+using namespace elgar;
+
+#define WIDTH   1920
+#define HEIGHT  1080
+
+#define PHASE_COUNT   3
+
+static const size_t instance_counts[PHASE_COUNT] = {1000, 10000, 100000};
+
+/**
+ * @brief The LegacySpriteBatch draws instanced sprites the way the SpriteRenderer did before the
+ *        instance ring buffer: one new buffer object per call, filled with GL_STATIC_DRAW
+ *
+ */
+class LegacySpriteBatch {
+private:
+  VertexArrayObject m_vao;            // The quad VAO
+  BufferObject      m_vertex_buffer;  // The quad corners
+  BufferObject      m_uv_buffer;      // The quad uvs
+
+public:
+  LegacySpriteBatch() : m_vertex_buffer(GL_ARRAY_BUFFER), m_uv_buffer(GL_ARRAY_BUFFER) {
+    static const glm::vec3 vertices[4] = {
+      {-0.5f, -0.5f, 0.0f}, {0.5f, -0.5f, 0.0f}, {-0.5f, 0.5f, 0.0f}, {0.5f, 0.5f, 0.0f}
+    };
+
+    static const glm::vec2 uvs[4] = {
+      {0.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 1.0f}
+    };
+
+    m_vao.Bind();
+
+    m_vertex_buffer.Bind();
+    m_vertex_buffer.FillData(&vertices[0][0], sizeof(vertices), GL_STATIC_DRAW);
+    m_vao.EnableAttribute(0);
+    m_vao.AttributePointer(0, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
+
+    m_uv_buffer.Bind();
+    m_uv_buffer.FillData(&uvs[0][0], sizeof(uvs), GL_STATIC_DRAW);
+    m_vao.EnableAttribute(1);
+    m_vao.AttributePointer(1, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid *)0);
+
+    m_vao.Unbind();
+  }
+
+  void DrawInstanced(const Shader &shader, const glm::mat4 *models, const size_t &count, const RGBA &color) {
+    shader.Use();
+    shader.SetBool("use_texture", GL_FALSE);
+    shader.SetVec4("color", color.GetData());
+    shader.SetBool("use_instancing", GL_TRUE);
+
+    m_vao.Bind();
+
+    // A brand new buffer for every call, deleted again at scope exit
+    BufferObject model_buffer(GL_ARRAY_BUFFER);
+    model_buffer.Bind();
+    model_buffer.FillData(&models[0][0][0], sizeof(glm::mat4) * count, GL_STATIC_DRAW);
+
+    for (GLuint row = 0; row < 4; row++) {
+      m_vao.EnableAttribute(2 + row);
+      m_vao.AttributePointer(2 + row, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (GLvoid *)(sizeof(glm::vec4) * row));
+      m_vao.AttributeDivisor(2 + row, 1);
+    }
+
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count);
+
+    m_vao.Unbind();
+  }
+
+};
+
+Engine *engine = nullptr;
+
+LegacySpriteBatch *legacy = nullptr;
+
+std::vector<glm::mat4> models;
+
+Camera camera(
+  glm::ortho(0.0f, (float)WIDTH, 0.0f, (float)HEIGHT, 0.0f, 1000.0f)
+);
+
+long warmup_frames = 0;
+long measured_frames = 0;
+
+size_t phase = 0;
+long phase_frame = 0;
+
+bench::Stopwatch frame_watch;
+bench::Samples frame_times[PHASE_COUNT];
+bench::Samples render_times[PHASE_COUNT];
+
+void update() {
+  const double frame_ms = frame_watch.GetElapsedMs();
+  frame_watch.Restart();
+
+  // The first update has no frame before it
+  if (phase_frame > warmup_frames)
+    frame_times[phase].Add(frame_ms);
+
+  if (++phase_frame > warmup_frames + measured_frames) {
+    phase_frame = 0;
+
+    if (++phase == PHASE_COUNT) {
+      phase = PHASE_COUNT - 1;
+      engine->SetRunning(false);
+    }
+  }
+}
+
+void render() {
+  static SpriteRenderer *sprite_renderer = SpriteRenderer::GetInstance();
+  static const Shader *shader = ShaderManager::GetInstance()->GetShader(SHADER_BASIC_PROGRAM);
+
+  if (!sprite_renderer || !shader)
+    return;
+
+  bench::Stopwatch render_watch;
+
+  camera.Draw(*shader);
+
+  if (legacy)
+    legacy->DrawInstanced(*shader, &models[0], instance_counts[phase], {0xFF, 0x25, 0x77, 0xFF});
+  else
+    sprite_renderer->DrawInstanced(*shader, &models[0], instance_counts[phase], {0xFF, 0x25, 0x77, 0xFF}, nullptr);
+
+  if (phase_frame > warmup_frames)
+    render_times[phase].Add(render_watch.GetElapsedMs());
+}
+
+int main(int argc, char **argv) {
+  const bool use_legacy = bench::HasFlag(argc, argv, "--legacy");
+  measured_frames = bench::GetOption(argc, argv, "--frames", 300);
+  warmup_frames = bench::GetOption(argc, argv, "--warmup", 30);
+
+  engine = new Engine("SpriteInstancing", WIDTH, HEIGHT, OFFSCREEN);
+  engine->SetFastForward(true);   // Run flat out instead of pacing to the display
+
+  if (use_legacy)
+    legacy = new LegacySpriteBatch();
+
+  // Spread the sprites over a grid covering the screen
+  const size_t columns = 400;
+  for (size_t i = 0; i < instance_counts[PHASE_COUNT - 1]; i++) {
+    const glm::vec3 position(
+      (i % columns) * (WIDTH / (float)columns),
+      (i / columns) * 4.0f,
+      0.0f
+    );
+
+    models.push_back(glm::scale(glm::translate(glm::mat4(), position), {4.0f, 4.0f, 1.0f}));
+  }
+
+  engine->Run(update, nullptr, render);
+
+  printf("\nSpriteInstancing (%s path, %ld frames after %ld warmup)\n", use_legacy ? "legacy" : "ring buffer", measured_frames, warmup_frames);
+  printf("%10s %16s %16s %16s %16s\n", "instances", "render ms mean", "render ms p95", "frame ms mean", "frame ms p95");
+
+  for (size_t i = 0; i < PHASE_COUNT; i++) {
+    printf("%10zu %16.3f %16.3f %16.3f %16.3f\n",
+      instance_counts[i],
+      render_times[i].GetMean(), render_times[i].GetPercentile(95.0),
+      frame_times[i].GetMean(), frame_times[i].GetPercentile(95.0)
+    );
+  }
+
+  if (legacy)
+    delete legacy;
+
+  delete engine;
+
+  return 0;
+}
@@ -0,0 +1,262 @@
+/*
+  Elgar Benchmarks
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+/**
+ * @file TransformKernels.cpp
+ * @brief Checks every transform kernel the CPU supports (scalar, SSE, AVX2) against the glm chain
+ *        Interpolated::GetMatrix used before the kernels, translate(position) * scale(scale) *
+ *        toMat4(quat(angles)), and times them. Batch sizes from 0 to 40 cover the remainder
+ *        handling of the SIMD kernels, a large batch with angles of several turns covers the
+ *        range reduction of their sine and cosine. The kernels may round differently than glm
+ *        (AVX2 fuses the interpolation into FMAs), so an error in the angle grows with its size;
+ *        the rotation columns are therefore compared relative to scale times angle.
+ *
+ *        Exits with a non-zero code if any kernel differs from glm by more than the tolerance.
+ *
+ *        Usage: TransformKernels [--transforms N] [--runs N]
+ */
+
+#include "elgar/physics/TransformKernel.hpp"
+
+#include "Bench.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+using namespace elgar;
+
+#define SMALL_BATCH_MAX   40
+#define MAX_ERROR         1e-5    // Relative to the magnitude of the element (see Compare)
+
+#define KERNEL_COUNT      3
+
+static const TransformKernelType kernels[KERNEL_COUNT] = {
+  TRANSFORM_KERNEL_SCALAR, TRANSFORM_KERNEL_SSE, TRANSFORM_KERNEL_AVX2
+};
+
+/**
+ * @brief A Batch is a structure of arrays of random transforms
+ *
+ */
+struct Batch {
+  std::vector<glm::vec3> prev_positions;
+  std::vector<glm::vec3> positions;
+  std::vector<glm::vec3> prev_scales;
+  std::vector<glm::vec3> scales;
+  std::vector<glm::vec3> prev_rotations;
+  std::vector<glm::vec3> rotations;
+
+  /**
+   * @brief Fill the batch with random transforms
+   *
+   * @param count   The number of transforms
+   * @param turns   The largest rotation, in whole turns either way
+   * @param random  The random generator
+   */
+  void Generate(const size_t &count, const float &turns, std::mt19937 &random) {
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    const float max_angle = turns * 2.0f * 3.14159265f;
+
+    prev_positions.resize(count);
+    positions.resize(count);
+    prev_scales.resize(count);
+    scales.resize(count);
+    prev_rotations.resize(count);
+    rotations.resize(count);
+
+    for (size_t i = 0; i < count; i++) {
+      prev_positions[i] = glm::vec3(unit(random), unit(random), unit(random)) * 1000.0f;
+      positions[i] = prev_positions[i] + glm::vec3(unit(random), unit(random), unit(random));
+      prev_scales[i] = glm::vec3(unit(random), unit(random), unit(random)) * 5.0f + glm::vec3(5.5f);
+      scales[i] = prev_scales[i] + glm::vec3(unit(random), unit(random), unit(random)) * 0.1f;
+      prev_rotations[i] = glm::vec3(unit(random), unit(random), unit(random)) * max_angle;
+      rotations[i] = prev_rotations[i] + glm::vec3(unit(random), unit(random), unit(random)) * 0.1f;
+    }
+  }
+
+  /**
+   * @brief Get the arrays of the batch for the kernels
+   *
+   * @return The arrays
+   */
+  TransformArrays GetArrays() const {
+    TransformArrays arrays;
+    arrays.prev_positions = prev_positions.data();
+    arrays.positions = positions.data();
+    arrays.prev_scales = prev_scales.data();
+    arrays.scales = scales.data();
+    arrays.prev_rotations = prev_rotations.data();
+    arrays.rotations = rotations.data();
+    return arrays;
+  }
+
+  /**
+   * @brief Get the magnitude the rotation columns of a transform are compared relative to
+   *
+   * @param i       The transform
+   * @param alpha   Interpolation alpha
+   * @param row     The row of the column
+   * @return The magnitude (at least 1)
+   */
+  double GetRotationMagnitude(const size_t &i, const float &alpha, const int &row) const {
+    const glm::vec3 scale = scales[i] * alpha + prev_scales[i] * (1.0f - alpha);
+    const glm::vec3 rotation = rotations[i] * alpha + prev_rotations[i] * (1.0f - alpha);
+
+    const double angle = std::max(std::fabs(rotation.x), std::max(std::fabs(rotation.y), std::fabs(rotation.z)));
+
+    return std::max(1.0, std::fabs(scale[row]) * std::max(1.0, angle));
+  }
+
+  /**
+   * @brief Compute the matrix of a transform the way Interpolated::GetMatrix did before the kernels
+   *
+   * @param i       The transform
+   * @param alpha   Interpolation alpha
+   * @return The model matrix
+   */
+  glm::mat4 GetReference(const size_t &i, const float &alpha) const {
+    const glm::vec3 position = positions[i] * alpha + prev_positions[i] * (1.0f - alpha);
+    const glm::vec3 scale = scales[i] * alpha + prev_scales[i] * (1.0f - alpha);
+    const glm::vec3 rotation = rotations[i] * alpha + prev_rotations[i] * (1.0f - alpha);
+
+    glm::mat4 model_matrix;
+    model_matrix = glm::translate(model_matrix, position);
+    model_matrix = glm::scale(model_matrix, scale);
+
+    return model_matrix * glm::toMat4(glm::quat(rotation));
+  }
+};
+
+/**
+ * @brief Compare a batch of kernel output against the glm reference
+ *
+ * @param batch     The transforms
+ * @param alpha     Interpolation alpha
+ * @param matrices  The kernel output
+ * @return The largest error relative to the magnitude of the element (the translation column) or
+ *         to scale times angle (the rotation columns)
+ */
+static double Compare(const Batch &batch, const float &alpha, const std::vector<glm::mat4> &matrices) {
+  double max_error = 0.0;
+
+  for (size_t i = 0; i < batch.positions.size(); i++) {
+    const glm::mat4 reference = batch.GetReference(i, alpha);
+
+    for (int column = 0; column < 4; column++) {
+      for (int row = 0; row < 4; row++) {
+        const double expected = reference[column][row];
+        const double magnitude = column < 3 ?
+          batch.GetRotationMagnitude(i, alpha, row) : std::max(1.0, std::fabs(expected));
+        const double error = std::fabs(matrices[i][column][row] - expected) / magnitude;
+
+        // NaN must fail too
+        if (!(error <= max_error))
+          max_error = std::isnan(error) ? INFINITY : error;
+      }
+    }
+  }
+
+  return max_error;
+}
+
+int main(int argc, char **argv) {
+  const long transform_count = bench::GetOption(argc, argv, "--transforms", 100000);
+  const long runs = bench::GetOption(argc, argv, "--runs", 50);
+
+  static const float alphas[] = {0.0f, 0.25f, 0.5f, 0.999f, 1.0f};
+
+  std::mt19937 random(2019);
+
+  // Every small batch size, near zero rotations and several turns
+  std::vector<Batch> small_batches;
+  for (size_t count = 0; count <= SMALL_BATCH_MAX; count++) {
+    small_batches.emplace_back();
+    small_batches.back().Generate(count, count % 2 ? 0.05f : 4.0f, random);
+  }
+
+  Batch large_batch;
+  large_batch.Generate(transform_count, 16.0f, random);
+
+  std::vector<glm::mat4> matrices(std::max((size_t)transform_count, (size_t)SMALL_BATCH_MAX));
+
+  printf("\nTransformKernels (%ld transforms, %ld runs, tolerance %.0e)\n", transform_count, runs, MAX_ERROR);
+  printf("%8s %14s %14s %14s %14s\n", "kernel", "small error", "large error", "ms mean", "ns/transform");
+
+  bool failed = false;
+
+  for (size_t k = 0; k < KERNEL_COUNT; k++) {
+    const TransformKernelType kernel = kernels[k];
+
+    if (!IsTransformKernelSupported(kernel)) {
+      printf("%8s %14s\n", GetTransformKernelName(kernel), "unsupported");
+      continue;
+    }
+
+    SetTransformKernel(kernel);
+
+    double small_error = 0.0;
+    double large_error = 0.0;
+
+    for (const float &alpha : alphas) {
+      for (const Batch &batch : small_batches) {
+        // Poison the output so skipped elements are caught
+        std::fill(matrices.begin(), matrices.end(), glm::mat4(NAN));
+
+        ComputeInterpolatedMatrices(batch.GetArrays(), batch.positions.size(), alpha, matrices.data());
+        small_error = std::max(small_error, Compare(batch, alpha, matrices));
+
+        // Nothing past the end of the batch may be written
+        for (size_t i = batch.positions.size(); i < SMALL_BATCH_MAX; i++) {
+          if (!std::isnan(matrices[i][0][0]))
+            small_error = INFINITY;
+        }
+      }
+
+      ComputeInterpolatedMatrices(large_batch.GetArrays(), transform_count, alpha, matrices.data());
+      large_error = std::max(large_error, Compare(large_batch, alpha, matrices));
+    }
+
+    bench::Samples times;
+    for (long run = 0; run < runs; run++) {
+      bench::Stopwatch watch;
+      ComputeInterpolatedMatrices(large_batch.GetArrays(), transform_count, 0.5f, matrices.data());
+      times.Add(watch.GetElapsedMs());
+    }
+
+    bench::DoNotOptimize(matrices[transform_count - 1]);
+
+    printf("%8s %14.3g %14.3g %14.3f %14.2f\n",
+      GetTransformKernelName(kernel), small_error, large_error, times.GetMean(), times.GetMean() * 1e6 / transform_count);
+
+    if (small_error > MAX_ERROR || large_error > MAX_ERROR)
+      failed = true;
+  }
+
+  // Time the glm chain itself for comparison
+  bench::Samples glm_times;
+  for (long run = 0; run < runs; run++) {
+    bench::Stopwatch watch;
+    for (long i = 0; i < transform_count; i++)
+      matrices[i] = large_batch.GetReference(i, 0.5f);
+    glm_times.Add(watch.GetElapsedMs());
+  }
+
+  bench::DoNotOptimize(matrices[transform_count - 1]);
+
+  printf("%8s %14s %14s %14.3f %14.2f\n", "glm", "-", "-", glm_times.GetMean(), glm_times.GetMean() * 1e6 / transform_count);
+
+  printf("%s\n", failed ? "FAILED: a kernel differs from the glm chain" : "PASSED");
+
+  return failed ? 1 : 0;
+}
@@ -31,9 +31,17 @@
 // DEFINES //
 
 #define DEFAULT_PHYS_STEPS_PER_SECOND   50  // Number of physics cycles per second
+#define DEFAULT_RENDER_PIPELINE_DEPTH   2   // Frames the render thread may fall behind by in threaded rendering
+
+union SDL_Event;
 
 namespace elgar {
 
+  class Keyboard;
+  class Mouse;
+  class InputRecorder;
+  class InputPlayer;
+
   /**
    * @brief      The Engine class oversees all core functionalities of the Elgar pipeline. Every program 
    *             using Elgar must utilize this class. (Is a Singleton class)
@@ -41,6 +49,26 @@ namespace elgar {
   class Engine : public Singleton<Engine> {
   private:
     bool m_running; // Track whether engine is running or not
+    bool m_fast_forward;  // Step the simulation as fast as possible instead of in real time
+    bool m_threaded_rendering;    // Render from a dedicated thread that owns the OpenGL context
+    unsigned int m_pipeline_depth;  // Frames the render thread may fall behind by
+    unsigned char m_flags;  // The window flags the engine was started with
+    unsigned int m_worker_count;  // Worker threads for the JobSystem (0 for one per core)
+
+    InputRecorder *m_recorder;  // Records the input of the next run (nullptr if not recording)
+    InputPlayer *m_player;      // Replays input during the next run (nullptr if not replaying)
+    std::string m_frame_times_path;   // Where to write the frame times of a replay (empty to skip)
+
+  private:
+    /**
+     * @brief      Apply an event to the engine and input devices, recording it if a recording is
+     *             in progress
+     *
+     * @param[in]  e         The event
+     * @param      keyboard  The keyboard
+     * @param      mouse     The mouse
+     */
+    void HandleEvent(const SDL_Event &e, Keyboard *keyboard, Mouse *mouse);
 
   public:
     /**
@@ -49,13 +77,18 @@ namespace elgar {
      * @param[in]  window_name    The name of the window
      * @param[in]  window_width   The window width (in pixels)
      * @param[in]  window_height  The window height (in pixels)
-     * @param[in]  window_flags   The window flags (window enumeration flags)
+     * @param[in]  window_flags   The window flags (window enumeration flags, HEADLESS runs without
+     *                            a window or OpenGL, OFFSCREEN runs without a window but renders
+     *                            into an offscreen frame buffer)
+     * @param[in]  worker_count   Worker threads for the JobSystem besides the main thread (0 for
+     *                            one per core)
      */
     Engine(
       const std::string &window_name, 
       const int &window_width, 
       const int &window_height, 
-      const unsigned char &window_flags
+      const unsigned char &window_flags,
+      const unsigned int &worker_count = 0
     );
 
     /**
@@ -85,6 +118,24 @@ namespace elgar {
      */
     void Run(void (*update)(), void (*fixed_update)(), void (*render)());
 
+    /**
+     * @brief      Record the input events and frame times of the next Run to a binary file
+     *
+     * @param[in]  path  The file to write (an exception is thrown if it cannot be opened)
+     */
+    void RecordInput(const std::string &path);
+
+    /**
+     * @brief      Drive the next Run from a recording instead of live input and the wall clock. The
+     *             Keyboard, Mouse and FrameTimer see exactly what was recorded, frames run as fast
+     *             as the machine allows and the loop stops when the recording ends.
+     *
+     * @param[in]  path              The recording to replay (an exception is thrown if it cannot be read)
+     * @param[in]  frame_times_path  File to write the wall clock time of every replayed frame to
+     *                               (one millisecond value per line, empty to skip)
+     */
+    void ReplayInput(const std::string &path, const std::string &frame_times_path = "");
+
     /**
      * @brief      Checks if the engine is running or not
      *
@@ -99,6 +150,51 @@ namespace elgar {
      */
     void SetRunning(const bool &running);
 
+    /**
+     * @brief      Checks if the engine is running without a window
+     *
+     * @return     True if HEADLESS or OFFSCREEN was requested, False otherwise
+     */
+    bool IsHeadless() const;
+
+    /**
+     * @brief      Sets whether the application loop should ignore the wall clock and advance exactly
+     *             one fixed step per frame, running the simulation as fast as the machine allows
+     *
+     * @param[in]  fast_forward  True to fast forward, False to run in real time
+     */
+    void SetFastForward(const bool &fast_forward);
+
+    /**
+     * @brief      Checks if the application loop is fast forwarding
+     *
+     * @return     True if fast forwarding, False otherwise
+     */
+    bool IsFastForward() const;
+
+    /**
+     * @brief      Sets whether the next Run renders from a dedicated thread. The render function is
+     *             then called on the main thread with the renderer calls recorded into a command list,
+     *             and a render thread that owns the OpenGL context presents each list while the main
+     *             thread moves on to the next frame. OpenGL objects are created on the render thread
+     *             (RenderThread::Invoke) and deleted once the frames that may use them are presented
+     *             (RenderThread::Defer). Shader uniform setters called while recording are recorded
+     *             too and take effect in order with the draws. Shaders, textures and meshes a recorded
+     *             frame draws with must still be alive when it is presented, so delete them through
+     *             RenderThread::Defer. Ignored without a window.
+     *
+     * @param[in]  threaded  True to render from a dedicated thread, False to render on the main thread
+     * @param[in]  depth     Most frames the render thread may fall behind by (1 - 3)
+     */
+    void SetThreadedRendering(const bool &threaded, const unsigned int &depth = DEFAULT_RENDER_PIPELINE_DEPTH);
+
+    /**
+     * @brief      Checks if the engine renders from a dedicated thread
+     *
+     * @return     True if rendering is threaded, False otherwise
+     */
+    bool IsThreadedRendering() const;
+
   };
 
 }
@@ -22,6 +22,7 @@ namespace elgar {
   friend class AudioSource; // Grant AudioSource field viewing rights
   private:
     ALuint m_buffer_data; // Reference to the OpenAL buffer
+    ALint  m_size;        // Size in bytes of the audio data (as reported to the MemoryTracker)
 
   private:
     AudioBuffer();  // Default constructor
@@ -48,6 +49,11 @@ namespace elgar {
      * @return     Handle to the OpenAL buffer
      */
     ALuint GetBufferData() const;
+
+    /**
+     * @brief      Report the current size of the buffer to the MemoryTracker
+     */
+    void TrackSize();
   };
 
 }
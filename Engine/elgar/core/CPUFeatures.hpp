@@ -0,0 +1,35 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_CPU_FEATURES_HPP_
+#define _ELGAR_CPU_FEATURES_HPP_
+
+namespace elgar {
+
+  /**
+   * @brief The CPUFeatures struct lists the instruction set extensions the CPU (and operating
+   *        system, for the AVX register state) supports
+   *
+   */
+  struct CPUFeatures {
+    bool sse2;    // SSE2 (always present on x86-64)
+    bool sse41;   // SSE4.1
+    bool avx;     // AVX
+    bool avx2;    // AVX2
+    bool fma;     // FMA3
+  };
+
+  /**
+   * @brief Get the features of the CPU, queried through CPUID on first use (all false on
+   *        anything but x86)
+   *
+   * @return The features
+   */
+  const CPUFeatures &GetCPUFeatures();
+
+}
+
+#endif
@@ -0,0 +1,208 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_FRAME_ARENA_HPP_
+#define _ELGAR_FRAME_ARENA_HPP_
+
+// INCLUDES //
+
+#include "elgar/core/Singleton.hpp"
+#include "elgar/core/Exception.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// DEFINES //
+
+#define FRAME_ARENA_CHUNK_SIZE    (1024 * 1024)   // Bytes a thread's arena starts with (and grows by at least)
+
+namespace elgar {
+
+  /**
+   * @brief A FrameSubArena is the part of the FrameArena owned by a single thread. Only the owning
+   *        thread allocates from it, so allocation never takes a lock.
+   *
+   */
+  struct FrameSubArena {
+    std::vector<std::unique_ptr<unsigned char[]>> chunks;   // The memory of the arena
+    std::vector<size_t> sizes;    // Size of each chunk
+    size_t  chunk;      // Chunk currently allocated from
+    size_t  offset;     // Bytes used in the current chunk
+    size_t  used;       // Bytes used in the chunks before the current one
+    size_t  peak;       // Most bytes in use at once this frame
+    size_t  last_peak;  // Most bytes in use at once during the last frame
+    bool    owned;      // Is a live thread allocating from the sub-arena?
+  };
+
+  /**
+   * @brief The FrameArena class is a linear allocator for data that only lives for a single frame.
+   *        Every thread bumps a pointer through its own sub-arena and everything is released at
+   *        once when the Engine starts the next frame, so transient arrays cost no malloc/free
+   *        traffic. A sub-arena that overflows grows by another chunk and is merged back into a
+   *        single chunk of its high-water size on the next reset. Memory taken from the arena
+   *        must not be used after the frame ends (or handed to the render thread). (Is a
+   *        Singleton class)
+   *
+   */
+  class FrameArena : public Singleton<FrameArena> {
+  friend class Engine;
+  friend struct SubArenaRelease;
+  private:
+    std::vector<std::unique_ptr<FrameSubArena>> m_arenas;   // The sub-arena of every thread seen so far
+    mutable std::mutex  m_lock;     // Guards the sub-arena list (only taken when a thread first allocates)
+
+    uint32_t  m_generation;         // Distinguishes this arena from previous instances
+    size_t    m_last_frame_bytes;   // High-water mark of the last frame across every thread
+    size_t    m_peak_frame_bytes;   // Largest high-water mark of any frame so far
+    uint64_t  m_frame_count;        // Frames the arena has been reset for
+
+  private:
+    /**
+     * @brief Construct a new FrameArena object
+     *
+     */
+    FrameArena();
+
+    /**
+     * @brief Destroy the FrameArena object
+     *
+     */
+    virtual ~FrameArena();
+
+    /**
+     * @brief Get the sub-arena of the calling thread, creating it on first use
+     *
+     * @return The sub-arena
+     */
+    FrameSubArena *GetSubArena();
+
+    /**
+     * @brief Hand the sub-arena of an exiting thread over to the next new thread
+     *
+     * @param arena The sub-arena
+     */
+    void ReleaseSubArena(FrameSubArena *arena);
+
+    /**
+     * @brief Release everything allocated during the frame (no other thread may be allocating)
+     *
+     */
+    void Reset();
+
+  public:
+    /**
+     * @brief Allocate memory that lives until the end of the frame
+     *
+     * @param size      The number of bytes
+     * @param alignment The alignment (must be a power of two)
+     * @return The memory
+     */
+    void *Allocate(const size_t &size, const size_t &alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Give memory back early. Only the most recent allocation of the calling thread can be
+     *        reclaimed (which lets a growing array reuse its old storage), anything else is
+     *        released with the frame.
+     *
+     * @param memory  The memory
+     * @param size    The number of bytes it was allocated with
+     */
+    void Deallocate(void *memory, const size_t &size);
+
+    /**
+     * @brief Allocate an uninitialized array that lives until the end of the frame
+     *
+     * @tparam T      The element type (must be trivially destructible, nothing is destroyed)
+     * @param count   The number of elements
+     * @return The array
+     */
+    template<typename T>
+    T *AllocateArray(const size_t &count) {
+      return static_cast<T *>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief Get the high-water mark of the last frame across every thread
+     *
+     * @return Bytes
+     */
+    const size_t &GetLastFrameBytes() const;
+
+    /**
+     * @brief Get the largest high-water mark of any frame so far
+     *
+     * @return Bytes
+     */
+    const size_t &GetPeakFrameBytes() const;
+
+    /**
+     * @brief Get the high-water mark of the last frame of every thread that has used the arena
+     *
+     * @return Bytes per thread (in the order the threads first allocated)
+     */
+    std::vector<size_t> GetThreadFrameBytes() const;
+
+    /**
+     * @brief Get the memory reserved by every sub-arena
+     *
+     * @return Bytes
+     */
+    size_t GetCapacity() const;
+
+  };
+
+  /**
+   * @brief A FrameAllocator is an STL allocator that takes its memory from the FrameArena, for
+   *        containers that are thrown away by the end of the frame
+   *
+   * @tparam T The element type
+   */
+  template<typename T>
+  class FrameAllocator {
+  public:
+    typedef T value_type;
+
+    FrameAllocator() noexcept {}
+
+    template<typename U>
+    FrameAllocator(const FrameAllocator<U> &) noexcept {}
+
+    T *allocate(const size_t count) {
+      FrameArena *arena = FrameArena::GetInstance();
+
+      if (!arena)
+        throw Exception("ERROR: FrameAllocator used without a FrameArena!");
+
+      return arena->AllocateArray<T>(count);
+    }
+
+    void deallocate(T *memory, const size_t count) noexcept {
+      FrameArena *arena = FrameArena::GetInstance();
+
+      if (arena)
+        arena->Deallocate(memory, sizeof(T) * count);
+    }
+
+    template<typename U>
+    bool operator ==(const FrameAllocator<U> &) const noexcept {
+      return true;
+    }
+
+    template<typename U>
+    bool operator !=(const FrameAllocator<U> &) const noexcept {
+      return false;
+    }
+  };
+
+  template<typename T>
+  using FrameVector = std::vector<T, FrameAllocator<T>>;  // A vector that lives for a single frame
+
+}
+
+#endif
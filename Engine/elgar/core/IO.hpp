@@ -13,17 +13,22 @@
 
 #include <SDL2/SDL.h>
 #include <glm/glm.hpp>
-#include <unordered_map>
+#include <bitset>
 
 namespace elgar {
 
   /**
-   * @brief      The Keyboard captures all key events during application runtime
+   * @brief      The Keyboard captures all key events during application runtime. Key state is
+   *             kept in bitsets indexed by SDL_Scancode for the current and previous frame, along
+   *             with the keys that went down or up during the current frame.
    */
   class Keyboard : public Singleton<Keyboard> {
   friend class Engine;    // Grant the Engine exclusive instantiation rights
   private:
-    std::unordered_map<SDL_Keycode, bool> m_keys;  // The key table
+    std::bitset<SDL_NUM_SCANCODES> m_current;   // Keys held down this frame
+    std::bitset<SDL_NUM_SCANCODES> m_previous;  // Keys held down last frame
+    std::bitset<SDL_NUM_SCANCODES> m_pressed;   // Keys that went down this frame
+    std::bitset<SDL_NUM_SCANCODES> m_released;  // Keys that went up this frame
 
   private:
     /**
@@ -38,29 +43,71 @@ namespace elgar {
      */
     virtual ~Keyboard();
 
+    /**
+     * @brief      Snapshot the key state and clear the per frame edges (called before events are polled)
+     */
+    void BeginFrame();
+
   public:
     /**
      * @brief      Presses a key on the keyboard
      *
-     * @param[in]  key   The key
+     * @param[in]  key   The scancode of the key
      */
-    void PressKey(const SDL_Keycode &key);
+    void PressKey(const SDL_Scancode &key);
 
     /**
      * @brief      Releases a key on the keyboard
      *
-     * @param[in]  key   The key
+     * @param[in]  key   The scancode of the key
+     */
+    void ReleaseKey(const SDL_Scancode &key);
+
+    /**
+     * @brief      Determines if a given key is held down
+     *
+     * @param[in]  key   The scancode of the key
+     *
+     * @return     True if the key is down, False otherwise.
+     */
+    bool IsKeyDown(const SDL_Scancode &key) const;
+
+    /**
+     * @brief      Determines if a given key was held down last frame
+     *
+     * @param[in]  key   The scancode of the key
+     *
+     * @return     True if the key was down, False otherwise.
+     */
+    bool WasKeyDown(const SDL_Scancode &key) const;
+
+    /**
+     * @brief      Determines if a given key went down this frame (key repeats are ignored)
+     *
+     * @param[in]  key   The scancode of the key
+     *
+     * @return     True if the key was pressed this frame, False otherwise.
+     */
+    bool WasKeyPressedThisFrame(const SDL_Scancode &key) const;
+
+    /**
+     * @brief      Determines if a given key went up this frame
+     *
+     * @param[in]  key   The scancode of the key
+     *
+     * @return     True if the key was released this frame, False otherwise.
      */
-    void ReleaseKey(const SDL_Keycode &key);
+    bool WasKeyReleasedThisFrame(const SDL_Scancode &key) const;
 
     /**
-     * @brief      Determines if a given key is pressed
+     * @brief      Determines if a given key is pressed (maps the keycode to its scancode through SDL's
+     *             keymap on every call, prefer IsKeyDown in per frame code)
      *
      * @param[in]  key   The key
      *
      * @return     True if key pressed, False otherwise.
      */
-    bool IsKeyPressed(const SDL_Keycode &key);
+    bool IsKeyPressed(const SDL_Keycode &key) const;
 
   };
 
@@ -74,14 +121,20 @@ namespace elgar {
   };
 
   /**
-   * @brief      The Mouse captures all mouse events during application runtime
+   * @brief      The Mouse captures all mouse events during application runtime. Button state is
+   *             kept as bitmasks of MouseButton for the current and previous frame.
    */
   class Mouse : public Singleton<Mouse> {
   friend class Engine;      // Grant the engine exclusive instantiation rights
   private:
-    glm::vec2 m_pos; // The 2D position of the cursor
+    glm::vec2 m_pos;        // The 2D position of the cursor
+    glm::vec2 m_prev_pos;   // The position of the cursor last frame
+    glm::vec2 m_wheel;      // Wheel scroll accumulated this frame
 
-    unsigned char m_buttons;  // Track button presses
+    unsigned char m_buttons;    // Buttons held down this frame
+    unsigned char m_previous;   // Buttons held down last frame
+    unsigned char m_pressed;    // Buttons that went down this frame
+    unsigned char m_released;   // Buttons that went up this frame
 
   private:
     /**
@@ -96,6 +149,12 @@ namespace elgar {
      */
     virtual ~Mouse();
 
+    /**
+     * @brief      Snapshot the button state and clear the per frame edges and wheel (called before
+     *             events are polled)
+     */
+    void BeginFrame();
+
   public:
     /**
      * @brief      Press a MouseButton down
@@ -112,11 +171,46 @@ namespace elgar {
     void ReleaseButton(const MouseButton &button);
 
     /**
-     * @brief      Check if a given MouseButton is pressed
+     * @brief      Check if a given MouseButton is held down
      *
      * @param[in]  button  The button
      */
-    bool IsButtonPressed(const MouseButton &button);
+    bool IsButtonDown(const MouseButton &button) const;
+
+    /**
+     * @brief      Check if a given MouseButton went down this frame
+     *
+     * @param[in]  button  The button
+     */
+    bool WasButtonPressedThisFrame(const MouseButton &button) const;
+
+    /**
+     * @brief      Check if a given MouseButton went up this frame
+     *
+     * @param[in]  button  The button
+     */
+    bool WasButtonReleasedThisFrame(const MouseButton &button) const;
+
+    /**
+     * @brief      Check if a given MouseButton is pressed (same as IsButtonDown)
+     *
+     * @param[in]  button  The button
+     */
+    bool IsButtonPressed(const MouseButton &button) const;
+
+    /**
+     * @brief      Add wheel scroll to this frame's total
+     *
+     * @param[in]  delta The scroll amount (positive y is away from the user)
+     */
+    void Scroll(const glm::vec2 &delta);
+
+    /**
+     * @brief      Get the wheel scroll of this frame
+     *
+     * @return     The scroll amount (positive y is away from the user)
+     */
+    const glm::vec2 &GetWheelDelta() const;
 
     /**
      * @brief      Set the position of the mouse
@@ -130,7 +224,14 @@ namespace elgar {
      *
      * @return     The position.
      */
-    glm::vec2 GetPosition();
+    glm::vec2 GetPosition() const;
+
+    /**
+     * @brief      Get how far the mouse moved since last frame
+     *
+     * @return     The motion.
+     */
+    glm::vec2 GetMotion() const;
   };
 
 }
@@ -0,0 +1,121 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_INIT_GRAPH_HPP_
+#define _ELGAR_INIT_GRAPH_HPP_
+
+// INCLUDES //
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace elgar {
+
+  /**
+   * @brief The InitAffinity enum lists where an init step may run
+   *
+   */
+  enum InitAffinity {
+    INIT_ANY_THREAD,    // CPU side work that may run on the JobSystem alongside other steps
+    INIT_MAIN_THREAD    // Work that needs the calling thread (e.g. its OpenGL context)
+  };
+
+  /**
+   * @brief An InitGraph runs a set of init steps in dependency order. Steps that may run on any
+   *        thread are handed to the JobSystem as soon as their dependencies are done, while steps
+   *        bound to the main thread run on the thread that called Run, in the order they were
+   *        added. The time every step took is kept for a startup breakdown.
+   *
+   */
+  class InitGraph {
+  private:
+    /**
+     * @brief An InitStep is a single node of the graph
+     *
+     */
+    struct InitStep {
+      std::string           name;           // Name of the step (used by dependencies and the log)
+      std::function<void()> init;           // The work of the step
+      InitAffinity          affinity;       // Where the step may run
+      std::vector<size_t>   dependents;     // Steps waiting on this one
+      size_t                waiting;        // Dependencies of the step that are not done yet
+      uint64_t              start;          // Clock reading the step started at
+      uint64_t              end;            // Clock reading the step finished at
+      bool                  worker;         // Did the step run off the main thread?
+    };
+
+  private:
+    std::vector<InitStep> m_steps;    // The steps in the order they were added
+    std::vector<std::vector<std::string>> m_dependencies;  // Names each step depends on
+
+    std::mutex              m_lock;       // Guards the finished list
+    std::condition_variable m_finished_signal;  // Signalled whenever a worker finishes a step
+    std::vector<size_t>     m_finished;   // Steps finished by workers but not processed yet
+    std::exception_ptr      m_error;      // The first exception thrown by a step
+
+    uint64_t m_start;   // Clock reading Run started at
+    uint64_t m_end;     // Clock reading Run finished at
+
+  private:
+    /**
+     * @brief Run a step, recording its timing and any exception it throws
+     *
+     * @param index The step
+     */
+    void RunStep(const size_t &index);
+
+  public:
+    /**
+     * @brief Construct a new InitGraph object
+     *
+     */
+    InitGraph();
+
+    /**
+     * @brief Destroy the InitGraph object
+     *
+     */
+    virtual ~InitGraph();
+
+    /**
+     * @brief Add a step to the graph
+     *
+     * @param name          Unique name of the step
+     * @param init          The work of the step
+     * @param affinity      Where the step may run
+     * @param dependencies  Names of the steps that must finish first (added before or after this one)
+     */
+    void Add(
+      const std::string &name,
+      const std::function<void()> &init,
+      const InitAffinity &affinity,
+      const std::vector<std::string> &dependencies = {}
+    );
+
+    /**
+     * @brief Run every step and return once they have all finished. An exception is thrown for
+     *        unknown dependencies or cycles; if a step throws, no further steps are started and the
+     *        exception is rethrown once the running ones are done.
+     *
+     */
+    void Run();
+
+    /**
+     * @brief Log how long every step took, when it started and how much the steps overlapped
+     *
+     */
+    void LogTimings() const;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,197 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_INPUT_RECORDING_HPP_
+#define _ELGAR_INPUT_RECORDING_HPP_
+
+// INCLUDES //
+
+#include <SDL2/SDL.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// DEFINES //
+
+#define INPUT_RECORDING_MAGIC     0x524C4745    // "ELGR" read as a little endian integer
+#define INPUT_RECORDING_VERSION   1             // Bumped whenever the format changes
+
+namespace elgar {
+
+  /**
+   * @brief The InputRecordType enum lists the records of an input recording
+   *
+   */
+  enum InputRecordType {
+    INPUT_RECORD_QUIT = 0,
+    INPUT_RECORD_KEY_DOWN = 1,
+    INPUT_RECORD_KEY_UP = 2,
+    INPUT_RECORD_BUTTON_DOWN = 3,
+    INPUT_RECORD_BUTTON_UP = 4,
+    INPUT_RECORD_MOTION = 5,
+    INPUT_RECORD_WHEEL = 6
+  };
+
+  /**
+   * @brief The InputRecorder writes the SDL events the engine consumes and the clock ticks of every
+   *        frame to a compact binary file. Each frame is stored as its tick delta and event count
+   *        followed by the events, all as variable length integers.
+   *
+   */
+  class InputRecorder {
+  private:
+    FILE *m_file;   // The file being written
+    std::vector<unsigned char> m_buffer;  // Bytes waiting to be written
+    std::vector<unsigned char> m_frame;   // Events of the frame being recorded
+
+    uint32_t m_event_count;   // Events in the frame being recorded
+    uint64_t m_frame_count;   // Frames recorded so far
+
+  private:
+    /**
+     * @brief Write the buffered bytes to the file
+     *
+     */
+    void FlushBuffer();
+
+  public:
+    /**
+     * @brief Construct a new InputRecorder object
+     *
+     * @param path            The file to record to (an exception is thrown if it cannot be opened)
+     * @param frequency       Clock ticks per second of the recorded ticks
+     * @param steps_per_second  Physics steps per second of the recorded run
+     */
+    InputRecorder(const std::string &path, const uint64_t &frequency, const uint64_t &steps_per_second);
+
+    /**
+     * @brief Destroy the InputRecorder object, closing the file
+     *
+     */
+    virtual ~InputRecorder();
+
+    /**
+     * @brief Record an event into the current frame (events the engine does not use are skipped)
+     *
+     * @param event The event
+     */
+    void RecordEvent(const SDL_Event &event);
+
+    /**
+     * @brief Close off the current frame
+     *
+     * @param ticks The clock ticks that passed during the frame
+     */
+    void EndFrame(const uint64_t &ticks);
+
+    /**
+     * @brief Get the number of frames recorded so far
+     *
+     * @return The frame count
+     */
+    const uint64_t &GetFrameCount() const;
+
+  };
+
+  /**
+   * @brief The InputPlayer reads back a file written by the InputRecorder one frame at a time
+   *
+   */
+  class InputPlayer {
+  private:
+    std::vector<unsigned char> m_data;  // The whole recording
+    size_t m_cursor;                    // Read position in the recording
+
+    uint64_t m_frequency;         // Clock ticks per second of the recording
+    uint64_t m_steps_per_second;  // Physics steps per second of the recording
+
+    uint32_t m_events_left;   // Events of the current frame not read yet
+    uint64_t m_frame_count;   // Frames read so far
+
+    std::vector<uint64_t> m_frame_times;  // Wall clock ticks each replayed frame took
+
+  private:
+    /**
+     * @brief Read a variable length integer
+     *
+     * @param value   Set to the value read
+     * @return True if a value was read, false at the end of the data
+     */
+    bool ReadVarint(uint64_t &value);
+
+  public:
+    /**
+     * @brief Construct a new InputPlayer object
+     *
+     * @param path  The recording to play (an exception is thrown if it cannot be read)
+     */
+    InputPlayer(const std::string &path);
+
+    /**
+     * @brief Destroy the InputPlayer object
+     *
+     */
+    virtual ~InputPlayer();
+
+    /**
+     * @brief Start the next frame
+     *
+     * @param ticks Set to the clock ticks that passed during the frame
+     * @return True if a frame was read, false once the recording is over
+     */
+    bool BeginFrame(uint64_t &ticks);
+
+    /**
+     * @brief Read the next event of the current frame
+     *
+     * @param event Filled with the event
+     * @return True if an event was read, false once the frame has no events left
+     */
+    bool NextEvent(SDL_Event &event);
+
+    /**
+     * @brief Keep the wall clock time a replayed frame took
+     *
+     * @param ticks The frame time in performance counter ticks
+     */
+    void AddFrameTime(const uint64_t &ticks);
+
+    /**
+     * @brief Log the distribution of the replayed frame times and optionally write them to a file
+     *
+     * @param frequency Performance counter ticks per second
+     * @param path      File to write one millisecond value per line to (empty to skip)
+     */
+    void ReportFrameTimes(const uint64_t &frequency, const std::string &path) const;
+
+    /**
+     * @brief Get the clock frequency of the recording
+     *
+     * @return Clock ticks per second
+     */
+    const uint64_t &GetFrequency() const;
+
+    /**
+     * @brief Get the physics step rate of the recording
+     *
+     * @return Physics steps per second
+     */
+    const uint64_t &GetStepsPerSecond() const;
+
+    /**
+     * @brief Get the number of frames played so far
+     *
+     * @return The frame count
+     */
+    const uint64_t &GetFrameCount() const;
+
+  };
+
+}
+
+#endif
@@ -9,31 +9,40 @@
 
 // INCLUDES //
 
+#include <atomic>
 #include <cstdlib>
 
 namespace elgar {
 
   /**
    * @brief      An InstanceCounter tracks the number of instantiated objects of a type in memory
+   *             (safe to construct and destroy from any thread)
    */
   template <typename T>
   class InstanceCounter {
   private:
-    static size_t m_count;  // Number of objects in memory
+    static std::atomic<size_t> m_count;  // Number of objects in memory
 
   public:
     /**
      * @brief      Constructs an InstanceCounter
      */
     InstanceCounter() {
-      m_count++;
+      m_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief      Constructs an InstanceCounter for a copy of an object
+     */
+    InstanceCounter(const InstanceCounter &) {
+      m_count.fetch_add(1, std::memory_order_relaxed);
     }
 
     /**
      * @brief      Destroys an InstanceCounter
      */
     virtual ~InstanceCounter() {
-      --m_count;
+      m_count.fetch_sub(1, std::memory_order_relaxed);
     }
 
     /**
@@ -42,12 +51,12 @@ namespace elgar {
      * @return     The number of objects instantiated
      */
     static size_t GetCount() {
-      return m_count;
+      return m_count.load(std::memory_order_relaxed);
     }
   };
 
   // Initialize static field
-  template <typename T> size_t InstanceCounter<T>::m_count(0);
+  template <typename T> std::atomic<size_t> InstanceCounter<T>::m_count(0);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,183 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_JOB_SYSTEM_HPP_
+#define _ELGAR_JOB_SYSTEM_HPP_
+
+// INCLUDES //
+
+#include "elgar/core/Singleton.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace elgar {
+
+  typedef std::function<void()> Job;    // A unit of work for the JobSystem
+
+  /**
+   * @brief A JobCounter tracks a set of scheduled jobs. It reaches zero once every job scheduled
+   *        against it has finished, at which point any jobs that depend on it are released.
+   *
+   */
+  class JobCounter {
+  friend class JobSystem;
+  private:
+    std::atomic<int>  m_pending;    // Number of jobs that have not finished yet
+    std::mutex        m_lock;       // Guards the continuations against the counter reaching zero
+    std::vector<std::pair<Job, JobCounter *>> m_continuations;   // Jobs waiting on this counter
+
+  public:
+    /**
+     * @brief Construct a new JobCounter object
+     *
+     */
+    JobCounter();
+
+    /**
+     * @brief Destroy the JobCounter object
+     *
+     */
+    virtual ~JobCounter();
+
+    /**
+     * @brief Checks if every job scheduled against the counter has finished
+     *
+     * @return True if no jobs are pending, false otherwise
+     */
+    bool IsDone() const;
+
+  };
+
+  /**
+   * @brief The JobSystem class runs jobs on a pool of worker threads. Every thread owns a deque of
+   *        jobs it pops from the back of, and idle threads steal from the front of the others'.
+   *        (Is a Singleton class)
+   *
+   */
+  class JobSystem : public Singleton<JobSystem> {
+  friend class Engine;
+  friend class InitGraph;   // Allow the init graph to help run jobs while it waits
+  private:
+    /**
+     * @brief A JobQueue is the deque of jobs owned by a single thread
+     *
+     */
+    struct JobQueue {
+      std::mutex lock;    // Guards the deque
+      std::deque<std::pair<Job, JobCounter *>> jobs;    // Scheduled jobs and their counters
+    };
+
+  private:
+    std::vector<std::unique_ptr<JobQueue>>  m_queues;   // One queue per thread (0 is the main thread)
+    std::vector<std::thread>                m_workers;  // The worker threads
+
+    std::atomic<bool>       m_running;    // Should the workers keep running?
+    std::atomic<int>        m_queued;     // Number of jobs sitting in the queues
+    std::mutex              m_sleep_lock; // Lock for idle workers to sleep on
+    std::condition_variable m_wake;       // Signalled whenever a job is queued
+
+  private:
+    /**
+     * @brief Construct a new JobSystem object
+     *
+     * @param worker_count  Number of worker threads to spawn (0 uses one per core besides the main thread)
+     */
+    JobSystem(const unsigned int &worker_count = 0);
+
+    /**
+     * @brief Destroy the JobSystem object, joining every worker
+     *
+     */
+    virtual ~JobSystem();
+
+    /**
+     * @brief The main loop of a worker thread
+     *
+     * @param index The index of the worker's queue
+     */
+    void WorkerLoop(const unsigned int &index);
+
+    /**
+     * @brief Get the queue index of the calling thread
+     *
+     * @return The queue index (threads outside the pool share the main thread's queue)
+     */
+    unsigned int GetQueueIndex() const;
+
+    /**
+     * @brief Push a job onto the calling thread's queue and wake a worker
+     *
+     * @param job     The job to push
+     * @param counter The counter to release once the job finishes (may be nullptr)
+     */
+    void Push(const Job &job, JobCounter *counter);
+
+    /**
+     * @brief Run a single job, taking it from the given queue first and stealing from the others
+     *        if it is empty
+     *
+     * @param index The queue of the calling thread
+     * @return True if a job was run, false if every queue was empty
+     */
+    bool RunJob(const unsigned int &index);
+
+    /**
+     * @brief Mark a job of a counter as finished, releasing its continuations if it was the last one
+     *
+     * @param counter The counter of the finished job
+     */
+    void Release(JobCounter *counter);
+
+  public:
+    /**
+     * @brief Schedule a job to run on the pool
+     *
+     * @param job         The job to run
+     * @param counter     Counter to increment now and decrement once the job finishes (optional)
+     * @param dependency  Counter that must reach zero before the job may start (optional)
+     */
+    void Schedule(const Job &job, JobCounter *counter = nullptr, JobCounter *dependency = nullptr);
+
+    /**
+     * @brief Block until a counter reaches zero. The calling thread runs jobs while it waits.
+     *
+     * @param counter The counter to wait on
+     */
+    void Wait(JobCounter &counter);
+
+    /**
+     * @brief Split the range [0, count) into chunks and run them across the pool, returning once
+     *        every chunk has finished
+     *
+     * @param count The number of items
+     * @param grain The number of items per chunk
+     * @param func  Function called with the [begin, end) range of each chunk
+     */
+    void ParallelFor(
+      const size_t &count,
+      const size_t &grain,
+      const std::function<void(size_t, size_t)> &func
+    );
+
+    /**
+     * @brief Get the number of threads that run jobs (the workers plus the main thread)
+     *
+     * @return The thread count
+     */
+    unsigned int GetThreadCount() const;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,337 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_LOGGER_HPP_
+#define _ELGAR_LOGGER_HPP_
+
+// INCLUDES //
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+// DEFINES //
+
+#define LOGGER_SLOT_COUNT     4096    // Messages the ring can hold (must be a power of two)
+#define LOGGER_PAYLOAD_SIZE   240     // Bytes of arguments (or formatted text) kept per message
+
+namespace elgar {
+
+  /**
+   * @brief The LogLevel enum lists the severities of a log message
+   *
+   */
+  enum LogLevel {
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_INFO = 1,
+    LOG_LEVEL_WARNING = 2,
+    LOG_LEVEL_ERROR = 3
+  };
+
+  typedef void (*LogSink)(const LogLevel &level, const uint64_t &time, const unsigned int &thread, const char *message);
+
+  /**
+   * @brief The Logger class hands log messages from any thread to a background thread that formats
+   *        and writes them. Messages go through a bounded lock-free ring; in deferred mode only the
+   *        format string and a binary copy of the arguments are captured on the calling thread and
+   *        the printf style formatting happens on the background thread. The Logger lives for the
+   *        whole program, so it can be used before and after the Engine exists.
+   *
+   */
+  class Logger {
+  private:
+    /**
+     * @brief A LogSlot holds a single message in the ring
+     *
+     */
+    struct LogSlot {
+      std::atomic<size_t> sequence;   // Ring position the slot is ready for (see Write and Drain)
+      LogLevel      level;      // Severity of the message
+      bool          deferred;   // Does data hold arguments (true) or formatted text (false)?
+      unsigned int  thread;     // Index of the thread that wrote the message
+      uint64_t      time;       // Nanoseconds since the logger started
+      const char    *format;    // The format string (must be a string literal)
+      uint16_t      size;       // Bytes used in data
+      char          data[LOGGER_PAYLOAD_SIZE];  // Captured arguments or formatted text
+    };
+
+    /**
+     * @brief The tags written in front of each captured argument
+     *
+     */
+    enum LogArgument : char {
+      LOG_ARGUMENT_SIGNED = 'i',
+      LOG_ARGUMENT_UNSIGNED = 'u',
+      LOG_ARGUMENT_FLOAT = 'f',
+      LOG_ARGUMENT_STRING = 's',
+      LOG_ARGUMENT_POINTER = 'p'
+    };
+
+  private:
+    LogSlot *m_slots;   // The ring of messages
+
+    alignas(64) std::atomic<size_t> m_enqueue;    // Next position a producer will claim
+    alignas(64) std::atomic<size_t> m_dequeue;    // Next position the flush thread will read
+    std::atomic<size_t> m_dropped;                // Messages lost because the ring was full
+
+    std::atomic<int>      m_level;      // Messages below this level are ignored at runtime
+    std::atomic<bool>     m_deferred;   // Capture arguments instead of formatting on the caller
+    std::atomic<LogSink>  m_sink;       // Where formatted messages are written
+
+    std::atomic<bool>       m_running;    // Should the flush thread keep running?
+    std::mutex              m_lock;       // Lock for the flush thread and Flush callers to sleep on
+    std::condition_variable m_wake;       // Wakes the flush thread early
+    std::condition_variable m_drained;    // Signalled whenever the flush thread empties the ring
+    std::thread             m_thread;     // The flush thread
+
+    uint64_t m_epoch;   // Clock reading the logger started at
+
+  private:
+    /**
+     * @brief Construct a new Logger object and start the flush thread
+     *
+     */
+    Logger();
+
+    /**
+     * @brief Destroy the Logger object, writing out everything still queued
+     *
+     */
+    ~Logger();
+
+    /**
+     * @brief Write out everything still queued and stop the flush thread (runs when the program exits)
+     *
+     */
+    void Shutdown();
+
+    /**
+     * @brief The main loop of the flush thread
+     *
+     */
+    void FlushLoop();
+
+    /**
+     * @brief Write out every message that is ready
+     *
+     * @return The number of messages written
+     */
+    size_t Drain();
+
+    /**
+     * @brief Format and write a single message
+     *
+     * @param slot    The message
+     * @param buffer  Scratch string the message is formatted into
+     */
+    void Emit(const LogSlot &slot, std::string &buffer) const;
+
+    /**
+     * @brief Claim a slot in the ring. If the ring is full, warnings and errors wait for room while
+     *        anything less severe is dropped (returns nullptr and counts the drop).
+     *
+     * @param level     The level of the message
+     * @param position  Set to the position of the claimed slot
+     * @return The claimed slot
+     */
+    LogSlot *Claim(const LogLevel &level, size_t &position);
+
+    /**
+     * @brief Hand a filled slot to the flush thread
+     *
+     * @param slot      The slot
+     * @param position  The position it was claimed at
+     */
+    void Publish(LogSlot *slot, const size_t &position);
+
+    /**
+     * @brief Get the current time of the logger
+     *
+     * @return Nanoseconds since the logger started
+     */
+    uint64_t Now() const;
+
+    /**
+     * @brief Get the index of the calling thread
+     *
+     * @return The thread index
+     */
+    static unsigned int GetThreadIndex();
+
+    /**
+     * @brief Write a tagged fixed size value into a payload
+     *
+     * @return False if the payload is full
+     */
+    static bool Capture(char *data, uint16_t &size, const char &tag, const void *value, const size_t &bytes);
+
+    /**
+     * @brief Write a string into a payload (truncated to whatever room is left)
+     *
+     * @return False if the payload is full
+     */
+    static bool CaptureString(char *data, uint16_t &size, const char *str);
+
+    // Overloads picking the tag of each argument type
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, bool>::type
+    CaptureArgument(char *data, uint16_t &size, const T &arg) {
+      const int64_t value = arg;
+      return Capture(data, size, LOG_ARGUMENT_SIGNED, &value, sizeof(value));
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, bool>::type
+    CaptureArgument(char *data, uint16_t &size, const T &arg) {
+      const uint64_t value = arg;
+      return Capture(data, size, LOG_ARGUMENT_UNSIGNED, &value, sizeof(value));
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_enum<T>::value, bool>::type
+    CaptureArgument(char *data, uint16_t &size, const T &arg) {
+      const int64_t value = (int64_t)arg;
+      return Capture(data, size, LOG_ARGUMENT_SIGNED, &value, sizeof(value));
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+    CaptureArgument(char *data, uint16_t &size, const T &arg) {
+      const double value = arg;
+      return Capture(data, size, LOG_ARGUMENT_FLOAT, &value, sizeof(value));
+    }
+
+    template<typename T>
+    static typename std::enable_if<std::is_pointer<T>::value, bool>::type
+    CaptureArgument(char *data, uint16_t &size, const T &arg) {
+      typedef typename std::remove_cv<typename std::remove_pointer<T>::type>::type Pointee;
+
+      // Character pointers are copied, since they rarely outlive the call (c_str() of a temporary)
+      if (std::is_same<Pointee, char>::value || std::is_same<Pointee, unsigned char>::value)
+        return CaptureString(data, size, (const char *)arg);
+
+      const void *value = (const void *)arg;
+      return Capture(data, size, LOG_ARGUMENT_POINTER, &value, sizeof(value));
+    }
+
+    template<size_t N>
+    static bool CaptureArgument(char *data, uint16_t &size, const char (&arg)[N]) {
+      return CaptureString(data, size, arg);
+    }
+
+    static bool CaptureArguments(char *, uint16_t &) {
+      return true;
+    }
+
+    template<typename T, typename... Args>
+    static bool CaptureArguments(char *data, uint16_t &size, const T &arg, const Args &... args) {
+      return CaptureArgument(data, size, arg) && CaptureArguments(data, size, args...);
+    }
+
+    static int FormatArguments(char *, const char *) {
+      return 0;   // Messages without arguments are always deferred
+    }
+
+    template<typename T, typename... Args>
+    static int FormatArguments(char *data, const char *format, const T &arg, const Args &... args) {
+      return snprintf(data, LOGGER_PAYLOAD_SIZE, format, arg, args...);
+    }
+
+  public:
+    Logger(const Logger &) = delete;
+    Logger &operator =(const Logger &) = delete;
+
+    /**
+     * @brief Get the Logger, starting it on first use
+     *
+     * @return The Logger
+     */
+    static Logger &Get();
+
+    /**
+     * @brief Queue a printf style message
+     *
+     * @param level   The severity of the message
+     * @param format  The format string (must be a string literal, it is read after the call returns)
+     * @param args    The arguments of the format string
+     */
+    template<typename... Args>
+    void Write(const LogLevel &level, const char *format, const Args &... args) {
+      if ((int)level < m_level.load(std::memory_order_relaxed))
+        return;
+
+      size_t position;
+      LogSlot *slot = Claim(level, position);
+
+      if (!slot)
+        return;
+
+      slot->level = level;
+      slot->thread = GetThreadIndex();
+      slot->time = Now();
+      slot->format = format;
+      slot->size = 0;
+      slot->deferred = sizeof...(Args) == 0 || m_deferred.load(std::memory_order_relaxed);
+
+      if (slot->deferred) {
+        CaptureArguments(slot->data, slot->size, args...);
+      }
+      else {
+        // Format on the calling thread, the flush thread only writes the text
+        const int length = FormatArguments(slot->data, format, args...);
+        slot->size = length < 0 ? 0 : (length < LOGGER_PAYLOAD_SIZE ? length : LOGGER_PAYLOAD_SIZE - 1);
+      }
+
+      Publish(slot, position);
+    }
+
+    /**
+     * @brief Block until every message queued before the call has been written
+     *
+     */
+    void Flush();
+
+    /**
+     * @brief Set the lowest level written at runtime (levels below ELGAR_LOG_LEVEL are compiled out)
+     *
+     * @param level The lowest level to write
+     */
+    void SetLevel(const LogLevel &level);
+
+    /**
+     * @brief Set whether arguments are captured and formatted on the flush thread (the default) or
+     *        formatted on the calling thread
+     *
+     * @param deferred True to defer formatting
+     */
+    void SetDeferred(const bool &deferred);
+
+    /**
+     * @brief Set where formatted messages are written (defaults to stdout)
+     *
+     * @param sink  The sink (nullptr restores the default)
+     */
+    void SetSink(LogSink sink);
+
+    /**
+     * @brief Get the number of messages lost because the ring was full
+     *
+     * @return The number of dropped messages
+     */
+    size_t GetDroppedCount() const;
+
+  };
+
+}
+
+#endif
@@ -11,12 +11,60 @@
 
 #include <cstdio>
 
+#include "elgar/core/Logger.hpp"
+
 // DEFINES //
 
+// Lowest level compiled in (0 = debug, 1 = info, 2 = warning, 3 = error)
+#ifndef ELGAR_LOG_LEVEL
+#ifndef _RELEASE
+#define ELGAR_LOG_LEVEL 0
+#else
+#define ELGAR_LOG_LEVEL 2
+#endif
+#endif
+
+// The dead printf keeps the compiler checking the format string against the arguments
+#define ELGAR_LOG(level, x, ...) \
+  do { \
+    if (false) printf(x, ##__VA_ARGS__); \
+    elgar::Logger::Get().Write(level, x, ##__VA_ARGS__); \
+  } while (0)
+
+#if ELGAR_LOG_LEVEL <= 0
+#define LOG_DEBUG(x, ...) ELGAR_LOG(elgar::LOG_LEVEL_DEBUG, x, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(x, ...)
+#endif
+
+#if ELGAR_LOG_LEVEL <= 1
+#define LOG_INFO(x, ...) ELGAR_LOG(elgar::LOG_LEVEL_INFO, x, ##__VA_ARGS__)
+#else
+#define LOG_INFO(x, ...)
+#endif
+
+#if ELGAR_LOG_LEVEL <= 2
+#define LOG_WARNING(x, ...) ELGAR_LOG(elgar::LOG_LEVEL_WARNING, x, ##__VA_ARGS__)
+#else
+#define LOG_WARNING(x, ...)
+#endif
+
+#if ELGAR_LOG_LEVEL <= 3
+#define LOG_ERROR(x, ...) ELGAR_LOG(elgar::LOG_LEVEL_ERROR, x, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(x, ...)
+#endif
+
+#define LOG(x, ...) LOG_INFO(x, ##__VA_ARGS__)
+
+#define ELGAR_CONCAT_IMPL(a, b) a##b
+#define ELGAR_CONCAT(a, b) ELGAR_CONCAT_IMPL(a, b)
+
 #ifndef _RELEASE
-#define LOG(x, ...) printf(x, ##__VA_ARGS__)
+#include "elgar/core/Profiler.hpp"
+#define PROFILE_ZONE(name) elgar::ProfileZone ELGAR_CONCAT(_profile_zone_, __LINE__)(name)
 #else
-#define LOG(x, ...)
+#define PROFILE_ZONE(name)
 #endif
 
 #endif
\ No newline at end of file
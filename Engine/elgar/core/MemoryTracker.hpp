@@ -0,0 +1,162 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_MEMORY_TRACKER_HPP_
+#define _ELGAR_MEMORY_TRACKER_HPP_
+
+// INCLUDES //
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace elgar {
+
+  /**
+   * @brief The MemoryCategory enum lists the kinds of memory the MemoryTracker accounts for
+   *
+   */
+  enum MemoryCategory {
+    MEMORY_IMAGES,      // Decoded pixels held by the ImageLoader (host)
+    MEMORY_MESHES,      // Vertex, index and texture arrays held by Meshes (host)
+    MEMORY_TEXTURES,    // Texture storage including mipmaps (device)
+    MEMORY_BUFFERS,     // OpenGL buffer object storage (device)
+    MEMORY_AUDIO,       // OpenAL buffer storage (device)
+    MEMORY_CATEGORY_COUNT
+  };
+
+  /**
+   * @brief The MemoryDomain enum lists where the memory of a category lives
+   *
+   */
+  enum MemoryDomain {
+    MEMORY_HOST,    // Memory allocated by the engine itself
+    MEMORY_DEVICE   // Memory owned by the OpenGL or OpenAL driver (video or audio device memory)
+  };
+
+  /**
+   * @brief A MemorySnapshot is a copy of the accounting of every category at one point in time
+   *
+   */
+  struct MemorySnapshot {
+    size_t  bytes[MEMORY_CATEGORY_COUNT];         // Bytes currently held
+    size_t  peak_bytes[MEMORY_CATEGORY_COUNT];    // Most bytes held at once
+    size_t  allocations[MEMORY_CATEGORY_COUNT];   // Allocations currently held
+    size_t  budgets[MEMORY_CATEGORY_COUNT];       // Budget in bytes (0 if there is none)
+    size_t  host_bytes;     // Bytes held across every host category
+    size_t  device_bytes;   // Bytes held across every device category
+  };
+
+  /**
+   * @brief The MemoryTracker class accounts for the bytes held by the engine's resources, per
+   *        category. Resources report what they allocate and release from any thread, and a
+   *        warning is logged whenever a category goes over its budget. The MemoryTracker lives
+   *        for the whole program, so resources may come and go before and after the Engine does.
+   *
+   */
+  class MemoryTracker {
+  private:
+    /**
+     * @brief A MemoryCounter holds the accounting of a single category
+     *
+     */
+    struct MemoryCounter {
+      std::atomic<size_t> bytes;        // Bytes currently held
+      std::atomic<size_t> peak_bytes;   // Most bytes held at once
+      std::atomic<size_t> allocations;  // Allocations currently held
+      std::atomic<size_t> budget;       // Budget in bytes (0 if there is none)
+    };
+
+  private:
+    MemoryCounter m_counters[MEMORY_CATEGORY_COUNT];  // The accounting of every category
+
+  private:
+    /**
+     * @brief Construct a new MemoryTracker object
+     *
+     */
+    MemoryTracker();
+
+    /**
+     * @brief Destroy the MemoryTracker object
+     *
+     */
+    virtual ~MemoryTracker();
+
+  public:
+    /**
+     * @brief Get the MemoryTracker (created on first use, never destroyed)
+     *
+     * @return The MemoryTracker
+     */
+    static MemoryTracker &Get();
+
+    /**
+     * @brief Get the name of a category
+     *
+     * @param category  The category
+     * @return The name
+     */
+    static const char *GetCategoryName(const MemoryCategory &category);
+
+    /**
+     * @brief Get the domain a category lives in
+     *
+     * @param category  The category
+     * @return The domain
+     */
+    static MemoryDomain GetCategoryDomain(const MemoryCategory &category);
+
+    /**
+     * @brief Account for an allocation
+     *
+     * @param category  The category of the allocation
+     * @param bytes     The size of the allocation
+     */
+    void Allocate(const MemoryCategory &category, const size_t &bytes);
+
+    /**
+     * @brief Account for a release (must match an earlier Allocate)
+     *
+     * @param category  The category of the allocation
+     * @param bytes     The size of the allocation
+     */
+    void Release(const MemoryCategory &category, const size_t &bytes);
+
+    /**
+     * @brief Set the budget of a category. A warning is logged every time the category goes over it.
+     *
+     * @param category  The category
+     * @param bytes     The budget (0 removes it)
+     */
+    void SetBudget(const MemoryCategory &category, const size_t &bytes);
+
+    /**
+     * @brief Get the bytes currently held by a category
+     *
+     * @param category  The category
+     * @return Bytes
+     */
+    size_t GetBytes(const MemoryCategory &category) const;
+
+    /**
+     * @brief Copy the accounting of every category
+     *
+     * @return The snapshot
+     */
+    MemorySnapshot GetSnapshot() const;
+
+    /**
+     * @brief Log the accounting of every category
+     *
+     */
+    void LogSnapshot() const;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,157 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_PROFILER_HPP_
+#define _ELGAR_PROFILER_HPP_
+
+// INCLUDES //
+
+#include "elgar/core/Singleton.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// DEFINES //
+
+#define PROFILER_THREAD_CAPACITY    65536   // Zones kept per thread (must be a power of two)
+
+namespace elgar {
+
+  /**
+   * @brief A ProfileEvent is a single completed zone
+   *
+   */
+  struct ProfileEvent {
+    const char  *name;    // The name of the zone (must be a string literal)
+    uint64_t    start;    // Start time in nanoseconds since the profiler started
+    uint64_t    end;      // End time in nanoseconds since the profiler started
+    uint32_t    depth;    // Nesting depth of the zone on its thread
+  };
+
+  /**
+   * @brief A ProfileBuffer is the ring of events recorded by a single thread. Only the owning
+   *        thread writes to it, so recording never takes a lock.
+   *
+   */
+  struct ProfileBuffer {
+    std::vector<ProfileEvent> events;   // The ring of events
+    std::atomic<uint64_t>     head;     // Total number of events ever written
+    uint32_t                  thread;   // Index of the owning thread in the capture
+    uint32_t                  depth;    // Current nesting depth of the owning thread
+  };
+
+  /**
+   * @brief The Profiler class collects scoped CPU zones from every thread into per-thread ring
+   *        buffers and exports them as Chrome trace JSON (chrome://tracing). Zones are recorded
+   *        through the PROFILE_ZONE macro. (Is a Singleton class)
+   *
+   */
+  class Profiler : public Singleton<Profiler> {
+  friend class Engine;
+  friend class ProfileZone;
+  private:
+    std::vector<std::unique_ptr<ProfileBuffer>> m_buffers;   // The buffer of every thread seen so far
+    mutable std::mutex  m_lock;     // Guards the buffer list (only taken when a thread first records)
+
+    std::atomic<bool>   m_enabled;      // Is the profiler recording?
+    uint32_t            m_generation;   // Distinguishes this profiler from previous instances
+    uint64_t            m_epoch;        // Clock reading the profiler started at
+
+  private:
+    /**
+     * @brief Construct a new Profiler object
+     *
+     */
+    Profiler();
+
+    /**
+     * @brief Destroy the Profiler object
+     *
+     */
+    virtual ~Profiler();
+
+    /**
+     * @brief Read the clock
+     *
+     * @return The time in nanoseconds since the profiler started
+     */
+    uint64_t Now() const;
+
+    /**
+     * @brief Get the buffer of the calling thread, creating it the first time the thread records
+     *
+     * @return The buffer of the calling thread
+     */
+    ProfileBuffer *GetThreadBuffer();
+
+  public:
+    /**
+     * @brief Set whether zones are recorded
+     *
+     * @param enabled True to record, false to ignore zones
+     */
+    void SetEnabled(const bool &enabled);
+
+    /**
+     * @brief Checks if zones are being recorded
+     *
+     * @return True if recording, false otherwise
+     */
+    bool IsEnabled() const;
+
+    /**
+     * @brief Drop every recorded zone (call while no other thread is recording)
+     *
+     */
+    void Clear();
+
+    /**
+     * @brief Write the zones currently held by every thread to a Chrome trace JSON file
+     *
+     * @param path      The path of the file to write
+     * @return true     If the trace was written
+     * @return false    If the file could not be opened
+     */
+    bool WriteChromeTrace(const std::string &path) const;
+
+  };
+
+  /**
+   * @brief A ProfileZone records the time between its construction and destruction as a zone
+   *        (use the PROFILE_ZONE macro rather than this class directly)
+   *
+   */
+  class ProfileZone {
+  private:
+    ProfileBuffer *m_buffer;  // The buffer to record into (nullptr if not recording)
+    const char    *m_name;    // The name of the zone
+    uint64_t      m_start;    // The start time of the zone
+
+  public:
+    /**
+     * @brief Open a zone
+     *
+     * @param name The name of the zone (must be a string literal)
+     */
+    ProfileZone(const char *name);
+
+    /**
+     * @brief Close the zone and record it
+     *
+     */
+    ~ProfileZone();
+
+    ProfileZone(const ProfileZone &) = delete;
+    ProfileZone &operator =(const ProfileZone &) = delete;
+  };
+
+}
+
+#endif
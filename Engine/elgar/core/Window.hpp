@@ -9,7 +9,9 @@
 
 // INCLUDES //
 
+#include <GL/glew.h>
 #include <SDL2/SDL.h>
+#include <functional>
 #include <string>
 #include <glm/glm.hpp>
 
@@ -19,6 +21,7 @@
 
 #define DEFAULT_GL_MAJOR_VERSION        4   // Use OpenGL 4.x
 #define DEFAULT_GL_MINOR_VERSION        3   // Use OpenGL x.3
+#define DEFAULT_VSYNC_MODE              VSYNC_ON  // Vertical sync mode a new Window starts with
 
 namespace elgar {
 
@@ -32,24 +35,46 @@ namespace elgar {
     BORDERLESS = 0x04,  // The window is borderless
     MINIMIZED = 0x08,   // The windows starts out minimized
     MAXIMIZED = 0x10,   // The window starts out maximized
-    RESIZABLE = 0x20    // The window can be scaled
+    RESIZABLE = 0x20,   // The window can be scaled
+    HEADLESS = 0x40,    // No window and no OpenGL (simulation only)
+    OFFSCREEN = 0x80    // No window, render into an offscreen frame buffer through EGL
   };
 
+  /**
+   * @brief      The VSyncMode enum lists how buffer swaps are synchronized with the display
+   */
+  enum VSyncMode {
+    VSYNC_OFF,        // Swap immediately (may tear)
+    VSYNC_ON,         // Wait for the vertical blank on every swap
+    VSYNC_ADAPTIVE    // Wait for the vertical blank unless the frame is late, then swap immediately
+  };
+
+  class FrameBufferObject;
+
   /**
    * @brief      The Window class handles construction, destruction, and
    *             management of SDL2 windows. (Is a Singleton class)
    */
   class Window : public Singleton<Window> {
   friend class Engine;  // Grant engine rights to private members
+  friend class RenderThread;  // Allow the render thread to take the OpenGL context and present
   private:
     SDL_Window *m_window; // Handle to the SDL2 window context
     SDL_GLContext m_context;  // Handle to the OpenGL context
 
+    void *m_egl_display;    // Handle to the EGL display (offscreen only)
+    void *m_egl_context;    // Handle to the EGL context (offscreen only)
+
+    FrameBufferObject *m_framebuffer;   // The frame buffer rendered into (offscreen only)
+    GLuint m_renderbuffers[2];          // Color and depth/stencil storage of the frame buffer
+
     glm::vec2 m_dimensions; // The dimensions of the window
 
+    VSyncMode m_vsync_mode; // The vertical sync mode in effect
+
   private:
     /**
-     * @brief      Constructs a new Window
+     * @brief      Constructs a new Window (or an offscreen render target if OFFSCREEN is set)
      *
      * @param[in]  name    The name of the window
      * @param[in]  width   The width (in pixels)
@@ -69,7 +94,39 @@ namespace elgar {
      *
      * @param[in]  value  The value to set vsync to (true to enable, false to disable)
      */
-    void SetVerticalSync(const bool &value) const;
+    void SetVerticalSync(const bool &value);
+
+    /**
+     * @brief      Sets the vertical sync mode. Adaptive sync falls back to regular vertical sync
+     *             where the driver does not support it. Needs the OpenGL context, so it cannot be
+     *             changed while the render thread is running.
+     *
+     * @param[in]  mode  The mode to use
+     *
+     * @return     The mode actually in effect
+     */
+    VSyncMode SetVSyncMode(const VSyncMode &mode);
+
+    /**
+     * @brief      Get the vertical sync mode in effect
+     *
+     * @return     The mode
+     */
+    const VSyncMode &GetVSyncMode() const;
+
+    /**
+     * @brief      Checks if the Window is minimized or hidden (never true offscreen)
+     *
+     * @return     True if minimized, False otherwise
+     */
+    bool IsMinimized() const;
+
+    /**
+     * @brief      Checks if the Window has input focus (always true offscreen)
+     *
+     * @return     True if focused, False otherwise
+     */
+    bool HasFocus() const;
 
     /**
      * @brief      Get the screen dimensions
@@ -78,7 +135,25 @@ namespace elgar {
      */
     glm::vec2 GetDimensions() const;
 
+    /**
+     * @brief      Checks if the Window renders offscreen instead of to a display
+     *
+     * @return     True if offscreen, False otherwise
+     */
+    bool IsOffscreen() const;
+
   private:
+    /**
+     * @brief      Creates a surfaceless OpenGL context through EGL (works without a display server,
+     *             e.g. on Mesa llvmpipe)
+     */
+    void CreateOffscreenContext();
+
+    /**
+     * @brief      Creates the frame buffer offscreen rendering is done into
+     */
+    void CreateOffscreenTarget();
+
     /**
      * @brief      Initializes OpenGL specs
      *
@@ -86,10 +161,20 @@ namespace elgar {
      */
     bool InitGL();
 
+    /**
+     * @brief      Make the OpenGL context current on the calling thread
+     */
+    void AcquireContext();
+
+    /**
+     * @brief      Detach the OpenGL context from the calling thread so another thread can acquire it
+     */
+    void ReleaseContext();
+
     /**
      * @brief      Draws all renderables to the window as well as calls optional rendering function
      */
-    void Present(void (*render)());
+    void Present(const std::function<void()> &render);
 
   };
 
@@ -0,0 +1,155 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_ARCHETYPE_HPP_
+#define _ELGAR_ARCHETYPE_HPP_
+
+// INCLUDES //
+
+#include "elgar/ecs/Entity.hpp"
+
+#include <memory>
+#include <vector>
+
+// DEFINES //
+
+#define ECS_CHUNK_SIZE          (16 * 1024)   // Bytes per chunk (sized to sit comfortably in L1/L2)
+#define ECS_COLUMN_ALIGNMENT    64            // Alignment of every array in a chunk (a cache line)
+
+namespace elgar {
+
+  /**
+   * @brief An Archetype stores every entity that has exactly the same set of components. Its
+   *        entities are packed into fixed size chunks, and within a chunk every component type
+   *        has its own contiguous array (structure of arrays), so a query streams through
+   *        exactly the arrays it asks for. Rows stay dense: removing an entity moves the last
+   *        one into its place.
+   *
+   */
+  class Archetype {
+  friend class World;   // Only a World changes the rows of an Archetype
+  private:
+    ComponentMask m_mask;   // The components of the archetype
+    std::vector<ComponentId> m_components;  // The components in id order
+    int m_columns[ECS_MAX_COMPONENTS];      // Column of every component id (-1 if absent)
+    std::vector<size_t> m_offsets;    // Byte offset of every column's array in a chunk
+    std::vector<size_t> m_sizes;      // Size of a component of every column
+
+    size_t m_capacity;      // Rows per chunk
+    size_t m_chunk_bytes;   // Bytes per chunk
+    size_t m_count;         // Rows in use across every chunk
+
+    std::vector<std::unique_ptr<unsigned char[]>> m_chunks;   // The chunk memory (over allocated for alignment)
+    std::vector<unsigned char *> m_chunk_data;                // Aligned start of every chunk
+
+    Archetype *m_add_edges[ECS_MAX_COMPONENTS];       // Archetype with one more component (cached)
+    Archetype *m_remove_edges[ECS_MAX_COMPONENTS];    // Archetype with one less component (cached)
+
+  private:
+    /**
+     * @brief Construct a new Archetype object
+     *
+     * @param mask  The components of the archetype
+     */
+    Archetype(const ComponentMask &mask);
+
+    /**
+     * @brief Add a row to the end of the archetype (its components are left uninitialized)
+     *
+     * @param entity  The entity the row belongs to
+     * @return The row
+     */
+    size_t AddRow(const Entity &entity);
+
+    /**
+     * @brief Remove a row, moving the last row into its place
+     *
+     * @param row     The row
+     * @param moved   Set to the entity that was moved into the row (if any)
+     * @return True if an entity was moved, false if the row was the last one
+     */
+    bool RemoveRow(const size_t &row, Entity &moved);
+
+    /**
+     * @brief Copy the components two archetypes share from a row of another archetype
+     *
+     * @param row     The row to copy into
+     * @param source  The archetype to copy from
+     * @param source_row  The row to copy from
+     */
+    void CopyRow(const size_t &row, const Archetype &source, const size_t &source_row);
+
+    /**
+     * @brief Get a component of a row
+     *
+     * @param row     The row
+     * @param column  The column of the component
+     * @return The component
+     */
+    void *GetComponent(const size_t &row, const int &column) const;
+
+  public:
+    /**
+     * @brief Destroy the Archetype object
+     *
+     */
+    virtual ~Archetype();
+
+    /**
+     * @brief Get the components of the archetype
+     *
+     * @return The mask
+     */
+    const ComponentMask &GetMask() const;
+
+    /**
+     * @brief Get the number of entities in the archetype
+     *
+     * @return The count
+     */
+    const size_t &GetEntityCount() const;
+
+    /**
+     * @brief Get the number of chunks holding entities
+     *
+     * @return The count
+     */
+    size_t GetChunkCount() const;
+
+    /**
+     * @brief Get the number of entities in a chunk
+     *
+     * @param chunk The chunk
+     * @return The count
+     */
+    size_t GetChunkEntityCount(const size_t &chunk) const;
+
+    /**
+     * @brief Get the entities of a chunk
+     *
+     * @param chunk The chunk
+     * @return The array
+     */
+    const Entity *GetEntities(const size_t &chunk) const;
+
+    /**
+     * @brief Get the array of a component in a chunk
+     *
+     * @tparam T    The component type (must be part of the archetype)
+     * @param chunk The chunk
+     * @return The array
+     */
+    template<typename T>
+    T *GetArray(const size_t &chunk) const {
+      const int column = m_columns[ComponentRegistry::GetId<T>()];
+      return reinterpret_cast<T *>(m_chunk_data[chunk] + m_offsets[column]);
+    }
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,107 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_ENTITY_HPP_
+#define _ELGAR_ENTITY_HPP_
+
+// INCLUDES //
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// DEFINES //
+
+#define ECS_MAX_COMPONENTS    64    // Component types a program may register (one bit each in a ComponentMask)
+
+namespace elgar {
+
+  typedef uint32_t ComponentId;     // Index of a registered component type
+  typedef uint64_t ComponentMask;   // Set of component types (bit i is ComponentId i)
+
+  /**
+   * @brief An Entity is a handle to a row of components in a World. The generation tells a
+   *        destroyed entity apart from a newer one reusing its index.
+   *
+   */
+  struct Entity {
+    uint32_t index;       // Slot of the entity in its World
+    uint32_t generation;  // Times the slot has been reused
+
+    bool operator ==(const Entity &entity) const {
+      return index == entity.index && generation == entity.generation;
+    }
+
+    bool operator !=(const Entity &entity) const {
+      return !(*this == entity);
+    }
+  };
+
+  /**
+   * @brief The ComponentInfo struct describes the storage of a registered component type
+   *
+   */
+  struct ComponentInfo {
+    size_t size;        // Size of a component in bytes
+    size_t alignment;   // Alignment of a component in bytes
+  };
+
+  /**
+   * @brief The ComponentRegistry hands out a ComponentId for every component type on first use.
+   *        Components are stored as raw bytes and moved with memcpy, so they must be trivially
+   *        copyable (plain data such as glm vectors).
+   *
+   */
+  class ComponentRegistry {
+  private:
+    /**
+     * @brief Register a component type
+     *
+     * @param size      Size of the component in bytes
+     * @param alignment Alignment of the component in bytes
+     * @return The id of the component type
+     */
+    static ComponentId Register(const size_t &size, const size_t &alignment);
+
+  public:
+    /**
+     * @brief Get the id of a component type, registering it on first use
+     *
+     * @tparam T  The component type
+     * @return The id
+     */
+    template<typename T>
+    static ComponentId GetId() {
+      static_assert(std::is_trivially_copyable<T>::value, "Components must be trivially copyable!");
+
+      static const ComponentId id = Register(sizeof(T), alignof(T));
+      return id;
+    }
+
+    /**
+     * @brief Get the mask of a set of component types
+     *
+     * @tparam T  The component types
+     * @return The mask
+     */
+    template<typename... T>
+    static ComponentMask GetMask() {
+      return (ComponentMask(0) | ... | (ComponentMask(1) << GetId<T>()));
+    }
+
+    /**
+     * @brief Get the storage description of a component type
+     *
+     * @param id  The id of the component type
+     * @return The description
+     */
+    static const ComponentInfo &GetInfo(const ComponentId &id);
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,77 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_TRANSFORM_HPP_
+#define _ELGAR_TRANSFORM_HPP_
+
+// INCLUDES //
+
+#include "elgar/ecs/World.hpp"
+
+#include <glm/glm.hpp>
+
+namespace elgar {
+
+  /**
+   * @brief The position of an entity (the ECS counterpart of a Movable)
+   *
+   */
+  struct Position {
+    glm::vec3 value;
+  };
+
+  /**
+   * @brief The scale of an entity (the ECS counterpart of a Scalable)
+   *
+   */
+  struct Scale {
+    glm::vec3 value;
+  };
+
+  /**
+   * @brief The Euler angles of an entity (the ECS counterpart of a Rotatable)
+   *
+   */
+  struct Rotation {
+    glm::vec3 value;
+  };
+
+  /**
+   * @brief The position of an entity before the last fixed step (for interpolation)
+   *
+   */
+  struct PreviousPosition {
+    glm::vec3 value;
+  };
+
+  /**
+   * @brief The scale of an entity before the last fixed step (for interpolation)
+   *
+   */
+  struct PreviousScale {
+    glm::vec3 value;
+  };
+
+  /**
+   * @brief The Euler angles of an entity before the last fixed step (for interpolation)
+   *
+   */
+  struct PreviousRotation {
+    glm::vec3 value;
+  };
+
+  /**
+   * @brief Copy the current position, scale and rotation of every entity that has them into
+   *        their previous state components (call at the start of every fixed step, the ECS
+   *        counterpart of what the Interpolated Change* methods do)
+   *
+   * @param world The world
+   */
+  void StorePreviousTransforms(World &world);
+
+}
+
+#endif
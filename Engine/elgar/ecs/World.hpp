@@ -0,0 +1,321 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_WORLD_HPP_
+#define _ELGAR_WORLD_HPP_
+
+// INCLUDES //
+
+#include "elgar/ecs/Entity.hpp"
+#include "elgar/ecs/Archetype.hpp"
+#include "elgar/core/JobSystem.hpp"
+
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// DEFINES //
+
+#define ECS_PARALLEL_CHUNK_GRAIN    4   // Chunks per job when iterating in parallel
+
+namespace elgar {
+
+  /**
+   * @brief A World owns a set of entities and their components, grouped into Archetypes by the
+   *        exact set of components they have. Queries visit only the archetypes holding every
+   *        component they ask for and walk their chunks array by array. Adding or removing
+   *        components moves an entity between archetypes, so it must not happen while the World
+   *        is being iterated.
+   *
+   */
+  class World {
+  private:
+    /**
+     * @brief An EntityRecord tells where the components of an entity live
+     *
+     */
+    struct EntityRecord {
+      Archetype *archetype;   // Archetype holding the entity (nullptr if the slot is free)
+      size_t    row;          // Row of the entity in the archetype
+      uint32_t  generation;   // Generation of the entity currently using the slot
+    };
+
+  private:
+    std::vector<EntityRecord> m_records;    // Every entity slot
+    std::vector<uint32_t>     m_free;       // Slots free for reuse
+    size_t                    m_entity_count;   // Live entities
+
+    std::unordered_map<ComponentMask, std::unique_ptr<Archetype>> m_archetypes;  // Archetypes by mask
+    std::vector<Archetype *>  m_archetype_list;   // Archetypes in creation order (for iteration)
+
+  private:
+    /**
+     * @brief Get the archetype of a set of components, creating it on first use
+     *
+     * @param mask  The components
+     * @return The archetype
+     */
+    Archetype *GetArchetype(const ComponentMask &mask);
+
+    /**
+     * @brief Create an entity in an archetype (its components are left uninitialized)
+     *
+     * @param archetype The archetype
+     * @return The entity
+     */
+    Entity CreateEntity(Archetype *archetype);
+
+    /**
+     * @brief Move an entity into another archetype, keeping the components both have
+     *
+     * @param entity  The entity
+     * @param target  The archetype to move to
+     */
+    void MoveEntity(const Entity &entity, Archetype *target);
+
+    /**
+     * @brief Get the record of a live entity
+     *
+     * @param entity  The entity
+     * @return The record (throws if the entity is not alive)
+     */
+    EntityRecord &GetRecord(const Entity &entity);
+
+    /**
+     * @brief Get a component of an entity
+     *
+     * @param entity  The entity
+     * @param id      The component type
+     * @return The component or nullptr if the entity does not have it
+     */
+    void *GetComponentData(const Entity &entity, const ComponentId &id) const;
+
+    /**
+     * @brief Add a component to an entity (moving it to a new archetype if needed)
+     *
+     * @param entity  The entity
+     * @param id      The component type
+     * @return The storage of the component (uninitialized if it was just added)
+     */
+    void *AddComponentData(const Entity &entity, const ComponentId &id);
+
+    /**
+     * @brief Collect the chunks of every archetype holding a set of components
+     *
+     * @param mask    The components
+     * @param chunks  Filled with an (archetype, chunk) pair per chunk
+     */
+    void GetChunks(const ComponentMask &mask, std::vector<std::pair<Archetype *, size_t>> &chunks) const;
+
+  public:
+    /**
+     * @brief Construct a new World object
+     *
+     */
+    World();
+
+    /**
+     * @brief Destroy the World object
+     *
+     */
+    virtual ~World();
+
+    /**
+     * @brief Create an entity without components
+     *
+     * @return The entity
+     */
+    Entity CreateEntity();
+
+    /**
+     * @brief Create an entity with a set of components
+     *
+     * @tparam T          The component types
+     * @param components  The components
+     * @return The entity
+     */
+    template<typename... T>
+    Entity CreateEntity(const T &...components) {
+      Archetype *archetype = GetArchetype(ComponentRegistry::GetMask<T...>());
+      const Entity entity = CreateEntity(archetype);
+      const size_t row = m_records[entity.index].row;
+
+      ((new (archetype->GetComponent(row, archetype->m_columns[ComponentRegistry::GetId<T>()])) T(components)), ...);
+
+      return entity;
+    }
+
+    /**
+     * @brief Destroy an entity and its components
+     *
+     * @param entity  The entity
+     */
+    void DestroyEntity(const Entity &entity);
+
+    /**
+     * @brief Check if an entity has not been destroyed
+     *
+     * @param entity  The entity
+     * @return True if alive, false otherwise
+     */
+    bool IsAlive(const Entity &entity) const;
+
+    /**
+     * @brief Add a component to an entity (or overwrite it if the entity already has one)
+     *
+     * @tparam T          The component type
+     * @param entity      The entity
+     * @param component   The component
+     */
+    template<typename T>
+    void AddComponent(const Entity &entity, const T &component) {
+      new (AddComponentData(entity, ComponentRegistry::GetId<T>())) T(component);
+    }
+
+    /**
+     * @brief Remove a component from an entity
+     *
+     * @tparam T      The component type
+     * @param entity  The entity
+     */
+    template<typename T>
+    void RemoveComponent(const Entity &entity) {
+      RemoveComponent(entity, ComponentRegistry::GetId<T>());
+    }
+
+    /**
+     * @brief Remove a component from an entity
+     *
+     * @param entity  The entity
+     * @param id      The component type
+     */
+    void RemoveComponent(const Entity &entity, const ComponentId &id);
+
+    /**
+     * @brief Check if an entity has a component
+     *
+     * @tparam T      The component type
+     * @param entity  The entity
+     * @return True if it does, false otherwise
+     */
+    template<typename T>
+    bool HasComponent(const Entity &entity) const {
+      return GetComponentData(entity, ComponentRegistry::GetId<T>()) != nullptr;
+    }
+
+    /**
+     * @brief Get a component of an entity
+     *
+     * @tparam T      The component type
+     * @param entity  The entity
+     * @return The component or nullptr if the entity does not have it (invalidated by any
+     *         change to the components of any entity)
+     */
+    template<typename T>
+    T *GetComponent(const Entity &entity) const {
+      return static_cast<T *>(GetComponentData(entity, ComponentRegistry::GetId<T>()));
+    }
+
+    /**
+     * @brief Call a function on every chunk holding a set of components, with the number of
+     *        entities in the chunk and the array of each component
+     *
+     * @tparam T    The component types
+     * @param func  Function called as func(count, T *...)
+     */
+    template<typename... T, typename F>
+    void EachChunk(F &&func) const {
+      const ComponentMask mask = ComponentRegistry::GetMask<T...>();
+
+      for (Archetype *archetype : m_archetype_list) {
+        if ((archetype->GetMask() & mask) != mask)
+          continue;
+
+        const size_t chunks = archetype->GetChunkCount();
+        for (size_t chunk = 0; chunk < chunks; chunk++)
+          func(archetype->GetChunkEntityCount(chunk), archetype->GetArray<T>(chunk)...);
+      }
+    }
+
+    /**
+     * @brief Call a function on every entity holding a set of components
+     *
+     * @tparam T    The component types
+     * @param func  Function called as func(T &...)
+     */
+    template<typename... T, typename F>
+    void Each(F &&func) const {
+      EachChunk<T...>([&func](const size_t &count, T *...arrays) {
+        for (size_t i = 0; i < count; i++)
+          func(arrays[i]...);
+      });
+    }
+
+    /**
+     * @brief Like EachChunk, but spread the chunks across the JobSystem (the function must be
+     *        safe to call from several threads at once)
+     *
+     * @tparam T    The component types
+     * @param func  Function called as func(count, T *...)
+     */
+    template<typename... T, typename F>
+    void ParallelEachChunk(F &&func) const {
+      JobSystem *jobs = JobSystem::GetInstance();
+
+      if (!jobs) {
+        EachChunk<T...>(func);
+        return;
+      }
+
+      std::vector<std::pair<Archetype *, size_t>> chunks;
+      GetChunks(ComponentRegistry::GetMask<T...>(), chunks);
+
+      jobs->ParallelFor(chunks.size(), ECS_PARALLEL_CHUNK_GRAIN, [&func, &chunks](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+          Archetype *archetype = chunks[i].first;
+          const size_t chunk = chunks[i].second;
+
+          func(archetype->GetChunkEntityCount(chunk), archetype->GetArray<T>(chunk)...);
+        }
+      });
+    }
+
+    /**
+     * @brief Like Each, but spread the chunks across the JobSystem (the function must be safe to
+     *        call from several threads at once)
+     *
+     * @tparam T    The component types
+     * @param func  Function called as func(T &...)
+     */
+    template<typename... T, typename F>
+    void ParallelEach(F &&func) const {
+      ParallelEachChunk<T...>([&func](const size_t &count, T *...arrays) {
+        for (size_t i = 0; i < count; i++)
+          func(arrays[i]...);
+      });
+    }
+
+    /**
+     * @brief Get the number of live entities
+     *
+     * @return The count
+     */
+    const size_t &GetEntityCount() const;
+
+    /**
+     * @brief Get the number of archetypes created so far
+     *
+     * @return The count
+     */
+    size_t GetArchetypeCount() const;
+
+  };
+
+}
+
+#endif
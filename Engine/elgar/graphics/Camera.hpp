@@ -12,6 +12,8 @@
 #include <glm/glm.hpp>
 
 #include "elgar/graphics/Shader.hpp"
+#include "elgar/physics/AABB.hpp"
+#include "elgar/physics/Frustum.hpp"
 
 namespace elgar {
 
@@ -25,6 +27,17 @@ namespace elgar {
     glm::mat4 m_projection_matrix;    // The projection fustrum
     glm::mat4 m_view_matrix;          // Where in the world is the camera
 
+    Frustum   m_frustum;          // World space view volume (kept in step with the matrices)
+    AABB      m_view_bounds;      // World space box around the view volume
+    bool      m_orthographic;     // Set if the projection is orthographic
+
+  private:
+    /**
+     * @brief Extract the frustum and view bounds from the matrices
+     * 
+     */
+    void UpdateViewVolume();
+
   public:
     /**
      * @brief Construct a new Camera object
@@ -82,6 +95,28 @@ namespace elgar {
      */
     const glm::mat4 &GetViewMatrix() const;
 
+    /**
+     * @brief Get the world space frustum of the Camera (an orthographic projection gives a box)
+     * 
+     * @return Reference to the frustum
+     */
+    const Frustum &GetFrustum() const;
+
+    /**
+     * @brief Get the world space box around everything the Camera can see. For a 2D orthographic
+     *        Camera the x and y extents are exactly the view rectangle.
+     * 
+     * @return Reference to the view bounds
+     */
+    const AABB &GetViewBounds() const;
+
+    /**
+     * @brief Check if the Camera uses an orthographic projection
+     * 
+     * @return True if orthographic, false otherwise
+     */
+    const bool &IsOrthographic() const;
+
     /**
      * @brief Draw the Camera using a Shader program
      * 
@@ -0,0 +1,206 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_COMMAND_LIST_HPP_
+#define _ELGAR_COMMAND_LIST_HPP_
+
+// INCLUDES //
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "elgar/graphics/data/Mesh.hpp"
+#include "elgar/graphics/data/RGBA.hpp"
+#include "elgar/graphics/data/Texture.hpp"
+#include "elgar/graphics/Shader.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace elgar {
+
+  /**
+   * @brief A CommandList records the renderer calls of a frame so they can be replayed later on
+   *        the thread that owns the OpenGL context. While a list is set as the recording target of a
+   *        thread, Camera::Draw, the Draw/Submit/Flush calls of the Sprite, Mesh and Text renderers
+   *        and the Shader uniform setters made on that thread are recorded into it instead of
+   *        reaching OpenGL (a setter is recorded as a call, with its name and values copied, and
+   *        checked against the uniform's last value when replayed). Shaders, textures and meshes
+   *        are recorded by pointer; matrices and strings are copied. The OpenGL objects
+   *        behind textures, buffers and cached meshes are released through RenderThread::Defer, so
+   *        they survive until the frames recorded before their release are presented, but the
+   *        objects recorded by pointer must still be alive when the frame is presented (delete them
+   *        through RenderThread::Defer too). Storage is kept between frames, so a list reaches a
+   *        steady state without allocating.
+   *
+   */
+  class CommandList {
+  private:
+    /**
+     * @brief The CommandType enum lists the calls a CommandList can record
+     *
+     */
+    enum CommandType {
+      COMMAND_CAMERA,             // Camera::Draw
+      COMMAND_SPRITE,             // SpriteRenderer::Draw
+      COMMAND_SPRITE_INSTANCED,   // SpriteRenderer::DrawInstanced
+      COMMAND_MESH,               // MeshRenderer::Draw
+      COMMAND_MESH_INSTANCED,     // MeshRenderer::DrawInstanced
+      COMMAND_TEXT,               // TextRenderer::Submit
+      COMMAND_TEXT_FLUSH,         // TextRenderer::Flush
+      COMMAND_CALL                // A user function
+    };
+
+    /**
+     * @brief A Command holds the arguments of a single recorded call
+     *
+     */
+    struct Command {
+      CommandType     type;       // Which call to make
+      const Shader    *shader;    // The shader program to draw with
+      const Texture   *texture;   // The texture to draw with (sprites only)
+      const Mesh      *mesh;      // The mesh to draw (meshes only)
+      RGBA            color;      // The color to draw with
+      GLuint          first;      // Index of the first matrix of the call in m_matrices
+      GLuint          count;      // Number of matrices used by the call
+      GLuint          index;      // Index of the string (text) or function (calls) of the call
+      GLfloat         scale;      // The text scale (text only)
+    };
+
+  private:
+    std::vector<Command>    m_commands;   // Commands recorded since the last clear
+    std::vector<glm::mat4>  m_matrices;   // Matrices referenced by the recorded commands
+    std::vector<std::string>  m_text;     // Strings referenced by text commands (kept for their storage)
+    GLuint                  m_text_count; // Strings of m_text in use
+    std::vector<std::function<void()>>  m_calls;  // Functions referenced by call commands
+
+  private:
+    /**
+     * @brief Add a command and copy its matrices
+     *
+     * @param command   The command (first and count are filled in)
+     * @param matrices  The matrices of the command
+     * @param count     The number of matrices
+     */
+    void Push(Command command, const glm::mat4 *matrices, const size_t &count);
+
+  public:
+    /**
+     * @brief Construct a new CommandList object
+     *
+     */
+    CommandList();
+
+    /**
+     * @brief Destroy the CommandList object
+     *
+     */
+    virtual ~CommandList();
+
+    /**
+     * @brief Get the list the calling thread is recording into
+     *
+     * @return The list (nullptr if renderer calls should go straight to OpenGL)
+     */
+    static CommandList *GetRecording();
+
+    /**
+     * @brief Set the list the calling thread records renderer calls into
+     *
+     * @param list  The list (nullptr to stop recording)
+     */
+    static void SetRecording(CommandList *list);
+
+    /**
+     * @brief Record a Camera::Draw
+     *
+     * @param shader      The shader program to set the camera matrices of
+     * @param projection  The projection matrix
+     * @param view        The view matrix
+     */
+    void RecordCamera(const Shader &shader, const glm::mat4 &projection, const glm::mat4 &view);
+
+    /**
+     * @brief Record a SpriteRenderer::Draw
+     *
+     */
+    void RecordSprite(const Shader &shader, const glm::mat4 &model, const RGBA &color, const Texture *texture);
+
+    /**
+     * @brief Record a SpriteRenderer::DrawInstanced (the matrices are copied)
+     *
+     */
+    void RecordSpriteInstanced(
+      const Shader &shader,
+      const glm::mat4 *models,
+      const size_t &count,
+      const RGBA &color,
+      const Texture *texture
+    );
+
+    /**
+     * @brief Record a MeshRenderer::Draw
+     *
+     */
+    void RecordMesh(const Mesh &mesh, const Shader &shader, const RGBA &color, const glm::mat4 &model);
+
+    /**
+     * @brief Record a MeshRenderer::DrawInstanced (the matrices are copied)
+     *
+     */
+    void RecordMeshInstanced(
+      const Mesh &mesh,
+      const Shader &shader,
+      const RGBA &color,
+      const glm::mat4 *models,
+      const size_t &count
+    );
+
+    /**
+     * @brief Record a TextRenderer::Submit (the text is copied)
+     *
+     */
+    void RecordText(const std::string &text, const RGBA &color, const glm::mat4 &model, const GLfloat &scale);
+
+    /**
+     * @brief Record a TextRenderer::Flush
+     *
+     */
+    void RecordTextFlush(const Shader &shader);
+
+    /**
+     * @brief Record a function to run in order with the draws (e.g. to create or destroy OpenGL
+     *        resources from the render thread)
+     *
+     * @param call  The function
+     */
+    void RecordCall(const std::function<void()> &call);
+
+    /**
+     * @brief Replay the recorded calls (must be called on the thread that owns the OpenGL context)
+     *
+     */
+    void Execute() const;
+
+    /**
+     * @brief Forget the recorded calls, keeping the storage for the next frame
+     *
+     */
+    void Clear();
+
+    /**
+     * @brief Get the number of recorded calls
+     *
+     * @return The command count
+     */
+    size_t GetCommandCount() const;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,232 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_GPU_TIMER_HPP_
+#define _ELGAR_GPU_TIMER_HPP_
+
+// INCLUDES //
+
+#include <GL/glew.h>
+
+#include "elgar/core/Singleton.hpp"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// DEFINES //
+
+#define GPU_TIMER_FRAME_COUNT       4     // Frames of queries kept in flight before results are read
+#define GPU_TIMER_QUERY_CAPACITY    512   // Most timestamp queries issued in a single frame
+
+#define GPU_TIMER_CONCAT_IMPL(a, b) a##b
+#define GPU_TIMER_CONCAT(a, b) GPU_TIMER_CONCAT_IMPL(a, b)
+
+// The pass is resolved once per call site, so an open zone costs no lookups
+#define GPU_ZONE(name) \
+  static const GLuint GPU_TIMER_CONCAT(_gpu_pass_, __LINE__) = elgar::GPUTimer::RegisterPass(name); \
+  elgar::GPUZone GPU_TIMER_CONCAT(_gpu_zone_, __LINE__)(GPU_TIMER_CONCAT(_gpu_pass_, __LINE__))
+
+namespace elgar {
+
+  /**
+   * @brief The GPUTimer class measures how long the GPU spends on each named pass of a frame with
+   *        GL_TIMESTAMP queries. Queries are pooled over several frames and only read back once they
+   *        are available, so reading results never stalls the pipeline (results lag a few frames
+   *        behind). Consecutive zones of the same pass are merged into one pair of queries.
+   *        (Is a Singleton class)
+   *
+   */
+  class GPUTimer : public Singleton<GPUTimer> {
+  friend class Engine;
+  friend class RenderThread;  // Allow the render thread to close off frames
+  private:
+    /**
+     * @brief A GPUTimerRecord is a single timed range of a pass
+     *
+     */
+    struct GPUTimerRecord {
+      GLuint pass;    // The pass the range belongs to
+      GLuint begin;   // Index of the query written when the range opened
+      GLuint end;     // Index of the query written when the range closed
+      GLuint depth;   // Number of ranges that were open when this one opened
+    };
+
+    /**
+     * @brief A GPUTimerFrame holds the queries issued during one frame
+     *
+     */
+    struct GPUTimerFrame {
+      std::vector<GLuint>         queries;    // Query objects owned by the frame
+      std::vector<GPUTimerRecord> records;    // Ranges recorded during the frame
+      GLuint                      issued;     // Number of queries handed out during the frame
+      GLint                       last;       // Index of the query written most recently (-1 if none)
+    };
+
+  private:
+    bool    m_supported;    // Does the context support timestamp queries?
+    bool    m_enabled;      // Are zones being recorded?
+
+    GPUTimerFrame m_frames[GPU_TIMER_FRAME_COUNT];  // The pool of frames in flight
+    GLuint        m_frame;                          // The frame being recorded
+    std::vector<GLuint> m_open;                     // Records of the current frame that are still open
+
+    std::vector<std::string>  m_pass_names;   // Name of each registered pass seen so far (by index)
+    std::vector<GLuint64>     m_pass_scratch; // Per pass nanoseconds while a frame is read back
+
+    std::map<std::string, GLdouble> m_pass_times;   // Milliseconds of each pass in the last frame read back
+    mutable std::mutex  m_pass_times_lock;          // Guards the pass times (read from any thread)
+    std::atomic<GLuint> m_dropped;    // Frames whose results were not ready in time
+
+  private:
+    /**
+     * @brief Construct a new GPUTimer object
+     *
+     */
+    GPUTimer();
+
+    /**
+     * @brief Destroy the GPUTimer object
+     *
+     */
+    virtual ~GPUTimer();
+
+    /**
+     * @brief Write a timestamp query into the current frame
+     *
+     * @return The index of the query in the frame, or -1 if the frame is out of queries
+     */
+    GLint Timestamp();
+
+    /**
+     * @brief Read the results of a frame back if the GPU has finished with it
+     *
+     * @param frame   The frame to read
+     * @return True if the frame was read (or had nothing recorded), false if it is still in flight
+     */
+    bool Resolve(GPUTimerFrame &frame);
+
+    /**
+     * @brief Close off the current frame and start recording into the oldest one
+     *
+     */
+    void EndFrame();
+
+  public:
+    /**
+     * @brief Get the index of a pass, registering it the first time its name is seen. Indices are
+     *        shared by every GPUTimer for the life of the program (safe to call from any thread).
+     *
+     * @param name  The name of the pass
+     * @return The index of the pass
+     */
+    static GLuint RegisterPass(const std::string &name);
+
+    /**
+     * @brief Open a range of a pass (ranges may nest, but must be closed in reverse order)
+     *
+     * @param pass  The index of the pass (see RegisterPass)
+     */
+    void Begin(const GLuint &pass);
+
+    /**
+     * @brief Open a range of a pass by name (looks the pass up, prefer the index overload)
+     *
+     * @param name  The name of the pass
+     */
+    void Begin(const std::string &name);
+
+    /**
+     * @brief Close the most recently opened range
+     *
+     */
+    void End();
+
+    /**
+     * @brief Set whether ranges are recorded
+     *
+     * @param enabled True to record, false to ignore ranges
+     */
+    void SetEnabled(const bool &enabled);
+
+    /**
+     * @brief Checks if ranges are recorded
+     *
+     * @return True if recording, false otherwise
+     */
+    bool IsEnabled() const;
+
+    /**
+     * @brief Checks if the context supports timestamp queries (every query is skipped if not)
+     *
+     * @return True if supported, false otherwise
+     */
+    const bool &IsSupported() const;
+
+    /**
+     * @brief Get the GPU time of a pass in the latest frame whose results are available
+     *
+     * @param name  The name of the pass
+     * @return The time in milliseconds (0 if the pass was not drawn)
+     */
+    GLdouble GetPassTime(const std::string &name) const;
+
+    /**
+     * @brief Get the GPU time of every pass in the latest frame whose results are available
+     *
+     * @return A copy of the time in milliseconds of each pass
+     */
+    std::map<std::string, GLdouble> GetPassTimes() const;
+
+    /**
+     * @brief Get the number of frames whose results were dropped because the GPU had not finished
+     *        them by the time their queries had to be reused
+     *
+     * @return The number of dropped frames
+     */
+    GLuint GetDroppedFrameCount() const;
+
+  };
+
+  /**
+   * @brief A GPUZone times a pass between its construction and destruction (use the GPU_ZONE macro)
+   *
+   */
+  class GPUZone {
+  private:
+    bool m_open;    // Did the zone open a range?
+
+  public:
+    /**
+     * @brief Open a range of a pass
+     *
+     * @param pass The index of the pass (see GPUTimer::RegisterPass)
+     */
+    GPUZone(const GLuint &pass);
+
+    /**
+     * @brief Open a range of a pass by name
+     *
+     * @param name The name of the pass
+     */
+    GPUZone(const char *name);
+
+    /**
+     * @brief Close the range
+     *
+     */
+    ~GPUZone();
+
+    GPUZone(const GPUZone &) = delete;
+    GPUZone &operator =(const GPUZone &) = delete;
+  };
+
+}
+
+#endif
@@ -0,0 +1,166 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_RENDER_THREAD_HPP_
+#define _ELGAR_RENDER_THREAD_HPP_
+
+// INCLUDES //
+
+#include "elgar/core/Singleton.hpp"
+#include "elgar/graphics/CommandList.hpp"
+
+#include <GL/glew.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// DEFINES //
+
+#define RENDER_THREAD_MAX_DEPTH   3   // Most frames that may be queued ahead of the render thread
+
+namespace elgar {
+
+  /**
+   * @brief The RenderThread owns the OpenGL context while the Engine runs in threaded rendering
+   *        mode. The main thread records each frame's renderer calls into a CommandList and hands it
+   *        over; the render thread presents the frame from that list while the main thread moves on
+   *        to the next update. At most depth frames may be queued or rendering at once, so input to
+   *        display latency stays bounded. OpenGL objects are created on the render thread through
+   *        Invoke and deleted through Defer once no queued frame can still draw with them.
+   *        (Is a Singleton class)
+   *
+   */
+  class RenderThread : public Singleton<RenderThread> {
+  friend class Engine;
+  private:
+    /**
+     * @brief An Invocation is a call another thread is blocked on until the render thread runs it
+     *
+     */
+    struct Invocation {
+      const std::function<void()> *call;  // The call to run
+      std::exception_ptr          error;  // Whatever the call threw
+      bool                        done;   // Has the call run?
+    };
+
+    /**
+     * @brief A DeferredCall is held back until the frames recorded before it have been presented
+     *
+     */
+    struct DeferredCall {
+      uint64_t              frame;  // Frames submitted when the call was deferred
+      std::function<void()> call;   // The call to run
+    };
+
+  private:
+    CommandList m_lists[RENDER_THREAD_MAX_DEPTH + 1];  // One list recording plus up to depth in flight
+    GLuint      m_depth;        // Most frames that may be in flight
+
+    uint64_t    m_submitted;    // Frames handed to the render thread
+    uint64_t    m_completed;    // Frames the render thread has presented
+    uint64_t    m_stalls;       // Frames the main thread had to wait for the render thread
+    bool        m_running;      // Should the render thread keep running?
+
+    std::deque<Invocation *>  m_invokes;    // Calls waiting to run on the render thread
+    std::deque<DeferredCall>  m_deferred;   // Calls waiting on the frames recorded before them
+
+    mutable std::mutex      m_lock;       // Guards the frame counters and the call queues
+    std::condition_variable m_submit;     // Signalled when a frame or call is submitted (or on shutdown)
+    std::condition_variable m_complete;   // Signalled when a frame has been presented or a call has run
+    std::thread             m_thread;     // The render thread
+
+  private:
+    /**
+     * @brief Construct a new RenderThread object, moving the OpenGL context to a new thread
+     *
+     * @param depth Most frames that may be in flight (clamped to 1 - RENDER_THREAD_MAX_DEPTH)
+     */
+    RenderThread(const GLuint &depth);
+
+    /**
+     * @brief Destroy the RenderThread object, finishing every submitted frame and moving the
+     *        OpenGL context back to the calling thread
+     *
+     */
+    virtual ~RenderThread();
+
+    /**
+     * @brief The main loop of the render thread
+     *
+     */
+    void Loop();
+
+    /**
+     * @brief Run the deferred calls whose frames have all been presented
+     *
+     * @param all Run every deferred call regardless of the frames (used on shutdown)
+     */
+    void RunDeferred(const bool &all);
+
+    /**
+     * @brief Record a frame by calling render with the frame's CommandList as the recording target
+     *        and hand it to the render thread (waits if depth frames are already in flight)
+     *
+     * @param render  The render function (may be nullptr)
+     */
+    void Submit(void (*render)());
+
+    /**
+     * @brief Wait until every submitted frame has been presented
+     *
+     */
+    void Finish();
+
+  public:
+    /**
+     * @brief Run a call on the thread that owns the OpenGL context and wait for it to finish. Runs
+     *        the call right away without a render thread or when already on it. Anything the call
+     *        throws is rethrown on the calling thread.
+     *
+     * @param call  The call to run (typically OpenGL object creation)
+     */
+    static void Invoke(const std::function<void()> &call);
+
+    /**
+     * @brief Run a call on the thread that owns the OpenGL context once every frame recorded so
+     *        far has been presented. Runs the call right away without a render thread or when
+     *        already on it.
+     *
+     * @param call  The call to run (typically OpenGL object deletion, capturing the object name)
+     */
+    static void Defer(const std::function<void()> &call);
+
+    /**
+     * @brief Get the most frames that may be in flight
+     *
+     * @return The pipeline depth
+     */
+    const GLuint &GetPipelineDepth() const;
+
+    /**
+     * @brief Get the number of frames submitted but not presented yet
+     *
+     * @return The frames in flight
+     */
+    GLuint GetFramesInFlight() const;
+
+    /**
+     * @brief Get the number of frames the main thread had to wait for the render thread to catch up
+     *
+     * @return The stall count
+     */
+    uint64_t GetStallCount() const;
+
+  };
+
+}
+
+#endif
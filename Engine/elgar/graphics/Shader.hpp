@@ -13,20 +13,35 @@
 #include <glm/glm.hpp>
 
 #include <unordered_map>
+#include <vector>
 #include <string>
 
 namespace elgar {
 
   /**
-   * @brief      The Shader class is a wrapper for interacting with OpenGL shader programs
+   * @brief      The Shader class is a wrapper for interacting with OpenGL shader programs. While the
+   *             calling thread records into a CommandList, the uniform setters are recorded into it
+   *             and run when the frame is replayed.
    */
   class Shader {
   friend class ShaderManager;
+  private:
+    /**
+     * @brief The UniformShadow struct holds the last value sent to a uniform location
+     * 
+     */
+    struct UniformShadow {
+      GLuint  data[16];   // Raw bits of the value (large enough for a mat4)
+      GLsizei size;       // Number of bytes of data in use (0 if the value is unknown)
+    };
+
   private:
     GLuint m_id;  // The shader program id
 
-    std::unordered_map<std::string, GLint> m_uniform_cache;   // Cache of uniform locations
-    std::unordered_map<std::string, GLint> m_attrib_cache;    // Cache of attribute locations
+    mutable std::unordered_map<std::string, GLint> m_uniform_cache;   // Cache of uniform locations
+    mutable std::unordered_map<std::string, GLint> m_attrib_cache;    // Cache of attribute locations
+
+    mutable std::vector<UniformShadow> m_uniform_shadows;   // Last value of each uniform (indexed by location)
 
   private:
     /**
@@ -43,13 +58,19 @@ namespace elgar {
      */
     virtual ~Shader();
 
+    /**
+     * @brief Fill the uniform cache by walking the active uniforms of the linked program
+     * 
+     */
+    void BuildUniformCache();
+
     /**
      * @brief Checks uniform cache for the given uniform, updates the cache if necessary
      * 
      * @param name    The name of the uniform in the GLSL source code
      * @return GLint  The location of the uniform, or -1 if not found
      */
-    GLint UpdateUniformCache(const std::string &name);
+    GLint UpdateUniformCache(const std::string &name) const;
 
     /**
      * @brief Checks attribute cache for the given attribute, updates the cache if necessary
@@ -57,7 +78,25 @@ namespace elgar {
      * @param name    The name of the attribute in the GLSL source code
      * @return GLint  The location of the attribute, or -1 if not found
      */
-    GLint UpdateAttributeCache(const std::string &name);
+    GLint UpdateAttributeCache(const std::string &name) const;
+
+    /**
+     * @brief Compare a value against the shadow copy of a uniform, recording it if it differs
+     * 
+     * @param handle  The location of the uniform
+     * @param data    The value to send
+     * @param size    The size in bytes of the value
+     * @return True if the uniform needs to be sent to OpenGL, false if it is redundant
+     */
+    bool UpdateShadow(const GLint &handle, const GLvoid *data, const GLsizei &size) const;
+
+    /**
+     * @brief Forget the shadow copies of a range of uniform locations (after an array upload)
+     * 
+     * @param handle  The first location
+     * @param count   The number of locations
+     */
+    void InvalidateShadows(const GLint &handle, const GLsizei &count) const;
 
   public:
     /**
@@ -65,6 +104,23 @@ namespace elgar {
      */
     void Use() const;
 
+    /**
+     * @brief      Get a handle to a uniform that can be passed to the handle based setters without
+     *             any further lookups
+     *
+     * @param[in]  name  The name of the uniform
+     *
+     * @return     The uniform handle, or -1 if the uniform does not exist
+     */
+    GLint GetUniformHandle(const std::string &name) const;
+
+    /**
+     * @brief      Get the OpenGL id of the shader program
+     *
+     * @return     The program id
+     */
+    const GLuint &GetId() const;
+
     /**
      * @brief      Set a boolean uniform
      *
@@ -73,6 +129,14 @@ namespace elgar {
      */
     void SetBool(const std::string &name, GLboolean value) const;
 
+    /**
+     * @brief      Set a boolean uniform by handle
+     *
+     * @param[in]  handle  The handle of the uniform (see GetUniformHandle)
+     * @param[in]  value   The value
+     */
+    void SetBool(GLint handle, GLboolean value) const;
+
     /**
      * @brief      Sets an integer uniform
      *
@@ -81,6 +145,14 @@ namespace elgar {
      */
     void SetInt(const std::string &name, GLint value) const;
 
+    /**
+     * @brief      Sets an integer uniform by handle
+     *
+     * @param[in]  handle  The handle of the uniform (see GetUniformHandle)
+     * @param[in]  value   The value
+     */
+    void SetInt(GLint handle, GLint value) const;
+
     /**
      * @brief      Sets an integer array uniform
      *
@@ -90,6 +162,15 @@ namespace elgar {
      */
     void SetIntArray(const std::string &name, GLsizei count, GLint *values) const;
 
+    /**
+     * @brief      Sets an integer array uniform by handle
+     *
+     * @param[in]  handle  The handle of the uniform (see GetUniformHandle)
+     * @param[in]  count   The count
+     * @param[in]  values  The values
+     */
+    void SetIntArray(GLint handle, GLsizei count, GLint *values) const;
+
     /**
      * @brief      Sets a float uniform
      *
@@ -98,6 +179,14 @@ namespace elgar {
      */
     void SetFloat(const std::string &name, GLfloat value) const;
 
+    /**
+     * @brief      Sets a float uniform by handle
+     *
+     * @param[in]  handle  The handle of the uniform (see GetUniformHandle)
+     * @param[in]  value   The value
+     */
+    void SetFloat(GLint handle, GLfloat value) const;
+
     /**
      * @brief      Sets a float array uniform
      *
@@ -107,6 +196,15 @@ namespace elgar {
      */
     void SetFloatArray(const std::string &name, GLsizei count, GLfloat *values) const;
 
+    /**
+     * @brief      Sets a float array uniform by handle
+     *
+     * @param[in]  handle  The handle of the uniform (see GetUniformHandle)
+     * @param[in]  count   The count
+     * @param[in]  values  The values
+     */
+    void SetFloatArray(GLint handle, GLsizei count, GLfloat *values) const;
+
     /**
      * @brief      Sets a vector2 uniform
      *
@@ -115,6 +213,14 @@ namespace elgar {
      */
     void SetVec2(const std::string &name, const glm::vec2 &value) const;
 
+    /**
+     * @brief      Sets a vector2 uniform by handle
+     *
+     * @param[in]  handle  The handle of the uniform (see GetUniformHandle)
+     * @param[in]  value   The value
+     */
+    void SetVec2(GLint handle, const glm::vec2 &value) const;
+
     /**
      * @brief      Sets a vector2 array uniform
      *
@@ -124,6 +230,15 @@ namespace elgar {
      */
     void SetVec2Array(const std::string &name, GLsizei count, const GLfloat *values) const;
 
+    /**
+     * @brief      Sets a vector2 array uniform by handle
+     *
+     * @param[in]  handle  The handle of the uniform (see GetUniformHandle)
+     * @param[in]  count   The count
+     * @param[in]  values  The values
+     */
+    void SetVec2Array(GLint handle, GLsizei count, const GLfloat *values) const;
+
     /**
      * @brief      Sets a vector3 uniform
      *
@@ -132,6 +247,14 @@ namespace elgar {
      */
     void SetVec3(const std::string &name, const glm::vec3 &value) const;
 
+    /**
+     * @brief      Sets a vector3 uniform by handle
+     *
+     * @param[in]  handle  The handle of the uniform (see GetUniformHandle)
+     * @param[in]  value   The value
+     */
+    void SetVec3(GLint handle, const glm::vec3 &value) const;
+
     /**
      * @brief      Sets a vector3 array uniform
      *
@@ -141,6 +264,15 @@ namespace elgar {
      */
     void SetVec3Array(const std::string &name, GLsizei count, const GLfloat *values) const;
 
+    /**
+     * @brief      Sets a vector3 array uniform by handle
+     *
+     * @param[in]  handle  The handle of the uniform (see GetUniformHandle)
+     * @param[in]  count   The count
+     * @param[in]  values  The values
+     */
+    void SetVec3Array(GLint handle, GLsizei count, const GLfloat *values) const;
+
     /**
      * @brief      Sets a vector4 uniform
      *
@@ -149,6 +281,14 @@ namespace elgar {
      */
     void SetVec4(const std::string &name, const glm::vec4 &value) const;
 
+    /**
+     * @brief      Sets a vector4 uniform by handle
+     *
+     * @param[in]  handle  The handle of the uniform (see GetUniformHandle)
+     * @param[in]  value   The value
+     */
+    void SetVec4(GLint handle, const glm::vec4 &value) const;
+
     /**
      * @brief      Sets a mat2 uniform
      *
@@ -157,6 +297,14 @@ namespace elgar {
      */
     void SetMat2(const std::string &name, const glm::mat2 &mat) const;
 
+    /**
+     * @brief      Sets a mat2 uniform by handle
+     *
+     * @param[in]  handle  The handle of the uniform (see GetUniformHandle)
+     * @param[in]  mat     The matrix
+     */
+    void SetMat2(GLint handle, const glm::mat2 &mat) const;
+
     /**
      * @brief      Sets a mat3 uniform
      *
@@ -165,6 +313,14 @@ namespace elgar {
      */
     void SetMat3(const std::string &name, const glm::mat3 &mat) const;
 
+    /**
+     * @brief      Sets a mat3 uniform by handle
+     *
+     * @param[in]  handle  The handle of the uniform (see GetUniformHandle)
+     * @param[in]  mat     The matrix
+     */
+    void SetMat3(GLint handle, const glm::mat3 &mat) const;
+
     /**
      * @brief      Sets a mat4 uniform
      *
@@ -173,6 +329,14 @@ namespace elgar {
      */
     void SetMat4(const std::string &name, const glm::mat4 &mat) const;
 
+    /**
+     * @brief      Sets a mat4 uniform by handle
+     *
+     * @param[in]  handle  The handle of the uniform (see GetUniformHandle)
+     * @param[in]  mat     The matrix
+     */
+    void SetMat4(GLint handle, const glm::mat4 &mat) const;
+
     /**
      * @brief Enable an attribute in the loaded shader program
      * 
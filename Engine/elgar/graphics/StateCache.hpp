@@ -0,0 +1,183 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_STATE_CACHE_HPP_
+#define _ELGAR_STATE_CACHE_HPP_
+
+// INCLUDES //
+
+#include <GL/glew.h>
+
+#include "elgar/core/Singleton.hpp"
+
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+// DEFINES //
+
+#define STATE_CACHE_UNKNOWN   0xFFFFFFFF    // Marks a binding whose current value is not known
+
+namespace elgar {
+
+  /**
+   * @brief The StateCache class shadows the OpenGL bindings made by the engine's wrappers so that
+   *        redundant program, vertex array, texture, buffer and frame buffer binds never reach the
+   *        driver. (Is a Singleton class)
+   *
+   */
+  class StateCache : public Singleton<StateCache> {
+  friend class Engine;
+  friend class RenderThread;  // Allow the render thread to close off frames
+  private:
+    GLuint  m_program;          // The program in use
+    GLuint  m_vertex_array;     // The bound vertex array
+    GLuint  m_active_texture;   // The active texture unit
+
+    std::vector<GLuint>                 m_textures;       // The GL_TEXTURE_2D bound to each unit
+    std::unordered_map<GLenum, GLuint>  m_buffers;        // The buffer bound to each target
+    std::unordered_map<GLenum, GLuint>  m_framebuffers;   // The frame buffer bound to each target
+
+    GLuint  m_frame_issued;     // State changes sent to OpenGL this frame
+    GLuint  m_frame_skipped;    // State changes filtered out this frame
+
+    std::atomic<GLuint> m_last_issued;    // State changes sent to OpenGL last frame (read from any thread)
+    std::atomic<GLuint> m_last_skipped;   // State changes filtered out last frame (read from any thread)
+
+  private:
+    /**
+     * @brief Construct a new StateCache object
+     *
+     */
+    StateCache();
+
+    /**
+     * @brief Destroy the StateCache object
+     *
+     */
+    virtual ~StateCache();
+
+    /**
+     * @brief Record a state change as either issued or skipped
+     *
+     * @param issued  True if the change was sent to OpenGL
+     * @return The value of issued
+     */
+    bool Count(const bool &issued);
+
+    /**
+     * @brief Close off the per frame statistics
+     *
+     */
+    void EndFrame();
+
+  public:
+    /**
+     * @brief Use a shader program
+     *
+     * @param program The id of the program
+     */
+    void UseProgram(const GLuint &program);
+
+    /**
+     * @brief Bind a vertex array object
+     *
+     * @param vertex_array The id of the vertex array
+     */
+    void BindVertexArray(const GLuint &vertex_array);
+
+    /**
+     * @brief Select the active texture unit
+     *
+     * @param unit The index of the unit (not offset by GL_TEXTURE0)
+     */
+    void ActiveTexture(const GLuint &unit);
+
+    /**
+     * @brief Bind a GL_TEXTURE_2D to a texture unit. Only touches the active unit if the binding
+     *        actually changes.
+     *
+     * @param unit    The index of the unit (not offset by GL_TEXTURE0)
+     * @param texture The id of the texture
+     */
+    void BindTexture(const GLuint &unit, const GLuint &texture);
+
+    /**
+     * @brief Bind a buffer to a target
+     *
+     * @param target  The binding point
+     * @param buffer  The id of the buffer
+     */
+    void BindBuffer(const GLenum &target, const GLuint &buffer);
+
+    /**
+     * @brief Bind a frame buffer to a target
+     *
+     * @param target      The binding point (GL_FRAMEBUFFER binds both draw and read)
+     * @param framebuffer The id of the frame buffer
+     */
+    void BindFramebuffer(const GLenum &target, const GLuint &framebuffer);
+
+    /**
+     * @brief Drop a program that is being deleted from the cache
+     *
+     * @param program The id of the program
+     */
+    void ForgetProgram(const GLuint &program);
+
+    /**
+     * @brief Drop a vertex array that is being deleted from the cache
+     *
+     * @param vertex_array The id of the vertex array
+     */
+    void ForgetVertexArray(const GLuint &vertex_array);
+
+    /**
+     * @brief Drop a texture that is being deleted from the cache
+     *
+     * @param texture The id of the texture
+     */
+    void ForgetTexture(const GLuint &texture);
+
+    /**
+     * @brief Drop a buffer that is being deleted from the cache
+     *
+     * @param buffer The id of the buffer
+     */
+    void ForgetBuffer(const GLuint &buffer);
+
+    /**
+     * @brief Drop a frame buffer that is being deleted from the cache
+     *
+     * @param framebuffer The id of the frame buffer
+     */
+    void ForgetFramebuffer(const GLuint &framebuffer);
+
+    /**
+     * @brief Forget every binding (call after touching OpenGL state behind the cache's back)
+     *
+     */
+    void Invalidate();
+
+    /**
+     * @brief Get the number of state changes sent to OpenGL last frame
+     *
+     * @return The issued count
+     */
+    GLuint GetIssuedChanges() const;
+
+    /**
+     * @brief Get the number of redundant state changes filtered out last frame
+     *
+     * @return The skipped count
+     */
+    GLuint GetSkippedChanges() const;
+
+  };
+
+}
+
+#endif
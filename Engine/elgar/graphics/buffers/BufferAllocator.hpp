@@ -0,0 +1,84 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_BUFFER_ALLOCATOR_HPP_
+#define _ELGAR_BUFFER_ALLOCATOR_HPP_
+
+// INCLUDES //
+
+#include <GL/glew.h>
+
+#include <map>
+
+namespace elgar {
+
+  /**
+   * @brief      The BufferAllocator class hands out ranges of a fixed size buffer using a first-fit
+   *             free list. It only does the bookkeeping; ranges are measured in elements and it is up
+   *             to the owner to fill the actual buffer.
+   */
+  class BufferAllocator {
+  private:
+    GLsizei m_capacity;   // The number of elements in the buffer
+    GLsizei m_used;       // The number of elements currently handed out
+
+    std::map<GLsizei, GLsizei> m_free_list;   // Free ranges keyed by offset (offset -> size)
+
+  public:
+    /**
+     * @brief      Constructs a BufferAllocator
+     *
+     * @param[in]  capacity  The number of elements in the buffer being managed
+     */
+    BufferAllocator(const GLsizei &capacity);
+
+    /**
+     * @brief      Destroys the BufferAllocator
+     */
+    virtual ~BufferAllocator();
+
+    /**
+     * @brief      Allocate a contiguous range of elements
+     *
+     * @param[in]  size  The number of elements to allocate
+     *
+     * @return     The offset of the range, or -1 if no free range is large enough
+     */
+    GLint Allocate(const GLsizei &size);
+
+    /**
+     * @brief      Give a range back to the allocator, merging it with its free neighbours
+     *
+     * @param[in]  offset  The offset returned by Allocate
+     * @param[in]  size    The size passed to Allocate
+     */
+    void Free(const GLint &offset, const GLsizei &size);
+
+    /**
+     * @brief      Extend the managed buffer, the new elements are added to the end as free space
+     *
+     * @param[in]  capacity  The new number of elements (ignored unless larger than the current one)
+     */
+    void Grow(const GLsizei &capacity);
+
+    /**
+     * @brief      Get the number of elements currently allocated
+     *
+     * @return     The number of allocated elements
+     */
+    const GLsizei &GetUsed() const;
+
+    /**
+     * @brief      Get the number of elements in the managed buffer
+     *
+     * @return     The capacity
+     */
+    const GLsizei &GetCapacity() const;
+  };
+
+}
+
+#endif
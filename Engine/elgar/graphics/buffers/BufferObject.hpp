@@ -22,6 +22,8 @@ namespace elgar {
 
     GLenum m_target;  // The binding point of the BufferObject
 
+    mutable GLsizeiptr m_size;  // The size in bytes of the storage (as reported to the MemoryTracker)
+
   public:
     /**
      * @brief      Constructs a BufferObject
@@ -0,0 +1,120 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_STREAM_BUFFER_OBJECT_HPP_
+#define _ELGAR_STREAM_BUFFER_OBJECT_HPP_
+
+// INCLUDES //
+
+#include <GL/glew.h>
+
+#include <vector>
+
+// DEFINES //
+
+#define STREAM_BUFFER_DEFAULT_REGION_COUNT    3   // Triple buffer by default
+
+namespace elgar {
+
+  /**
+   * @brief      The StreamBufferObject class is a ring of fixed size elements that is persistently
+   *             mapped into client memory. The ring is split into regions which are fenced once the
+   *             GPU has been handed their contents, so data can be written straight into GPU visible
+   *             memory every frame without reallocating or implicitly synchronizing the buffer.
+   */
+  class StreamBufferObject {
+  private:
+    GLuint      m_id;       // The id of the OpenGL buffer
+    GLenum      m_target;   // The binding point of the buffer
+
+    GLsizeiptr  m_stride;           // The size in bytes of a single element
+    GLsizei     m_region_capacity;  // The number of elements per region
+    GLsizei     m_region_count;     // The number of regions in the ring
+    GLsizeiptr  m_size;             // The size in bytes of the whole ring
+
+    GLsizei     m_region;   // The region currently being written to
+    GLsizei     m_head;     // The next free element in the current region
+
+    GLubyte     *m_mapped;  // Pointer to the persistently mapped buffer (nullptr if unsupported)
+    std::vector<GLsync>   m_fences;   // Fences guarding each region
+    std::vector<GLubyte>  m_staging;  // Staging memory used when persistent mapping is unsupported
+
+  public:
+    /**
+     * @brief      Constructs a StreamBufferObject
+     *
+     * @param[in]  target           The binding point for the buffer
+     * @param[in]  stride           The size in bytes of a single element
+     * @param[in]  region_capacity  The number of elements that fit in a single region
+     * @param[in]  region_count     The number of regions in the ring (defaults to 3)
+     */
+    StreamBufferObject(
+      const GLenum &target,
+      const GLsizeiptr &stride,
+      const GLsizei &region_capacity,
+      const GLsizei &region_count = STREAM_BUFFER_DEFAULT_REGION_COUNT
+    );
+
+    /**
+     * @brief      Unmaps and deletes the StreamBufferObject
+     */
+    virtual ~StreamBufferObject();
+
+    /**
+     * @brief      Bind the StreamBufferObject
+     */
+    void Bind() const;
+
+    /**
+     * @brief      Unbind the StreamBufferObject
+     */
+    void Unbind() const;
+
+    /**
+     * @brief      Reserve space for a number of elements. Must be followed by a call to Commit before
+     *             the next reservation. The StreamBufferObject must be bound.
+     *
+     * @param[in]  count  The number of elements to reserve (at most the region capacity)
+     *
+     * @return     Pointer to write the elements to
+     */
+    GLvoid *Reserve(const GLsizei &count);
+
+    /**
+     * @brief      Hand the elements written since the last Reserve over to OpenGL
+     *
+     * @param[in]  count  The number of elements written (at most the reserved count)
+     *
+     * @return     The index of the first committed element in the buffer (for use as a base
+     *             instance or first vertex)
+     */
+    GLuint Commit(const GLsizei &count);
+
+    /**
+     * @brief      Get the number of elements that fit in a single region
+     *
+     * @return     The region capacity
+     */
+    const GLsizei &GetRegionCapacity() const;
+
+    /**
+     * @brief      Checks if the buffer is persistently mapped
+     *
+     * @return     True if persistently mapped, False if falling back to buffer uploads
+     */
+    bool IsPersistent() const;
+
+  private:
+    /**
+     * @brief      Fence the current region and move on to the next one, waiting on the GPU if it is
+     *             still reading from it
+     */
+    void NextRegion();
+  };
+
+}
+
+#endif
@@ -20,7 +20,7 @@
 
 // INCLUDES //
 
-#include "elgar/graphics/data/Texture.hpp"
+#include <GL/glew.h>
 
 #include <glm/glm.hpp>
 
@@ -31,7 +31,9 @@ namespace elgar {
    * 
    */
   struct ASCII {
-    const Texture   *texture;   // The texture for the character
+    GLboolean       loaded;     // Has the character been rasterized into the atlas?
+    glm::vec2       uv_min;     // Atlas coordinates of the top left of the glyph
+    glm::vec2       uv_max;     // Atlas coordinates of the bottom right of the glyph
     glm::ivec2      size;       // The size of the glyph
     glm::ivec2      bearing;    // Offset from baseline to left/top of glyph
     GLuint          advance;    // Offset to advance to next glyph
@@ -14,7 +14,9 @@
 #include "elgar/graphics/buffers/BufferObject.hpp"
 #include "elgar/graphics/buffers/VertexArrayObject.hpp"
 #include "elgar/graphics/Shader.hpp"
+#include "elgar/physics/AABB.hpp"
 
+#include <cstdint>
 #include <vector>
 
 // DEFINES //
@@ -34,6 +36,31 @@ namespace elgar {
     std::vector<GLuint> m_indices;    // The indices of the Mesh
     std::vector<const Texture *> m_textures;    // The textures of the Mesh
 
+    uint64_t m_id;    // Identifies the contents to the MeshRenderer (never reused)
+
+    size_t m_bytes;   // Bytes of the arrays as reported to the MemoryTracker
+
+    AABB m_bounds;    // Local space box around the vertices
+
+  private:
+    /**
+     * @brief Compute the box around the vertices
+     * 
+     */
+    void ComputeBounds();
+
+    /**
+     * @brief Report the size of the arrays to the MemoryTracker
+     * 
+     */
+    void Track();
+
+    /**
+     * @brief Withdraw the size reported by Track from the MemoryTracker
+     * 
+     */
+    void Untrack();
+
   public:
     /**
      * @brief Construct a new Mesh object
@@ -49,11 +76,26 @@ namespace elgar {
     );
 
     /**
-     * @brief Destroy the Mesh object
+     * @brief Construct a new Mesh object as a copy of another
+     * 
+     * @param mesh    The Mesh to copy
+     */
+    Mesh(const Mesh &mesh);
+
+    /**
+     * @brief Destroy the Mesh object (releases any geometry cached by the MeshRenderer)
      * 
      */
     virtual ~Mesh();
 
+    /**
+     * @brief Copy the contents of another Mesh into this one
+     * 
+     * @param mesh    The Mesh to copy
+     * @return Reference to this Mesh
+     */
+    Mesh &operator =(const Mesh &mesh);
+
     /**
      * @brief Get the vertices of the Mesh as a reference
      * 
@@ -75,6 +117,21 @@ namespace elgar {
      */
     const std::vector<const Texture *> &GetTextures() const;
 
+    /**
+     * @brief Get the local space box around the vertices of the Mesh (used for culling)
+     * 
+     * @return Reference to the bounds of the Mesh
+     */
+    const AABB &GetBounds() const;
+
+    /**
+     * @brief Get the id the MeshRenderer caches the geometry of the Mesh under. Every Mesh gets a
+     *        fresh id, and so does a Mesh whose contents are replaced.
+     * 
+     * @return Reference to the id of the Mesh
+     */
+    const uint64_t &GetId() const;
+
   };
 
 }
@@ -41,6 +41,13 @@ namespace elgar {
       const GLubyte &a = 0
     );
 
+    /**
+     * @brief Construct a copy of another RGBA object
+     * 
+     * @param color The color to copy
+     */
+    RGBA(const RGBA &color);
+
     /**
      * @brief Destroy the RGBA object
      * 
@@ -10,6 +10,7 @@
 // INCLUDES //
 
 #include <GL/glew.h>
+#include <cstddef>
 
 #include "elgar/graphics/data/Image.hpp"
 
@@ -50,6 +51,8 @@ namespace elgar {
     GLsizei m_width;          // The width in pixels
     GLsizei m_height;         // The height in pixels
 
+    size_t  m_bytes;          // Estimated storage as reported to the MemoryTracker
+
   public:
     /**
      * @brief       Builds a new Texture from Image data
@@ -119,6 +122,13 @@ namespace elgar {
      */
     const GLsizei &GetHeight() const;
 
+    /**
+     * @brief Get the OpenGL id of the Texture
+     * 
+     * @return Reference to the texture id
+     */
+    const GLuint &GetId() const;
+
     /**
      * @brief Get the type of the Texture
      * 
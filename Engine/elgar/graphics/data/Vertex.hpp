@@ -24,6 +24,16 @@ namespace elgar {
     glm::vec2 uv;           // The texture coordinates for the vertex
   };
 
+  /**
+   * @brief A TextVertex is a single corner of a glyph quad, already transformed into world space
+   * 
+   */
+  struct TextVertex {
+    glm::vec3 pos;          // The position of the vertex
+    glm::vec2 uv;           // The atlas coordinates for the vertex
+    glm::vec4 color;        // The color of the glyph
+  };
+
 };
 
 #endif
\ No newline at end of file
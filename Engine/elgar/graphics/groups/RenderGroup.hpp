@@ -7,17 +7,238 @@
 #ifndef _ELGAR_RENDER_GROUP_HPP_
 #define _ELGAR_RENDER_GROUP_HPP_
 
+// INCLUDES //
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "elgar/graphics/groups/RenderLayer.hpp"
+#include "elgar/graphics/data/Mesh.hpp"
+#include "elgar/graphics/data/RGBA.hpp"
+#include "elgar/graphics/data/Texture.hpp"
+#include "elgar/graphics/Shader.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace elgar {
 
   /**
    * @brief A RenderGroup is a collection of Renderables that are to be drawn under the same
-   *        rules and shader programs.
-   * 
+   *        rules and shader programs. Draws are queued with a 64-bit sort key (layer, translucency,
+   *        shader, texture and depth) and submitted to the renderers in state-minimizing order when
+   *        the group is flushed.
+   *
    */
   class RenderGroup {
+  private:
+    /**
+     * @brief The RenderCommandType enum lists the renderer calls a RenderGroup can queue
+     *
+     */
+    enum RenderCommandType {
+      RENDER_COMMAND_SPRITE,              // SpriteRenderer::Draw
+      RENDER_COMMAND_SPRITE_INSTANCED,    // SpriteRenderer::DrawInstanced
+      RENDER_COMMAND_MESH,                // MeshRenderer::Draw
+      RENDER_COMMAND_MESH_INSTANCED,      // MeshRenderer::DrawInstanced
+      RENDER_COMMAND_TEXT                 // TextRenderer::Submit
+    };
+
+    /**
+     * @brief A RenderCommand holds the arguments of a single queued renderer call
+     *
+     */
+    struct RenderCommand {
+      RenderCommandType type;       // Which renderer call to make
+      const Shader      *shader;    // The shader program to draw with
+      const Texture     *texture;   // The texture to draw with (sprites only)
+      const Mesh        *mesh;      // The mesh to draw (meshes only)
+      const std::vector<glm::mat4> *models;   // The instance transforms (instanced calls only)
+      glm::mat4         model;      // The model matrix (non-instanced calls only)
+      RGBA              color;      // The color to draw with
+      GLuint            text;       // Index of the string to draw (text only)
+      GLfloat           scale;      // The text scale (text only)
+    };
+
+  private:
+    glm::mat4 m_view_matrix;    // View matrix used to compute the depth of each command
+
+    std::vector<RenderCommand>  m_commands;   // Commands queued since the last flush
+    std::vector<std::string>    m_text;       // Strings referenced by queued text commands
+
+    std::vector<std::pair<GLuint64, GLuint>>  m_keys;     // Sort key and command index of each command
+    std::vector<std::pair<GLuint64, GLuint>>  m_scratch;  // Scratch space for the radix sort
+    std::vector<glm::mat4>  m_batch;    // Model matrices of consecutive sprites merged into one draw
+
+    GLsizei m_draw_count;   // Number of renderer calls made by the last flush
+
+  private:
+    /**
+     * @brief Build the sort key for a command and queue it
+     *
+     * @param command     The command to queue
+     * @param layer       The layer to draw the command in
+     * @param translucent Whether the command must be blended (sorted back to front)
+     * @param position    World position used for the depth of the command
+     */
+    void Queue(
+      const RenderCommand &command,
+      const GLubyte &layer,
+      const bool &translucent,
+      const glm::vec3 &position
+    );
+
+    /**
+     * @brief Sort the queued keys with an LSD radix sort (bytes shared by every key are skipped)
+     *
+     */
+    void Sort();
+
+  public:
+    /**
+     * @brief Construct a new RenderGroup object
+     *
+     */
+    RenderGroup();
+
+    /**
+     * @brief Destroy the RenderGroup object
+     *
+     */
+    virtual ~RenderGroup();
+
+    /**
+     * @brief Set the view matrix used to compute the depth of queued commands (defaults to identity)
+     *
+     * @param view  The view matrix of the camera the group will be drawn with
+     */
+    void SetViewMatrix(const glm::mat4 &view);
+
+    /**
+     * @brief Queue a Sprite
+     *
+     * @param shader      The shader program to use for drawing
+     * @param model       The model matrix for the sprite
+     * @param color       The color to draw the sprite with
+     * @param texture     The texture to use for the sprite (nullptr to draw without texture)
+     * @param layer       The layer to draw the sprite in
+     * @param translucent Set if the texture has transparency (implied by a color alpha below 255)
+     */
+    void SubmitSprite(
+      const Shader &shader,
+      const glm::mat4 &model,
+      const RGBA &color,
+      const Texture *texture,
+      const RenderLayer &layer = RENDER_LAYER_WORLD,
+      const bool &translucent = false
+    );
+
+    /**
+     * @brief Queue a set of instanced Sprites (models must stay alive until the group is flushed)
+     *
+     * @param shader      The shader program to use (must be compatible with instancing)
+     * @param models      The set of model matrices for each sprite
+     * @param color       The color to draw the sprites with
+     * @param texture     The texture to draw each sprite with
+     * @param layer       The layer to draw the sprites in
+     * @param translucent Set if the texture has transparency (implied by a color alpha below 255)
+     */
+    void SubmitSpriteInstanced(
+      const Shader &shader,
+      const std::vector<glm::mat4> &models,
+      const RGBA &color,
+      const Texture *texture,
+      const RenderLayer &layer = RENDER_LAYER_WORLD,
+      const bool &translucent = false
+    );
+
+    /**
+     * @brief Queue a Mesh (the mesh must stay alive until the group is flushed)
+     *
+     * @param mesh        The mesh to draw
+     * @param shader      The shader program to use
+     * @param color       The color of the mesh
+     * @param model       The model matrix of the mesh
+     * @param layer       The layer to draw the mesh in
+     * @param translucent Set if the mesh has transparency (implied by a color alpha below 255)
+     */
+    void SubmitMesh(
+      const Mesh &mesh,
+      const Shader &shader,
+      const RGBA &color,
+      const glm::mat4 &model,
+      const RenderLayer &layer = RENDER_LAYER_WORLD,
+      const bool &translucent = false
+    );
+
+    /**
+     * @brief Queue a set of instanced Meshes (mesh and models must stay alive until the group is flushed)
+     *
+     * @param mesh        The mesh to draw
+     * @param shader      The shader program to use (must be compatible with instancing)
+     * @param color       The color of the meshes
+     * @param models      The set of model matrices for each mesh
+     * @param layer       The layer to draw the meshes in
+     * @param translucent Set if the mesh has transparency (implied by a color alpha below 255)
+     */
+    void SubmitMeshInstanced(
+      const Mesh &mesh,
+      const Shader &shader,
+      const RGBA &color,
+      const std::vector<glm::mat4> &models,
+      const RenderLayer &layer = RENDER_LAYER_WORLD,
+      const bool &translucent = false
+    );
+
+    /**
+     * @brief Queue a string of text (text is always blended, so it is sorted back to front)
+     *
+     * @param shader    The shader to use
+     * @param text      The text to draw
+     * @param color     The color of the text
+     * @param model     The model matrix for the textbox
+     * @param scale     The space between letters (defaults to 1.0f)
+     * @param layer     The layer to draw the text in
+     */
+    void SubmitText(
+      const Shader &shader,
+      const std::string &text,
+      const RGBA &color,
+      const glm::mat4 &model,
+      const GLfloat &scale = 1.0f,
+      const RenderLayer &layer = RENDER_LAYER_UI
+    );
+
+    /**
+     * @brief Sort every queued command and submit it to the renderers
+     *
+     */
+    void Flush();
+
+    /**
+     * @brief Drop every queued command without drawing
+     *
+     */
+    void Clear();
+
+    /**
+     * @brief Get the number of commands waiting to be flushed
+     *
+     * @return The number of queued commands
+     */
+    GLsizei GetCommandCount() const;
+
+    /**
+     * @brief Get the number of renderer calls made by the last flush (consecutive sprites sharing
+     *        a shader, texture and color are merged into one instanced call)
+     *
+     * @return The number of renderer calls
+     */
+    const GLsizei &GetDrawCount() const;
 
   };
-  
+
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -10,11 +10,16 @@
 namespace elgar {
 
   /**
-   * @brief A RenderLayer is a set of Renderables that will all be drawn at the same time.
+   * @brief A RenderLayer is a set of Renderables that will all be drawn at the same time. Layers are
+   *        drawn in ascending order, so any value from 0 to 255 may be used to slot in between the
+   *        named layers.
    * 
    */
-  class RenderLayer {
-
+  enum RenderLayer {
+    RENDER_LAYER_BACKGROUND = 0,      // Skyboxes, backdrops
+    RENDER_LAYER_WORLD      = 64,     // The scene itself
+    RENDER_LAYER_EFFECTS    = 128,    // Particles and other effects drawn over the scene
+    RENDER_LAYER_UI         = 192     // Interface elements drawn over everything
   };
   
 }
@@ -9,17 +9,253 @@
 
 // INCLUDES //
 
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "elgar/graphics/data/Mesh.hpp"
+#include "elgar/graphics/data/RGBA.hpp"
+#include "elgar/graphics/data/Texture.hpp"
+#include "elgar/graphics/Shader.hpp"
+
+#include <cstddef>
+#include <vector>
+
+// DEFINES //
+
+#define TRANSFORM_NODE_NONE   0xFFFFFFFF    // No node (the parent of a root node)
+
 namespace elgar {
 
+  typedef GLuint TransformNode;   // Handle to a node of a TransformationGroup
+
   /**
-   * @brief A TransformationGroup is a set of Renderables whose transforms are all relative to 
+   * @brief A TransformationGroup is a set of Renderables whose transforms are all relative to
    *        the group transform. This is useful for composing Renderables of other Renderables.
-   * 
+   *
+   *        Nodes are stored breadth-first in flat arrays (parents always come before their
+   *        children) with a parent index and a dirty flag each. Update only recomputes the world
+   *        matrices of nodes whose local transform changed and of their descendants. The world
+   *        matrices are contiguous, so they can be handed straight to the instanced draw calls.
+   *
    */
   class TransformationGroup {
+  private:
+    glm::mat4 m_group_transform;    // Transform every root node is relative to
+
+    // Per node data, indexed by slot (breadth-first order)
+    std::vector<GLuint>     m_parents;    // Slot of the parent (TRANSFORM_NODE_NONE for roots)
+    std::vector<glm::mat4>  m_local;      // Transform relative to the parent
+    std::vector<glm::mat4>  m_world;      // Transform relative to the world
+    std::vector<GLubyte>    m_dirty;      // Set if the world transform must be recomputed
+    std::vector<TransformNode> m_nodes;   // Handle of the node in each slot (TRANSFORM_NODE_NONE if destroyed)
+
+    // Per handle data
+    std::vector<GLuint>         m_slots;        // Slot of each handle (TRANSFORM_NODE_NONE if free)
+    std::vector<TransformNode>  m_free_nodes;   // Handles ready for reuse
+
+    GLuint  m_first_dirty;    // Lowest dirty slot (TRANSFORM_NODE_NONE if nothing is dirty)
+    bool    m_reorder;        // Set if the slots are no longer breadth-first or have holes
+    size_t  m_node_count;     // Number of live nodes
+    size_t  m_update_count;   // Number of world transforms recomputed by the last update
+
+  private:
+    /**
+     * @brief Get the slot of a node and make sure it is alive
+     *
+     * @param node  The node
+     * @return The slot
+     */
+    GLuint GetSlot(const TransformNode &node) const;
+
+    /**
+     * @brief Flag a slot for recomputation
+     *
+     * @param slot  The slot
+     */
+    void MarkDirty(const GLuint &slot);
+
+    /**
+     * @brief Drop destroyed slots and put the rest back in breadth-first order
+     *
+     */
+    void Reorder();
+
+  public:
+    /**
+     * @brief Construct a new TransformationGroup object
+     *
+     * @param transform   The group transform (defaults to identity)
+     */
+    TransformationGroup(const glm::mat4 &transform = glm::mat4(1.0f));
+
+    /**
+     * @brief Destroy the TransformationGroup object
+     *
+     */
+    virtual ~TransformationGroup();
+
+    /**
+     * @brief Add a node to the group
+     *
+     * @param parent  The parent node (TRANSFORM_NODE_NONE to add a root node)
+     * @param local   The transform of the node relative to its parent
+     * @return The new node
+     */
+    TransformNode CreateNode(
+      const TransformNode &parent = TRANSFORM_NODE_NONE,
+      const glm::mat4 &local = glm::mat4(1.0f)
+    );
+
+    /**
+     * @brief Remove a node and all of its descendants from the group
+     *
+     * @param node  The node
+     */
+    void DestroyNode(const TransformNode &node);
+
+    /**
+     * @brief Check if a node belongs to the group
+     *
+     * @param node  The node
+     * @return True if the node is alive, false otherwise
+     */
+    bool IsAlive(const TransformNode &node) const;
+
+    /**
+     * @brief Attach a node (and its descendants) to another parent
+     *
+     * @param node    The node
+     * @param parent  The new parent (TRANSFORM_NODE_NONE to make the node a root)
+     */
+    void SetParent(const TransformNode &node, const TransformNode &parent);
+
+    /**
+     * @brief Get the parent of a node
+     *
+     * @param node  The node
+     * @return The parent (TRANSFORM_NODE_NONE for root nodes)
+     */
+    TransformNode GetParent(const TransformNode &node) const;
+
+    /**
+     * @brief Set the transform of a node relative to its parent
+     *
+     * @param node    The node
+     * @param local   The transform
+     */
+    void SetLocalTransform(const TransformNode &node, const glm::mat4 &local);
+
+    /**
+     * @brief Set the transform of a node relative to its parent
+     *
+     * @param node      The node
+     * @param position  The position
+     * @param scale     The scale
+     * @param rotation  The Euler angles
+     */
+    void SetLocalTransform(
+      const TransformNode &node,
+      const glm::vec3 &position,
+      const glm::vec3 &scale,
+      const glm::vec3 &rotation
+    );
+
+    /**
+     * @brief Get the transform of a node relative to its parent
+     *
+     * @param node  The node
+     * @return The transform
+     */
+    const glm::mat4 &GetLocalTransform(const TransformNode &node) const;
+
+    /**
+     * @brief Get the transform of a node relative to the world (as of the last update)
+     *
+     * @param node  The node
+     * @return The transform
+     */
+    const glm::mat4 &GetWorldTransform(const TransformNode &node) const;
+
+    /**
+     * @brief Set the transform every root node is relative to
+     *
+     * @param transform   The transform
+     */
+    void SetGroupTransform(const glm::mat4 &transform);
+
+    /**
+     * @brief Get the transform every root node is relative to
+     *
+     * @return The transform
+     */
+    const glm::mat4 &GetGroupTransform() const;
+
+    /**
+     * @brief Recompute the world transforms of every changed node and its descendants
+     *
+     */
+    void Update();
+
+    /**
+     * @brief Get the world transforms of every node in breadth-first order (valid until the
+     *        group changes shape, see GetNodeIndex)
+     *
+     * @return The world transforms (GetNodeCount of them)
+     */
+    const glm::mat4 *GetWorldTransforms() const;
+
+    /**
+     * @brief Get the index of a node in GetWorldTransforms (changes when nodes are created,
+     *        destroyed or reparented)
+     *
+     * @param node  The node
+     * @return The index
+     */
+    GLuint GetNodeIndex(const TransformNode &node) const;
+
+    /**
+     * @brief Copy the world transforms of some of the nodes (e.g. every node sharing a mesh)
+     *
+     * @param nodes     The nodes
+     * @param count     The number of nodes
+     * @param matrices  Filled with count world transforms
+     */
+    void GatherWorldTransforms(const TransformNode *nodes, const size_t &count, glm::mat4 *matrices) const;
+
+    /**
+     * @brief Update the group and draw a sprite at every node with one instanced draw call
+     *
+     * @param shader    The shader program to use (must be compatible with instancing)
+     * @param color     The color to draw the sprites with
+     * @param texture   The texture to draw each sprite with
+     */
+    void DrawSprites(const Shader &shader, const RGBA &color, const Texture *texture);
+
+    /**
+     * @brief Update the group and draw a mesh at every node with one instanced draw call
+     *
+     * @param mesh    The mesh to draw
+     * @param shader  The shader program to use (must be compatible with instancing)
+     * @param color   The color of the meshes
+     */
+    void DrawMeshes(const Mesh &mesh, const Shader &shader, const RGBA &color);
+
+    /**
+     * @brief Get the number of nodes in the group
+     *
+     * @return The number of nodes
+     */
+    const size_t &GetNodeCount() const;
+
+    /**
+     * @brief Get the number of world transforms recomputed by the last update
+     *
+     * @return The number of recomputed transforms
+     */
+    const size_t &GetUpdateCount() const;
 
   };
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -25,10 +25,24 @@
 
 #include "elgar/graphics/buffers/VertexArrayObject.hpp"
 #include "elgar/graphics/buffers/BufferObject.hpp"
+#include "elgar/graphics/buffers/BufferAllocator.hpp"
+#include "elgar/graphics/buffers/StreamBufferObject.hpp"
 #include "elgar/graphics/data/RGBA.hpp"
+#include "elgar/graphics/renderers/RendererUniforms.hpp"
+#include "elgar/graphics/Camera.hpp"
+#include "elgar/physics/Culling.hpp"
+
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 // DEFINES //
 
+#define MESH_RENDERER_VERTEX_CAPACITY   (MESH_MAX_VERTEX_COUNT * 16)  // Number of vertices the mesh cache starts with
+#define MESH_RENDERER_INDEX_CAPACITY    (MESH_MAX_VERTEX_COUNT * 48)  // Number of indices the mesh cache starts with
+#define MESH_RENDERER_GROWTH_LIMIT      8       // Most the mesh cache may grow to (multiple of the starting capacity)
+#define MESH_RENDERER_INSTANCE_CAPACITY 4096    // Number of model matrices per instance buffer region
 
 namespace elgar {
 
@@ -38,10 +52,46 @@ namespace elgar {
    */
   class MeshRenderer : public Singleton<MeshRenderer> {
   friend class Engine;    // Allow Engine to instantiate
+  friend class Mesh;      // Allow Meshes to release their cached geometry
+  friend class RenderThread;  // Allow the render thread to close off frames
+  friend class CommandList;   // Allow recorded draws to skip culling a second time
+  private:
+    /**
+     * @brief The MeshAllocation struct records where a Mesh lives in the shared buffers
+     * 
+     */
+    struct MeshAllocation {
+      GLint   base_vertex;    // Offset of the first vertex in the vertex buffer
+      GLsizei vertex_count;   // Number of vertices allocated
+      GLint   first_index;    // Offset of the first index in the element buffer
+      GLsizei index_count;    // Number of indices allocated
+    };
+
   private:
     VertexArrayObject m_vao;    // The Mesh VAO
-    BufferObject      m_vbo;    // The vertex buffer object
-    BufferObject      m_ebo;    // The element array buffer object
+    BufferObject      m_vbo;    // The vertex buffer object (shared by all meshes)
+    BufferObject      m_ebo;    // The element array buffer object (shared by all meshes)
+
+    BufferAllocator   m_vertex_allocator;   // Hands out ranges of the vertex buffer
+    BufferAllocator   m_index_allocator;    // Hands out ranges of the element buffer
+
+    StreamBufferObject  m_instance_buffer;  // Ring buffer to stream instanced model matrices through
+
+    RendererUniformCache  m_uniforms;   // Uniform handles of each shader drawn with
+
+    std::unordered_map<uint64_t, MeshAllocation> m_resident_meshes;   // Meshes uploaded to the GPU (by id)
+    std::unordered_set<uint64_t> m_rejected_meshes;   // Meshes that did not fit (reported once each)
+
+    GLsizeiptr              m_frame_upload_bytes;   // Bytes uploaded during the current frame (render thread)
+    std::atomic<GLsizeiptr> m_last_upload_bytes;    // Bytes uploaded during the last presented frame
+
+    const Camera            *m_culling_camera;  // Camera instances are culled against (nullptr to draw everything)
+    std::vector<uint32_t>   m_visible_indices;  // Indices of the instances that survived culling
+    std::vector<glm::mat4>  m_visible_models;   // Model matrices of the instances that survived culling
+
+    size_t    m_frame_tested;     // Instances tested during the current frame (main thread)
+    size_t    m_frame_culled;     // Instances culled during the current frame (main thread)
+    CullStats m_last_cull_stats;  // Culling counts of the last completed frame (main thread)
 
   private:
     /**
@@ -57,11 +107,85 @@ namespace elgar {
     virtual ~MeshRenderer();
 
     /**
-     * @brief Helper function for registering mesh data with the GPU
+     * @brief Helper function for registering mesh data with the GPU. Meshes are only uploaded the
+     *        first time they are seen and stay resident until they are destroyed.
      * 
      * @param mesh The Mesh to register
+     * @return Pointer to the allocation of the Mesh, or nullptr if the cache is full
+     */
+    const MeshAllocation *RegisterMesh(const Mesh &mesh);
+
+    /**
+     * @brief Reallocate one of the shared buffers with room for at least size more elements. The
+     *        buffer keeps its name (so the VAO still points at it) and its resident contents.
+     * 
+     * @param buffer        The buffer to grow
+     * @param target        The binding point of the buffer
+     * @param allocator     The allocator handing out ranges of the buffer
+     * @param element_size  The size in bytes of one element
+     * @param size          The number of elements that did not fit
+     * @param limit         The most elements the buffer may hold
+     * @return True if the buffer grew, false if it would pass the limit
+     */
+    bool GrowBuffer(
+      const BufferObject &buffer,
+      const GLenum &target,
+      BufferAllocator &allocator,
+      const GLsizeiptr &element_size,
+      const GLsizei &size,
+      const GLsizei &limit
+    );
+
+    /**
+     * @brief Give the buffer ranges held by a Mesh back to the cache. The release is deferred to
+     *        the render thread until the frames that may still draw the Mesh have been presented.
+     * 
+     * @param id The id of the Mesh being destroyed or overwritten
+     */
+    void ReleaseMesh(const uint64_t &id);
+
+    /**
+     * @brief Bind the textures of a Mesh to consecutive texture units
+     * 
+     * @param mesh      The Mesh whose textures to bind
+     * @param shader    The shader program being drawn with
+     * @param uniforms  The uniform handles of the shader
+     */
+    void BindTextures(const Mesh &mesh, const Shader &shader, const RendererUniforms &uniforms) const;
+
+    /**
+     * @brief Drop the instances of a Mesh outside the view of the culling camera
+     * 
+     * @param mesh    The mesh being drawn
+     * @param models  The model matrices of the instances
+     * @param count   The number of instances (updated to the number of visible instances)
+     * @return The model matrices of the visible instances
+     */
+    const glm::mat4 *Cull(const Mesh &mesh, const glm::mat4 *models, size_t &count);
+
+    /**
+     * @brief Stream instances of a Mesh through the instance ring without culling or recording
+     * 
+     * @param mesh    The mesh to draw using instanced rendering
+     * @param shader  The shader program to use
+     * @param color   The colors of the mesh
+     * @param models  The matrices to use
+     * @param count   The number of matrices
      */
-    void RegisterMesh(const Mesh &mesh) const;
+    void DrawInstancedVisible(const Mesh &mesh, const Shader &shader, const RGBA &color, const glm::mat4 *models, const size_t &count);
+
+    /**
+     * @brief Close off the per frame upload counters (called wherever the frame was presented)
+     * 
+     */
+    void EndFrame();
+
+    /**
+     * @brief Close off the per frame culling counters. Culling runs wherever the frame is recorded,
+     *        so this is called on the main thread in both rendering modes.
+     * 
+     */
+    void EndCullFrame();
 
   public:
     /**
@@ -72,18 +196,60 @@ namespace elgar {
      * @param color   The color of the mesh
      * @param model   The model matrix to translate mesh by
      */
-    void Draw(const Mesh &mesh, const Shader &shader, const RGBA &color, const glm::mat4 &model) const;
+    void Draw(const Mesh &mesh, const Shader &shader, const RGBA &color, const glm::mat4 &model);
 
     /**
-     * @brief Draw a Mesh repeatedly using instanced rendering
+     * @brief Draw a Mesh repeatedly using instanced rendering (one draw call per instance buffer region)
      * 
      * @param mesh    The mesh to draw using instanced rendering
      * @param shader  The shader program to use
      * @param color   The colors of the mesh
      * @param models  The set of matrices to use
      */
-    void DrawInstanced(const Mesh &mesh, const Shader &shader, const RGBA &color, const std::vector<glm::mat4> &models) const;
-    
+    void DrawInstanced(const Mesh &mesh, const Shader &shader, const RGBA &color, const std::vector<glm::mat4> &models);
+
+    /**
+     * @brief Draw a Mesh repeatedly using instanced rendering (one draw call per instance buffer region,
+     *        only the instances in view of the culling camera are drawn)
+     * 
+     * @param mesh    The mesh to draw using instanced rendering
+     * @param shader  The shader program to use
+     * @param color   The colors of the mesh
+     * @param models  The matrices to use
+     * @param count   The number of matrices
+     */
+    void DrawInstanced(const Mesh &mesh, const Shader &shader, const RGBA &color, const glm::mat4 *models, const size_t &count);
+
+    /**
+     * @brief Get the number of bytes of mesh data uploaded to the GPU during the last presented
+     *        frame (safe to call while the render thread runs)
+     * 
+     * @return The number of bytes uploaded
+     */
+    GLsizeiptr GetUploadedBytes() const;
+
+    /**
+     * @brief Set the Camera instanced meshes are culled against. Instances are bounded by the
+     *        sphere around the bounds of their Mesh, scaled by their model matrix.
+     * 
+     * @param camera  The camera (must outlive its use here, nullptr to disable culling)
+     */
+    void SetCullingCamera(const Camera *camera);
+
+    /**
+     * @brief Get the Camera instanced meshes are culled against
+     * 
+     * @return The camera (nullptr if culling is disabled)
+     */
+    const Camera *GetCullingCamera() const;
+
+    /**
+     * @brief Get the culling counts of the last recorded frame (main thread only)
+     * 
+     * @return Reference to the counts
+     */
+    const CullStats &GetCullStats() const;
+
   };
 
 }
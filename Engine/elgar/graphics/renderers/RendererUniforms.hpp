@@ -0,0 +1,67 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_RENDERER_UNIFORMS_HPP_
+#define _ELGAR_RENDERER_UNIFORMS_HPP_
+
+// INCLUDES //
+
+#include <GL/glew.h>
+
+#include "elgar/graphics/Shader.hpp"
+
+#include <unordered_map>
+
+namespace elgar {
+
+  /**
+   * @brief The RendererUniforms struct holds the handles of the uniforms every renderer sets per draw
+   * 
+   */
+  struct RendererUniforms {
+    GLint use_texture;      // Handle of "use_texture"
+    GLint use_instancing;   // Handle of "use_instancing"
+    GLint color;            // Handle of "color"
+    GLint model_matrix;     // Handle of "model_matrix"
+  };
+
+  /**
+   * @brief The RendererUniformCache class resolves the RendererUniforms of each shader program once,
+   *        so draws never look uniforms up by name
+   * 
+   */
+  class RendererUniformCache {
+  private:
+    std::unordered_map<GLuint, RendererUniforms> m_handles;   // Handles of each program seen so far
+
+    GLuint            m_last_program;   // The program looked up most recently (0 if none)
+    RendererUniforms  m_last_handles;   // Its handles (consecutive draws skip the map)
+
+  public:
+    /**
+     * @brief Construct a new RendererUniformCache object
+     * 
+     */
+    RendererUniformCache();
+
+    /**
+     * @brief Destroy the RendererUniformCache object
+     * 
+     */
+    virtual ~RendererUniformCache();
+
+    /**
+     * @brief Get the handles of a shader program, resolving them the first time it is seen
+     * 
+     * @param shader  The shader program
+     * @return Reference to the handles
+     */
+    const RendererUniforms &Get(const Shader &shader);
+  };
+
+}
+
+#endif
@@ -12,14 +12,23 @@
 #include "elgar/core/Singleton.hpp"
 #include "elgar/graphics/buffers/VertexArrayObject.hpp"
 #include "elgar/graphics/buffers/BufferObject.hpp"
+#include "elgar/graphics/buffers/StreamBufferObject.hpp"
 
 #include "elgar/graphics/data/Texture.hpp"
 #include "elgar/graphics/data/RGBA.hpp"
+#include "elgar/graphics/Camera.hpp"
 #include "elgar/graphics/Shader.hpp"
+#include "elgar/graphics/renderers/RendererUniforms.hpp"
+#include "elgar/physics/Culling.hpp"
 
 #include <glm/glm.hpp>
 #include <vector>
 
+// DEFINES //
+
+#define SPRITE_RENDERER_INSTANCE_CAPACITY   16384   // Number of model matrices per instance buffer region
+#define SPRITE_RENDERER_BOUNDING_RADIUS     0.70710678f   // Radius of the sphere around the unit quad
+
 namespace elgar {
   
   /**
@@ -28,10 +37,23 @@ namespace elgar {
    */
   class SpriteRenderer : public Singleton<SpriteRenderer> {
   friend class Engine;
+  friend class CommandList;   // Allow recorded draws to skip culling a second time
+  friend class RenderThread;  // Allow the render thread to close off frames
   private:
     VertexArrayObject m_vao;              // The VAO for the Sprite Renderer
     BufferObject      m_vertex_buffer;    // Buffer to store the vertex data of a Sprite
     BufferObject      m_uv_buffer;        // Buffer to store the uv data of a Sprite
+    StreamBufferObject  m_instance_buffer;  // Ring buffer to stream instanced model matrices through
+
+    RendererUniformCache  m_uniforms;   // Uniform handles of each shader drawn with
+
+    const Camera            *m_culling_camera;  // Camera instances are culled against (nullptr to draw everything)
+    std::vector<uint32_t>   m_visible_indices;  // Indices of the instances that survived culling
+    std::vector<glm::mat4>  m_visible_models;   // Model matrices of the instances that survived culling
+
+    size_t    m_frame_tested;     // Instances tested during the current frame (main thread)
+    size_t    m_frame_culled;     // Instances culled during the current frame (main thread)
+    CullStats m_last_cull_stats;  // Culling counts of the last completed frame (main thread)
 
   private:
     /**
@@ -46,6 +68,39 @@ namespace elgar {
      */
     virtual ~SpriteRenderer();
 
+    /**
+     * @brief Drop the instances outside the view of the culling camera
+     * 
+     * @param models  The model matrices of the instances
+     * @param count   The number of instances (updated to the number of visible instances)
+     * @return The model matrices of the visible instances
+     */
+    const glm::mat4 *Cull(const glm::mat4 *models, size_t &count);
+
+    /**
+     * @brief Stream a set of sprites through the instance ring without culling or recording
+     * 
+     * @param shader    The shader program to use (must be compatible with instancing)
+     * @param models    The model matrices for each sprite
+     * @param count     The number of model matrices
+     * @param color     The color to draw the sprites with
+     * @param texture   The texture to draw each sprite with
+     */
+    void DrawInstancedVisible(
+      const Shader &shader,
+      const glm::mat4 *models,
+      const size_t &count,
+      const RGBA &color,
+      const Texture *texture
+    );
+
+    /**
+     * @brief Close off the per frame culling counters. Culling runs wherever the frame is recorded,
+     *        so this is called on the main thread in both rendering modes.
+     * 
+     */
+    void EndCullFrame();
+
   public:
     /**
      * @brief Draws a Sprite to the screen
@@ -77,6 +132,46 @@ namespace elgar {
       const Texture *texture
     );
 
+    /**
+     * @brief Draw a set of sprites with a single draw call using Instancing (only the sprites
+     *        in view of the culling camera are drawn)
+     * 
+     * @param shader    The shader program to use (must be compatible with instancing)
+     * @param models    The model matrices for each sprite
+     * @param count     The number of model matrices
+     * @param color     The color to draw the sprites with
+     * @param texture   The texture to draw each sprite with
+     */
+    void DrawInstanced(
+      const Shader &shader,
+      const glm::mat4 *models,
+      const size_t &count,
+      const RGBA &color,
+      const Texture *texture
+    );
+
+    /**
+     * @brief Set the Camera instanced sprites are culled against. Sprites are bounded by the
+     *        sphere around the unit quad, scaled by their model matrix.
+     * 
+     * @param camera  The camera (must outlive its use here, nullptr to disable culling)
+     */
+    void SetCullingCamera(const Camera *camera);
+
+    /**
+     * @brief Get the Camera instanced sprites are culled against
+     * 
+     * @return The camera (nullptr if culling is disabled)
+     */
+    const Camera *GetCullingCamera() const;
+
+    /**
+     * @brief Get the culling counts of the last recorded frame (main thread only)
+     * 
+     * @return Reference to the counts
+     */
+    const CullStats &GetCullStats() const;
+
   };
 
 }
@@ -23,15 +23,24 @@
 #include "elgar/core/Singleton.hpp"
 #include "elgar/graphics/data/ASCII.hpp"
 #include "elgar/graphics/data/RGBA.hpp"
+#include "elgar/graphics/data/Texture.hpp"
+#include "elgar/graphics/data/Vertex.hpp"
 
 #include "elgar/graphics/buffers/VertexArrayObject.hpp"
-#include "elgar/graphics/buffers/BufferObject.hpp"
+#include "elgar/graphics/buffers/StreamBufferObject.hpp"
 #include "elgar/graphics/Shader.hpp"
+#include "elgar/graphics/renderers/RendererUniforms.hpp"
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
-#include <map>
+#include <vector>
+
+// DEFINES //
+
+#define TEXT_RENDERER_GLYPH_COUNT       128     // Number of code points in the alphabet
+#define TEXT_RENDERER_ATLAS_WIDTH       1024    // Width in pixels of the glyph atlas
+#define TEXT_RENDERER_VERTEX_CAPACITY   (6 * 4096)  // Vertices streamed per region (4096 glyphs)
 
 namespace elgar {
 
@@ -43,18 +52,24 @@ namespace elgar {
   friend class Engine;
   private:
     FT_Library  m_context;    // FreeType library context
-    std::map<GLchar, ASCII> m_ascii_table;    // Hash table of characters for performance
+    ASCII       m_ascii_table[TEXT_RENDERER_GLYPH_COUNT];   // Characters indexed by code point
+    GLsizei     m_glyph_count;    // Number of characters loaded into the atlas
+    Texture     *m_atlas;         // Every glyph of the bound font packed into one texture
+
+    VertexArrayObject   m_vao;            // VAO for the TextRenderer
+    StreamBufferObject  m_vertex_buffer;  // Ring the glyph quads are streamed through
+
+    RendererUniformCache  m_uniforms;   // Uniform handles of each shader drawn with
 
-    VertexArrayObject m_vao;            // VAO for the TextRenderer
-    BufferObject      m_vertex_buffer;  // VBO for the TextRenderer
-    BufferObject      m_uv_buffer;      // UV Buffer for the TextRenderer
+    std::vector<TextVertex> m_batch;      // Glyph quads submitted since the last flush
 
   private:
     /**
      * @brief Construct a new TextRenderer object
      * 
+     * @param library   An initialized FreeType library to take ownership of (nullptr to initialize one)
      */
-    TextRenderer();
+    TextRenderer(FT_Library library = nullptr);
 
     /**
      * @brief Destroy the TextRenderer object
@@ -68,6 +83,15 @@ namespace elgar {
      */
     void CleanTable();
 
+    /**
+     * @brief Rasterize a font into the glyph atlas (runs on the thread that owns the context)
+     * 
+     * @param path        The path to the ttf file
+     * @param size        The size of the font
+     * @return GLboolean  True if bind successful, false otherwise
+     */
+    GLboolean BuildAtlas(const std::string &path, const GLuint &size);
+
   public:
     /**
      * @brief Bind a font to render with at a given size
@@ -79,7 +103,7 @@ namespace elgar {
     GLboolean BindFont(const std::string &path, const GLuint &size);
 
     /**
-     * @brief Unbinds a font, freeing all ascii textures from memory (MUST BE DONE BEFORE A NEW BINDING)
+     * @brief Unbinds a font, freeing the glyph atlas from memory (MUST BE DONE BEFORE A NEW BINDING)
      * 
      */
     void UnbindFont();
@@ -99,7 +123,30 @@ namespace elgar {
     GLsizei GetAlphabetSize() const;
 
     /**
-     * @brief Draw a string of text to the screen
+     * @brief Queue a string of text to be drawn by the next Flush. Glyphs are transformed on the CPU
+     *        so any number of strings can share a single draw call.
+     * 
+     * @param text      The text to draw
+     * @param color     The color of the text 
+     * @param model     The model matrix for the textbox
+     * @param scale     The space between letters (defaults to 1.0f)
+     */
+    void Submit(
+      const std::string &text,
+      const RGBA &color,
+      const glm::mat4 &model,
+      const GLfloat &scale = 1.0f
+    );
+
+    /**
+     * @brief Draw all of the text submitted since the last flush
+     * 
+     * @param shader    The shader to use
+     */
+    void Flush(const Shader &shader);
+
+    /**
+     * @brief Draw a string of text to the screen (Submit followed by Flush)
      * 
      * @param shader    The shader to use
      * @param text      The text to draw
@@ -113,7 +160,7 @@ namespace elgar {
       const RGBA &color,
       const glm::mat4 &model,
       const GLfloat &scale = 1.0f
-    ) const;
+    );
 
   };
 
@@ -15,6 +15,7 @@ R""(
 layout (location = 0) in vec3 vertex_pos;           // The position of the vertex
 layout (location = 1) in vec2 vertex_uv;            // The texture uv for the vertex
 layout (location = 2) in mat4 vertex_model_matrix;  // The model matrix (for instancing only)
+layout (location = 6) in vec3 vertex_normal;        // The normal of the vertex (meshes only)
 
 // Vertex uniforms
 uniform mat4 projection_matrix;     // Screen specifications 
@@ -34,7 +35,8 @@ void main() {
     // Compute vertex position
     gl_Position = projection_matrix * view_matrix * model * vec4(vertex_pos, 1.0); 
 
-    // Send the uvs to the fragment
+    // Send the normals and uvs to the fragment
+    fragment_normal = mat3(model) * vertex_normal;
     fragment_uv = vertex_uv;
 }
 
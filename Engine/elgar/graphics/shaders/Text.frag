@@ -16,14 +16,14 @@ R""(
 layout (location = 0) out vec4 fragment_color;        // Output pixel color
 
 // Fragment uniforms
-uniform sampler2D   texture_sampler;        // The texture to sample from
-uniform vec4        color;                  // RGBA color to use    
+uniform sampler2D   texture_sampler;        // The glyph atlas to sample from
 
 // Inputs from vertex shader
 in vec2         fragment_uv;        // UV for sampling texture
+in vec4         fragment_rgba;      // RGBA color of the glyph
 
 void main() {
-  fragment_color = vec4(color.xyz, 1.0) * vec4(1.0, 1.0, 1.0, texture(texture_sampler, fragment_uv).r);
+  fragment_color = vec4(fragment_rgba.xyz, fragment_rgba.w * texture(texture_sampler, fragment_uv).r);
 }
 
 )""
\ No newline at end of file
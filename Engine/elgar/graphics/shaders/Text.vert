@@ -15,6 +15,7 @@ R""(
 // Vertex attributes
 layout (location = 0) in vec3 vertex_pos;           // The position of the vertex
 layout (location = 1) in vec2 vertex_uv;            // The texture uv for the vertex
+layout (location = 2) in vec4 vertex_color;         // The color of the glyph
 
 // Vertex uniforms
 uniform mat4 projection_matrix;     // Screen specifications 
@@ -23,6 +24,7 @@ uniform mat4 model_matrix;          // Model translations / rotations
 
 // Output to fragment shader
 out vec2 fragment_uv;
+out vec4 fragment_rgba;
 
 void main() {
   // Compute vertex position
@@ -30,6 +32,9 @@ void main() {
   
   // Send uv's to fragment shader
   fragment_uv = vertex_uv;
+
+  // Send color to fragment shader
+  fragment_rgba = vertex_color;
 }
 
 )""
\ No newline at end of file
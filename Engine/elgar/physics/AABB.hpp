@@ -0,0 +1,132 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_AABB_HPP_
+#define _ELGAR_AABB_HPP_
+
+// INCLUDES //
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace elgar {
+
+  /**
+   * @brief An AABB is an axis-aligned bounding box. 2D code can use it with a zero z extent.
+   *
+   */
+  struct AABB {
+    glm::vec3 min;    // Lower corner
+    glm::vec3 max;    // Upper corner
+
+    /**
+     * @brief Check if two boxes overlap (touching counts)
+     *
+     * @param other   The other box
+     * @return True if they overlap, false otherwise
+     */
+    bool Overlaps(const AABB &other) const {
+      return min.x <= other.max.x && max.x >= other.min.x &&
+             min.y <= other.max.y && max.y >= other.min.y &&
+             min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    /**
+     * @brief Check if a box lies entirely inside this one
+     *
+     * @param other   The other box
+     * @return True if contained, false otherwise
+     */
+    bool Contains(const AABB &other) const {
+      return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+             max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+    }
+
+    /**
+     * @brief Get half the surface area of the box (the cost metric of the surface area heuristic,
+     *        which reduces to the area of a 2D box)
+     *
+     * @return Half the surface area
+     */
+    float GetCost() const {
+      const glm::vec3 size = max - min;
+      return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    /**
+     * @brief Get the center of the box
+     *
+     * @return The center
+     */
+    glm::vec3 GetCenter() const {
+      return (min + max) * 0.5f;
+    }
+
+    /**
+     * @brief Get the half size of the box
+     *
+     * @return The half extents
+     */
+    glm::vec3 GetExtents() const {
+      return (max - min) * 0.5f;
+    }
+
+    /**
+     * @brief Build the smallest box holding two boxes
+     *
+     * @param a   The first box
+     * @param b   The second box
+     * @return The combined box
+     */
+    static AABB Combine(const AABB &a, const AABB &b) {
+      return AABB{glm::min(a.min, b.min), glm::max(a.max, b.max)};
+    }
+
+    /**
+     * @brief Clip a segment against the box (slab test)
+     *
+     * @param origin          Start of the segment
+     * @param inv_direction   One over the segment direction, per axis (infinite where the
+     *                        direction is zero)
+     * @param max_fraction    Only hits closer than this fraction of the direction count
+     * @param fraction        Filled with the entry fraction on a hit
+     * @return True if the segment hits the box, false otherwise
+     */
+    bool RayIntersect(
+      const glm::vec3 &origin,
+      const glm::vec3 &inv_direction,
+      const float &max_fraction,
+      float &fraction
+    ) const {
+      float enter = 0.0f;
+      float exit = max_fraction;
+
+      for (int axis = 0; axis < 3; axis++) {
+        // A segment parallel to the slab never crosses it (and 0 * inf would be NaN)
+        if (std::isinf(inv_direction[axis])) {
+          if (origin[axis] < min[axis] || origin[axis] > max[axis])
+            return false;
+
+          continue;
+        }
+
+        const float t1 = (min[axis] - origin[axis]) * inv_direction[axis];
+        const float t2 = (max[axis] - origin[axis]) * inv_direction[axis];
+
+        enter = std::max(enter, std::min(t1, t2));
+        exit = std::min(exit, std::max(t1, t2));
+      }
+
+      fraction = enter;
+      return enter <= exit;
+    }
+  };
+
+}
+
+#endif
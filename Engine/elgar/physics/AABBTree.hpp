@@ -0,0 +1,385 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_AABB_TREE_HPP_
+#define _ELGAR_AABB_TREE_HPP_
+
+// INCLUDES //
+
+#include <glm/glm.hpp>
+
+#include "elgar/physics/AABB.hpp"
+#include "elgar/physics/Frustum.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// DEFINES //
+
+#define AABB_TREE_NULL                      -1      // No node
+#define AABB_TREE_MARGIN                    0.1f    // Default padding around every proxy
+#define AABB_TREE_DISPLACEMENT_MULTIPLIER   4.0f    // How far ahead a moving proxy's box is stretched
+#define AABB_TREE_STACK_SIZE                256     // Nodes a query can stack before it allocates
+
+namespace elgar {
+
+  /**
+   * @brief An AABBTreeNode is a node of an AABBTree. Leaves hold a proxy, inner nodes always have
+   *        two children.
+   *
+   */
+  struct AABBTreeNode {
+    AABB      aabb;         // Fattened box of a leaf, union of the children otherwise
+    void      *user_data;   // Data handed out with the proxy (leaves only)
+    int32_t   parent;       // Parent node (next free node while in the free list)
+    int32_t   child1;       // First child (AABB_TREE_NULL for leaves)
+    int32_t   child2;       // Second child (AABB_TREE_NULL for leaves)
+    int32_t   height;       // 0 for leaves, -1 for free nodes
+    bool      moved;        // Set if the proxy moved since the last EnumeratePairs
+
+    bool IsLeaf() const {
+      return child1 == AABB_TREE_NULL;
+    }
+  };
+
+  /**
+   * @brief An AABBTree is a dynamic bounding volume hierarchy for culling and spatial queries.
+   *        Proxies are stored with a fattened box, so small moves do not touch the tree. Leaves
+   *        are inserted where the surface area heuristic says they are cheapest and the tree is
+   *        kept balanced with rotations. Nodes live in one contiguous pool and refer to each
+   *        other by index, so the tree can grow without invalidating proxies.
+   *
+   *        2D games can use it with boxes whose z extent is zero. A tree is not thread-safe, but
+   *        queries are const and may run from several threads while nothing modifies it.
+   *
+   */
+  class AABBTree {
+  private:
+    /**
+     * @brief A QueryStack is a stack of nodes that only allocates when a query goes deeper than
+     *        AABB_TREE_STACK_SIZE
+     *
+     */
+    class QueryStack {
+    private:
+      int32_t m_array[AABB_TREE_STACK_SIZE];    // The first nodes
+      std::vector<int32_t> m_overflow;          // Nodes past the array
+      size_t m_count;                           // Nodes on the stack
+
+    public:
+      QueryStack() : m_count(0) {}
+
+      void Push(const int32_t &node) {
+        if (m_count < AABB_TREE_STACK_SIZE)
+          m_array[m_count] = node;
+        else
+          m_overflow.push_back(node);
+
+        m_count++;
+      }
+
+      int32_t Pop() {
+        m_count--;
+
+        if (m_count < AABB_TREE_STACK_SIZE)
+          return m_array[m_count];
+
+        const int32_t node = m_overflow.back();
+        m_overflow.pop_back();
+        return node;
+      }
+
+      bool IsEmpty() const {
+        return m_count == 0;
+      }
+    };
+
+  private:
+    std::vector<AABBTreeNode> m_nodes;    // The node pool
+    std::vector<int32_t>      m_moved;    // Proxies created or moved since the last EnumeratePairs
+
+    int32_t m_root;         // The root node
+    int32_t m_free_list;    // First free node in the pool
+    size_t  m_proxy_count;  // Number of proxies in the tree
+    float   m_margin;       // Padding around every proxy
+
+  private:
+    /**
+     * @brief Take a node from the pool (grows the pool if needed)
+     *
+     * @return The node
+     */
+    int32_t AllocateNode();
+
+    /**
+     * @brief Return a node to the pool
+     *
+     * @param node  The node
+     */
+    void FreeNode(const int32_t &node);
+
+    /**
+     * @brief Insert a leaf next to its cheapest sibling and refit the ancestors
+     *
+     * @param leaf  The leaf
+     */
+    void InsertLeaf(const int32_t &leaf);
+
+    /**
+     * @brief Unlink a leaf from the tree and refit the ancestors
+     *
+     * @param leaf  The leaf
+     */
+    void RemoveLeaf(const int32_t &leaf);
+
+    /**
+     * @brief Rotate a node if its children's heights differ by more than one
+     *
+     * @param node  The node
+     * @return The node now in the place of the given node
+     */
+    int32_t Balance(const int32_t &node);
+
+    /**
+     * @brief Get a proxy node and make sure it is a live leaf
+     *
+     * @param proxy   The proxy
+     * @return The node
+     */
+    const AABBTreeNode &GetProxyNode(const int32_t &proxy) const;
+
+  public:
+    /**
+     * @brief Construct a new AABBTree object
+     *
+     * @param margin  Padding around every proxy (in world units)
+     */
+    AABBTree(const float &margin = AABB_TREE_MARGIN);
+
+    /**
+     * @brief Destroy the AABBTree object
+     *
+     */
+    virtual ~AABBTree();
+
+    /**
+     * @brief Add a proxy to the tree
+     *
+     * @param aabb        The tight box of the object
+     * @param user_data   Data handed out with the proxy (e.g. the object)
+     * @return The proxy
+     */
+    int32_t CreateProxy(const AABB &aabb, void *user_data);
+
+    /**
+     * @brief Remove a proxy from the tree
+     *
+     * @param proxy   The proxy
+     */
+    void DestroyProxy(const int32_t &proxy);
+
+    /**
+     * @brief Update the box of a proxy. Nothing happens while the tight box stays inside the fat
+     *        one.
+     *
+     * @param proxy         The proxy
+     * @param aabb          The new tight box
+     * @param displacement  How far the object moved since the last call (stretches the fat box
+     *                      in the direction of motion)
+     * @return True if the proxy was reinserted, false otherwise
+     */
+    bool MoveProxy(const int32_t &proxy, const AABB &aabb, const glm::vec3 &displacement = glm::vec3(0.0f));
+
+    /**
+     * @brief Get the data of a proxy
+     *
+     * @param proxy   The proxy
+     * @return The user data
+     */
+    void *GetUserData(const int32_t &proxy) const;
+
+    /**
+     * @brief Get the fattened box of a proxy
+     *
+     * @param proxy   The proxy
+     * @return The fattened box
+     */
+    const AABB &GetFatAABB(const int32_t &proxy) const;
+
+    /**
+     * @brief Find every proxy whose fat box overlaps a box
+     *
+     * @param aabb  The box
+     * @param func  Called as func(proxy) for every overlap, returns false to stop the query
+     */
+    template<typename F>
+    void QueryAABB(const AABB &aabb, F &&func) const {
+      if (m_root == AABB_TREE_NULL)
+        return;
+
+      QueryStack stack;
+      stack.Push(m_root);
+
+      while (!stack.IsEmpty()) {
+        const AABBTreeNode &node = m_nodes[stack.Pop()];
+
+        if (!node.aabb.Overlaps(aabb))
+          continue;
+
+        if (node.IsLeaf()) {
+          if (!func(int32_t(&node - m_nodes.data())))
+            return;
+        } else {
+          stack.Push(node.child1);
+          stack.Push(node.child2);
+        }
+      }
+    }
+
+    /**
+     * @brief Find every proxy whose fat box is hit by a segment
+     *
+     * @param origin        Start of the segment
+     * @param direction     The segment runs to origin + direction * max_fraction
+     * @param max_fraction  Fraction of the direction to search
+     * @param func          Called as func(proxy, max_fraction) for every hit, returns the new
+     *                      max fraction (the hit fraction to clip the segment, 0 to stop, or the
+     *                      given max fraction to go on)
+     */
+    template<typename F>
+    void RayCast(const glm::vec3 &origin, const glm::vec3 &direction, float max_fraction, F &&func) const {
+      if (m_root == AABB_TREE_NULL)
+        return;
+
+      const glm::vec3 inv_direction = glm::vec3(1.0f) / direction;
+
+      QueryStack stack;
+      stack.Push(m_root);
+
+      while (!stack.IsEmpty()) {
+        const AABBTreeNode &node = m_nodes[stack.Pop()];
+
+        float fraction;
+        if (!node.aabb.RayIntersect(origin, inv_direction, max_fraction, fraction))
+          continue;
+
+        if (node.IsLeaf()) {
+          max_fraction = func(int32_t(&node - m_nodes.data()), max_fraction);
+
+          if (max_fraction <= 0.0f)
+            return;
+        } else {
+          stack.Push(node.child1);
+          stack.Push(node.child2);
+        }
+      }
+    }
+
+    /**
+     * @brief Find every proxy whose fat box is at least partly inside a frustum. Subtrees that
+     *        are entirely inside are reported without testing their leaves.
+     *
+     * @param frustum   The frustum
+     * @param func      Called as func(proxy) for every visible proxy, returns false to stop
+     */
+    template<typename F>
+    void QueryFrustum(const Frustum &frustum, F &&func) const {
+      if (m_root == AABB_TREE_NULL)
+        return;
+
+      // Entries are node * 2, plus one once an ancestor was found entirely inside
+      QueryStack stack;
+      stack.Push(m_root << 1);
+
+      while (!stack.IsEmpty()) {
+        const int32_t entry = stack.Pop();
+        const AABBTreeNode &node = m_nodes[entry >> 1];
+
+        int32_t inside = entry & 1;
+        if (!inside) {
+          const FrustumTest test = frustum.TestAABB(node.aabb);
+
+          if (test == FRUSTUM_OUTSIDE)
+            continue;
+          inside = test == FRUSTUM_INSIDE;
+        }
+
+        if (node.IsLeaf()) {
+          if (!func(entry >> 1))
+            return;
+        } else {
+          stack.Push((node.child1 << 1) | inside);
+          stack.Push((node.child2 << 1) | inside);
+        }
+      }
+    }
+
+    /**
+     * @brief Find every pair of proxies whose fat boxes overlap where at least one of the two
+     *        was created or moved since the last call (every pair is reported once). Clears the
+     *        moved proxies.
+     *
+     * @param func  Called as func(proxy_a, proxy_b) with proxy_a < proxy_b
+     */
+    template<typename F>
+    void EnumeratePairs(F &&func) {
+      // A proxy may have been queued more than once (or destroyed since)
+      std::sort(m_moved.begin(), m_moved.end());
+      m_moved.erase(std::unique(m_moved.begin(), m_moved.end()), m_moved.end());
+
+      for (const int32_t &proxy : m_moved) {
+        if (!m_nodes[proxy].moved)
+          continue;
+
+        QueryAABB(m_nodes[proxy].aabb, [this, &proxy, &func](const int32_t &other) {
+          // Moved pairs are reported by the lower proxy only
+          if (other == proxy || (m_nodes[other].moved && other < proxy))
+            return true;
+
+          if (proxy < other)
+            func(proxy, other);
+          else
+            func(other, proxy);
+
+          return true;
+        });
+      }
+
+      for (const int32_t &proxy : m_moved)
+        m_nodes[proxy].moved = false;
+
+      m_moved.clear();
+    }
+
+    /**
+     * @brief Get the height of the tree
+     *
+     * @return The height (0 for an empty tree or a single proxy)
+     */
+    int32_t GetHeight() const;
+
+    /**
+     * @brief Get the number of proxies in the tree
+     *
+     * @return The number of proxies
+     */
+    const size_t &GetProxyCount() const;
+
+    /**
+     * @brief Get the summed cost of every inner node over the cost of the root, a measure of
+     *        tree quality (lower is better)
+     *
+     * @return The ratio
+     */
+    float GetAreaRatio() const;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,123 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_CULLING_HPP_
+#define _ELGAR_CULLING_HPP_
+
+// INCLUDES //
+
+#include <glm/glm.hpp>
+
+#include "elgar/physics/AABB.hpp"
+#include "elgar/physics/Frustum.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace elgar {
+
+  /**
+   * @brief The CullKernelType enum lists the implementations of the batch culling routines
+   *
+   */
+  enum CullKernelType {
+    CULL_KERNEL_SCALAR,   // Plain C++ (works everywhere)
+    CULL_KERNEL_SSE,      // 4 objects at a time with SSE2
+    CULL_KERNEL_AVX2      // 8 objects at a time with AVX2
+  };
+
+  /**
+   * @brief The CullStats struct counts the work done by view culling
+   *
+   */
+  struct CullStats {
+    size_t tested;    // Objects tested against the view
+    size_t culled;    // Objects found outside the view (and not drawn)
+  };
+
+  /*
+   * The batch culling routines below test 8 objects per iteration with AVX2, 4 with SSE2 and fall
+   * back to plain C++ elsewhere (picked by CPUID on first use). They write the indices of the
+   * visible objects in ascending order and return how many there are, so visible must have room
+   * for count indices.
+   */
+
+  /**
+   * @brief Find the spheres that are at least partly inside a frustum
+   *
+   * @param frustum   The frustum
+   * @param spheres   The spheres (center in xyz, radius in w)
+   * @param count     The number of spheres
+   * @param visible   Filled with the indices of the visible spheres
+   * @return The number of visible spheres
+   */
+  size_t CullSpheres(const Frustum &frustum, const glm::vec4 *spheres, const size_t &count, uint32_t *visible);
+
+  /**
+   * @brief Find the boxes that are at least partly inside a frustum
+   *
+   * @param frustum   The frustum
+   * @param boxes     The boxes
+   * @param count     The number of boxes
+   * @param visible   Filled with the indices of the visible boxes
+   * @return The number of visible boxes
+   */
+  size_t CullAABBs(const Frustum &frustum, const AABB *boxes, const size_t &count, uint32_t *visible);
+
+  /**
+   * @brief Find the instances that are at least partly inside a frustum. Every instance is
+   *        bounded by the same local sphere, moved and scaled (by its largest axis) by the
+   *        instance's model matrix.
+   *
+   * @param frustum   The frustum
+   * @param models    The model matrices of the instances
+   * @param count     The number of instances
+   * @param sphere    The local bounding sphere (center in xyz, radius in w)
+   * @param visible   Filled with the indices of the visible instances
+   * @return The number of visible instances
+   */
+  size_t CullInstances(
+    const Frustum &frustum,
+    const glm::mat4 *models,
+    const size_t &count,
+    const glm::vec4 &sphere,
+    uint32_t *visible
+  );
+
+  /**
+   * @brief Get the kernel the batch culling routines use (picked by CPUID on first use)
+   *
+   * @return The kernel
+   */
+  CullKernelType GetCullKernel();
+
+  /**
+   * @brief Force the kernel the batch culling routines use (for validation and benchmarks).
+   *        Throws if the CPU does not support it.
+   *
+   * @param type  The kernel
+   */
+  void SetCullKernel(const CullKernelType &type);
+
+  /**
+   * @brief Check if the CPU can run a kernel
+   *
+   * @param type  The kernel
+   * @return True if supported, false otherwise
+   */
+  bool IsCullKernelSupported(const CullKernelType &type);
+
+  /**
+   * @brief Get the name of a kernel
+   *
+   * @param type  The kernel
+   * @return The name
+   */
+  const char *GetCullKernelName(const CullKernelType &type);
+
+}
+
+#endif
@@ -0,0 +1,77 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_FRUSTUM_HPP_
+#define _ELGAR_FRUSTUM_HPP_
+
+// INCLUDES //
+
+#include <glm/glm.hpp>
+
+#include "elgar/physics/AABB.hpp"
+
+// DEFINES //
+
+#define FRUSTUM_PLANE_COUNT   6
+
+namespace elgar {
+
+  /**
+   * @brief The FrustumTest enum lists the results of testing a volume against a Frustum
+   *
+   */
+  enum FrustumTest {
+    FRUSTUM_OUTSIDE,      // Entirely outside
+    FRUSTUM_INTERSECTS,   // Partly inside (or too close to call)
+    FRUSTUM_INSIDE        // Entirely inside
+  };
+
+  /**
+   * @brief A Frustum is the volume a camera can see, stored as six planes (left, right, bottom,
+   *        top, near, far) whose normals point inwards. An orthographic projection gives a box.
+   *
+   */
+  struct Frustum {
+    glm::vec4 planes[FRUSTUM_PLANE_COUNT];    // Normal in xyz, distance in w (normalized)
+
+    /**
+     * @brief Extract the frustum from a combined matrix
+     *
+     * @param matrix  projection * view (the planes come out in world space), or the projection
+     *                alone (view space)
+     * @return The frustum
+     */
+    static Frustum FromMatrix(const glm::mat4 &matrix);
+
+    /**
+     * @brief Check if a point is inside the frustum
+     *
+     * @param point   The point
+     * @return True if inside, false otherwise
+     */
+    bool ContainsPoint(const glm::vec3 &point) const;
+
+    /**
+     * @brief Test a sphere against the frustum
+     *
+     * @param center  The center of the sphere
+     * @param radius  The radius of the sphere
+     * @return The result
+     */
+    FrustumTest TestSphere(const glm::vec3 &center, const float &radius) const;
+
+    /**
+     * @brief Test a box against the frustum
+     *
+     * @param aabb  The box
+     * @return The result
+     */
+    FrustumTest TestAABB(const AABB &aabb) const;
+  };
+
+}
+
+#endif
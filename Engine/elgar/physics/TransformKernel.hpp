@@ -0,0 +1,115 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_TRANSFORM_KERNEL_HPP_
+#define _ELGAR_TRANSFORM_KERNEL_HPP_
+
+// INCLUDES //
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+namespace elgar {
+
+  /**
+   * @brief The TransformKernelType enum lists the implementations of the batch transform kernel
+   *
+   */
+  enum TransformKernelType {
+    TRANSFORM_KERNEL_SCALAR,    // Plain C++ (works everywhere)
+    TRANSFORM_KERNEL_SSE,       // 4 transforms at a time with SSE2
+    TRANSFORM_KERNEL_AVX2       // 8 transforms at a time with AVX2 and FMA
+  };
+
+  /**
+   * @brief The TransformArrays struct points at the structure of arrays a batch of transforms is
+   *        read from (element i of every array belongs to transform i)
+   *
+   */
+  struct TransformArrays {
+    const glm::vec3 *prev_positions;    // Positions before the last fixed step
+    const glm::vec3 *positions;         // Current positions
+    const glm::vec3 *prev_scales;       // Scales before the last fixed step
+    const glm::vec3 *scales;            // Current scales
+    const glm::vec3 *prev_rotations;    // Euler angles before the last fixed step
+    const glm::vec3 *rotations;         // Current Euler angles
+  };
+
+  /**
+   * @brief Compute the model matrix of a single interpolated transform, exactly like
+   *        Interpolated::GetMatrix does
+   *
+   * @param prev_position   Position before the last fixed step
+   * @param position        Current position
+   * @param prev_scale      Scale before the last fixed step
+   * @param scale           Current scale
+   * @param prev_rotation   Euler angles before the last fixed step
+   * @param rotation        Current Euler angles
+   * @param alpha           Interpolation alpha (see FrameTimer::GetAlpha)
+   * @return The model matrix
+   */
+  glm::mat4 ComputeInterpolatedMatrix(
+    const glm::vec3 &prev_position,
+    const glm::vec3 &position,
+    const glm::vec3 &prev_scale,
+    const glm::vec3 &scale,
+    const glm::vec3 &prev_rotation,
+    const glm::vec3 &rotation,
+    const float &alpha
+  );
+
+  /**
+   * @brief Compute the model matrices of a batch of interpolated transforms with the fastest
+   *        kernel the CPU supports. The matrices may be written straight into an instance
+   *        buffer (e.g. memory from a StreamBufferObject or the arrays handed to DrawInstanced).
+   *
+   * @param arrays    The transforms
+   * @param count     The number of transforms
+   * @param alpha     Interpolation alpha shared by every transform
+   * @param matrices  Filled with count matrices
+   */
+  void ComputeInterpolatedMatrices(
+    const TransformArrays &arrays,
+    const size_t &count,
+    const float &alpha,
+    glm::mat4 *matrices
+  );
+
+  /**
+   * @brief Get the kernel ComputeInterpolatedMatrices uses (picked by CPUID on first use)
+   *
+   * @return The kernel
+   */
+  TransformKernelType GetTransformKernel();
+
+  /**
+   * @brief Force the kernel ComputeInterpolatedMatrices uses (for validation and benchmarks).
+   *        Throws if the CPU does not support it.
+   *
+   * @param type  The kernel
+   */
+  void SetTransformKernel(const TransformKernelType &type);
+
+  /**
+   * @brief Check if the CPU can run a kernel
+   *
+   * @param type  The kernel
+   * @return True if supported, false otherwise
+   */
+  bool IsTransformKernelSupported(const TransformKernelType &type);
+
+  /**
+   * @brief Get the name of a kernel
+   *
+   * @param type  The kernel
+   * @return The name
+   */
+  const char *GetTransformKernelName(const TransformKernelType &type);
+
+}
+
+#endif
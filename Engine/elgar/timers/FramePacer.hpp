@@ -0,0 +1,149 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+#ifndef _ELGAR_FRAME_PACER_HPP_
+#define _ELGAR_FRAME_PACER_HPP_
+
+// INCLUDES //
+
+#include "elgar/core/Singleton.hpp"
+
+#include <cstdint>
+
+// DEFINES //
+
+#define FRAME_PACER_BUCKET_COUNT          9       // Buckets in the pacing error histogram
+#define DEFAULT_SPIN_THRESHOLD            1.0f    // Milliseconds before a deadline to stop sleeping and spin
+#define DEFAULT_UNFOCUSED_FRAME_RATE      0.0f    // Frame rate cap while the window is out of focus (0 to disable)
+#define DEFAULT_MINIMIZED_FRAME_RATE      10.0f   // Frame rate cap while the window is minimized (0 to disable)
+
+namespace elgar {
+
+  /**
+   * @brief The FramePacingStats struct holds how closely the FramePacer hit its deadlines
+   *
+   */
+  struct FramePacingStats {
+    uint64_t  buckets[FRAME_PACER_BUCKET_COUNT];        // Paced frames per error bucket
+    uint32_t  bucket_bounds[FRAME_PACER_BUCKET_COUNT];  // Upper bound of every bucket in microseconds (last is unbounded)
+    uint64_t  paced_frames;   // Frames that waited for their deadline
+    uint64_t  late_frames;    // Frames that were already past their deadline
+    double    mean_error;     // Mean distance between wake up and deadline in microseconds
+    double    max_error;      // Largest distance between wake up and deadline in microseconds
+  };
+
+  /**
+   * @brief The FramePacer holds the Engine loop to a target frame rate. It sleeps until shortly
+   *        before each deadline and spins for the rest, so the CPU idles for most of the wait
+   *        without the wake up jitter of a plain sleep. The frame rate can be capped further while
+   *        the window is out of focus or minimized. (Is a Singleton class)
+   *
+   */
+  class FramePacer : public Singleton<FramePacer> {
+  friend class Engine;  // Grant the Engine exclusive instantiation rights
+  private:
+    float     m_target_rate;      // Frames per second to pace to (0 for unlimited)
+    float     m_unfocused_rate;   // Frame rate cap while out of focus (0 for none)
+    float     m_minimized_rate;   // Frame rate cap while minimized (0 for none)
+    uint64_t  m_spin_threshold;   // Nanoseconds before a deadline to stop sleeping
+
+    uint64_t  m_period;           // Nanoseconds per frame being paced to (0 if not pacing)
+    uint64_t  m_deadline;         // Clock reading the current frame should end at
+    uint64_t  m_oversleep;        // Running average of how late sleeps wake up in nanoseconds
+
+    uint64_t  m_buckets[FRAME_PACER_BUCKET_COUNT];  // Paced frames per error bucket
+    uint64_t  m_paced_frames;     // Frames that waited for their deadline
+    uint64_t  m_late_frames;      // Frames that were already past their deadline
+    uint64_t  m_total_error;      // Sum of the pacing error in nanoseconds
+    uint64_t  m_max_error;        // Largest pacing error in nanoseconds
+
+  private:
+    /**
+     * @brief Construct a new FramePacer object
+     *
+     */
+    FramePacer();
+
+    /**
+     * @brief Destroy the FramePacer object
+     *
+     */
+    virtual ~FramePacer();
+
+    /**
+     * @brief Get the frame rate to pace to given the target and the state of the window
+     *
+     * @return Frames per second (0 for unlimited)
+     */
+    float GetEffectiveFrameRate() const;
+
+    /**
+     * @brief Wait until the current frame's deadline and schedule the next one
+     *
+     */
+    void Wait();
+
+  public:
+    /**
+     * @brief Set the frame rate to pace to
+     *
+     * @param rate  Frames per second (0 for unlimited)
+     */
+    void SetTargetFrameRate(const float &rate);
+
+    /**
+     * @brief Get the frame rate being paced to
+     *
+     * @return Frames per second (0 for unlimited)
+     */
+    const float &GetTargetFrameRate() const;
+
+    /**
+     * @brief Set the frame rate cap while the window is out of focus
+     *
+     * @param rate  Frames per second (0 to leave the frame rate alone)
+     */
+    void SetUnfocusedFrameRate(const float &rate);
+
+    /**
+     * @brief Set the frame rate cap while the window is minimized
+     *
+     * @param rate  Frames per second (0 to leave the frame rate alone)
+     */
+    void SetMinimizedFrameRate(const float &rate);
+
+    /**
+     * @brief Set how long before a deadline sleeping stops and spinning takes over (raise it on
+     *        systems with a coarse sleep granularity)
+     *
+     * @param milliseconds  The threshold
+     */
+    void SetSpinThreshold(const float &milliseconds);
+
+    /**
+     * @brief Get how closely the deadlines were hit since the last reset
+     *
+     * @return The stats
+     */
+    FramePacingStats GetStats() const;
+
+    /**
+     * @brief Clear the pacing stats
+     *
+     */
+    void ResetStats();
+
+    /**
+     * @brief Log the pacing error histogram
+     *
+     */
+    void LogStats() const;
+
+  };
+
+}
+
+#endif
@@ -11,6 +11,8 @@
 
 #include "elgar/core/Singleton.hpp"
 
+#include <cstdint>
+
 namespace elgar {
 
   /**
@@ -26,10 +28,48 @@ namespace elgar {
     float m_fixed_time_scale;  // Scalar to multiply fixed time by
     float m_alpha; // Interpolated alpha from phys steps
 
+    uint64_t m_frequency;       // Clock ticks per second
+    uint64_t m_steps_per_second;  // Physics steps per second
+    uint64_t m_last_ticks;      // Clock reading of the previous frame
+    uint64_t m_accumulator;     // Unsimulated time in ticks * steps per second (a step costs m_frequency)
+    uint64_t m_elapsed;         // Total frame time in ticks * steps per second
+    uint64_t m_step_count;      // Total number of physics steps taken
+
   private:
-    void SetDeltaTime(const float &dt); // Record the delta time
-    void SetFixedDeltaTime(const float &fixed_dt);  // Record the fixed delta time
-    void SetAlpha(const float &alpha); // Set the alpha
+    /**
+     * @brief Start timing from a clock reading
+     * 
+     * @param ticks             The current reading of the clock
+     * @param frequency         The number of clock ticks per second
+     * @param steps_per_second  The number of physics steps per second
+     */
+    void Start(const uint64_t &ticks, const uint64_t &frequency, const uint64_t &steps_per_second);
+
+    /**
+     * @brief Advance the timer to a new clock reading, updating the delta time and accumulator
+     * 
+     * @param ticks The current reading of the clock
+     */
+    void Tick(const uint64_t &ticks);
+
+    /**
+     * @brief Advance the timer by exactly one physics step regardless of the clock (fast forward)
+     * 
+     */
+    void TickFixedStep();
+
+    /**
+     * @brief Take a physics step out of the accumulator if a whole one is available
+     * 
+     * @return True if a step should be simulated, false otherwise
+     */
+    bool ConsumeFixedStep();
+
+    /**
+     * @brief Recompute the interpolation alpha from the accumulator
+     * 
+     */
+    void UpdateAlpha();
 
   private:
     /**
@@ -94,6 +134,20 @@ namespace elgar {
      */
     const float &GetAlpha() const;
 
+    /**
+     * @brief      Get the total time advanced by the timer since the engine started running
+     *
+     * @return     The elapsed time in seconds
+     */
+    double GetElapsedTime() const;
+
+    /**
+     * @brief      Get the total number of physics steps taken since the engine started running
+     *
+     * @return     The step count
+     */
+    const uint64_t &GetFixedStepCount() const;
+
     /**
      * @brief Compute the current frames per second
      * 
@@ -11,12 +11,22 @@
 #include "elgar/Engine.hpp"
 #include "elgar/core/Exception.hpp"
 #include "elgar/core/IO.hpp"
+#include "elgar/core/InputRecording.hpp"
 #include "elgar/core/Macros.hpp"
 #include "elgar/core/AudioSystem.hpp"
 #include "elgar/core/Window.hpp"
+#include "elgar/core/JobSystem.hpp"
+#include "elgar/core/Profiler.hpp"
+#include "elgar/core/InitGraph.hpp"
+#include "elgar/core/FrameArena.hpp"
+#include "elgar/core/MemoryTracker.hpp"
 
 #include "elgar/timers/FrameTimer.hpp"
+#include "elgar/timers/FramePacer.hpp"
 
+#include "elgar/graphics/StateCache.hpp"
+#include "elgar/graphics/GPUTimer.hpp"
+#include "elgar/graphics/RenderThread.hpp"
 #include "elgar/graphics/ImageLoader.hpp"
 #include "elgar/graphics/ModelLoader.hpp"
 #include "elgar/graphics/TextureStorage.hpp"
@@ -35,21 +45,42 @@ namespace elgar {
       const std::string &window_name, 
       const int &window_width, 
       const int &window_height, 
-      const unsigned char &window_flags
+      const unsigned char &window_flags,
+      const unsigned int &worker_count
   ) : Singleton<Engine>(this) {
     // Initialize subsystems
 
     int code = 0; // A response code to check for errors with
 
-    code = SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_TIMER); // Initialize Video, events, and time handling
+    m_flags = window_flags;
+    m_worker_count = worker_count;
+    m_fast_forward = false;
+    m_threaded_rendering = false;
+    m_pipeline_depth = DEFAULT_RENDER_PIPELINE_DEPTH;
+    m_recorder = nullptr;
+    m_player = nullptr;
+
+    // Initialize Video (unless headless), events, and time handling
+    if (IsHeadless())
+      code = SDL_Init(SDL_INIT_EVENTS | SDL_INIT_TIMER);
+    else
+      code = SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_TIMER);
 
     // If something went wrong
     if (code < 0) {
       throw Exception("ERROR: Failed to initialize SDL! SDL_Error: " + std::string(SDL_GetError()));
     }
 
-    // Initialize the window
-    new Window(window_name, window_width, window_height, window_flags);
+    const uint64_t window_start = SDL_GetPerformanceCounter();
+
+    // Initialize the window (or offscreen render target), headless runs have no OpenGL at all
+    if (!(window_flags & HEADLESS) || (window_flags & OFFSCREEN))
+      new Window(window_name, window_width, window_height, window_flags);
+
+    const uint64_t window_end = SDL_GetPerformanceCounter();
+
+    LOG("Window and OpenGL context created in %.2f ms...\n",
+      (window_end - window_start) * 1000.0 / SDL_GetPerformanceFrequency());
 
     // Initialize elgar subsystem //
 
@@ -58,10 +89,18 @@ namespace elgar {
     SetRunning(false);  // Engine is not running by default
 
     // Give status log
-    LOG("Elgar online...\n");
+    LOG("Elgar online after %.2f ms...\n",
+      (SDL_GetPerformanceCounter() - window_start) * 1000.0 / SDL_GetPerformanceFrequency());
   }
 
   Engine::~Engine() {
+    // Drop a recording or replay that never ran
+    if (m_recorder)
+      delete m_recorder;
+
+    if (m_player)
+      delete m_player;
+
     // Terminate subsystems
 
     DisableSubsystems();
@@ -73,40 +112,99 @@ namespace elgar {
     SDL_Quit(); // Shutdown SDL
 
     LOG("Elgar offline...\n");
+
+    // Make sure the whole log is out before control returns to the application
+    Logger::Get().Flush();
   }
 
   void Engine::InitSubsystems() {
-    // Initialize the audio subsystem
-    new AudioSystem();
+    // Initialize the profiler first so every other subsystem can record zones
+    new Profiler();
+
+    // Initialize the job system so every other subsystem can spread work across cores
+    new JobSystem(m_worker_count);
+
+    // Initialize the frame arena so transient per frame data never touches the heap
+    new FrameArena();
+
+    // Initialize the frame pacer so the frame rate can be configured before running
+    new FramePacer();
+
+    // Everything else starts through the init graph, CPU side work overlapping on the job system
+    // while anything that touches OpenGL stays on this thread (which owns the context)
+    InitGraph graph;
+
+    FT_Library freetype = nullptr;  // Started off the main thread, handed to the TextRenderer
+
+    // Initialize the audio subsystem (headless machines rarely have an audio device)
+    if (!IsHeadless())
+      graph.Add("AudioSystem", []() { new AudioSystem(); }, INIT_ANY_THREAD);
 
     // Initialize the image loader
-    new ImageLoader();
+    graph.Add("ImageLoader", []() { new ImageLoader(); }, INIT_ANY_THREAD);
 
-    // Initialize the shader manager and compile all shader programs
-    new ShaderManager();
+    // Everything past here needs an OpenGL context
+    if (Window::GetInstance()) {
+      // Initialize the GL state cache before anything binds OpenGL objects
+      graph.Add("StateCache", []() { new StateCache(); }, INIT_MAIN_THREAD);
 
-    // Initialize the mesh manager and create all default meshes
-    new MeshManager();
+      // Initialize the GPU pass timer
+      graph.Add("GPUTimer", []() { new GPUTimer(); }, INIT_MAIN_THREAD, {"StateCache"});
 
-    // Initialize TextureStorage
-    new TextureStorage();
+      // Initialize the shader manager and compile all shader programs
+      graph.Add("ShaderManager", []() { new ShaderManager(); }, INIT_MAIN_THREAD, {"StateCache"});
 
-    // Initialize the SpriteRenderer
-    new SpriteRenderer();
+      // Initialize the mesh manager and create all default meshes (geometry is uploaded on first draw)
+      graph.Add("MeshManager", []() { new MeshManager(); }, INIT_ANY_THREAD);
 
-    // Initialize the TextRenderer
-    new TextRenderer();
+      // Initialize TextureStorage
+      graph.Add("TextureStorage", []() { new TextureStorage(); }, INIT_ANY_THREAD);
 
-    // Initialize the MeshRenderer
-    new MeshRenderer();
+      // Initialize the SpriteRenderer
+      graph.Add("SpriteRenderer", []() { new SpriteRenderer(); }, INIT_MAIN_THREAD, {"StateCache"});
 
-    // Initialize the ModelLoader
-    new ModelLoader();
+      // Start FreeType for the TextRenderer
+      graph.Add("FreeType", [&freetype]() {
+        if (FT_Init_FreeType(&freetype) != 0)
+          throw Exception("ERROR: Failed to initialize FreeType library!");
+      }, INIT_ANY_THREAD);
 
+      // Initialize the TextRenderer
+      graph.Add("TextRenderer", [&freetype]() {
+        new TextRenderer(freetype);
+        freetype = nullptr;   // Owned by the TextRenderer now
+      }, INIT_MAIN_THREAD, {"StateCache", "FreeType"});
+
+      // Initialize the MeshRenderer
+      graph.Add("MeshRenderer", []() { new MeshRenderer(); }, INIT_MAIN_THREAD, {"StateCache"});
+
+      // Initialize the ModelLoader
+      graph.Add("ModelLoader", []() { new ModelLoader(); }, INIT_ANY_THREAD);
+    }
+
+    try {
+      graph.Run();
+    }
+    catch (...) {
+      // FreeType started but the TextRenderer never took it
+      if (freetype)
+        FT_Done_FreeType(freetype);
+
+      throw;
+    }
+
+    graph.LogTimings();
   }
 
   void Engine::DisableSubsystems() {
 
+    // Report what the resources held before they are released
+    MemoryTracker::Get().LogSnapshot();
+
+    // Take the OpenGL context back if Run was left without stopping the render thread
+    if (RenderThread::GetInstance())
+      delete RenderThread::GetInstance();
+
     // Destroy the ShaderManager instance
     if (ShaderManager::GetInstance()) 
       delete ShaderManager::GetInstance();
@@ -141,6 +239,30 @@ namespace elgar {
     // Destroy the audio system
     if (AudioSystem::GetInstance()) 
       delete AudioSystem::GetInstance();
+
+    // Destroy the GPUTimer instance
+    if (GPUTimer::GetInstance())
+      delete GPUTimer::GetInstance();
+
+    // Destroy the StateCache instance
+    if (StateCache::GetInstance())
+      delete StateCache::GetInstance();
+
+    // Destroy the FramePacer instance
+    if (FramePacer::GetInstance())
+      delete FramePacer::GetInstance();
+
+    // Destroy the FrameArena instance
+    if (FrameArena::GetInstance())
+      delete FrameArena::GetInstance();
+
+    // Destroy the JobSystem instance
+    if (JobSystem::GetInstance())
+      delete JobSystem::GetInstance();
+
+    // Destroy the Profiler instance
+    if (Profiler::GetInstance())
+      delete Profiler::GetInstance();
     
   }
 
@@ -154,93 +276,159 @@ namespace elgar {
     // Struct to store event data
     SDL_Event e;
 
-    /* Frame delta time variables */
-    float delta_time = 1.0f / DEFAULT_PHYS_STEPS_PER_SECOND;
-    
-    // Create new frame timer and set the global fixed dt
+    // Replays run on the recorded clock, everything else on the high resolution clock
+    uint64_t frequency = SDL_GetPerformanceFrequency();
+    uint64_t steps_per_second = DEFAULT_PHYS_STEPS_PER_SECOND;
+    uint64_t clock = SDL_GetPerformanceCounter();
+
+    if (m_player) {
+      frequency = m_player->GetFrequency();
+      steps_per_second = m_player->GetStepsPerSecond();
+      clock = 0;
+    }
+
+    // Create new frame timer and start it
     FrameTimer *frame_timer = new FrameTimer();
-    frame_timer->SetFixedDeltaTime(delta_time);
+    frame_timer->Start(clock, frequency, steps_per_second);
 
     // Create the keyboard and mouse
     Keyboard *keyboard = new Keyboard();
     Mouse *mouse = new Mouse();
 
-    float current_time = (float) SDL_GetTicks() / 1000.0f;
-    float accumulator = 0.0f;
+    // Move the OpenGL context over to the render thread
+    if (m_threaded_rendering && Window::GetInstance())
+      new RenderThread(m_pipeline_depth);
+
+    uint64_t frame_start = SDL_GetPerformanceCounter();
 
     while (m_running) {
       /* BEGIN APPLICATION LOOP */
+      PROFILE_ZONE("Frame");
+
+      // Release everything the last frame allocated from the frame arena
+      FrameArena::GetInstance()->Reset();
+
+      // Snapshot last frame's input before new events arrive
+      keyboard->BeginFrame();
+      mouse->BeginFrame();
 
-      // Poll for events
-      while (SDL_PollEvent(&e)) {
-        if (e.type == SDL_QUIT) {
+      uint64_t frame_ticks = 0;
+
+      if (m_player) {
+        // The recording is over
+        if (!m_player->BeginFrame(frame_ticks)) {
           SetRunning(false);
+          break;
         }
-        else if (e.type == SDL_KEYDOWN) {
-          // Handle key press
 
-          keyboard->PressKey(e.key.keysym.sym);
-        }
-        else if (e.type == SDL_KEYUP) {
-          // Handle key release
+        // Feed the recorded events in place of the live ones
+        while (m_player->NextEvent(e))
+          HandleEvent(e, keyboard, mouse);
 
-          keyboard->ReleaseKey(e.key.keysym.sym);
-        }
-        else if (e.type == SDL_MOUSEBUTTONDOWN) {
-          // Handle mouse click
-
-          if (e.button.button == SDL_BUTTON_LEFT) {
-            mouse->PressButton(LEFT); // Handle left click
-          }
-          else if (e.button.button == SDL_BUTTON_RIGHT) {
-            mouse->PressButton(RIGHT);  // Handle right click
-          }
-        }
-        else if (e.type == SDL_MOUSEBUTTONUP) {
-          // Handle mouse release
-
-          if (e.button.button == SDL_BUTTON_LEFT) {
-            mouse->ReleaseButton(LEFT); // Handle left release 
-          }
-          else if (e.button.button == SDL_BUTTON_RIGHT) {
-            mouse->ReleaseButton(RIGHT);  // Handle right release
-          }
-        }
-        else if (e.type == SDL_MOUSEMOTION) {
-          // Handle mouse motion
-          mouse->SetPosition({e.motion.x, e.motion.y});
+        // Still let the user close the window
+        while (SDL_PollEvent(&e)) {
+          if (e.type == SDL_QUIT)
+            HandleEvent(e, keyboard, mouse);
         }
       }
+      else {
+        // Poll for events
+        while (SDL_PollEvent(&e))
+          HandleEvent(e, keyboard, mouse);
+      }
 
       // Compute the frame time
-      float new_time = (float) SDL_GetTicks() / 1000.0f;
-      float frame_time = new_time - current_time;
-      if (frame_time > 0.25) 
-        frame_time = 0.25;
+      if (m_player) {
+        clock += frame_ticks;
+        frame_timer->Tick(clock);   // Advance by exactly what was recorded
+      }
+      else if (m_fast_forward) {
+        frame_ticks = frequency / steps_per_second;
+        frame_timer->TickFixedStep();   // Advance exactly one fixed step regardless of the wall clock
+      }
+      else {
+        const uint64_t now = SDL_GetPerformanceCounter();
+        frame_ticks = now - clock;
+        clock = now;
+
+        frame_timer->Tick(clock);
+      }
 
-      current_time = new_time;
+      if (m_recorder)
+        m_recorder->EndFrame(frame_ticks);
 
       if (update) {
-        frame_timer->SetDeltaTime(frame_time); // Set the global delta time
+        PROFILE_ZONE("Update");
         update(); // Call the supplied user update function
       }
 
-      // Handle phys steps
-      if (fixed_update) {
-        accumulator += frame_time;
-
-        while (accumulator >= delta_time) {
+      // Handle phys steps (the alpha is kept up to date as steps are consumed)
+      while (frame_timer->ConsumeFixedStep()) {
+        PROFILE_ZONE("FixedUpdate");
+        if (fixed_update)
           fixed_update();
-          accumulator -= delta_time;
+      }
+
+      if (RenderThread::GetInstance()) {
+        // Record the frame and let the render thread draw it
+        RenderThread::GetInstance()->Submit(render);
+
+        // Culling ran while the frame was recorded, so its counts belong to this frame
+        if (MeshRenderer::GetInstance())
+          MeshRenderer::GetInstance()->EndCullFrame();
+
+        if (SpriteRenderer::GetInstance())
+          SpriteRenderer::GetInstance()->EndCullFrame();
+      }
+      else {
+        // Draw the window contents
+        if (Window::GetInstance()) {
+          PROFILE_ZONE("Present");
+          Window::GetInstance()->Present(render);
+        }
+
+        // Close off the per frame renderer statistics
+        if (MeshRenderer::GetInstance()) {
+          MeshRenderer::GetInstance()->EndFrame();
+          MeshRenderer::GetInstance()->EndCullFrame();
         }
+
+        if (SpriteRenderer::GetInstance())
+          SpriteRenderer::GetInstance()->EndCullFrame();
+
+        if (StateCache::GetInstance())
+          StateCache::GetInstance()->EndFrame();
+
+        if (GPUTimer::GetInstance())
+          GPUTimer::GetInstance()->EndFrame();
       }
 
-      // Compute the alpha
-      frame_timer->SetAlpha(accumulator / delta_time);  // Update global alpha
+      // Hold the loop to the target frame rate (replays and fast forward run flat out)
+      if (!m_player && !m_fast_forward)
+        FramePacer::GetInstance()->Wait();
 
-      // Draw the window contents
-      if (Window::GetInstance())
-        Window::GetInstance()->Present(render);
+      // Keep the wall clock time of replayed frames for comparing runs
+      const uint64_t frame_end = SDL_GetPerformanceCounter();
+      if (m_player)
+        m_player->AddFrameTime(frame_end - frame_start);
+      frame_start = frame_end;
+    }
+
+    // Finish the queued frames and take the OpenGL context back
+    if (RenderThread::GetInstance())
+      delete RenderThread::GetInstance();
+
+    // Close off any recording or replay
+    if (m_recorder) {
+      delete m_recorder;
+      m_recorder = nullptr;
+    }
+
+    if (m_player) {
+      m_player->ReportFrameTimes(SDL_GetPerformanceFrequency(), m_frame_times_path);
+
+      delete m_player;
+      m_player = nullptr;
     }
 
     // Delete the FrameTimer
@@ -253,6 +441,82 @@ namespace elgar {
     delete mouse;
   }
 
+  void Engine::HandleEvent(const SDL_Event &e, Keyboard *keyboard, Mouse *mouse) {
+    // Everything handled here is what gets recorded
+    if (m_recorder)
+      m_recorder->RecordEvent(e);
+
+    if (e.type == SDL_QUIT) {
+      SetRunning(false);
+    }
+    else if (e.type == SDL_KEYDOWN) {
+      // Handle key press
+
+      keyboard->PressKey(e.key.keysym.scancode);
+    }
+    else if (e.type == SDL_KEYUP) {
+      // Handle key release
+
+      keyboard->ReleaseKey(e.key.keysym.scancode);
+    }
+    else if (e.type == SDL_MOUSEBUTTONDOWN) {
+      // Handle mouse click
+
+      if (e.button.button == SDL_BUTTON_LEFT) {
+        mouse->PressButton(LEFT); // Handle left click
+      }
+      else if (e.button.button == SDL_BUTTON_RIGHT) {
+        mouse->PressButton(RIGHT);  // Handle right click
+      }
+      else if (e.button.button == SDL_BUTTON_MIDDLE) {
+        mouse->PressButton(MIDDLE); // Handle middle click
+      }
+    }
+    else if (e.type == SDL_MOUSEBUTTONUP) {
+      // Handle mouse release
+
+      if (e.button.button == SDL_BUTTON_LEFT) {
+        mouse->ReleaseButton(LEFT); // Handle left release 
+      }
+      else if (e.button.button == SDL_BUTTON_RIGHT) {
+        mouse->ReleaseButton(RIGHT);  // Handle right release
+      }
+      else if (e.button.button == SDL_BUTTON_MIDDLE) {
+        mouse->ReleaseButton(MIDDLE); // Handle middle release
+      }
+    }
+    else if (e.type == SDL_MOUSEMOTION) {
+      // Handle mouse motion
+      mouse->SetPosition({e.motion.x, e.motion.y});
+    }
+    else if (e.type == SDL_MOUSEWHEEL) {
+      // Handle wheel scroll (flipped wheels report inverted deltas)
+      const float direction = e.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -1.0f : 1.0f;
+      mouse->Scroll(glm::vec2(e.wheel.x, e.wheel.y) * direction);
+    }
+  }
+
+  void Engine::RecordInput(const std::string &path) {
+    if (IsRunning())
+      throw Exception("ERROR: Input recording must be set up before the engine runs!");
+
+    if (m_recorder)
+      delete m_recorder;
+
+    m_recorder = new InputRecorder(path, SDL_GetPerformanceFrequency(), DEFAULT_PHYS_STEPS_PER_SECOND);
+  }
+
+  void Engine::ReplayInput(const std::string &path, const std::string &frame_times_path) {
+    if (IsRunning())
+      throw Exception("ERROR: Input replay must be set up before the engine runs!");
+
+    if (m_player)
+      delete m_player;
+
+    m_player = new InputPlayer(path);
+    m_frame_times_path = frame_times_path;
+  }
+
   bool Engine::IsRunning() const {
     return m_running;
   }
@@ -261,4 +525,28 @@ namespace elgar {
     m_running = running;
   }
 
+  bool Engine::IsHeadless() const {
+    return (m_flags & (HEADLESS | OFFSCREEN)) != 0;
+  }
+
+  void Engine::SetFastForward(const bool &fast_forward) {
+    m_fast_forward = fast_forward;
+  }
+
+  bool Engine::IsFastForward() const {
+    return m_fast_forward;
+  }
+
+  void Engine::SetThreadedRendering(const bool &threaded, const unsigned int &depth) {
+    if (IsRunning())
+      throw Exception("ERROR: Threaded rendering must be set up before the engine runs!");
+
+    m_threaded_rendering = threaded;
+    m_pipeline_depth = depth;
+  }
+
+  bool Engine::IsThreadedRendering() const {
+    return m_threaded_rendering;
+  }
+
 }
\ No newline at end of file
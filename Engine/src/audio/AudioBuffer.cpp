@@ -8,6 +8,7 @@
 
 #include "elgar/audio/AudioBuffer.hpp"
 #include "elgar/core/Macros.hpp"
+#include "elgar/core/MemoryTracker.hpp"
 
 namespace elgar {
 
@@ -15,24 +16,51 @@ namespace elgar {
 
   AudioBuffer::AudioBuffer() {
     alGenBuffers(1, &m_buffer_data);  // Generate the OpenAL buffer
+    m_size = 0;
   }
 
   AudioBuffer::AudioBuffer(const ALuint &handle) {
     m_buffer_data = handle; // Copy the handle
+    m_size = 0;
+
+    TrackSize();
   }
 
   AudioBuffer::~AudioBuffer() {
+    if (m_size > 0)
+      MemoryTracker::Get().Release(MEMORY_AUDIO, m_size);
+
     alDeleteBuffers(1, &m_buffer_data); // Delete the OpenAL buffer
   }
 
   bool AudioBuffer::FillData(ALenum format, const ALvoid *data, ALsizei size, ALsizei freq) {
     alBufferData(m_buffer_data, format, data, size, freq);  // Fill the buffer with audio data
 
-    return alGetError() == AL_NO_ERROR;
+    const bool success = alGetError() == AL_NO_ERROR;
+
+    TrackSize();
+
+    return success;
   }
 
   ALuint AudioBuffer::GetBufferData() const {
     return m_buffer_data; // Return handle to the buffer
   }
 
+  void AudioBuffer::TrackSize() {
+    ALint size = 0;
+    alGetBufferi(m_buffer_data, AL_SIZE, &size);
+
+    MemoryTracker &tracker = MemoryTracker::Get();
+
+    // Swap the old size for the new one
+    if (m_size > 0)
+      tracker.Release(MEMORY_AUDIO, m_size);
+
+    m_size = size;
+
+    if (m_size > 0)
+      tracker.Allocate(MEMORY_AUDIO, m_size);
+  }
+
 }
\ No newline at end of file
@@ -85,9 +85,11 @@ namespace elgar {
   }
 
   bool AudioSystem::LoadAudioFile(const std::string &filepath) {
+    PROFILE_ZONE("AudioSystem::LoadAudioFile");
+
     // Check if file has already been loaded into main memory
     if (m_buffers.find(filepath) != m_buffers.end()) {
-      LOG("WARNING: %s already exists in memory!\n", filepath.c_str());
+      LOG_WARNING("%s already exists in memory!\n", filepath.c_str());
       return false;
     }
 
@@ -104,35 +106,35 @@ namespace elgar {
       success = AL_FALSE;
 
       if (error == ALUT_ERROR_OUT_OF_MEMORY) {
-        LOG("ERROR: Failed to load %s!\n", filepath.c_str());
+        LOG_ERROR("Failed to load %s!\n", filepath.c_str());
         LOG("\tReason: Out of memory!\n");
       }
       else if (error == ALUT_ERROR_INVALID_OPERATION) {
-        LOG("ERROR: Failed to load %s!\n", filepath.c_str());
+        LOG_ERROR("Failed to load %s!\n", filepath.c_str());
         LOG("\tReason: OpenAL has not been initialized!\n");
       }
       else if (error == ALUT_ERROR_NO_CURRENT_CONTEXT) {
-        LOG("ERROR: Failed to load %s!\n", filepath.c_str());
+        LOG_ERROR("Failed to load %s!\n", filepath.c_str());
         LOG("\tReason: OpenAL has no current context!\n");
       }
       else if (error == ALUT_ERROR_AL_ERROR_ON_ENTRY) {
-        LOG("ERROR: Failed to load %s!\n", filepath.c_str());
+        LOG_ERROR("Failed to load %s!\n", filepath.c_str());
         LOG("\tReason: Prior unresolved error exists!\n");
       }
       else if (error == ALUT_ERROR_ALC_ERROR_ON_ENTRY) {
-        LOG("ERROR: Failed to load %s!\n", filepath.c_str());
+        LOG_ERROR("Failed to load %s!\n", filepath.c_str());
         LOG("\tReason: Prior unresolved error exists in context!\n");
       }
       else if (error == ALUT_ERROR_GEN_BUFFERS) {
-        LOG("ERROR: Failed to load %s!\n", filepath.c_str());
+        LOG_ERROR("Failed to load %s!\n", filepath.c_str());
         LOG("\tReason: Failed to generate buffer!\n");
       }
       else if (error == ALUT_ERROR_BUFFER_DATA) {
-        LOG("ERROR: Failed to load %s!\n", filepath.c_str());
+        LOG_ERROR("Failed to load %s!\n", filepath.c_str());
         LOG("\tReason: Failed to send data to buffer!\n");
       }
       else if (error == ALUT_ERROR_IO_ERROR) {
-        LOG("ERROR: Failed to load %s!\n", filepath.c_str());
+        LOG_ERROR("Failed to load %s!\n", filepath.c_str());
         LOG("\tReason: Failed to read file on disk!\n");
       }
       else if (error == ALUT_ERROR_UNSUPPORTED_FILE_TYPE) {
@@ -183,16 +185,16 @@ namespace elgar {
 
         // If still failed to load file
         if (buffer == AL_NONE) {
-          LOG("ERROR: Failed to load %s!\n", filepath.c_str());
+          LOG_ERROR("Failed to load %s!\n", filepath.c_str());
           LOG("\tReason: File type not supported!\n");
         }
       }
       else if (ALUT_ERROR_UNSUPPORTED_FILE_SUBTYPE) {
-        LOG("ERROR: Failed to load %s!\n", filepath.c_str());
+        LOG_ERROR("Failed to load %s!\n", filepath.c_str());
         LOG("\tReason: File mode not supported!\n");
       }
       else if (ALUT_ERROR_CORRUPT_OR_TRUNCATED_DATA) {
-        LOG("ERROR: Failed to load %s!\n", filepath.c_str());
+        LOG_ERROR("Failed to load %s!\n", filepath.c_str());
         LOG("\tReason: File is corrupted!\n");
       }
     }
@@ -0,0 +1,68 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/core/CPUFeatures.hpp"
+#include "elgar/core/Macros.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define ELGAR_X86
+#endif
+
+namespace elgar {
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief Query the CPU
+   *
+   * @return The features
+   */
+  static CPUFeatures DetectCPUFeatures() {
+    CPUFeatures features = {false, false, false, false, false};
+
+    #ifdef ELGAR_X86
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+      return features;
+
+    features.sse2 = (edx & bit_SSE2) != 0;
+    features.sse41 = (ecx & bit_SSE4_1) != 0;
+
+    // AVX also needs the operating system to save the YMM registers on context switches
+    const bool osxsave = (ecx & bit_OSXSAVE) != 0;
+    if (osxsave && (ecx & bit_AVX)) {
+      unsigned int xcr0_low, xcr0_high;
+      __asm__ ("xgetbv" : "=a" (xcr0_low), "=d" (xcr0_high) : "c" (0));
+
+      features.avx = (xcr0_low & 0x6) == 0x6;   // XMM and YMM state enabled
+    }
+
+    features.fma = features.avx && (ecx & bit_FMA);
+
+    if (features.avx && __get_cpuid_max(0, nullptr) >= 7) {
+      __cpuid_count(7, 0, eax, ebx, ecx, edx);
+      features.avx2 = (ebx & bit_AVX2) != 0;
+    }
+    #endif
+
+    LOG("CPU features: SSE2 %d, SSE4.1 %d, AVX %d, AVX2 %d, FMA %d\n",
+      features.sse2, features.sse41, features.avx, features.avx2, features.fma);
+
+    return features;
+  }
+
+  // FUNCTIONS //
+
+  const CPUFeatures &GetCPUFeatures() {
+    static const CPUFeatures features = DetectCPUFeatures();
+    return features;
+  }
+
+}
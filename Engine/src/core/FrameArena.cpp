@@ -0,0 +1,210 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/core/FrameArena.hpp"
+#include "elgar/core/Macros.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace elgar {
+
+  // LOCAL DATA //
+
+  static std::atomic<uint32_t> s_generation(0);    // Bumped every time a FrameArena is created
+
+  static thread_local FrameSubArena *t_arena = nullptr;   // Sub-arena of the calling thread
+  static thread_local uint32_t t_generation = 0;          // FrameArena generation the sub-arena belongs to
+
+  /**
+   * @brief Gives the sub-arena of a thread back to the FrameArena when the thread exits
+   *
+   */
+  static thread_local struct SubArenaRelease {
+    ~SubArenaRelease() {
+      FrameArena *arena = FrameArena::GetInstance();
+
+      if (arena && t_arena && t_generation == s_generation)
+        arena->ReleaseSubArena(t_arena);
+    }
+  } t_release;
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief Add a chunk to the end of a sub-arena
+   *
+   * @param arena The sub-arena
+   * @param size  The size of the chunk
+   */
+  static void AddChunk(FrameSubArena &arena, const size_t &size) {
+    arena.chunks.push_back(std::unique_ptr<unsigned char[]>(new unsigned char[size]));
+    arena.sizes.push_back(size);
+  }
+
+  // FUNCTIONS //
+
+  FrameArena::FrameArena() : Singleton<FrameArena>(this) {
+    m_generation = ++s_generation;
+    m_last_frame_bytes = 0;
+    m_peak_frame_bytes = 0;
+    m_frame_count = 0;
+
+    LOG("FrameArena online...\n");
+  }
+
+  FrameArena::~FrameArena() {
+    LOG("FrameArena offline (peak frame used %zu bytes)...\n", m_peak_frame_bytes);
+  }
+
+  FrameSubArena *FrameArena::GetSubArena() {
+    if (t_arena && t_generation == m_generation)
+      return t_arena;
+
+    // Touch the release hook so it runs when this thread exits
+    (void)&t_release;
+
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    FrameSubArena *arena = nullptr;
+
+    // Take over the sub-arena of a thread that has exited
+    for (std::unique_ptr<FrameSubArena> &unowned : m_arenas) {
+      if (!unowned->owned) {
+        arena = unowned.get();
+        break;
+      }
+    }
+
+    if (!arena) {
+      arena = new FrameSubArena();
+      arena->chunk = 0;
+      arena->offset = 0;
+      arena->used = 0;
+      arena->peak = 0;
+      arena->last_peak = 0;
+
+      AddChunk(*arena, FRAME_ARENA_CHUNK_SIZE);
+      m_arenas.push_back(std::unique_ptr<FrameSubArena>(arena));
+    }
+
+    arena->owned = true;
+
+    t_arena = arena;
+    t_generation = m_generation;
+
+    return arena;
+  }
+
+  void FrameArena::ReleaseSubArena(FrameSubArena *arena) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    arena->owned = false;
+  }
+
+  void *FrameArena::Allocate(const size_t &size, const size_t &alignment) {
+    FrameSubArena &arena = *GetSubArena();
+
+    for (;;) {
+      unsigned char *base = arena.chunks[arena.chunk].get();
+      const uintptr_t address = (uintptr_t)(base + arena.offset);
+      const size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+
+      // Fits in the current chunk
+      if (arena.offset + padding + size <= arena.sizes[arena.chunk]) {
+        arena.offset += padding + size;
+        arena.peak = std::max(arena.peak, arena.used + arena.offset);
+
+        return base + arena.offset - size;
+      }
+
+      // Move on to the next chunk, adding one big enough if there is none
+      arena.used += arena.offset;
+      arena.offset = 0;
+      arena.chunk++;
+
+      if (arena.chunk == arena.chunks.size())
+        AddChunk(arena, std::max((size_t)FRAME_ARENA_CHUNK_SIZE, size + alignment));
+    }
+  }
+
+  void FrameArena::Deallocate(void *memory, const size_t &size) {
+    if (!memory || !t_arena || t_generation != m_generation)
+      return;
+
+    FrameSubArena &arena = *t_arena;
+    unsigned char *top = arena.chunks[arena.chunk].get() + arena.offset;
+
+    // Only the newest allocation can be handed back
+    if ((unsigned char *)memory + size == top)
+      arena.offset -= size;
+  }
+
+  void FrameArena::Reset() {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    size_t frame_bytes = 0;
+
+    for (std::unique_ptr<FrameSubArena> &arena : m_arenas) {
+      // The frame spilled into more chunks, merge them so the next one fits in a single chunk
+      if (arena->chunks.size() > 1) {
+        size_t capacity = 0;
+        for (const size_t &size : arena->sizes)
+          capacity += size;
+
+        arena->chunks.clear();
+        arena->sizes.clear();
+        AddChunk(*arena, capacity);
+
+        LOG_DEBUG("FrameArena grew a thread's arena to %zu bytes...\n", capacity);
+      }
+
+      frame_bytes += arena->peak;
+
+      arena->last_peak = arena->peak;
+      arena->chunk = 0;
+      arena->offset = 0;
+      arena->used = 0;
+      arena->peak = 0;
+    }
+
+    m_last_frame_bytes = frame_bytes;
+    m_peak_frame_bytes = std::max(m_peak_frame_bytes, frame_bytes);
+    m_frame_count++;
+  }
+
+  const size_t &FrameArena::GetLastFrameBytes() const {
+    return m_last_frame_bytes;
+  }
+
+  const size_t &FrameArena::GetPeakFrameBytes() const {
+    return m_peak_frame_bytes;
+  }
+
+  std::vector<size_t> FrameArena::GetThreadFrameBytes() const {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    std::vector<size_t> bytes;
+    for (const std::unique_ptr<FrameSubArena> &arena : m_arenas)
+      bytes.push_back(arena->last_peak);
+
+    return bytes;
+  }
+
+  size_t FrameArena::GetCapacity() const {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    size_t capacity = 0;
+    for (const std::unique_ptr<FrameSubArena> &arena : m_arenas) {
+      for (const size_t &size : arena->sizes)
+        capacity += size;
+    }
+
+    return capacity;
+  }
+
+}
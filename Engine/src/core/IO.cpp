@@ -22,24 +22,61 @@ namespace elgar {
     LOG("Keyboard offline...\n");
   }
 
-  void Keyboard::PressKey(const SDL_Keycode &key) {
-    m_keys[key] = true;
+  void Keyboard::BeginFrame() {
+    m_previous = m_current;
+    m_pressed.reset();
+    m_released.reset();
   }
 
-  void Keyboard::ReleaseKey(const SDL_Keycode &key) {
-    m_keys[key] = false;
+  void Keyboard::PressKey(const SDL_Scancode &key) {
+    if (key <= SDL_SCANCODE_UNKNOWN || key >= SDL_NUM_SCANCODES)
+      return;
+
+    // Only the first event of a held key counts as a press
+    if (!m_current[key])
+      m_pressed[key] = true;
+
+    m_current[key] = true;
+  }
+
+  void Keyboard::ReleaseKey(const SDL_Scancode &key) {
+    if (key <= SDL_SCANCODE_UNKNOWN || key >= SDL_NUM_SCANCODES)
+      return;
+
+    if (m_current[key])
+      m_released[key] = true;
+
+    m_current[key] = false;
+  }
+
+  bool Keyboard::IsKeyDown(const SDL_Scancode &key) const {
+    return key > SDL_SCANCODE_UNKNOWN && key < SDL_NUM_SCANCODES && m_current[key];
+  }
+
+  bool Keyboard::WasKeyDown(const SDL_Scancode &key) const {
+    return key > SDL_SCANCODE_UNKNOWN && key < SDL_NUM_SCANCODES && m_previous[key];
   }
 
-  bool Keyboard::IsKeyPressed(const SDL_Keycode &key) {
-    if (m_keys.find(key) == m_keys.end())
-      return false;
+  bool Keyboard::WasKeyPressedThisFrame(const SDL_Scancode &key) const {
+    return key > SDL_SCANCODE_UNKNOWN && key < SDL_NUM_SCANCODES && m_pressed[key];
+  }
 
-    return m_keys[key];
+  bool Keyboard::WasKeyReleasedThisFrame(const SDL_Scancode &key) const {
+    return key > SDL_SCANCODE_UNKNOWN && key < SDL_NUM_SCANCODES && m_released[key];
+  }
+
+  bool Keyboard::IsKeyPressed(const SDL_Keycode &key) const {
+    return IsKeyDown(SDL_GetScancodeFromKey(key));
   }
 
   // MOUSE FUNCTIONS //
 
-  Mouse::Mouse() : Singleton<Mouse>(this) {
+  Mouse::Mouse() : Singleton<Mouse>(this), m_pos(0.0f), m_prev_pos(0.0f), m_wheel(0.0f) {
+    m_buttons = 0;
+    m_previous = 0;
+    m_pressed = 0;
+    m_released = 0;
+
     LOG("Mouse online...\n");
   }
 
@@ -47,24 +84,58 @@ namespace elgar {
     LOG("Mouse offline...\n");
   }
 
+  void Mouse::BeginFrame() {
+    m_previous = m_buttons;
+    m_pressed = 0;
+    m_released = 0;
+    m_prev_pos = m_pos;
+    m_wheel = glm::vec2(0.0f);
+  }
+
   void Mouse::PressButton(const MouseButton &button) {
+    m_pressed |= (unsigned char)button & ~m_buttons;
     m_buttons |= (unsigned char)button;
   }
 
   void Mouse::ReleaseButton(const MouseButton &button) {
+    m_released |= (unsigned char)button & m_buttons;
     m_buttons &= ~(unsigned char)button;
   }
 
-  bool Mouse::IsButtonPressed(const MouseButton &button) {
+  bool Mouse::IsButtonDown(const MouseButton &button) const {
     return (m_buttons & (unsigned char)button) != 0;
   }
 
+  bool Mouse::WasButtonPressedThisFrame(const MouseButton &button) const {
+    return (m_pressed & (unsigned char)button) != 0;
+  }
+
+  bool Mouse::WasButtonReleasedThisFrame(const MouseButton &button) const {
+    return (m_released & (unsigned char)button) != 0;
+  }
+
+  bool Mouse::IsButtonPressed(const MouseButton &button) const {
+    return IsButtonDown(button);
+  }
+
+  void Mouse::Scroll(const glm::vec2 &delta) {
+    m_wheel += delta;
+  }
+
+  const glm::vec2 &Mouse::GetWheelDelta() const {
+    return m_wheel;
+  }
+
   void Mouse::SetPosition(const glm::vec2 &pos) {
     m_pos = pos;
   }
 
-  glm::vec2 Mouse::GetPosition() {
+  glm::vec2 Mouse::GetPosition() const {
     return m_pos;
   }
 
+  glm::vec2 Mouse::GetMotion() const {
+    return m_pos - m_prev_pos;
+  }
+
 }
\ No newline at end of file
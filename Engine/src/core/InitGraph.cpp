@@ -0,0 +1,272 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/core/InitGraph.hpp"
+#include "elgar/core/JobSystem.hpp"
+#include "elgar/core/Exception.hpp"
+#include "elgar/core/Macros.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+
+// DEFINES //
+
+#define INIT_GRAPH_POLL_INTERVAL  std::chrono::milliseconds(1)   // Longest the main thread sleeps while waiting on workers
+
+namespace elgar {
+
+  // LOCAL DATA //
+
+  static std::thread::id s_main_thread;   // The thread running the graph
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief Read the steady clock
+   *
+   * @return Nanoseconds since an arbitrary epoch
+   */
+  static uint64_t Now() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+  }
+
+  // FUNCTIONS //
+
+  InitGraph::InitGraph() {
+    m_start = 0;
+    m_end = 0;
+  }
+
+  InitGraph::~InitGraph() {
+    // Do nothing
+  }
+
+  void InitGraph::Add(
+    const std::string &name,
+    const std::function<void()> &init,
+    const InitAffinity &affinity,
+    const std::vector<std::string> &dependencies
+  ) {
+    for (const InitStep &step : m_steps) {
+      if (step.name == name)
+        throw Exception("ERROR: Init step " + name + " was added twice!");
+    }
+
+    InitStep step;
+    step.name = name;
+    step.init = init;
+    step.affinity = affinity;
+    step.waiting = 0;
+    step.start = 0;
+    step.end = 0;
+    step.worker = false;
+
+    m_steps.push_back(step);
+    m_dependencies.push_back(dependencies);
+  }
+
+  void InitGraph::RunStep(const size_t &index) {
+    InitStep &step = m_steps[index];
+
+    step.worker = std::this_thread::get_id() != s_main_thread;
+    step.start = Now();
+
+    try {
+      step.init();
+    }
+    catch (...) {
+      std::lock_guard<std::mutex> lock(m_lock);
+
+      if (!m_error)
+        m_error = std::current_exception();
+    }
+
+    step.end = Now();
+  }
+
+  void InitGraph::Run() {
+    PROFILE_ZONE("InitGraph::Run");
+
+    // Link every step to the steps waiting on it
+    std::unordered_map<std::string, size_t> indices;
+    for (size_t i = 0; i < m_steps.size(); i++)
+      indices[m_steps[i].name] = i;
+
+    for (size_t i = 0; i < m_steps.size(); i++) {
+      for (const std::string &dependency : m_dependencies[i]) {
+        auto it = indices.find(dependency);
+
+        if (it == indices.end())
+          throw Exception("ERROR: Init step " + m_steps[i].name + " depends on unknown step " + dependency + "!");
+
+        m_steps[it->second].dependents.push_back(i);
+      }
+
+      m_steps[i].waiting = m_dependencies[i].size();
+    }
+
+    // Make sure every step can be reached before starting any of them
+    {
+      std::vector<size_t> waiting(m_steps.size());
+      std::vector<size_t> open;
+
+      for (size_t i = 0; i < m_steps.size(); i++) {
+        waiting[i] = m_steps[i].waiting;
+        if (waiting[i] == 0)
+          open.push_back(i);
+      }
+
+      size_t reached = 0;
+      while (!open.empty()) {
+        const size_t index = open.back();
+        open.pop_back();
+        reached++;
+
+        for (const size_t &dependent : m_steps[index].dependents) {
+          if (--waiting[dependent] == 0)
+            open.push_back(dependent);
+        }
+      }
+
+      if (reached != m_steps.size())
+        throw Exception("ERROR: Init steps have a dependency cycle!");
+    }
+
+    JobSystem *jobs = JobSystem::GetInstance();
+
+    std::vector<size_t> ready;        // Steps whose dependencies are done
+    std::vector<size_t> main_ready;   // Ready steps waiting for the main thread
+    size_t running = 0;               // Steps handed to the JobSystem that are not processed yet
+    bool failed = false;
+
+    for (size_t i = 0; i < m_steps.size(); i++) {
+      if (m_steps[i].waiting == 0)
+        ready.push_back(i);
+    }
+
+    // Mark a step done, readying the steps that were only waiting on it
+    auto release = [this, &ready](const size_t &index) {
+      for (const size_t &dependent : m_steps[index].dependents) {
+        if (--m_steps[dependent].waiting == 0)
+          ready.push_back(dependent);
+      }
+    };
+
+    s_main_thread = std::this_thread::get_id();
+    m_start = Now();
+
+    for (;;) {
+      // Hand out everything that became ready (nothing new starts once a step has failed)
+      if (!failed) {
+        for (const size_t &index : ready) {
+          if (m_steps[index].affinity == INIT_ANY_THREAD && jobs) {
+            running++;
+
+            jobs->Schedule([this, index]() {
+              RunStep(index);
+
+              {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_finished.push_back(index);
+              }
+              m_finished_signal.notify_one();
+            });
+          }
+          else {
+            main_ready.push_back(index);
+          }
+        }
+      }
+
+      ready.clear();
+
+      // Main thread steps run in the order they were added
+      if (!failed && !main_ready.empty()) {
+        auto next = std::min_element(main_ready.begin(), main_ready.end());
+        const size_t index = *next;
+        main_ready.erase(next);
+
+        RunStep(index);
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        failed = m_error != nullptr;
+
+        if (!failed)
+          release(index);
+
+        continue;
+      }
+
+      if (running == 0)
+        break;
+
+      // Help the workers until one of the steps they run is done
+      std::vector<size_t> finished;
+
+      for (;;) {
+        {
+          std::lock_guard<std::mutex> lock(m_lock);
+          finished.swap(m_finished);
+        }
+
+        if (!finished.empty() || jobs->RunJob(jobs->GetQueueIndex()))
+          break;
+
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_finished_signal.wait_for(lock, INIT_GRAPH_POLL_INTERVAL, [this]() { return !m_finished.empty(); });
+      }
+
+      std::lock_guard<std::mutex> lock(m_lock);
+      failed = m_error != nullptr;
+
+      for (const size_t &index : finished) {
+        running--;
+
+        if (!failed)
+          release(index);
+      }
+    }
+
+    m_end = Now();
+
+    if (m_error)
+      std::rethrow_exception(m_error);
+  }
+
+  void InitGraph::LogTimings() const {
+    if (m_end <= m_start)
+      return;
+
+    std::vector<const InitStep *> steps;
+    uint64_t work = 0;
+
+    for (const InitStep &step : m_steps) {
+      steps.push_back(&step);
+      work += step.end - step.start;
+    }
+
+    std::sort(steps.begin(), steps.end(), [](const InitStep *a, const InitStep *b) { return a->start < b->start; });
+
+    const double total = (m_end - m_start) / 1000000.0;
+
+    LOG("Subsystems initialized in %.2f ms (%.2f ms of work, %.2fx overlap):\n",
+      total, work / 1000000.0, (work / 1000000.0) / total);
+
+    for (const InitStep *step : steps) {
+      LOG("  %-16s %8.2f ms, started at %7.2f ms on the %s thread\n",
+        step->name.c_str(),
+        (step->end - step->start) / 1000000.0,
+        (step->start - m_start) / 1000000.0,
+        step->worker ? "worker" : "main");
+    }
+  }
+
+}
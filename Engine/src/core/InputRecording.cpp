@@ -0,0 +1,340 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/core/InputRecording.hpp"
+#include "elgar/core/Exception.hpp"
+#include "elgar/core/Macros.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// DEFINES //
+
+#define INPUT_RECORDER_BUFFER_SIZE  65536   // Bytes buffered before they are written to disk
+
+namespace elgar {
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief Append an unsigned integer as 7 bit groups, the high bit marking that more follow
+   *
+   * @param bytes The bytes to append to
+   * @param value The value to write
+   */
+  static void WriteVarint(std::vector<unsigned char> &bytes, uint64_t value) {
+    while (value >= 0x80) {
+      bytes.push_back((unsigned char)(value | 0x80));
+      value >>= 7;
+    }
+
+    bytes.push_back((unsigned char)value);
+  }
+
+  /**
+   * @brief Append a signed integer, zigzag encoded so small negative values stay small
+   *
+   * @param bytes The bytes to append to
+   * @param value The value to write
+   */
+  static void WriteSigned(std::vector<unsigned char> &bytes, const int64_t &value) {
+    WriteVarint(bytes, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+  }
+
+  /**
+   * @brief Undo the zigzag encoding of a signed integer
+   *
+   * @param value The encoded value
+   * @return The signed value
+   */
+  static int64_t DecodeSigned(const uint64_t &value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+  }
+
+  // RECORDER FUNCTIONS //
+
+  InputRecorder::InputRecorder(
+    const std::string &path,
+    const uint64_t &frequency,
+    const uint64_t &steps_per_second
+  ) {
+    m_file = fopen(path.c_str(), "wb");
+
+    if (!m_file)
+      throw Exception("ERROR: Failed to open " + path + " to record input!");
+
+    m_event_count = 0;
+    m_frame_count = 0;
+    m_buffer.reserve(INPUT_RECORDER_BUFFER_SIZE);
+
+    // Header: magic, version, clock frequency and physics rate
+    const uint32_t magic = INPUT_RECORDING_MAGIC;
+    for (int i = 0; i < 4; i++)
+      m_buffer.push_back((unsigned char)(magic >> (i * 8)));
+
+    WriteVarint(m_buffer, INPUT_RECORDING_VERSION);
+    WriteVarint(m_buffer, frequency);
+    WriteVarint(m_buffer, steps_per_second);
+
+    LOG("Recording input to %s...\n", path.c_str());
+  }
+
+  InputRecorder::~InputRecorder() {
+    FlushBuffer();
+    fclose(m_file);
+
+    LOG("Input recording closed after %llu frames...\n", (unsigned long long)m_frame_count);
+  }
+
+  void InputRecorder::FlushBuffer() {
+    if (!m_buffer.empty() && fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) != m_buffer.size())
+      LOG_ERROR("Failed to write input recording!\n");
+
+    m_buffer.clear();
+  }
+
+  void InputRecorder::RecordEvent(const SDL_Event &event) {
+    switch (event.type) {
+      case SDL_QUIT:
+        m_frame.push_back(INPUT_RECORD_QUIT);
+        break;
+      case SDL_KEYDOWN:
+        // Repeats never change the key state
+        if (event.key.repeat)
+          return;
+
+        m_frame.push_back(INPUT_RECORD_KEY_DOWN);
+        WriteVarint(m_frame, event.key.keysym.scancode);
+        break;
+      case SDL_KEYUP:
+        m_frame.push_back(INPUT_RECORD_KEY_UP);
+        WriteVarint(m_frame, event.key.keysym.scancode);
+        break;
+      case SDL_MOUSEBUTTONDOWN:
+        m_frame.push_back(INPUT_RECORD_BUTTON_DOWN);
+        m_frame.push_back(event.button.button);
+        break;
+      case SDL_MOUSEBUTTONUP:
+        m_frame.push_back(INPUT_RECORD_BUTTON_UP);
+        m_frame.push_back(event.button.button);
+        break;
+      case SDL_MOUSEMOTION:
+        m_frame.push_back(INPUT_RECORD_MOTION);
+        WriteSigned(m_frame, event.motion.x);
+        WriteSigned(m_frame, event.motion.y);
+        break;
+      case SDL_MOUSEWHEEL: {
+        // Store the wheel unflipped so playback does not depend on the recording machine's settings
+        const int direction = event.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -1 : 1;
+
+        m_frame.push_back(INPUT_RECORD_WHEEL);
+        WriteSigned(m_frame, event.wheel.x * direction);
+        WriteSigned(m_frame, event.wheel.y * direction);
+        break;
+      }
+      default:
+        return;
+    }
+
+    m_event_count++;
+  }
+
+  void InputRecorder::EndFrame(const uint64_t &ticks) {
+    WriteVarint(m_buffer, ticks);
+    WriteVarint(m_buffer, m_event_count);
+    m_buffer.insert(m_buffer.end(), m_frame.begin(), m_frame.end());
+
+    m_frame.clear();
+    m_event_count = 0;
+    m_frame_count++;
+
+    if (m_buffer.size() >= INPUT_RECORDER_BUFFER_SIZE)
+      FlushBuffer();
+  }
+
+  const uint64_t &InputRecorder::GetFrameCount() const {
+    return m_frame_count;
+  }
+
+  // PLAYER FUNCTIONS //
+
+  InputPlayer::InputPlayer(const std::string &path) {
+    FILE *file = fopen(path.c_str(), "rb");
+
+    if (!file)
+      throw Exception("ERROR: Failed to open input recording " + path + "!");
+
+    // Recordings are small (a few bytes a frame), so read the whole thing up front
+    unsigned char chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+      m_data.insert(m_data.end(), chunk, chunk + read);
+
+    fclose(file);
+
+    m_cursor = 0;
+    m_events_left = 0;
+    m_frame_count = 0;
+
+    uint32_t magic = 0;
+    for (int i = 0; i < 4 && m_cursor < m_data.size(); i++)
+      magic |= (uint32_t)m_data[m_cursor++] << (i * 8);
+
+    uint64_t version = 0;
+    if (magic != INPUT_RECORDING_MAGIC || !ReadVarint(version) || version != INPUT_RECORDING_VERSION)
+      throw Exception("ERROR: " + path + " is not a supported input recording!");
+
+    if (!ReadVarint(m_frequency) || !ReadVarint(m_steps_per_second) || m_frequency == 0 || m_steps_per_second == 0)
+      throw Exception("ERROR: Input recording " + path + " has a corrupt header!");
+
+    LOG("Replaying input from %s...\n", path.c_str());
+  }
+
+  InputPlayer::~InputPlayer() {
+    LOG("Input replay closed after %llu frames...\n", (unsigned long long)m_frame_count);
+  }
+
+  bool InputPlayer::ReadVarint(uint64_t &value) {
+    value = 0;
+
+    for (unsigned int shift = 0; m_cursor < m_data.size() && shift < 64; shift += 7) {
+      const unsigned char byte = m_data[m_cursor++];
+      value |= (uint64_t)(byte & 0x7F) << shift;
+
+      if (!(byte & 0x80))
+        return true;
+    }
+
+    return false;
+  }
+
+  bool InputPlayer::BeginFrame(uint64_t &ticks) {
+    // Skip whatever the previous frame did not read
+    SDL_Event event;
+    while (NextEvent(event));
+
+    uint64_t count;
+    if (!ReadVarint(ticks) || !ReadVarint(count))
+      return false;
+
+    m_events_left = count;
+    m_frame_count++;
+
+    return true;
+  }
+
+  bool InputPlayer::NextEvent(SDL_Event &event) {
+    if (m_events_left == 0 || m_cursor >= m_data.size())
+      return false;
+
+    m_events_left--;
+
+    memset(&event, 0, sizeof(event));
+
+    const unsigned char type = m_data[m_cursor++];
+    uint64_t a = 0, b = 0;
+
+    switch (type) {
+      case INPUT_RECORD_QUIT:
+        event.type = SDL_QUIT;
+        break;
+      case INPUT_RECORD_KEY_DOWN:
+      case INPUT_RECORD_KEY_UP:
+        ReadVarint(a);
+        event.type = type == INPUT_RECORD_KEY_DOWN ? SDL_KEYDOWN : SDL_KEYUP;
+        event.key.state = type == INPUT_RECORD_KEY_DOWN ? SDL_PRESSED : SDL_RELEASED;
+        event.key.keysym.scancode = (SDL_Scancode)a;
+        break;
+      case INPUT_RECORD_BUTTON_DOWN:
+      case INPUT_RECORD_BUTTON_UP:
+        if (m_cursor >= m_data.size())
+          return false;
+
+        event.type = type == INPUT_RECORD_BUTTON_DOWN ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+        event.button.state = type == INPUT_RECORD_BUTTON_DOWN ? SDL_PRESSED : SDL_RELEASED;
+        event.button.button = m_data[m_cursor++];
+        break;
+      case INPUT_RECORD_MOTION:
+        ReadVarint(a);
+        ReadVarint(b);
+        event.type = SDL_MOUSEMOTION;
+        event.motion.x = (Sint32)DecodeSigned(a);
+        event.motion.y = (Sint32)DecodeSigned(b);
+        break;
+      case INPUT_RECORD_WHEEL:
+        ReadVarint(a);
+        ReadVarint(b);
+        event.type = SDL_MOUSEWHEEL;
+        event.wheel.direction = SDL_MOUSEWHEEL_NORMAL;
+        event.wheel.x = (Sint32)DecodeSigned(a);
+        event.wheel.y = (Sint32)DecodeSigned(b);
+        break;
+      default:
+        // Nothing after an unknown record can be trusted
+        LOG_ERROR("Corrupt input recording at byte %zu!\n", m_cursor - 1);
+        m_cursor = m_data.size();
+        m_events_left = 0;
+        return false;
+    }
+
+    return true;
+  }
+
+  void InputPlayer::AddFrameTime(const uint64_t &ticks) {
+    m_frame_times.push_back(ticks);
+  }
+
+  void InputPlayer::ReportFrameTimes(const uint64_t &frequency, const std::string &path) const {
+    if (m_frame_times.empty() || frequency == 0)
+      return;
+
+    const double to_ms = 1000.0 / (double)frequency;
+
+    std::vector<uint64_t> sorted(m_frame_times);
+    std::sort(sorted.begin(), sorted.end());
+
+    uint64_t total = 0;
+    for (const uint64_t &ticks : sorted)
+      total += ticks;
+
+    auto percentile = [&sorted, &to_ms](const double &p) {
+      return sorted[std::min(sorted.size() - 1, (size_t)(p * sorted.size()))] * to_ms;
+    };
+
+    LOG("Replayed %zu frames: mean %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+      sorted.size(), total * to_ms / sorted.size(), percentile(0.50), percentile(0.95), percentile(0.99),
+      sorted.back() * to_ms);
+
+    if (path.empty())
+      return;
+
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file) {
+      LOG_ERROR("Failed to open %s to write frame times!\n", path.c_str());
+      return;
+    }
+
+    for (const uint64_t &ticks : m_frame_times)
+      fprintf(file, "%.6f\n", ticks * to_ms);
+
+    fclose(file);
+  }
+
+  const uint64_t &InputPlayer::GetFrequency() const {
+    return m_frequency;
+  }
+
+  const uint64_t &InputPlayer::GetStepsPerSecond() const {
+    return m_steps_per_second;
+  }
+
+  const uint64_t &InputPlayer::GetFrameCount() const {
+    return m_frame_count;
+  }
+
+}
@@ -0,0 +1,239 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/core/JobSystem.hpp"
+#include "elgar/core/Macros.hpp"
+
+#include <algorithm>
+
+namespace elgar {
+
+  // LOCAL DATA //
+
+  static thread_local int t_queue_index = -1;   // Queue owned by the calling thread (-1 if none)
+
+  // FUNCTIONS //
+
+  JobCounter::JobCounter() {
+    m_pending = 0;
+  }
+
+  JobCounter::~JobCounter() {
+    // Do nothing
+  }
+
+  bool JobCounter::IsDone() const {
+    return m_pending.load() <= 0;
+  }
+
+  JobSystem::JobSystem(const unsigned int &worker_count) : Singleton<JobSystem>(this) {
+    unsigned int workers = worker_count;
+
+    // Default to one worker per core, leaving a core for the main thread
+    if (workers == 0) {
+      const unsigned int cores = std::thread::hardware_concurrency();
+      workers = cores > 1 ? cores - 1 : 0;
+    }
+
+    m_running = true;
+    m_queued = 0;
+
+    // The main thread owns queue 0
+    for (unsigned int i = 0; i <= workers; i++)
+      m_queues.push_back(std::unique_ptr<JobQueue>(new JobQueue()));
+
+    t_queue_index = 0;
+
+    for (unsigned int i = 1; i <= workers; i++)
+      m_workers.push_back(std::thread(&JobSystem::WorkerLoop, this, i));
+
+    LOG("JobSystem online with %u worker threads...\n", workers);
+  }
+
+  JobSystem::~JobSystem() {
+    // Wake every worker so it can see the shutdown
+    {
+      std::lock_guard<std::mutex> lock(m_sleep_lock);
+      m_running = false;
+    }
+    m_wake.notify_all();
+
+    for (std::thread &worker : m_workers)
+      worker.join();
+
+    // Finish anything that was still queued so no counter is left hanging
+    while (RunJob(0));
+
+    t_queue_index = -1;
+
+    LOG("JobSystem offline...\n");
+  }
+
+  void JobSystem::WorkerLoop(const unsigned int &index) {
+    t_queue_index = index;
+
+    while (m_running) {
+      if (RunJob(index))
+        continue;
+
+      // Nothing to do, sleep until a job is queued
+      std::unique_lock<std::mutex> lock(m_sleep_lock);
+      m_wake.wait(lock, [this]() { return m_queued.load() > 0 || !m_running; });
+    }
+  }
+
+  unsigned int JobSystem::GetQueueIndex() const {
+    if (t_queue_index < 0 || (size_t)t_queue_index >= m_queues.size())
+      return 0;
+
+    return t_queue_index;
+  }
+
+  void JobSystem::Push(const Job &job, JobCounter *counter) {
+    JobQueue &queue = *m_queues[GetQueueIndex()];
+
+    {
+      std::lock_guard<std::mutex> lock(queue.lock);
+      queue.jobs.push_back(std::pair<Job, JobCounter *>(job, counter));
+    }
+
+    m_queued++;
+
+    // Taking the sleep lock orders the wake up after any worker that is about to sleep
+    {
+      std::lock_guard<std::mutex> lock(m_sleep_lock);
+    }
+    m_wake.notify_one();
+  }
+
+  bool JobSystem::RunJob(const unsigned int &index) {
+    std::pair<Job, JobCounter *> entry;
+    bool found = false;
+
+    // Take the newest job from our own queue first, it is the most likely to be cache hot
+    {
+      JobQueue &queue = *m_queues[index];
+      std::lock_guard<std::mutex> lock(queue.lock);
+
+      if (!queue.jobs.empty()) {
+        entry = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+        found = true;
+      }
+    }
+
+    // Otherwise steal the oldest job of another thread
+    for (size_t i = 1; !found && i < m_queues.size(); i++) {
+      JobQueue &victim = *m_queues[(index + i) % m_queues.size()];
+      std::lock_guard<std::mutex> lock(victim.lock);
+
+      if (!victim.jobs.empty()) {
+        entry = std::move(victim.jobs.front());
+        victim.jobs.pop_front();
+        found = true;
+      }
+    }
+
+    if (!found)
+      return false;
+
+    m_queued--;
+
+    try {
+      entry.first();
+    }
+    catch (const std::exception &e) {
+      LOG_ERROR("Job threw an exception: %s\n", e.what());
+    }
+
+    Release(entry.second);
+
+    return true;
+  }
+
+  void JobSystem::Release(JobCounter *counter) {
+    if (!counter)
+      return;
+
+    std::vector<std::pair<Job, JobCounter *>> ready;
+
+    {
+      std::lock_guard<std::mutex> lock(counter->m_lock);
+
+      if (--counter->m_pending > 0)
+        return;
+
+      ready.swap(counter->m_continuations);
+    }
+
+    // The counter may be destroyed from here on, only touch the released jobs
+    for (const std::pair<Job, JobCounter *> &continuation : ready)
+      Push(continuation.first, continuation.second);
+  }
+
+  void JobSystem::Schedule(const Job &job, JobCounter *counter, JobCounter *dependency) {
+    if (counter)
+      counter->m_pending++;
+
+    if (dependency) {
+      std::lock_guard<std::mutex> lock(dependency->m_lock);
+
+      // Park the job on the dependency until it reaches zero
+      if (dependency->m_pending > 0) {
+        dependency->m_continuations.push_back(std::pair<Job, JobCounter *>(job, counter));
+        return;
+      }
+    }
+
+    Push(job, counter);
+  }
+
+  void JobSystem::Wait(JobCounter &counter) {
+    const unsigned int index = GetQueueIndex();
+
+    // Help out instead of blocking
+    while (!counter.IsDone()) {
+      if (!RunJob(index))
+        std::this_thread::yield();
+    }
+
+    // Make sure the thread that released the counter is done with it before the caller destroys it
+    std::lock_guard<std::mutex> lock(counter.m_lock);
+  }
+
+  void JobSystem::ParallelFor(
+    const size_t &count,
+    const size_t &grain,
+    const std::function<void(size_t, size_t)> &func
+  ) {
+    if (count == 0)
+      return;
+
+    const size_t chunk = std::max(grain, (size_t)1);
+
+    // Not worth splitting
+    if (count <= chunk || m_workers.empty()) {
+      func(0, count);
+      return;
+    }
+
+    JobCounter counter;
+
+    for (size_t begin = 0; begin < count; begin += chunk) {
+      const size_t end = std::min(begin + chunk, count);
+      Schedule([&func, begin, end]() { func(begin, end); }, &counter);
+    }
+
+    Wait(counter);
+  }
+
+  unsigned int JobSystem::GetThreadCount() const {
+    return m_queues.size();
+  }
+
+}
@@ -0,0 +1,460 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/core/Logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+
+// DEFINES //
+
+#define LOGGER_FLUSH_INTERVAL   std::chrono::milliseconds(10)   // Longest the flush thread sleeps for
+
+namespace elgar {
+
+  // LOCAL DATA //
+
+  static std::atomic<unsigned int> s_thread_count(0);   // Threads that have logged so far
+  static std::mutex s_drain_lock;                       // Only one thread may drain the ring at a time
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief The default sink, writes the message to stdout
+   *
+   */
+  static void WriteToStdout(const LogLevel &level, const uint64_t &, const unsigned int &, const char *message) {
+    if (level == LOG_LEVEL_WARNING)
+      fputs("WARNING: ", stdout);
+    else if (level == LOG_LEVEL_ERROR)
+      fputs("ERROR: ", stdout);
+
+    fputs(message, stdout);
+  }
+
+  /**
+   * @brief Format a single value onto the end of a string
+   *
+   * @param buffer  The string to append to
+   * @param spec    The printf conversion specification
+   * @param value   The value to format
+   */
+  template<typename T>
+  static void AppendFormatted(std::string &buffer, const char *spec, const T &value) {
+    char text[128];
+    const int length = snprintf(text, sizeof(text), spec, value);
+
+    if (length <= 0)
+      return;
+
+    if ((size_t)length < sizeof(text)) {
+      buffer.append(text, length);
+      return;
+    }
+
+    // Too long for the stack, format straight into the string
+    const size_t offset = buffer.size();
+    buffer.resize(offset + length + 1);
+    snprintf(&buffer[offset], length + 1, spec, value);
+    buffer.resize(offset + length);
+  }
+
+  // FUNCTIONS //
+
+  Logger::Logger() {
+    m_slots = new LogSlot[LOGGER_SLOT_COUNT];
+
+    for (size_t i = 0; i < LOGGER_SLOT_COUNT; i++)
+      m_slots[i].sequence.store(i, std::memory_order_relaxed);
+
+    m_enqueue = 0;
+    m_dequeue = 0;
+    m_dropped = 0;
+    m_level = LOG_LEVEL_DEBUG;
+    m_deferred = true;
+    m_sink = &WriteToStdout;
+
+    m_epoch = 0;
+    m_epoch = Now();
+
+    m_running = true;
+    m_thread = std::thread(&Logger::FlushLoop, this);
+  }
+
+  Logger::~Logger() {
+    // Do nothing, the Logger is never destroyed so that it stays usable during static destruction
+  }
+
+  Logger &Logger::Get() {
+    static Logger *logger = nullptr;
+    static std::once_flag once;
+
+    std::call_once(once, []() {
+      logger = new Logger();
+      std::atexit([]() { logger->Shutdown(); });
+    });
+
+    return *logger;
+  }
+
+  void Logger::Shutdown() {
+    Flush();
+
+    {
+      std::lock_guard<std::mutex> lock(m_lock);
+      m_running = false;
+    }
+    m_wake.notify_all();
+
+    if (m_thread.joinable())
+      m_thread.join();
+
+    // Anything that slipped in while the thread was stopping
+    std::lock_guard<std::mutex> lock(s_drain_lock);
+    Drain();
+  }
+
+  void Logger::FlushLoop() {
+    size_t reported = 0;
+
+    while (m_running) {
+      size_t written;
+      {
+        std::lock_guard<std::mutex> lock(s_drain_lock);
+        written = Drain();
+      }
+
+      // Let the user know the ring overflowed
+      const size_t dropped = m_dropped.load();
+      if (dropped != reported) {
+        fprintf(stdout, "WARNING: %zu log messages were dropped, the log ring was full!\n", dropped - reported);
+        reported = dropped;
+      }
+
+      std::unique_lock<std::mutex> lock(m_lock);
+      m_drained.notify_all();
+
+      if (written == 0)
+        m_wake.wait_for(lock, LOGGER_FLUSH_INTERVAL);
+    }
+  }
+
+  size_t Logger::Drain() {
+    std::string buffer;
+    size_t written = 0;
+
+    for (;;) {
+      const size_t position = m_dequeue.load(std::memory_order_relaxed);
+      LogSlot &slot = m_slots[position & (LOGGER_SLOT_COUNT - 1)];
+
+      // The producer has not finished filling the slot yet
+      if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+        break;
+
+      Emit(slot, buffer);
+
+      // Hand the slot back to the producers for the next lap of the ring
+      slot.sequence.store(position + LOGGER_SLOT_COUNT, std::memory_order_release);
+      m_dequeue.store(position + 1, std::memory_order_release);
+
+      written++;
+    }
+
+    if (written)
+      fflush(stdout);
+
+    return written;
+  }
+
+  void Logger::Emit(const LogSlot &slot, std::string &buffer) const {
+    if (!slot.deferred) {
+      buffer.assign(slot.data, slot.size);
+      m_sink.load()(slot.level, slot.time, slot.thread, buffer.c_str());
+      return;
+    }
+
+    const char *arg = slot.data;
+    const char *end = slot.data + slot.size;
+
+    buffer.clear();
+
+    for (const char *c = slot.format; *c; c++) {
+      // Copy the run of plain text up to the next specification
+      if (*c != '%') {
+        const char *next = strchr(c, '%');
+        const size_t length = next ? next - c : strlen(c);
+
+        buffer.append(c, length);
+        c += length - 1;
+        continue;
+      }
+
+      if (c[1] == '%') {
+        buffer += '%';
+        c++;
+        continue;
+      }
+
+      // Copy the flags/width/precision of the specification, then skip the length and find the
+      // conversion (the length modifier is rebuilt from the captured type)
+      const char *spec_begin = c++;
+
+      char spec[48];
+      size_t spec_length = 1;
+      bool missing = false;
+
+      spec[0] = '%';
+
+      while (*c && strchr("-+ #0123456789.*", *c)) {
+        if (*c != '*') {
+          if (spec_length < sizeof(spec) - 16)
+            spec[spec_length++] = *c;
+        }
+        else if (arg < end && (*arg == LOG_ARGUMENT_SIGNED || *arg == LOG_ARGUMENT_UNSIGNED)) {
+          // A '*' width or precision takes the next captured argument, written into the specification
+          int64_t value;
+          memcpy(&value, arg + 1, sizeof(value));
+          arg += 1 + sizeof(value);
+
+          const int star = (int)std::max<int64_t>(INT_MIN + 1, std::min<int64_t>(INT_MAX, value));
+
+          // A negative precision counts as none (a negative width is the '-' flag, as printf does)
+          if (star < 0 && spec[spec_length - 1] == '.')
+            spec_length--;
+          else if (spec_length < sizeof(spec) - 16)
+            spec_length += snprintf(spec + spec_length, 12, "%d", star);
+        }
+        else {
+          missing = true;
+        }
+
+        c++;
+      }
+
+      while (*c && strchr("hlLqjzt", *c))
+        c++;
+
+      const char conversion = *c;
+      if (!conversion) {
+        buffer.append(spec_begin);
+        break;
+      }
+
+      // Ran out of captured arguments (or the payload was truncated, or a '*' was not handed an
+      // integer), keep the specification as is
+      if (missing || arg >= end) {
+        buffer.append(spec_begin, c + 1 - spec_begin);
+        continue;
+      }
+
+      const char tag = *arg++;
+
+      if (tag == LOG_ARGUMENT_STRING) {
+        uint16_t length;
+        memcpy(&length, arg, sizeof(length));
+        arg += sizeof(length);
+
+        const std::string str(arg, length);
+        arg += length;
+
+        memcpy(spec + spec_length, "s", 2);
+        AppendFormatted(buffer, spec, conversion == 's' ? str.c_str() : "(string)");
+        continue;
+      }
+
+      uint64_t bits = 0;
+      memcpy(&bits, arg, sizeof(bits));
+      arg += sizeof(bits);
+
+      int64_t i_value = (int64_t)bits;
+      uint64_t u_value = bits;
+      double f_value = 0.0;
+      const void *p_value = nullptr;
+
+      if (tag == LOG_ARGUMENT_FLOAT) {
+        memcpy(&f_value, &bits, sizeof(f_value));
+        i_value = (int64_t)f_value;
+        u_value = (uint64_t)f_value;
+      }
+      else if (tag == LOG_ARGUMENT_POINTER) {
+        memcpy(&p_value, &bits, sizeof(p_value));
+      }
+      else {
+        f_value = tag == LOG_ARGUMENT_SIGNED ? (double)i_value : (double)u_value;
+      }
+
+      switch (conversion) {
+        case 'd':
+        case 'i':
+          memcpy(spec + spec_length, "lld", 4);
+          AppendFormatted(buffer, spec, (long long)i_value);
+          break;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+          memcpy(spec + spec_length, "ll", 2);
+          spec[spec_length + 2] = conversion;
+          spec[spec_length + 3] = '\0';
+          AppendFormatted(buffer, spec, (unsigned long long)u_value);
+          break;
+        case 'c':
+          memcpy(spec + spec_length, "c", 2);
+          AppendFormatted(buffer, spec, (int)i_value);
+          break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+          spec[spec_length] = conversion;
+          spec[spec_length + 1] = '\0';
+          AppendFormatted(buffer, spec, f_value);
+          break;
+        case 'p':
+          memcpy(spec + spec_length, "p", 2);
+          AppendFormatted(buffer, spec, p_value);
+          break;
+        default:
+          break;
+      }
+    }
+
+    m_sink.load()(slot.level, slot.time, slot.thread, buffer.c_str());
+  }
+
+  Logger::LogSlot *Logger::Claim(const LogLevel &level, size_t &position) {
+    position = m_enqueue.load(std::memory_order_relaxed);
+
+    for (;;) {
+      LogSlot &slot = m_slots[position & (LOGGER_SLOT_COUNT - 1)];
+      const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      const intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+      if (difference == 0) {
+        // The slot is free for this lap, try to take it
+        if (m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+          return &slot;
+      }
+      else if (difference < 0) {
+        // The flush thread is a whole lap behind, only warnings and errors are worth waiting for
+        if (level < LOG_LEVEL_WARNING || !m_running) {
+          m_dropped++;
+          return nullptr;
+        }
+
+        m_wake.notify_one();
+        std::this_thread::yield();
+        position = m_enqueue.load(std::memory_order_relaxed);
+      }
+      else {
+        // Another producer took the slot first
+        position = m_enqueue.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void Logger::Publish(LogSlot *slot, const size_t &position) {
+    const LogLevel level = slot->level;
+
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    // Nobody is left to write the message (the program is exiting), so write it here
+    if (!m_running) {
+      std::lock_guard<std::mutex> lock(s_drain_lock);
+      Drain();
+      return;
+    }
+
+    // Get warnings and errors out promptly, everything else waits for the next flush unless the
+    // ring is filling up
+    const size_t pending = position - m_dequeue.load(std::memory_order_relaxed);
+
+    if (level >= LOG_LEVEL_WARNING || pending >= LOGGER_SLOT_COUNT / 2)
+      m_wake.notify_one();
+  }
+
+  uint64_t Logger::Now() const {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() - m_epoch;
+  }
+
+  unsigned int Logger::GetThreadIndex() {
+    static thread_local unsigned int t_index = s_thread_count++;
+    return t_index;
+  }
+
+  bool Logger::Capture(char *data, uint16_t &size, const char &tag, const void *value, const size_t &bytes) {
+    if (size + 1 + bytes > LOGGER_PAYLOAD_SIZE)
+      return false;
+
+    data[size] = tag;
+    memcpy(data + size + 1, value, bytes);
+    size += 1 + bytes;
+
+    return true;
+  }
+
+  bool Logger::CaptureString(char *data, uint16_t &size, const char *str) {
+    if (size + 1 + sizeof(uint16_t) > LOGGER_PAYLOAD_SIZE)
+      return false;
+
+    const size_t room = LOGGER_PAYLOAD_SIZE - size - 1 - sizeof(uint16_t);
+    const size_t length = str ? strnlen(str, room) : 0;
+    const uint16_t stored = length;
+
+    data[size] = LOG_ARGUMENT_STRING;
+    memcpy(data + size + 1, &stored, sizeof(stored));
+    if (length)
+      memcpy(data + size + 1 + sizeof(stored), str, length);
+
+    size += 1 + sizeof(stored) + length;
+
+    return true;
+  }
+
+  void Logger::Flush() {
+    const size_t target = m_enqueue.load();
+
+    // Past shutdown there is no flush thread, so drain on the caller
+    if (!m_running) {
+      std::lock_guard<std::mutex> lock(s_drain_lock);
+      Drain();
+      return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    while (m_dequeue.load() < target) {
+      m_wake.notify_one();
+      m_drained.wait_for(lock, LOGGER_FLUSH_INTERVAL);
+    }
+  }
+
+  void Logger::SetLevel(const LogLevel &level) {
+    m_level = level;
+  }
+
+  void Logger::SetDeferred(const bool &deferred) {
+    m_deferred = deferred;
+  }
+
+  void Logger::SetSink(LogSink sink) {
+    m_sink = sink ? sink : &WriteToStdout;
+  }
+
+  size_t Logger::GetDroppedCount() const {
+    return m_dropped.load();
+  }
+
+}
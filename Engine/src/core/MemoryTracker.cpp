@@ -0,0 +1,139 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/core/MemoryTracker.hpp"
+#include "elgar/core/Macros.hpp"
+
+namespace elgar {
+
+  // LOCAL DATA //
+
+  static const char *s_category_names[MEMORY_CATEGORY_COUNT] = {
+    "Images",
+    "Meshes",
+    "Textures",
+    "Buffers",
+    "Audio"
+  };
+
+  static const MemoryDomain s_category_domains[MEMORY_CATEGORY_COUNT] = {
+    MEMORY_HOST,
+    MEMORY_HOST,
+    MEMORY_DEVICE,
+    MEMORY_DEVICE,
+    MEMORY_DEVICE
+  };
+
+  // FUNCTIONS //
+
+  MemoryTracker::MemoryTracker() {
+    for (MemoryCounter &counter : m_counters) {
+      counter.bytes = 0;
+      counter.peak_bytes = 0;
+      counter.allocations = 0;
+      counter.budget = 0;
+    }
+  }
+
+  MemoryTracker::~MemoryTracker() {
+    // Do nothing
+  }
+
+  MemoryTracker &MemoryTracker::Get() {
+    // Never destroyed so resources released during static destruction can still report in
+    static MemoryTracker *tracker = new MemoryTracker();
+    return *tracker;
+  }
+
+  const char *MemoryTracker::GetCategoryName(const MemoryCategory &category) {
+    return s_category_names[category];
+  }
+
+  MemoryDomain MemoryTracker::GetCategoryDomain(const MemoryCategory &category) {
+    return s_category_domains[category];
+  }
+
+  void MemoryTracker::Allocate(const MemoryCategory &category, const size_t &bytes) {
+    MemoryCounter &counter = m_counters[category];
+
+    const size_t held = counter.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    counter.allocations.fetch_add(1, std::memory_order_relaxed);
+
+    // Raise the peak (another thread may be raising it at the same time)
+    size_t peak = counter.peak_bytes.load(std::memory_order_relaxed);
+    while (held > peak && !counter.peak_bytes.compare_exchange_weak(peak, held, std::memory_order_relaxed));
+
+    // Only warn on the allocation that crosses the budget
+    const size_t budget = counter.budget.load(std::memory_order_relaxed);
+    if (budget > 0 && held > budget && held - bytes <= budget) {
+      LOG_WARNING("%s memory is over budget (%zu of %zu bytes)!\n",
+        s_category_names[category], held, budget);
+    }
+  }
+
+  void MemoryTracker::Release(const MemoryCategory &category, const size_t &bytes) {
+    MemoryCounter &counter = m_counters[category];
+
+    counter.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    counter.allocations.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void MemoryTracker::SetBudget(const MemoryCategory &category, const size_t &bytes) {
+    MemoryCounter &counter = m_counters[category];
+
+    counter.budget = bytes;
+
+    const size_t held = counter.bytes.load(std::memory_order_relaxed);
+    if (bytes > 0 && held > bytes) {
+      LOG_WARNING("%s memory is over budget (%zu of %zu bytes)!\n",
+        s_category_names[category], held, bytes);
+    }
+  }
+
+  size_t MemoryTracker::GetBytes(const MemoryCategory &category) const {
+    return m_counters[category].bytes.load(std::memory_order_relaxed);
+  }
+
+  MemorySnapshot MemoryTracker::GetSnapshot() const {
+    MemorySnapshot snapshot;
+    snapshot.host_bytes = 0;
+    snapshot.device_bytes = 0;
+
+    for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+      const MemoryCounter &counter = m_counters[i];
+
+      snapshot.bytes[i] = counter.bytes.load(std::memory_order_relaxed);
+      snapshot.peak_bytes[i] = counter.peak_bytes.load(std::memory_order_relaxed);
+      snapshot.allocations[i] = counter.allocations.load(std::memory_order_relaxed);
+      snapshot.budgets[i] = counter.budget.load(std::memory_order_relaxed);
+
+      if (s_category_domains[i] == MEMORY_HOST)
+        snapshot.host_bytes += snapshot.bytes[i];
+      else
+        snapshot.device_bytes += snapshot.bytes[i];
+    }
+
+    return snapshot;
+  }
+
+  void MemoryTracker::LogSnapshot() const {
+    const MemorySnapshot snapshot = GetSnapshot();
+
+    LOG("Memory held: %.2f MB host, %.2f MB device\n",
+      snapshot.host_bytes / (1024.0 * 1024.0), snapshot.device_bytes / (1024.0 * 1024.0));
+
+    for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+      LOG("  %-10s %10.2f KB in %6zu allocations (peak %.2f KB)\n",
+        s_category_names[i],
+        snapshot.bytes[i] / 1024.0,
+        snapshot.allocations[i],
+        snapshot.peak_bytes[i] / 1024.0);
+    }
+  }
+
+}
@@ -0,0 +1,193 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/core/Profiler.hpp"
+#include "elgar/core/Macros.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+namespace elgar {
+
+  // LOCAL DATA //
+
+  static std::atomic<uint32_t> s_generation(0);    // Bumped every time a Profiler is created
+
+  static thread_local ProfileBuffer *t_buffer = nullptr;    // Buffer of the calling thread
+  static thread_local uint32_t t_generation = 0;            // Profiler generation the buffer belongs to
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief Write a string to a JSON file, escaping anything that would break the string literal
+   *
+   * @param file  The file to write to
+   * @param str   The string to write
+   */
+  static void WriteJSONString(FILE *file, const char *str) {
+    fputc('"', file);
+
+    for (const char *c = str; *c; c++) {
+      if (*c == '"' || *c == '\\')
+        fputc('\\', file);
+
+      fputc(((unsigned char)*c < 0x20) ? ' ' : *c, file);
+    }
+
+    fputc('"', file);
+  }
+
+  // FUNCTIONS //
+
+  Profiler::Profiler() : Singleton<Profiler>(this) {
+    m_generation = ++s_generation;
+    m_epoch = 0;
+    m_epoch = Now();
+    m_enabled = true;
+
+    LOG("Profiler online...\n");
+  }
+
+  Profiler::~Profiler() {
+    LOG("Profiler offline...\n");
+  }
+
+  uint64_t Profiler::Now() const {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() - m_epoch;
+  }
+
+  ProfileBuffer *Profiler::GetThreadBuffer() {
+    // Fast path, the thread has already registered with this profiler
+    if (t_buffer && t_generation == m_generation)
+      return t_buffer;
+
+    ProfileBuffer *buffer = new ProfileBuffer();
+    buffer->events.resize(PROFILER_THREAD_CAPACITY);
+    buffer->head = 0;
+    buffer->depth = 0;
+
+    {
+      std::lock_guard<std::mutex> lock(m_lock);
+      buffer->thread = m_buffers.size();
+      m_buffers.push_back(std::unique_ptr<ProfileBuffer>(buffer));
+    }
+
+    t_buffer = buffer;
+    t_generation = m_generation;
+
+    return buffer;
+  }
+
+  void Profiler::SetEnabled(const bool &enabled) {
+    m_enabled = enabled;
+  }
+
+  bool Profiler::IsEnabled() const {
+    return m_enabled.load(std::memory_order_relaxed);
+  }
+
+  void Profiler::Clear() {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    for (std::unique_ptr<ProfileBuffer> &buffer : m_buffers)
+      buffer->head.store(0, std::memory_order_release);
+  }
+
+  bool Profiler::WriteChromeTrace(const std::string &path) const {
+    FILE *file = fopen(path.c_str(), "w");
+
+    if (!file) {
+      LOG_ERROR("Could not open %s to write the profiler trace!\n", path.c_str());
+      return false;
+    }
+
+    std::vector<ProfileEvent> events;
+    bool first = true;
+
+    fprintf(file, "{\"traceEvents\":[\n");
+
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    for (const std::unique_ptr<ProfileBuffer> &buffer : m_buffers) {
+      // Name the thread in the viewer
+      fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Thread %u\"}}",
+        first ? "" : ",\n", buffer->thread, buffer->thread);
+      first = false;
+
+      // Copy out what the ring holds right now
+      const uint64_t head = buffer->head.load(std::memory_order_acquire);
+      const uint64_t tail = head > PROFILER_THREAD_CAPACITY ? head - PROFILER_THREAD_CAPACITY : 0;
+
+      events.clear();
+      for (uint64_t i = tail; i < head; i++)
+        events.push_back(buffer->events[i & (PROFILER_THREAD_CAPACITY - 1)]);
+
+      // The owner kept recording while we copied, so drop whatever it may have overwritten
+      const uint64_t end = buffer->head.load(std::memory_order_acquire);
+      const uint64_t skip = end > PROFILER_THREAD_CAPACITY + tail ? end - PROFILER_THREAD_CAPACITY - tail : 0;
+
+      for (size_t i = skip; i < events.size(); i++) {
+        const ProfileEvent &event = events[i];
+
+        fprintf(file, ",\n{\"name\":");
+        WriteJSONString(file, event.name);
+        fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u,\"args\":{\"depth\":%u}}",
+          event.start / 1000.0, (event.end - event.start) / 1000.0, buffer->thread, event.depth);
+      }
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    LOG("Profiler trace written to %s...\n", path.c_str());
+
+    return true;
+  }
+
+  ProfileZone::ProfileZone(const char *name) {
+    Profiler *profiler = Profiler::GetInstance();
+
+    m_buffer = nullptr;
+    m_name = name;
+    m_start = 0;
+
+    if (!profiler || !profiler->IsEnabled())
+      return;
+
+    m_buffer = profiler->GetThreadBuffer();
+    m_buffer->depth++;
+    m_start = profiler->Now();
+  }
+
+  ProfileZone::~ProfileZone() {
+    if (!m_buffer)
+      return;
+
+    Profiler *profiler = Profiler::GetInstance();
+
+    // The profiler went away (along with the buffer) while the zone was open
+    if (!profiler || t_generation != profiler->m_generation)
+      return;
+
+    m_buffer->depth--;
+
+    // Only this thread writes the buffer, so a plain load of head is enough
+    const uint64_t head = m_buffer->head.load(std::memory_order_relaxed);
+
+    ProfileEvent &event = m_buffer->events[head & (PROFILER_THREAD_CAPACITY - 1)];
+    event.name = m_name;
+    event.start = m_start;
+    event.end = profiler->Now();
+    event.depth = m_buffer->depth;
+
+    // Publish the event to WriteChromeTrace
+    m_buffer->head.store(head + 1, std::memory_order_release);
+  }
+
+}
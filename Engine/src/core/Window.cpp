@@ -9,9 +9,16 @@
 #include "elgar/core/Window.hpp"
 #include "elgar/core/Exception.hpp"
 #include "elgar/core/Macros.hpp"
+#include "elgar/graphics/buffers/FrameBufferObject.hpp"
+#include "elgar/graphics/GPUTimer.hpp"
 
 #include <GL/glew.h>
 
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstring>
+
 namespace elgar {
 
   // FUNCTIONS //
@@ -23,6 +30,33 @@ namespace elgar {
     const unsigned char &flags
   ) : Singleton<Window>(this) {
 
+    m_window = nullptr;
+    m_context = nullptr;
+    m_egl_display = nullptr;
+    m_egl_context = nullptr;
+    m_framebuffer = nullptr;
+    m_renderbuffers[0] = m_renderbuffers[1] = 0;
+
+    m_dimensions = glm::vec2(width, height);  // Store the screen dimensions
+    m_vsync_mode = VSYNC_OFF;
+
+    // Render into a frame buffer instead of a window
+    if (flags & OFFSCREEN) {
+      CreateOffscreenContext();
+
+      if (!InitGL()) {
+        eglDestroyContext(m_egl_display, m_egl_context);
+        eglTerminate(m_egl_display);
+
+        throw Exception("ERROR: Failed to initialize OpenGL!");
+      }
+
+      CreateOffscreenTarget();
+
+      LOG("Offscreen render target successfully created!\n");
+      return;
+    }
+
     Uint32 params = 0;  // SDL2 window params
 
     // Handle error cases
@@ -71,8 +105,6 @@ namespace elgar {
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG);
     #endif
 
-    m_dimensions = glm::vec2(width, height);  // Store the screen dimensions
-
     m_window = SDL_CreateWindow(
       name.c_str(), // The name of the window
       SDL_WINDOWPOS_CENTERED, // Center the window on the screen
@@ -107,14 +139,53 @@ namespace elgar {
   }
 
   Window::~Window() {
+    if (IsOffscreen()) {
+      // Destroy the frame buffer and the EGL context
+      delete m_framebuffer;
+      glDeleteRenderbuffers(2, m_renderbuffers);
+
+      eglMakeCurrent(m_egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+      eglDestroyContext(m_egl_display, m_egl_context);
+      eglTerminate(m_egl_display);
+
+      LOG("Offscreen render target destroyed!\n");
+      return;
+    }
+
     SDL_GL_DeleteContext(m_context); // Destroy the OpenGL context
     SDL_DestroyWindow(m_window);  // Destroy the window
 
     LOG("Window destroyed!\n");
   }
 
-  void Window::Present(void (*render)()) {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+  void Window::AcquireContext() {
+    bool current;
+
+    if (IsOffscreen())
+      current = eglMakeCurrent(m_egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_egl_context);
+    else
+      current = SDL_GL_MakeCurrent(m_window, m_context) == 0;
+
+    if (!current)
+      throw Exception("ERROR: Failed to make the OpenGL context current!");
+  }
+
+  void Window::ReleaseContext() {
+    if (IsOffscreen())
+      eglMakeCurrent(m_egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    else
+      SDL_GL_MakeCurrent(m_window, nullptr);
+  }
+
+  void Window::Present(const std::function<void()> &render) {
+    // Offscreen frames are drawn into the frame buffer
+    if (m_framebuffer)
+      m_framebuffer->Bind();
+
+    {
+      GPU_ZONE("Clear");
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    }
 
     /*
      *  Draw things in here
@@ -124,19 +195,135 @@ namespace elgar {
     if (render)
       render();
 
-    SDL_GL_SwapWindow(m_window);
+    // There is nothing to swap offscreen, just hand the frame to the driver
+    GPU_ZONE("Swap");
+
+    if (IsOffscreen())
+      glFlush();
+    else
+      SDL_GL_SwapWindow(m_window);
+  }
+
+  void Window::CreateOffscreenContext() {
+    EGLDisplay display = EGL_NO_DISPLAY;
+
+    // Prefer Mesa's surfaceless platform, which needs no display server at all
+    const char *client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+    if (client_extensions && strstr(client_extensions, "EGL_MESA_platform_surfaceless")) {
+      PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display = 
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+      if (get_platform_display)
+        display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    }
+
+    if (display == EGL_NO_DISPLAY)
+      display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL))
+      throw Exception("ERROR: Failed to initialize EGL display!");
+
+    const char *extensions = eglQueryString(display, EGL_EXTENSIONS);
+
+    if (!extensions || !strstr(extensions, "EGL_KHR_surfaceless_context")) {
+      eglTerminate(display);
+      throw Exception("ERROR: EGL display does not support surfaceless contexts!");
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+      eglTerminate(display);
+      throw Exception("ERROR: EGL does not support desktop OpenGL!");
+    }
+
+    const EGLint config_attribs[] = {
+      EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+      EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+      EGL_NONE
+    };
+
+    EGLConfig config;
+    EGLint config_count = 0;
+
+    if (!eglChooseConfig(display, config_attribs, &config, 1, &config_count) || config_count == 0) {
+      eglTerminate(display);
+      throw Exception("ERROR: Failed to find an EGL config for OpenGL!");
+    }
+
+    // Request the same context the windowed path does
+    const EGLint context_attribs[] = {
+      EGL_CONTEXT_MAJOR_VERSION, DEFAULT_GL_MAJOR_VERSION,
+      EGL_CONTEXT_MINOR_VERSION, DEFAULT_GL_MINOR_VERSION,
+      EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+      EGL_NONE
+    };
+
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attribs);
+
+    if (context == EGL_NO_CONTEXT) {
+      eglTerminate(display);
+      throw Exception("ERROR: Failed to create EGL OpenGL context!");
+    }
+
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+      eglDestroyContext(display, context);
+      eglTerminate(display);
+      throw Exception("ERROR: Failed to make EGL context current!");
+    }
+
+    m_egl_display = display;
+    m_egl_context = context;
+  }
+
+  void Window::CreateOffscreenTarget() {
+    glGenRenderbuffers(2, m_renderbuffers);
+
+    // Color storage
+    glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_dimensions.x, m_dimensions.y);
+
+    // Depth and stencil storage
+    glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_dimensions.x, m_dimensions.y);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    m_framebuffer = new FrameBufferObject();
+    m_framebuffer->Bind();
+
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_renderbuffers[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_renderbuffers[1]);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+      delete m_framebuffer;
+      glDeleteRenderbuffers(2, m_renderbuffers);
+
+      eglMakeCurrent(m_egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+      eglDestroyContext(m_egl_display, m_egl_context);
+      eglTerminate(m_egl_display);
+
+      throw Exception("ERROR: Offscreen frame buffer is incomplete!");
+    }
   }
 
   bool Window::InitGL() {
-    SetVerticalSync(true);  // Enable V-sync by default
+    // Offscreen frames are never presented, so there is nothing to sync to
+    if (!m_egl_context)
+      SetVSyncMode(DEFAULT_VSYNC_MODE);
 
     // Initialize glew
     glewExperimental = true;
     GLenum code = glewInit();
 
+    #ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // GLEW built against GLX loads the core entry points before failing to find a GLX display
+    if (code == GLEW_ERROR_NO_GLX_DISPLAY && m_egl_context)
+      code = GLEW_OK;
+    #endif
+
     if (code != GLEW_OK) {
-      LOG("ERROR: Failed to initialize GLEW!\n");
-      LOG("OpenGL_Error: %s\n", glewGetErrorString(code));
+      LOG_ERROR("Failed to initialize GLEW!\n");
+      LOG_ERROR("OpenGL_Error: %s\n", glewGetErrorString(code));
       return false;
     }
 
@@ -147,8 +334,8 @@ namespace elgar {
 
     code = glGetError();
     if (code != GL_NO_ERROR) {
-      LOG("ERROR: Failed to set viewport!\n");
-      LOG("OpenGL_Error: %s\n", glewGetErrorString(code));
+      LOG_ERROR("Failed to set viewport!\n");
+      LOG_ERROR("OpenGL_Error: %s\n", glewGetErrorString(code));
       return false;
     }
 
@@ -157,8 +344,8 @@ namespace elgar {
 
     code = glGetError();
     if (code != GL_NO_ERROR) {
-      LOG("ERROR: Failed to set clear color!\n");
-      LOG("OpenGL_Error: %s\n", glewGetErrorString(code));
+      LOG_ERROR("Failed to set clear color!\n");
+      LOG_ERROR("OpenGL_Error: %s\n", glewGetErrorString(code));
       return false;
     }
 
@@ -168,8 +355,8 @@ namespace elgar {
 
     code = glGetError();
     if (code != GL_NO_ERROR) {
-      LOG("ERROR: Failed to enable depth testing!\n");
-      LOG("OpenGL_Error: %s\n", glewGetErrorString(code));
+      LOG_ERROR("Failed to enable depth testing!\n");
+      LOG_ERROR("OpenGL_Error: %s\n", glewGetErrorString(code));
       return false;
     }
 
@@ -178,8 +365,8 @@ namespace elgar {
 
     code = glGetError();
     if (code != GL_NO_ERROR) {
-      LOG("ERROR: Failed to enable multisampling!\n");
-      LOG("OpenGL_Error: %s\n", glewGetErrorString(code));
+      LOG_ERROR("Failed to enable multisampling!\n");
+      LOG_ERROR("OpenGL_Error: %s\n", glewGetErrorString(code));
       return false;
     }
 
@@ -188,28 +375,74 @@ namespace elgar {
 
     code = glGetError();
     if (code != GL_NO_ERROR) {
-      LOG("ERROR: Failed to enable vertex culling!\n");
-      LOG("OpenGL_Error: %s\n", glewGetErrorString(code));
+      LOG_ERROR("Failed to enable vertex culling!\n");
+      LOG_ERROR("OpenGL_Error: %s\n", glewGetErrorString(code));
       return false;
     }
 
     return true;
   }
 
-  void Window::SetVerticalSync(const bool &value) const {
-    if (value) {
+  void Window::SetVerticalSync(const bool &value) {
+    SetVSyncMode(value ? VSYNC_ON : VSYNC_OFF);
+  }
+
+  VSyncMode Window::SetVSyncMode(const VSyncMode &mode) {
+    if (IsOffscreen())
+      return m_vsync_mode;   // Nothing is presented offscreen
+
+    m_vsync_mode = VSYNC_OFF;
+
+    if (mode == VSYNC_ADAPTIVE) {
+      // Late swap tearing is an optional extension, a swap interval of -1 fails without it
+      if (SDL_GL_SetSwapInterval(-1) == 0) {
+        m_vsync_mode = VSYNC_ADAPTIVE;
+        return m_vsync_mode;
+      }
+
+      LOG_WARNING("Adaptive vertical sync unsupported, falling back to vertical sync!\n");
+      SDL_ClearError();
+    }
+
+    if (mode != VSYNC_OFF) {
       if (SDL_GL_SetSwapInterval(1) < 0) {
-        LOG("Warning: Failed to enable vertical sync!\n");
-        LOG("SDL_Error: %s\n", SDL_GetError());
+        LOG_WARNING("Failed to enable vertical sync!\n");
+        LOG_ERROR("SDL_Error: %s\n", SDL_GetError());
         SDL_ClearError();
       }
+      else
+        m_vsync_mode = VSYNC_ON;
     }
     else
       SDL_GL_SetSwapInterval(0);
+
+    return m_vsync_mode;
+  }
+
+  const VSyncMode &Window::GetVSyncMode() const {
+    return m_vsync_mode;
+  }
+
+  bool Window::IsMinimized() const {
+    if (!m_window)
+      return false;
+
+    return (SDL_GetWindowFlags(m_window) & (SDL_WINDOW_MINIMIZED | SDL_WINDOW_HIDDEN)) != 0;
+  }
+
+  bool Window::HasFocus() const {
+    if (!m_window)
+      return true;
+
+    return (SDL_GetWindowFlags(m_window) & SDL_WINDOW_INPUT_FOCUS) != 0;
   }
 
   glm::vec2 Window::GetDimensions() const {
     return m_dimensions;
   }
 
+  bool Window::IsOffscreen() const {
+    return m_egl_context != nullptr;
+  }
+
 }
\ No newline at end of file
@@ -0,0 +1,161 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/ecs/Archetype.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace elgar {
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief Round an offset up to the column alignment
+   *
+   * @param offset  The offset
+   * @return The aligned offset
+   */
+  static size_t AlignColumn(const size_t &offset) {
+    return (offset + ECS_COLUMN_ALIGNMENT - 1) & ~(size_t)(ECS_COLUMN_ALIGNMENT - 1);
+  }
+
+  // FUNCTIONS //
+
+  Archetype::Archetype(const ComponentMask &mask) {
+    m_mask = mask;
+    m_count = 0;
+
+    for (int i = 0; i < ECS_MAX_COMPONENTS; i++) {
+      m_columns[i] = -1;
+      m_add_edges[i] = nullptr;
+      m_remove_edges[i] = nullptr;
+    }
+
+    size_t row_size = sizeof(Entity);
+
+    for (ComponentId id = 0; id < ECS_MAX_COMPONENTS; id++) {
+      if (!(mask & (ComponentMask(1) << id)))
+        continue;
+
+      m_columns[id] = m_components.size();
+      m_components.push_back(id);
+      m_sizes.push_back(ComponentRegistry::GetInfo(id).size);
+
+      row_size += m_sizes.back();
+    }
+
+    m_offsets.resize(m_components.size());
+
+    // Fit as many rows as possible while leaving room to align every array
+    const size_t padding = ECS_COLUMN_ALIGNMENT * (m_components.size() + 1);
+    m_capacity = ECS_CHUNK_SIZE > padding ? (ECS_CHUNK_SIZE - padding) / row_size : 0;
+    m_capacity = std::max(m_capacity, (size_t)1);
+
+    // The entities come first, then every component array
+    size_t offset = AlignColumn(sizeof(Entity) * m_capacity);
+
+    for (size_t i = 0; i < m_components.size(); i++) {
+      m_offsets[i] = offset;
+      offset = AlignColumn(offset + m_sizes[i] * m_capacity);
+    }
+
+    m_chunk_bytes = offset;
+  }
+
+  Archetype::~Archetype() {
+    // Do nothing
+  }
+
+  size_t Archetype::AddRow(const Entity &entity) {
+    const size_t row = m_count;
+    const size_t chunk = row / m_capacity;
+
+    // Grow by a chunk (a spare one may still be around from earlier removals)
+    if (chunk == m_chunks.size()) {
+      unsigned char *memory = new unsigned char[m_chunk_bytes + ECS_COLUMN_ALIGNMENT];
+
+      m_chunks.push_back(std::unique_ptr<unsigned char[]>(memory));
+      m_chunk_data.push_back((unsigned char *)AlignColumn((size_t)memory));
+    }
+
+    reinterpret_cast<Entity *>(m_chunk_data[chunk])[row % m_capacity] = entity;
+    m_count++;
+
+    return row;
+  }
+
+  bool Archetype::RemoveRow(const size_t &row, Entity &moved) {
+    const size_t last = --m_count;
+    bool moved_row = false;
+
+    if (row != last) {
+      unsigned char *data = m_chunk_data[row / m_capacity];
+      unsigned char *last_data = m_chunk_data[last / m_capacity];
+      const size_t index = row % m_capacity;
+      const size_t last_index = last % m_capacity;
+
+      for (size_t i = 0; i < m_components.size(); i++) {
+        std::memcpy(
+          data + m_offsets[i] + index * m_sizes[i],
+          last_data + m_offsets[i] + last_index * m_sizes[i],
+          m_sizes[i]
+        );
+      }
+
+      Entity *entities = reinterpret_cast<Entity *>(data);
+      entities[index] = reinterpret_cast<Entity *>(last_data)[last_index];
+
+      moved = entities[index];
+      moved_row = true;
+    }
+
+    // Keep a single spare chunk around so an entity bouncing across a boundary does not thrash
+    const size_t needed = (m_count + m_capacity - 1) / m_capacity;
+    while (m_chunks.size() > needed + 1) {
+      m_chunks.pop_back();
+      m_chunk_data.pop_back();
+    }
+
+    return moved_row;
+  }
+
+  void Archetype::CopyRow(const size_t &row, const Archetype &source, const size_t &source_row) {
+    for (size_t i = 0; i < m_components.size(); i++) {
+      const int column = source.m_columns[m_components[i]];
+
+      if (column >= 0)
+        std::memcpy(GetComponent(row, i), source.GetComponent(source_row, column), m_sizes[i]);
+    }
+  }
+
+  void *Archetype::GetComponent(const size_t &row, const int &column) const {
+    return m_chunk_data[row / m_capacity] + m_offsets[column] + (row % m_capacity) * m_sizes[column];
+  }
+
+  const ComponentMask &Archetype::GetMask() const {
+    return m_mask;
+  }
+
+  const size_t &Archetype::GetEntityCount() const {
+    return m_count;
+  }
+
+  size_t Archetype::GetChunkCount() const {
+    return (m_count + m_capacity - 1) / m_capacity;
+  }
+
+  size_t Archetype::GetChunkEntityCount(const size_t &chunk) const {
+    return std::min(m_capacity, m_count - chunk * m_capacity);
+  }
+
+  const Entity *Archetype::GetEntities(const size_t &chunk) const {
+    return reinterpret_cast<const Entity *>(m_chunk_data[chunk]);
+  }
+
+}
@@ -0,0 +1,40 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/ecs/Entity.hpp"
+#include "elgar/core/Exception.hpp"
+
+#include <mutex>
+
+namespace elgar {
+
+  // LOCAL DATA //
+
+  static std::mutex s_lock;   // Guards registration
+  static ComponentInfo s_components[ECS_MAX_COMPONENTS];  // Every registered component type
+  static ComponentId s_component_count = 0;               // Number of registered component types
+
+  // FUNCTIONS //
+
+  ComponentId ComponentRegistry::Register(const size_t &size, const size_t &alignment) {
+    std::lock_guard<std::mutex> lock(s_lock);
+
+    if (s_component_count == ECS_MAX_COMPONENTS)
+      throw Exception("ERROR: Too many component types registered!");
+
+    s_components[s_component_count].size = size;
+    s_components[s_component_count].alignment = alignment;
+
+    return s_component_count++;
+  }
+
+  const ComponentInfo &ComponentRegistry::GetInfo(const ComponentId &id) {
+    return s_components[id];
+  }
+
+}
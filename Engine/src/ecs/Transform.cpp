@@ -0,0 +1,36 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/ecs/Transform.hpp"
+#include "elgar/core/Macros.hpp"
+
+namespace elgar {
+
+  // FUNCTIONS //
+
+  void StorePreviousTransforms(World &world) {
+    PROFILE_ZONE("StorePreviousTransforms");
+
+    // Straight array copies, chunk by chunk
+    world.ParallelEachChunk<Position, PreviousPosition>([](const size_t &count, Position *current, PreviousPosition *previous) {
+      for (size_t i = 0; i < count; i++)
+        previous[i].value = current[i].value;
+    });
+
+    world.ParallelEachChunk<Scale, PreviousScale>([](const size_t &count, Scale *current, PreviousScale *previous) {
+      for (size_t i = 0; i < count; i++)
+        previous[i].value = current[i].value;
+    });
+
+    world.ParallelEachChunk<Rotation, PreviousRotation>([](const size_t &count, Rotation *current, PreviousRotation *previous) {
+      for (size_t i = 0; i < count; i++)
+        previous[i].value = current[i].value;
+    });
+  }
+
+}
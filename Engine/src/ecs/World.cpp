@@ -0,0 +1,179 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/ecs/World.hpp"
+#include "elgar/core/Exception.hpp"
+
+namespace elgar {
+
+  // FUNCTIONS //
+
+  World::World() {
+    m_entity_count = 0;
+  }
+
+  World::~World() {
+    // Do nothing
+  }
+
+  Archetype *World::GetArchetype(const ComponentMask &mask) {
+    auto it = m_archetypes.find(mask);
+    if (it != m_archetypes.end())
+      return it->second.get();
+
+    Archetype *archetype = new Archetype(mask);
+
+    m_archetypes[mask] = std::unique_ptr<Archetype>(archetype);
+    m_archetype_list.push_back(archetype);
+
+    return archetype;
+  }
+
+  Entity World::CreateEntity() {
+    return CreateEntity(GetArchetype(0));
+  }
+
+  Entity World::CreateEntity(Archetype *archetype) {
+    Entity entity;
+
+    if (!m_free.empty()) {
+      entity.index = m_free.back();
+      m_free.pop_back();
+    }
+    else {
+      entity.index = m_records.size();
+      m_records.push_back({nullptr, 0, 0});
+    }
+
+    EntityRecord &record = m_records[entity.index];
+    entity.generation = record.generation;
+
+    record.archetype = archetype;
+    record.row = archetype->AddRow(entity);
+
+    m_entity_count++;
+
+    return entity;
+  }
+
+  void World::DestroyEntity(const Entity &entity) {
+    EntityRecord &record = GetRecord(entity);
+
+    Entity moved;
+    if (record.archetype->RemoveRow(record.row, moved))
+      m_records[moved.index].row = record.row;
+
+    record.archetype = nullptr;
+    record.generation++;
+
+    m_free.push_back(entity.index);
+    m_entity_count--;
+  }
+
+  bool World::IsAlive(const Entity &entity) const {
+    return entity.index < m_records.size()
+      && m_records[entity.index].archetype
+      && m_records[entity.index].generation == entity.generation;
+  }
+
+  World::EntityRecord &World::GetRecord(const Entity &entity) {
+    if (!IsAlive(entity))
+      throw Exception("ERROR: Attempted to use an entity that does not exist!");
+
+    return m_records[entity.index];
+  }
+
+  void World::MoveEntity(const Entity &entity, Archetype *target) {
+    EntityRecord &record = m_records[entity.index];
+    Archetype *source = record.archetype;
+
+    const size_t row = target->AddRow(entity);
+    target->CopyRow(row, *source, record.row);
+
+    Entity moved;
+    if (source->RemoveRow(record.row, moved))
+      m_records[moved.index].row = record.row;
+
+    record.archetype = target;
+    record.row = row;
+  }
+
+  void *World::GetComponentData(const Entity &entity, const ComponentId &id) const {
+    if (!IsAlive(entity))
+      return nullptr;
+
+    const EntityRecord &record = m_records[entity.index];
+    const int column = record.archetype->m_columns[id];
+
+    if (column < 0)
+      return nullptr;
+
+    return record.archetype->GetComponent(record.row, column);
+  }
+
+  void *World::AddComponentData(const Entity &entity, const ComponentId &id) {
+    EntityRecord &record = GetRecord(entity);
+    Archetype *source = record.archetype;
+
+    if (source->m_columns[id] < 0) {
+      // Follow the cached edge to the archetype with the component added
+      Archetype *target = source->m_add_edges[id];
+
+      if (!target) {
+        target = GetArchetype(source->GetMask() | (ComponentMask(1) << id));
+
+        source->m_add_edges[id] = target;
+        target->m_remove_edges[id] = source;
+      }
+
+      MoveEntity(entity, target);
+    }
+
+    return record.archetype->GetComponent(record.row, record.archetype->m_columns[id]);
+  }
+
+  void World::RemoveComponent(const Entity &entity, const ComponentId &id) {
+    EntityRecord &record = GetRecord(entity);
+    Archetype *source = record.archetype;
+
+    if (source->m_columns[id] < 0)
+      return;
+
+    // Follow the cached edge to the archetype with the component removed
+    Archetype *target = source->m_remove_edges[id];
+
+    if (!target) {
+      target = GetArchetype(source->GetMask() & ~(ComponentMask(1) << id));
+
+      source->m_remove_edges[id] = target;
+      target->m_add_edges[id] = source;
+    }
+
+    MoveEntity(entity, target);
+  }
+
+  void World::GetChunks(const ComponentMask &mask, std::vector<std::pair<Archetype *, size_t>> &chunks) const {
+    for (Archetype *archetype : m_archetype_list) {
+      if ((archetype->GetMask() & mask) != mask)
+        continue;
+
+      const size_t count = archetype->GetChunkCount();
+      for (size_t chunk = 0; chunk < count; chunk++)
+        chunks.push_back(std::make_pair(archetype, chunk));
+    }
+  }
+
+  const size_t &World::GetEntityCount() const {
+    return m_entity_count;
+  }
+
+  size_t World::GetArchetypeCount() const {
+    return m_archetype_list.size();
+  }
+
+}
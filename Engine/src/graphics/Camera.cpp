@@ -7,6 +7,7 @@
 // INCLUDES //
 
 #include "elgar/graphics/Camera.hpp"
+#include "elgar/graphics/CommandList.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -14,9 +15,40 @@ namespace elgar {
 
   // FUNCTIONS //
 
+  void Camera::UpdateViewVolume() {
+    const glm::mat4 view_projection = m_projection_matrix * m_view_matrix;
+
+    m_frustum = Frustum::FromMatrix(view_projection);
+
+    // Perspective projections copy -z into w, orthographic ones leave w at 1
+    m_orthographic = m_projection_matrix[2][3] == 0.0f && m_projection_matrix[3][3] == 1.0f;
+
+    // Bound the corners of the clip space cube
+    const glm::mat4 inverse = glm::inverse(view_projection);
+
+    for (int i = 0; i < 8; i++) {
+      const glm::vec4 corner = inverse * glm::vec4(
+        (i & 1) ? 1.0f : -1.0f,
+        (i & 2) ? 1.0f : -1.0f,
+        (i & 4) ? 1.0f : -1.0f,
+        1.0f
+      );
+      const glm::vec3 point = glm::vec3(corner) / corner.w;
+
+      if (i == 0) {
+        m_view_bounds = AABB{point, point};
+      } else {
+        m_view_bounds.min = glm::min(m_view_bounds.min, point);
+        m_view_bounds.max = glm::max(m_view_bounds.max, point);
+      }
+    }
+  }
+
   Camera::Camera(const glm::mat4 &projection, const glm::mat4 &view) {
-    SetProjectionMatrix(projection);
-    SetViewMatrix(view);
+    m_projection_matrix = projection;
+    m_view_matrix = view;
+
+    UpdateViewVolume();
   }
 
   Camera::~Camera() {
@@ -25,18 +57,22 @@ namespace elgar {
 
   void Camera::SetProjectionMatrix(const glm::mat4 &projection) {
     m_projection_matrix = projection;
+    UpdateViewVolume();
   }
 
   void Camera::SetViewMatrix(const glm::mat4 &view) {
     m_view_matrix = view;
+    UpdateViewVolume();
   }
 
   void Camera::SetPosition(const glm::vec3 &position) {
     m_view_matrix = glm::translate(glm::mat4(), -position);
+    UpdateViewVolume();
   }
 
   void Camera::ChangePosition(const glm::vec3 &delta) {
     m_view_matrix = glm::translate(m_view_matrix, -delta);
+    UpdateViewVolume();
   }
 
   const glm::mat4 &Camera::GetProjectionMatrix() const {
@@ -47,7 +83,26 @@ namespace elgar {
     return m_view_matrix;
   }
 
+  const Frustum &Camera::GetFrustum() const {
+    return m_frustum;
+  }
+
+  const AABB &Camera::GetViewBounds() const {
+    return m_view_bounds;
+  }
+
+  const bool &Camera::IsOrthographic() const {
+    return m_orthographic;
+  }
+
   void Camera::Draw(const Shader &shader) const {
+    // Defer the uniforms to the render thread
+    CommandList *list = CommandList::GetRecording();
+    if (list) {
+      list->RecordCamera(shader, m_projection_matrix, m_view_matrix);
+      return;
+    }
+
     shader.Use();   // Use the shader program
 
     // Set projection and view matrices for the shader
@@ -0,0 +1,200 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/graphics/CommandList.hpp"
+#include "elgar/graphics/Camera.hpp"
+#include "elgar/graphics/renderers/SpriteRenderer.hpp"
+#include "elgar/graphics/renderers/MeshRenderer.hpp"
+#include "elgar/graphics/renderers/TextRenderer.hpp"
+
+#include "elgar/core/Macros.hpp"
+
+namespace elgar {
+
+  // LOCAL DATA //
+
+  static thread_local CommandList *t_recording = nullptr;   // The list the thread records into
+
+  // FUNCTIONS //
+
+  CommandList::CommandList() {
+    m_text_count = 0;
+  }
+
+  CommandList::~CommandList() {
+    // Do nothing
+  }
+
+  CommandList *CommandList::GetRecording() {
+    return t_recording;
+  }
+
+  void CommandList::SetRecording(CommandList *list) {
+    t_recording = list;
+  }
+
+  void CommandList::Push(Command command, const glm::mat4 *matrices, const size_t &count) {
+    command.first = m_matrices.size();
+    command.count = count;
+
+    m_matrices.insert(m_matrices.end(), matrices, matrices + count);
+    m_commands.push_back(command);
+  }
+
+  void CommandList::RecordCamera(const Shader &shader, const glm::mat4 &projection, const glm::mat4 &view) {
+    const glm::mat4 matrices[2] = { projection, view };
+
+    Command command = {};
+    command.type = COMMAND_CAMERA;
+    command.shader = &shader;
+
+    Push(command, matrices, 2);
+  }
+
+  void CommandList::RecordSprite(const Shader &shader, const glm::mat4 &model, const RGBA &color, const Texture *texture) {
+    Command command = {};
+    command.type = COMMAND_SPRITE;
+    command.shader = &shader;
+    command.texture = texture;
+    command.color = color;
+
+    Push(command, &model, 1);
+  }
+
+  void CommandList::RecordSpriteInstanced(
+    const Shader &shader,
+    const glm::mat4 *models,
+    const size_t &count,
+    const RGBA &color,
+    const Texture *texture
+  ) {
+    Command command = {};
+    command.type = COMMAND_SPRITE_INSTANCED;
+    command.shader = &shader;
+    command.texture = texture;
+    command.color = color;
+
+    Push(command, models, count);
+  }
+
+  void CommandList::RecordMesh(const Mesh &mesh, const Shader &shader, const RGBA &color, const glm::mat4 &model) {
+    Command command = {};
+    command.type = COMMAND_MESH;
+    command.shader = &shader;
+    command.mesh = &mesh;
+    command.color = color;
+
+    Push(command, &model, 1);
+  }
+
+  void CommandList::RecordMeshInstanced(
+    const Mesh &mesh,
+    const Shader &shader,
+    const RGBA &color,
+    const glm::mat4 *models,
+    const size_t &count
+  ) {
+    Command command = {};
+    command.type = COMMAND_MESH_INSTANCED;
+    command.shader = &shader;
+    command.mesh = &mesh;
+    command.color = color;
+
+    Push(command, models, count);
+  }
+
+  void CommandList::RecordText(const std::string &text, const RGBA &color, const glm::mat4 &model, const GLfloat &scale) {
+    // Reuse the storage of a string from an earlier frame when there is one
+    if (m_text_count == m_text.size())
+      m_text.push_back(text);
+    else
+      m_text[m_text_count].assign(text);
+
+    Command command = {};
+    command.type = COMMAND_TEXT;
+    command.color = color;
+    command.index = m_text_count++;
+    command.scale = scale;
+
+    Push(command, &model, 1);
+  }
+
+  void CommandList::RecordTextFlush(const Shader &shader) {
+    Command command = {};
+    command.type = COMMAND_TEXT_FLUSH;
+    command.shader = &shader;
+
+    Push(command, nullptr, 0);
+  }
+
+  void CommandList::RecordCall(const std::function<void()> &call) {
+    Command command = {};
+    command.type = COMMAND_CALL;
+    command.index = m_calls.size();
+
+    m_calls.push_back(call);
+    Push(command, nullptr, 0);
+  }
+
+  void CommandList::Execute() const {
+    PROFILE_ZONE("CommandList::Execute");
+
+    SpriteRenderer *sprite_renderer = SpriteRenderer::GetInstance();
+    MeshRenderer *mesh_renderer = MeshRenderer::GetInstance();
+    TextRenderer *text_renderer = TextRenderer::GetInstance();
+
+    for (const Command &command : m_commands) {
+      const glm::mat4 *matrices = m_matrices.data() + command.first;
+
+      switch (command.type) {
+        case COMMAND_CAMERA:
+          Camera(matrices[0], matrices[1]).Draw(*command.shader);
+          break;
+        case COMMAND_SPRITE:
+          if (sprite_renderer)
+            sprite_renderer->Draw(*command.shader, matrices[0], command.color, command.texture);
+          break;
+        case COMMAND_SPRITE_INSTANCED:
+          if (sprite_renderer)
+            sprite_renderer->DrawInstancedVisible(*command.shader, matrices, command.count, command.color, command.texture);
+          break;
+        case COMMAND_MESH:
+          if (mesh_renderer)
+            mesh_renderer->Draw(*command.mesh, *command.shader, command.color, matrices[0]);
+          break;
+        case COMMAND_MESH_INSTANCED:
+          if (mesh_renderer)
+            mesh_renderer->DrawInstancedVisible(*command.mesh, *command.shader, command.color, matrices, command.count);
+          break;
+        case COMMAND_TEXT:
+          if (text_renderer)
+            text_renderer->Submit(m_text[command.index], command.color, matrices[0], command.scale);
+          break;
+        case COMMAND_TEXT_FLUSH:
+          if (text_renderer)
+            text_renderer->Flush(*command.shader);
+          break;
+        case COMMAND_CALL:
+          m_calls[command.index]();
+          break;
+      }
+    }
+  }
+
+  void CommandList::Clear() {
+    m_commands.clear();
+    m_matrices.clear();
+    m_calls.clear();
+    m_text_count = 0;
+  }
+
+  size_t CommandList::GetCommandCount() const {
+    return m_commands.size();
+  }
+
+}
@@ -0,0 +1,298 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/graphics/GPUTimer.hpp"
+#include "elgar/core/Macros.hpp"
+
+#include <mutex>
+
+// DEFINES //
+
+#define GPU_TIMER_QUERY_CHUNK   32            // Queries generated at a time when a frame runs out
+#define GPU_TIMER_INVALID       0xFFFFFFFF    // Marks a range that could not be recorded
+
+namespace elgar {
+
+  // LOCAL DATA //
+
+  /**
+   * @brief The PassRegistry struct maps pass names to indices for the whole program
+   *
+   */
+  struct PassRegistry {
+    std::mutex  mutex;    // Guards the registry (call sites register from any thread)
+    std::unordered_map<std::string, GLuint> indices;   // Index of each pass name
+    std::vector<std::string>  names;    // Name of each pass
+  };
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief Get the pass registry (built on first use, so zones in static initializers are safe)
+   *
+   * @return Reference to the registry
+   */
+  static PassRegistry &GetPassRegistry() {
+    static PassRegistry registry;
+    return registry;
+  }
+
+  // FUNCTIONS //
+
+  GPUTimer::GPUTimer() : Singleton<GPUTimer>(this) {
+    m_frame = 0;
+    m_dropped = 0;
+    m_enabled = true;
+
+    // Timestamp queries are core since OpenGL 3.3, but the counter may still have no bits
+    m_supported = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+
+    if (m_supported) {
+      GLint bits = 0;
+      glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+      m_supported = bits > 0;
+    }
+
+    for (GLuint i = 0; i < GPU_TIMER_FRAME_COUNT; i++) {
+      m_frames[i].issued = 0;
+      m_frames[i].last = -1;
+    }
+
+    if (m_supported)
+      LOG("GPUTimer online...\n");
+    else
+      LOG_WARNING("Timestamp queries are not supported, GPU pass times will read zero!\n");
+  }
+
+  GPUTimer::~GPUTimer() {
+    for (GLuint i = 0; i < GPU_TIMER_FRAME_COUNT; i++) {
+      if (!m_frames[i].queries.empty())
+        glDeleteQueries(m_frames[i].queries.size(), m_frames[i].queries.data());
+    }
+
+    LOG("GPUTimer offline...\n");
+  }
+
+  GLint GPUTimer::Timestamp() {
+    GPUTimerFrame &frame = m_frames[m_frame];
+
+    if (frame.issued >= GPU_TIMER_QUERY_CAPACITY)
+      return -1;
+
+    // Grow the pool of the frame
+    if (frame.issued == frame.queries.size()) {
+      const size_t size = frame.queries.size();
+      frame.queries.resize(size + GPU_TIMER_QUERY_CHUNK);
+      glGenQueries(GPU_TIMER_QUERY_CHUNK, frame.queries.data() + size);
+    }
+
+    const GLint index = frame.issued++;
+    glQueryCounter(frame.queries[index], GL_TIMESTAMP);
+    frame.last = index;
+
+    return index;
+  }
+
+  bool GPUTimer::Resolve(GPUTimerFrame &frame) {
+    if (frame.last < 0)
+      return true;
+
+    // Queries finish in order, so the last one written tells us if the whole frame is done
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(frame.queries[frame.last], GL_QUERY_RESULT_AVAILABLE, &available);
+
+    if (!available)
+      return false;
+
+    // Pick up the names of passes registered since the last read back
+    {
+      PassRegistry &registry = GetPassRegistry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+
+      for (size_t i = m_pass_names.size(); i < registry.names.size(); i++)
+        m_pass_names.push_back(registry.names[i]);
+    }
+
+    m_pass_scratch.assign(m_pass_names.size(), 0);
+
+    for (const GPUTimerRecord &record : frame.records) {
+      if (record.begin == GPU_TIMER_INVALID || record.end == GPU_TIMER_INVALID)
+        continue;
+
+      GLuint64 begin = 0, end = 0;
+      glGetQueryObjectui64v(frame.queries[record.begin], GL_QUERY_RESULT, &begin);
+      glGetQueryObjectui64v(frame.queries[record.end], GL_QUERY_RESULT, &end);
+
+      if (end > begin)
+        m_pass_scratch[record.pass] += end - begin;
+    }
+
+    std::lock_guard<std::mutex> lock(m_pass_times_lock);
+    for (size_t i = 0; i < m_pass_names.size(); i++)
+      m_pass_times[m_pass_names[i]] = m_pass_scratch[i] / 1000000.0;
+
+    return true;
+  }
+
+  void GPUTimer::EndFrame() {
+    if (!m_supported)
+      return;
+
+    // Anything left open is unbalanced, drop it rather than let it leak into the next frame
+    if (!m_open.empty()) {
+      LOG_WARNING("%u GPU zones were left open at the end of the frame!\n", (GLuint)m_open.size());
+
+      for (const GLuint &record : m_open) {
+        if (record != GPU_TIMER_INVALID)
+          m_frames[m_frame].records[record].end = GPU_TIMER_INVALID;
+      }
+
+      m_open.clear();
+    }
+
+    // Move on to the oldest frame, reading its results back first if the GPU is done with it
+    m_frame = (m_frame + 1) % GPU_TIMER_FRAME_COUNT;
+    GPUTimerFrame &frame = m_frames[m_frame];
+
+    if (!Resolve(frame))
+      m_dropped++;
+
+    frame.records.clear();
+    frame.issued = 0;
+    frame.last = -1;
+  }
+
+  GLuint GPUTimer::RegisterPass(const std::string &name) {
+    PassRegistry &registry = GetPassRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    auto it = registry.indices.find(name);
+    if (it != registry.indices.end())
+      return it->second;
+
+    const GLuint pass = registry.names.size();
+    registry.indices.insert(std::pair<std::string, GLuint>(name, pass));
+    registry.names.push_back(name);
+
+    return pass;
+  }
+
+  void GPUTimer::Begin(const std::string &name) {
+    Begin(RegisterPass(name));
+  }
+
+  void GPUTimer::Begin(const GLuint &pass) {
+    if (!m_supported || !m_enabled) {
+      m_open.push_back(GPU_TIMER_INVALID);
+      return;
+    }
+
+    GPUTimerFrame &frame = m_frames[m_frame];
+
+    // Reopen the previous range if it is the same pass and nothing was timed since it closed
+    if (!frame.records.empty()) {
+      const GLuint previous = frame.records.size() - 1;
+      const GPUTimerRecord &record = frame.records[previous];
+
+      if (record.pass == pass && record.depth == m_open.size() &&
+          record.end != GPU_TIMER_INVALID && (GLint)record.end == frame.last) {
+        m_open.push_back(previous);
+        return;
+      }
+    }
+
+    // Reserve both queries up front so End can never run out
+    if (frame.issued + 2 > GPU_TIMER_QUERY_CAPACITY) {
+      m_open.push_back(GPU_TIMER_INVALID);
+      return;
+    }
+
+    GPUTimerRecord record;
+    record.pass = pass;
+    record.begin = Timestamp();
+    record.end = GPU_TIMER_INVALID;
+    record.depth = m_open.size();
+
+    m_open.push_back(frame.records.size());
+    frame.records.push_back(record);
+  }
+
+  void GPUTimer::End() {
+    if (m_open.empty()) {
+      LOG_WARNING("GPUTimer::End called without a matching Begin!\n");
+      return;
+    }
+
+    const GLuint index = m_open.back();
+    m_open.pop_back();
+
+    if (index == GPU_TIMER_INVALID)
+      return;
+
+    GPUTimerFrame &frame = m_frames[m_frame];
+    GPUTimerRecord &record = frame.records[index];
+
+    // A reopened range writes over its old end query
+    if (record.end != GPU_TIMER_INVALID) {
+      glQueryCounter(frame.queries[record.end], GL_TIMESTAMP);
+      frame.last = record.end;
+    }
+    else {
+      record.end = Timestamp();
+    }
+  }
+
+  void GPUTimer::SetEnabled(const bool &enabled) {
+    m_enabled = enabled;
+  }
+
+  bool GPUTimer::IsEnabled() const {
+    return m_enabled;
+  }
+
+  const bool &GPUTimer::IsSupported() const {
+    return m_supported;
+  }
+
+  GLdouble GPUTimer::GetPassTime(const std::string &name) const {
+    std::lock_guard<std::mutex> lock(m_pass_times_lock);
+
+    auto it = m_pass_times.find(name);
+    return it != m_pass_times.end() ? it->second : 0.0;
+  }
+
+  std::map<std::string, GLdouble> GPUTimer::GetPassTimes() const {
+    std::lock_guard<std::mutex> lock(m_pass_times_lock);
+    return m_pass_times;
+  }
+
+  GLuint GPUTimer::GetDroppedFrameCount() const {
+    return m_dropped;
+  }
+
+  GPUZone::GPUZone(const GLuint &pass) {
+    GPUTimer *timer = GPUTimer::GetInstance();
+
+    m_open = timer != nullptr;
+
+    if (m_open)
+      timer->Begin(pass);
+  }
+
+  GPUZone::GPUZone(const char *name) : GPUZone(GPUTimer::RegisterPass(name)) {
+
+  }
+
+  GPUZone::~GPUZone() {
+    GPUTimer *timer = GPUTimer::GetInstance();
+
+    if (m_open && timer)
+      timer->End();
+  }
+
+}
@@ -8,6 +8,7 @@
 
 #include "elgar/graphics/ImageLoader.hpp"
 #include "elgar/core/Macros.hpp"
+#include "elgar/core/MemoryTracker.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "elgar/graphics/aux/stb_image.h"
@@ -23,7 +24,10 @@ namespace elgar {
   ImageLoader::~ImageLoader() {
     // Delete all images
     for (auto it = m_images.begin(); it != m_images.end(); it++) {
-      stbi_image_free(it->second.data);   // Free the image data
+      const Image &image = it->second;
+
+      stbi_image_free(image.data);   // Free the image data
+      MemoryTracker::Get().Release(MEMORY_IMAGES, (size_t)image.width * image.height * image.channels);
     }
 
     m_images.clear();
@@ -32,13 +36,15 @@ namespace elgar {
   }
 
   bool ImageLoader::LoadFromDisk(const std::string &filepath, const std::string &name) {
+    PROFILE_ZONE("ImageLoader::LoadFromDisk");
+
     // Check for naming collision
     if (name.empty() && m_images.find(filepath) != m_images.end()) {
-      LOG("ERROR: Image already loaded in memory under the name: %s\n", filepath.c_str());
+      LOG_ERROR("Image already loaded in memory under the name: %s\n", filepath.c_str());
       return false;
     }
     else if (!name.empty() && m_images.find(name) != m_images.end()) {
-      LOG("ERROR: Image already loaded in memory under the name: %s\n", name.c_str());
+      LOG_ERROR("Image already loaded in memory under the name: %s\n", name.c_str());
       return false;
     }
 
@@ -49,12 +55,13 @@ namespace elgar {
     // Read the byte data into the Image struct
     new_image.data = stbi_load(filepath.c_str(), &new_image.width, &new_image.height, &new_image.channels, 0);
     if (!new_image.data) {
-      LOG("ERROR: Failed to load texture %s from disk!\n", filepath.c_str());
+      LOG_ERROR("Failed to load texture %s from disk!\n", filepath.c_str());
       return false;
     }
 
     if (new_image.channels != 3 && new_image.channels != 4) {
-      LOG("ERROR: Unsupported image format!\n");
+      LOG_ERROR("Unsupported image format!\n");
+      stbi_image_free(new_image.data);
       return false;
     }
 
@@ -68,6 +75,8 @@ namespace elgar {
     // Add the image into the table
     m_images.insert(std::pair<std::string, Image>(image_name, new_image));
 
+    MemoryTracker::Get().Allocate(MEMORY_IMAGES, (size_t)new_image.width * new_image.height * new_image.channels);
+
     return true;
   }
 
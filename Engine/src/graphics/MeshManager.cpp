@@ -63,12 +63,12 @@ namespace elgar {
 
   bool MeshManager::Register(const std::string &name, const Mesh *mesh) {
     if (m_mesh_table.find(name) != m_mesh_table.end()) {
-      LOG("Error: Failed to register mesh %s due to name collision!\n", name.c_str());
+      LOG_ERROR("Failed to register mesh %s due to name collision!\n", name.c_str());
       return false;
     }
 
     if (!mesh) {
-      LOG("Error: Cannot register null mesh!\n");
+      LOG_ERROR("Cannot register null mesh!\n");
       return false;
     }
 
@@ -32,6 +32,8 @@ namespace elgar {
   }
 
   const Model *ModelLoader::Load(const std::string &path) {
+    PROFILE_ZONE("ModelLoader::Load");
+
     if (m_models.find(path) != m_models.end())
       return m_models.at(path);
 
@@ -42,7 +44,7 @@ namespace elgar {
 
     // Check for errors
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-      LOG("ERROR: Failed to load model %s from disk! Error: %s\n", path.c_str(), import.GetErrorString());
+      LOG_ERROR("Failed to load model %s from disk! Error: %s\n", path.c_str(), import.GetErrorString());
       return nullptr;   // Failed to load model
     }
 
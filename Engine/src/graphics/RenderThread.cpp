@@ -0,0 +1,263 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/graphics/RenderThread.hpp"
+#include "elgar/graphics/StateCache.hpp"
+#include "elgar/graphics/GPUTimer.hpp"
+#include "elgar/graphics/renderers/MeshRenderer.hpp"
+
+#include "elgar/core/Window.hpp"
+#include "elgar/core/Exception.hpp"
+#include "elgar/core/Macros.hpp"
+
+#include <algorithm>
+
+// DEFINES //
+
+#define RENDER_THREAD_LIST_COUNT  (RENDER_THREAD_MAX_DEPTH + 1)
+
+namespace elgar {
+
+  // LOCAL DATA //
+
+  static thread_local bool t_render_thread = false;   // Is the calling thread the render thread?
+
+  // FUNCTIONS //
+
+  RenderThread::RenderThread(const GLuint &depth) : Singleton<RenderThread>(this) {
+    m_depth = std::min(std::max(depth, 1u), (GLuint)RENDER_THREAD_MAX_DEPTH);
+
+    m_submitted = 0;
+    m_completed = 0;
+    m_stalls = 0;
+    m_running = true;
+
+    // Hand the context over to the render thread
+    Window::GetInstance()->ReleaseContext();
+    m_thread = std::thread(&RenderThread::Loop, this);
+
+    LOG("Render thread online with a pipeline depth of %u...\n", m_depth);
+  }
+
+  RenderThread::~RenderThread() {
+    Finish();
+
+    {
+      std::lock_guard<std::mutex> lock(m_lock);
+      m_running = false;
+    }
+    m_submit.notify_all();
+
+    if (m_thread.joinable())
+      m_thread.join();
+
+    // Take the context back so the subsystems can release their OpenGL objects
+    Window::GetInstance()->AcquireContext();
+
+    RunDeferred(true);  // Anything deferred while the thread was winding down
+
+    LOG("Render thread offline after %llu frames (%llu stalls)...\n",
+      (unsigned long long)m_completed, (unsigned long long)m_stalls);
+  }
+
+  void RenderThread::Loop() {
+    t_render_thread = true;
+
+    Window *window = Window::GetInstance();
+
+    bool has_context = true;
+
+    try {
+      window->AcquireContext();
+    }
+    catch (const Exception &e) {
+      // Keep consuming frames so the main thread never waits on us
+      LOG_ERROR("%s\n", e.what());
+      has_context = false;
+    }
+
+    for (;;) {
+      Invocation *invocation = nullptr;
+      uint64_t frame = 0;
+      {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_submit.wait(lock, [this]() {
+          return m_completed < m_submitted || !m_invokes.empty() || !m_running;
+        });
+
+        // Calls other threads are blocked on go ahead of the queued frames
+        if (!m_invokes.empty()) {
+          invocation = m_invokes.front();
+          m_invokes.pop_front();
+        }
+        else if (m_completed == m_submitted)
+          break;  // Only stop once every submitted frame is out
+        else
+          frame = m_completed;
+      }
+
+      if (invocation) {
+        try {
+          (*invocation->call)();
+        }
+        catch (...) {
+          invocation->error = std::current_exception();
+        }
+
+        {
+          std::lock_guard<std::mutex> lock(m_lock);
+          invocation->done = true;
+        }
+        m_complete.notify_all();
+
+        continue;
+      }
+
+      CommandList &list = m_lists[frame % RENDER_THREAD_LIST_COUNT];
+
+      if (has_context) {
+        {
+          PROFILE_ZONE("Present");
+          window->Present([&list]() { list.Execute(); });
+        }
+
+        // Close off the per frame renderer statistics (culling counts are closed by the main thread)
+        if (MeshRenderer::GetInstance())
+          MeshRenderer::GetInstance()->EndFrame();
+
+        if (StateCache::GetInstance())
+          StateCache::GetInstance()->EndFrame();
+
+        if (GPUTimer::GetInstance())
+          GPUTimer::GetInstance()->EndFrame();
+      }
+
+      list.Clear();
+
+      {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_completed++;
+      }
+      m_complete.notify_all();
+
+      // Objects released while this frame was recorded are no longer drawn with
+      RunDeferred(false);
+    }
+
+    RunDeferred(true);
+
+    if (has_context)
+      window->ReleaseContext();
+  }
+
+  void RenderThread::RunDeferred(const bool &all) {
+    for (;;) {
+      std::function<void()> call;
+      {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        // The queue is in frame order, so stop at the first call still waiting
+        if (m_deferred.empty() || (!all && m_deferred.front().frame >= m_completed))
+          return;
+
+        call = std::move(m_deferred.front().call);
+        m_deferred.pop_front();
+      }
+
+      call();
+    }
+  }
+
+  void RenderThread::Submit(void (*render)()) {
+    // The list after the ones in flight is never being read by the render thread
+    CommandList &list = m_lists[m_submitted % RENDER_THREAD_LIST_COUNT];
+
+    if (render) {
+      PROFILE_ZONE("Record");
+
+      CommandList::SetRecording(&list);
+      render();
+      CommandList::SetRecording(nullptr);
+    }
+
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    // Bound the latency by waiting for the render thread to catch up
+    if (m_submitted - m_completed >= m_depth) {
+      PROFILE_ZONE("WaitForRenderThread");
+
+      m_stalls++;
+      m_complete.wait(lock, [this]() { return m_submitted - m_completed < m_depth; });
+    }
+
+    m_submitted++;
+
+    lock.unlock();
+    m_submit.notify_one();
+  }
+
+  void RenderThread::Finish() {
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_complete.wait(lock, [this]() { return m_completed == m_submitted; });
+  }
+
+  void RenderThread::Invoke(const std::function<void()> &call) {
+    RenderThread *render_thread = GetInstance();
+
+    // The calling thread already owns the context
+    if (!render_thread || t_render_thread) {
+      call();
+      return;
+    }
+
+    Invocation invocation = {&call, nullptr, false};
+    {
+      std::unique_lock<std::mutex> lock(render_thread->m_lock);
+
+      if (!render_thread->m_running)
+        throw Exception("ERROR: Attempted to invoke a call on the render thread while it is shutting down!");
+
+      render_thread->m_invokes.push_back(&invocation);
+      render_thread->m_submit.notify_one();
+
+      render_thread->m_complete.wait(lock, [&invocation]() { return invocation.done; });
+    }
+
+    if (invocation.error)
+      std::rethrow_exception(invocation.error);
+  }
+
+  void RenderThread::Defer(const std::function<void()> &call) {
+    RenderThread *render_thread = GetInstance();
+
+    // The calling thread already owns the context
+    if (!render_thread || t_render_thread) {
+      call();
+      return;
+    }
+
+    // Held back until the frame being recorded right now has been presented
+    std::lock_guard<std::mutex> lock(render_thread->m_lock);
+    render_thread->m_deferred.push_back(DeferredCall{render_thread->m_submitted, call});
+  }
+
+  const GLuint &RenderThread::GetPipelineDepth() const {
+    return m_depth;
+  }
+
+  GLuint RenderThread::GetFramesInFlight() const {
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_submitted - m_completed;
+  }
+
+  uint64_t RenderThread::GetStallCount() const {
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_stalls;
+  }
+
+}
@@ -7,204 +7,457 @@
 // INCLUDES //
 
 #include "elgar/graphics/Shader.hpp"
+#include "elgar/graphics/StateCache.hpp"
+#include "elgar/graphics/CommandList.hpp"
+#include "elgar/graphics/RenderThread.hpp"
 #include "elgar/core/Exception.hpp"
 #include "elgar/core/Macros.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 namespace elgar {
 
   // FUNCTIONS //
 
   Shader::Shader(const char *vertex_code, const char *fragment_code, const char *geometry_code) {
-    // Temporary shader program id's
-    GLuint vertex_program, fragment_program, geometry_program;
-    GLint success;
-    GLchar info_log[1024];  // Give 1 KB for error logs
-
-    // Create vertex shader program
-    vertex_program = glCreateShader(GL_VERTEX_SHADER);
-
-    // Send source to the vertex program
-    glShaderSource(vertex_program, 1, &vertex_code, NULL);
+    // The program is compiled and linked by whichever thread owns the context
+    RenderThread::Invoke([this, vertex_code, fragment_code, geometry_code]() {
+      // Temporary shader program id's
+      GLuint vertex_program, fragment_program, geometry_program;
+      GLint success;
+      GLchar info_log[1024];  // Give 1 KB for error logs
+
+      // Create vertex shader program
+      vertex_program = glCreateShader(GL_VERTEX_SHADER);
+
+      // Send source to the vertex program
+      glShaderSource(vertex_program, 1, &vertex_code, NULL);
     
-    // Compile the vertex shader
-    glCompileShader(vertex_program);
-
-    // Check for compilation errors
-    glGetShaderiv(vertex_program, GL_COMPILE_STATUS, &success);
-    if (!success) {
-      glGetShaderInfoLog(vertex_program, 1024, NULL, info_log);
-      throw Exception("ERROR: Failed to compile vertex shader!\n" + std::string(info_log));
-    }
+      // Compile the vertex shader
+      glCompileShader(vertex_program);
+
+      // Check for compilation errors
+      glGetShaderiv(vertex_program, GL_COMPILE_STATUS, &success);
+      if (!success) {
+        glGetShaderInfoLog(vertex_program, 1024, NULL, info_log);
+        throw Exception("ERROR: Failed to compile vertex shader!\n" + std::string(info_log));
+      }
 
-    // Create the fragment shader program
-    fragment_program = glCreateShader(GL_FRAGMENT_SHADER);
+      // Create the fragment shader program
+      fragment_program = glCreateShader(GL_FRAGMENT_SHADER);
 
-    // Send source to the fragment program
-    glShaderSource(fragment_program, 1, &fragment_code, NULL);
+      // Send source to the fragment program
+      glShaderSource(fragment_program, 1, &fragment_code, NULL);
     
-    // Compile the fragment shader
-    glCompileShader(fragment_program);
-
-    // Check for compilation errors
-    glGetShaderiv(fragment_program, GL_COMPILE_STATUS, &success);
-    if (!success) {
-      glGetShaderInfoLog(fragment_program, 1024, NULL, info_log);
-      throw Exception("ERROR: Failed to compile fragment shader!\n" + std::string(info_log));
-    }
+      // Compile the fragment shader
+      glCompileShader(fragment_program);
+
+      // Check for compilation errors
+      glGetShaderiv(fragment_program, GL_COMPILE_STATUS, &success);
+      if (!success) {
+        glGetShaderInfoLog(fragment_program, 1024, NULL, info_log);
+        throw Exception("ERROR: Failed to compile fragment shader!\n" + std::string(info_log));
+      }
 
-    // If a geometry shader has been provided
-    if (geometry_code) {
-      // Create the geometry shader program
-      geometry_program = glCreateShader(GL_GEOMETRY_SHADER);
+      // If a geometry shader has been provided
+      if (geometry_code) {
+        // Create the geometry shader program
+        geometry_program = glCreateShader(GL_GEOMETRY_SHADER);
 
-      // Send source to the geometry program
-      glShaderSource(geometry_program, 1, &geometry_code, NULL);
+        // Send source to the geometry program
+        glShaderSource(geometry_program, 1, &geometry_code, NULL);
 
-      // Compile the geometry shader
-      glCompileShader(geometry_program);
+        // Compile the geometry shader
+        glCompileShader(geometry_program);
 
-      // Check for compilation errors
-      glGetShaderiv(geometry_program, GL_COMPILE_STATUS, &success);
-      if (!success) {
-        glGetShaderInfoLog(geometry_program, 1024, NULL, info_log);
-        throw Exception("ERROR: Failed to compile geometry shader!\n" + std::string(info_log));
+        // Check for compilation errors
+        glGetShaderiv(geometry_program, GL_COMPILE_STATUS, &success);
+        if (!success) {
+          glGetShaderInfoLog(geometry_program, 1024, NULL, info_log);
+          throw Exception("ERROR: Failed to compile geometry shader!\n" + std::string(info_log));
+        }
       }
-    }
 
-    // Create the shader program
-    m_id = glCreateProgram();
+      // Create the shader program
+      m_id = glCreateProgram();
       
-    // Attach the vertex shader
-    glAttachShader(m_id, vertex_program);
+      // Attach the vertex shader
+      glAttachShader(m_id, vertex_program);
 
-    // Attach the geometry shader (if applicable)
-    if (geometry_code)
-      glAttachShader(m_id, geometry_program);
+      // Attach the geometry shader (if applicable)
+      if (geometry_code)
+        glAttachShader(m_id, geometry_program);
 
-    // Attach the fragment shader
-    glAttachShader(m_id, fragment_program);
+      // Attach the fragment shader
+      glAttachShader(m_id, fragment_program);
 
-    // Link the programs
-    glLinkProgram(m_id);
+      // Link the programs
+      glLinkProgram(m_id);
 
-    // Check for linker errors
-    glGetShaderiv(m_id, GL_LINK_STATUS, &success);
-    if (!success) {
-      glGetShaderInfoLog(m_id, 1024, NULL, info_log);
-      throw Exception("ERROR: Failed to link shader program!\n" + std::string(info_log));
-    }
+      // Check for linker errors
+      glGetProgramiv(m_id, GL_LINK_STATUS, &success);
+      if (!success) {
+        glGetProgramInfoLog(m_id, 1024, NULL, info_log);
+        throw Exception("ERROR: Failed to link shader program!\n" + std::string(info_log));
+      }
+
+      // Delete obsolete shaders
+      glDeleteShader(vertex_program);
 
-    // Delete obsolete shaders
-    glDeleteShader(vertex_program);
+      if (geometry_code)
+        glDeleteShader(geometry_program);
 
-    if (geometry_code)
-      glDeleteShader(geometry_program);
+      glDeleteShader(fragment_program);
 
-    glDeleteShader(fragment_program);
+      // Resolve every active uniform up front so the setters never have to ask the driver
+      BuildUniformCache();
 
-    LOG("Shader compiled and linked successfully!\n");
-    glGetError(); // Clear error buffer
+      LOG_DEBUG("Shader compiled and linked successfully!\n");
+      glGetError(); // Clear error buffer
+    });
   }
 
   Shader::~Shader() {
-    glDeleteProgram(m_id);
-    LOG("Shader destroyed...\n");
+    // Frames still in flight may draw with the program, so it goes once they are presented
+    const GLuint id = m_id;
+    RenderThread::Defer([id]() {
+      if (StateCache::GetInstance())
+        StateCache::GetInstance()->ForgetProgram(id);
+
+      glDeleteProgram(id);
+    });
+
+    LOG_DEBUG("Shader destroyed...\n");
   }
 
-  GLint Shader::UpdateUniformCache(const std::string &name) {
-    if (m_uniform_cache.find(name) != m_uniform_cache.end())
-      return m_uniform_cache.at(name);
+  void Shader::BuildUniformCache() {
+    GLint uniform_count = 0;
+    GLint max_length = 0;
 
-    GLint loc = glGetUniformLocation(m_id, name.c_str());
+    glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &uniform_count);
+    glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+    if (uniform_count <= 0 || max_length <= 0)
+      return;
 
-    if (loc == -1)
-      return -1;
+    std::vector<GLchar> name(max_length);
+    GLint max_location = -1;
 
+    for (GLint i = 0; i < uniform_count; i++) {
+      GLsizei length = 0;
+      GLint size = 0;
+      GLenum type = GL_NONE;
+
+      glGetActiveUniform(m_id, (GLuint)i, max_length, &length, &size, &type, &name[0]);
+
+      std::string uniform(&name[0], length);
+      GLint loc = glGetUniformLocation(m_id, uniform.c_str());
+
+      if (loc == -1)
+        continue;   // Uniform block members have no location
+
+      m_uniform_cache[uniform] = loc;
+
+      // Arrays are reported as "name[0]", but are usually looked up as "name"
+      const std::string::size_type suffix = uniform.rfind("[0]");
+      if (suffix != std::string::npos && suffix + 3 == uniform.size())
+        m_uniform_cache[uniform.substr(0, suffix)] = loc;
+
+      if (loc + size - 1 > max_location)
+        max_location = loc + size - 1;
+    }
+
+    m_uniform_shadows.resize(max_location + 1, UniformShadow());
+  }
+
+  GLint Shader::UpdateUniformCache(const std::string &name) const {
+    auto it = m_uniform_cache.find(name);
+    if (it != m_uniform_cache.end())
+      return it->second;
+
+    // Cache misses as well so unknown names are only looked up once
+    GLint loc = glGetUniformLocation(m_id, name.c_str());
     m_uniform_cache.insert(std::pair<std::string, GLint>(name, loc));
 
     return loc;
   }
 
-  GLint Shader::UpdateAttributeCache(const std::string &name) {
-    if (m_attrib_cache.find(name) != m_attrib_cache.end())
-      return m_attrib_cache.at(name);
+  GLint Shader::UpdateAttributeCache(const std::string &name) const {
+    auto it = m_attrib_cache.find(name);
+    if (it != m_attrib_cache.end())
+      return it->second;
 
     GLint loc = glGetAttribLocation(m_id, name.c_str());
-
-    if (loc == -1)
-      return -1;
-    
     m_attrib_cache.insert(std::pair<std::string, GLint>(name, loc));
 
     return loc;
   }
 
+  bool Shader::UpdateShadow(const GLint &handle, const GLvoid *data, const GLsizei &size) const {
+    if (handle < 0)
+      return false;   // Nothing to set
+
+    if ((size_t)handle >= m_uniform_shadows.size())
+      m_uniform_shadows.resize(handle + 1, UniformShadow());
+
+    UniformShadow &shadow = m_uniform_shadows[handle];
+
+    if (shadow.size == size && memcmp(shadow.data, data, size) == 0)
+      return false;   // Value is unchanged
+
+    memcpy(shadow.data, data, size);
+    shadow.size = size;
+
+    return true;
+  }
+
+  void Shader::InvalidateShadows(const GLint &handle, const GLsizei &count) const {
+    for (GLint loc = handle; loc >= 0 && loc < handle + count && (size_t)loc < m_uniform_shadows.size(); loc++)
+      m_uniform_shadows[loc].size = 0;
+  }
+
   void Shader::Use() const {
-    glUseProgram(m_id);
+    if (StateCache::GetInstance())
+      StateCache::GetInstance()->UseProgram(m_id);
+    else
+      glUseProgram(m_id);
+  }
+
+  GLint Shader::GetUniformHandle(const std::string &name) const {
+    return UpdateUniformCache(name);
+  }
+
+  const GLuint &Shader::GetId() const {
+    return m_id;
   }
 
   void Shader::SetBool(const std::string &name, GLboolean value) const {
-      glUniform1i(glGetUniformLocation(m_id, name.c_str()), (GLint)value);
+    SetInt(name, (GLint)value);
+  }
+
+  void Shader::SetBool(GLint handle, GLboolean value) const {
+    SetInt(handle, (GLint)value);
   }
 
   void Shader::SetInt(const std::string &name, GLint value) const {
-      glUniform1i(glGetUniformLocation(m_id, name.c_str()), value);
+    // While recording, the lookup and the upload both happen when the frame is replayed
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, name, value]() { SetInt(name, value); });
+    else
+      SetInt(UpdateUniformCache(name), value);
+  }
+
+  void Shader::SetInt(GLint handle, GLint value) const {
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, handle, value]() { SetInt(handle, value); });
+    else if (UpdateShadow(handle, &value, sizeof(GLint)))
+      glProgramUniform1i(m_id, handle, value);
   }
 
   void Shader::SetIntArray(const std::string &name, GLsizei count, GLint *values) const {
-    if (count > 0)
-      glUniform1iv(glGetUniformLocation(m_id, name.c_str()), count, values);
+    if (CommandList *list = CommandList::GetRecording()) {
+      // The caller's array may be gone by the time the frame is replayed
+      std::vector<GLint> copy(values, values + std::max(count, 0));
+      list->RecordCall([this, name, count, copy]() mutable { SetIntArray(name, count, copy.data()); });
+    }
+    else
+      SetIntArray(UpdateUniformCache(name), count, values);
+  }
+
+  void Shader::SetIntArray(GLint handle, GLsizei count, GLint *values) const {
+    if (handle < 0 || count <= 0)
+      return;
+
+    if (CommandList *list = CommandList::GetRecording()) {
+      std::vector<GLint> copy(values, values + count);
+      list->RecordCall([this, handle, count, copy]() mutable { SetIntArray(handle, count, copy.data()); });
+      return;
+    }
+
+    InvalidateShadows(handle, count);
+    glProgramUniform1iv(m_id, handle, count, values);
   }
 
   void Shader::SetFloat(const std::string &name, GLfloat value) const {
-      glUniform1f(glGetUniformLocation(m_id, name.c_str()), value);
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, name, value]() { SetFloat(name, value); });
+    else
+      SetFloat(UpdateUniformCache(name), value);
+  }
+
+  void Shader::SetFloat(GLint handle, GLfloat value) const {
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, handle, value]() { SetFloat(handle, value); });
+    else if (UpdateShadow(handle, &value, sizeof(GLfloat)))
+      glProgramUniform1f(m_id, handle, value);
   }
 
   void Shader::SetFloatArray(const std::string &name, GLsizei count, GLfloat *values) const {
-    if (count > 0)
-      glUniform1fv(glGetUniformLocation(m_id, name.c_str()), count, values);
+    if (CommandList *list = CommandList::GetRecording()) {
+      std::vector<GLfloat> copy(values, values + std::max(count, 0));
+      list->RecordCall([this, name, count, copy]() mutable { SetFloatArray(name, count, copy.data()); });
+    }
+    else
+      SetFloatArray(UpdateUniformCache(name), count, values);
+  }
+
+  void Shader::SetFloatArray(GLint handle, GLsizei count, GLfloat *values) const {
+    if (handle < 0 || count <= 0)
+      return;
+
+    if (CommandList *list = CommandList::GetRecording()) {
+      std::vector<GLfloat> copy(values, values + count);
+      list->RecordCall([this, handle, count, copy]() mutable { SetFloatArray(handle, count, copy.data()); });
+      return;
+    }
+
+    InvalidateShadows(handle, count);
+    glProgramUniform1fv(m_id, handle, count, values);
   }
 
   void Shader::SetVec2(const std::string &name, const glm::vec2 &value) const {
-      glUniform2fv(glGetUniformLocation(m_id, name.c_str()), 1, &value[0]);
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, name, value]() { SetVec2(name, value); });
+    else
+      SetVec2(UpdateUniformCache(name), value);
+  }
+
+  void Shader::SetVec2(GLint handle, const glm::vec2 &value) const {
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, handle, value]() { SetVec2(handle, value); });
+    else if (UpdateShadow(handle, &value[0], sizeof(glm::vec2)))
+      glProgramUniform2fv(m_id, handle, 1, &value[0]);
   }
 
   void Shader::SetVec2Array(const std::string &name, GLsizei count, const GLfloat *values) const {
-    if (count > 0)
-      glUniform2fv(glGetUniformLocation(m_id, name.c_str()), count, values);
+    if (CommandList *list = CommandList::GetRecording()) {
+      std::vector<GLfloat> copy(values, values + std::max(count, 0) * 2);
+      list->RecordCall([this, name, count, copy]() { SetVec2Array(name, count, copy.data()); });
+    }
+    else
+      SetVec2Array(UpdateUniformCache(name), count, values);
+  }
+
+  void Shader::SetVec2Array(GLint handle, GLsizei count, const GLfloat *values) const {
+    if (handle < 0 || count <= 0)
+      return;
+
+    if (CommandList *list = CommandList::GetRecording()) {
+      std::vector<GLfloat> copy(values, values + count * 2);
+      list->RecordCall([this, handle, count, copy]() { SetVec2Array(handle, count, copy.data()); });
+      return;
+    }
+
+    InvalidateShadows(handle, count);
+    glProgramUniform2fv(m_id, handle, count, values);
   }
 
   void Shader::SetVec3(const std::string &name, const glm::vec3 &value) const {
-      glUniform3fv(glGetUniformLocation(m_id, name.c_str()), 1, &value[0]);
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, name, value]() { SetVec3(name, value); });
+    else
+      SetVec3(UpdateUniformCache(name), value);
+  }
+
+  void Shader::SetVec3(GLint handle, const glm::vec3 &value) const {
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, handle, value]() { SetVec3(handle, value); });
+    else if (UpdateShadow(handle, &value[0], sizeof(glm::vec3)))
+      glProgramUniform3fv(m_id, handle, 1, &value[0]);
   }
 
   void Shader::SetVec3Array(const std::string &name, GLsizei count, const GLfloat *values) const {
-    if (count > 0)
-      glUniform3fv(glGetUniformLocation(m_id, name.c_str()), count, values);
+    if (CommandList *list = CommandList::GetRecording()) {
+      std::vector<GLfloat> copy(values, values + std::max(count, 0) * 3);
+      list->RecordCall([this, name, count, copy]() { SetVec3Array(name, count, copy.data()); });
+    }
+    else
+      SetVec3Array(UpdateUniformCache(name), count, values);
+  }
+
+  void Shader::SetVec3Array(GLint handle, GLsizei count, const GLfloat *values) const {
+    if (handle < 0 || count <= 0)
+      return;
+
+    if (CommandList *list = CommandList::GetRecording()) {
+      std::vector<GLfloat> copy(values, values + count * 3);
+      list->RecordCall([this, handle, count, copy]() { SetVec3Array(handle, count, copy.data()); });
+      return;
+    }
+
+    InvalidateShadows(handle, count);
+    glProgramUniform3fv(m_id, handle, count, values);
   }
 
   void Shader::SetVec4(const std::string &name, const glm::vec4 &value) const {
-      glUniform4fv(glGetUniformLocation(m_id, name.c_str()), 1, &value[0]);
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, name, value]() { SetVec4(name, value); });
+    else
+      SetVec4(UpdateUniformCache(name), value);
+  }
+
+  void Shader::SetVec4(GLint handle, const glm::vec4 &value) const {
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, handle, value]() { SetVec4(handle, value); });
+    else if (UpdateShadow(handle, &value[0], sizeof(glm::vec4)))
+      glProgramUniform4fv(m_id, handle, 1, &value[0]);
   }
 
   void Shader::SetMat2(const std::string &name, const glm::mat2 &mat) const {
-      glUniformMatrix2fv(glGetUniformLocation(m_id, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, name, mat]() { SetMat2(name, mat); });
+    else
+      SetMat2(UpdateUniformCache(name), mat);
+  }
+
+  void Shader::SetMat2(GLint handle, const glm::mat2 &mat) const {
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, handle, mat]() { SetMat2(handle, mat); });
+    else if (UpdateShadow(handle, &mat[0][0], sizeof(glm::mat2)))
+      glProgramUniformMatrix2fv(m_id, handle, 1, GL_FALSE, &mat[0][0]);
   }
 
   void Shader::SetMat3(const std::string &name, const glm::mat3 &mat) const {
-      glUniformMatrix3fv(glGetUniformLocation(m_id, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, name, mat]() { SetMat3(name, mat); });
+    else
+      SetMat3(UpdateUniformCache(name), mat);
+  }
+
+  void Shader::SetMat3(GLint handle, const glm::mat3 &mat) const {
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, handle, mat]() { SetMat3(handle, mat); });
+    else if (UpdateShadow(handle, &mat[0][0], sizeof(glm::mat3)))
+      glProgramUniformMatrix3fv(m_id, handle, 1, GL_FALSE, &mat[0][0]);
   }
 
   void Shader::SetMat4(const std::string &name, const glm::mat4 &mat) const {
-      glUniformMatrix4fv(glGetUniformLocation(m_id, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, name, mat]() { SetMat4(name, mat); });
+    else
+      SetMat4(UpdateUniformCache(name), mat);
+  }
+
+  void Shader::SetMat4(GLint handle, const glm::mat4 &mat) const {
+    if (CommandList *list = CommandList::GetRecording())
+      list->RecordCall([this, handle, mat]() { SetMat4(handle, mat); });
+    else if (UpdateShadow(handle, &mat[0][0], sizeof(glm::mat4)))
+      glProgramUniformMatrix4fv(m_id, handle, 1, GL_FALSE, &mat[0][0]);
   }
 
   void Shader::EnableAttribute(const std::string &name) const {
-    glEnableVertexAttribArray(glGetAttribLocation(m_id, name.c_str()));
+    const GLint location = UpdateAttributeCache(name);
+
+    if (location >= 0)
+      glEnableVertexAttribArray(location);
   }
 
   void Shader::DisableAttribute(const std::string &name) const {
-    glDisableVertexAttribArray(glGetAttribLocation(m_id, name.c_str()));
+    const GLint location = UpdateAttributeCache(name);
+
+    if (location >= 0)
+      glDisableVertexAttribArray(location);
   }
 
   void Shader::AttributePointer(
@@ -215,7 +468,7 @@ namespace elgar {
     const GLsizei &stride,
     const GLvoid *pointer
   ) const {
-    const GLint location = glGetAttribLocation(m_id, name.c_str());   // Get the location of the attribute
+    const GLint location = UpdateAttributeCache(name);   // Get the location of the attribute
 
     if (location >= 0) {
       glVertexAttribPointer(
@@ -230,7 +483,10 @@ namespace elgar {
   }
 
   void Shader::AttributeDivisor(const std::string &name, const GLuint &divisor) const {
-    glVertexAttribDivisor(glGetAttribLocation(m_id, name.c_str()), divisor);
+    const GLint location = UpdateAttributeCache(name);
+
+    if (location >= 0)
+      glVertexAttribDivisor(location, divisor);
   }
 
 }
\ No newline at end of file
@@ -99,7 +99,7 @@ namespace elgar {
   ) {
     // Check for name collision
     if (m_shaders.find(name) != m_shaders.end()) {
-      LOG("ERROR: Shader %s already exists!\n", name.c_str());
+      LOG_ERROR("Shader %s already exists!\n", name.c_str());
       return false;
     }
 
@@ -120,7 +120,7 @@ namespace elgar {
       in_stream.close();
     }
     else {
-      LOG("ERROR: Failed to open vertex shader %s!\n", vertex_path.c_str());
+      LOG_ERROR("Failed to open vertex shader %s!\n", vertex_path.c_str());
       return false;
     }
 
@@ -135,7 +135,7 @@ namespace elgar {
       in_stream.close();
     }
     else {
-      LOG("ERROR: Failed to open vertex shader %s!\n", fragment_path.c_str());
+      LOG_ERROR("Failed to open vertex shader %s!\n", fragment_path.c_str());
       return false;
     }
 
@@ -153,7 +153,7 @@ namespace elgar {
         in_stream.close();
       }
       else {
-        LOG("ERROR: Failed to open geometry shader %s!\n", geometry_path.c_str());
+        LOG_ERROR("Failed to open geometry shader %s!\n", geometry_path.c_str());
         return false;
       }
     }
@@ -184,7 +184,7 @@ namespace elgar {
     if (m_shaders.find(name) != m_shaders.end()) {
       delete m_shaders.at(name);
       m_shaders.erase(name);
-      LOG("Shader destroyed!\n");
+      LOG_DEBUG("Shader destroyed!\n");
     }
     else {
       LOG("Shader does not exist!\n");
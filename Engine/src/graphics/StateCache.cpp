@@ -0,0 +1,186 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/graphics/StateCache.hpp"
+#include "elgar/core/Macros.hpp"
+
+namespace elgar {
+
+  // FUNCTIONS //
+
+  StateCache::StateCache() : Singleton<StateCache>(this) {
+    GLint unit_count = 0;
+    glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &unit_count);
+
+    m_textures.resize(unit_count > 0 ? unit_count : 1);
+
+    Invalidate();   // Nothing is known about the context yet
+
+    m_frame_issued = 0;
+    m_frame_skipped = 0;
+    m_last_issued = 0;
+    m_last_skipped = 0;
+
+    LOG("StateCache online...\n");
+  }
+
+  StateCache::~StateCache() {
+    LOG("StateCache offline...\n");
+  }
+
+  bool StateCache::Count(const bool &issued) {
+    if (issued)
+      m_frame_issued++;
+    else
+      m_frame_skipped++;
+
+    return issued;
+  }
+
+  void StateCache::EndFrame() {
+    m_last_issued = m_frame_issued;
+    m_last_skipped = m_frame_skipped;
+
+    m_frame_issued = 0;
+    m_frame_skipped = 0;
+  }
+
+  void StateCache::UseProgram(const GLuint &program) {
+    if (!Count(m_program != program))
+      return;
+
+    glUseProgram(program);
+    m_program = program;
+  }
+
+  void StateCache::BindVertexArray(const GLuint &vertex_array) {
+    if (!Count(m_vertex_array != vertex_array))
+      return;
+
+    glBindVertexArray(vertex_array);
+    m_vertex_array = vertex_array;
+
+    // The element array binding is part of the vertex array state
+    m_buffers[GL_ELEMENT_ARRAY_BUFFER] = STATE_CACHE_UNKNOWN;
+  }
+
+  void StateCache::ActiveTexture(const GLuint &unit) {
+    if (!Count(m_active_texture != unit))
+      return;
+
+    glActiveTexture(GL_TEXTURE0 + unit);
+    m_active_texture = unit;
+  }
+
+  void StateCache::BindTexture(const GLuint &unit, const GLuint &texture) {
+    // Units beyond what the driver reported are passed straight through
+    if (unit >= m_textures.size()) {
+      ActiveTexture(unit);
+      glBindTexture(GL_TEXTURE_2D, texture);
+      Count(true);
+      return;
+    }
+
+    if (!Count(m_textures[unit] != texture))
+      return;
+
+    ActiveTexture(unit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    m_textures[unit] = texture;
+  }
+
+  void StateCache::BindBuffer(const GLenum &target, const GLuint &buffer) {
+    GLuint &bound = m_buffers.insert(std::pair<GLenum, GLuint>(target, STATE_CACHE_UNKNOWN)).first->second;
+
+    if (!Count(bound != buffer))
+      return;
+
+    glBindBuffer(target, buffer);
+    bound = buffer;
+  }
+
+  void StateCache::BindFramebuffer(const GLenum &target, const GLuint &framebuffer) {
+    if (target == GL_FRAMEBUFFER) {
+      // Binding GL_FRAMEBUFFER sets both the draw and read targets
+      GLuint &draw = m_framebuffers.insert(std::pair<GLenum, GLuint>(GL_DRAW_FRAMEBUFFER, STATE_CACHE_UNKNOWN)).first->second;
+      GLuint &read = m_framebuffers.insert(std::pair<GLenum, GLuint>(GL_READ_FRAMEBUFFER, STATE_CACHE_UNKNOWN)).first->second;
+
+      if (!Count(draw != framebuffer || read != framebuffer))
+        return;
+
+      glBindFramebuffer(target, framebuffer);
+      draw = framebuffer;
+      read = framebuffer;
+      return;
+    }
+
+    GLuint &bound = m_framebuffers.insert(std::pair<GLenum, GLuint>(target, STATE_CACHE_UNKNOWN)).first->second;
+
+    if (!Count(bound != framebuffer))
+      return;
+
+    glBindFramebuffer(target, framebuffer);
+    bound = framebuffer;
+  }
+
+  void StateCache::ForgetProgram(const GLuint &program) {
+    // A deleted program stays in use until another one replaces it, so force the next Use through
+    if (m_program == program)
+      m_program = STATE_CACHE_UNKNOWN;
+  }
+
+  void StateCache::ForgetVertexArray(const GLuint &vertex_array) {
+    // Deleting a bound object reverts the binding to zero
+    if (m_vertex_array == vertex_array) {
+      m_vertex_array = 0;
+      m_buffers[GL_ELEMENT_ARRAY_BUFFER] = STATE_CACHE_UNKNOWN;
+    }
+  }
+
+  void StateCache::ForgetTexture(const GLuint &texture) {
+    for (GLuint &bound : m_textures) {
+      if (bound == texture)
+        bound = 0;
+    }
+  }
+
+  void StateCache::ForgetBuffer(const GLuint &buffer) {
+    for (auto it = m_buffers.begin(); it != m_buffers.end(); it++) {
+      if (it->second == buffer)
+        it->second = 0;
+    }
+  }
+
+  void StateCache::ForgetFramebuffer(const GLuint &framebuffer) {
+    for (auto it = m_framebuffers.begin(); it != m_framebuffers.end(); it++) {
+      if (it->second == framebuffer)
+        it->second = 0;
+    }
+  }
+
+  void StateCache::Invalidate() {
+    m_program = STATE_CACHE_UNKNOWN;
+    m_vertex_array = STATE_CACHE_UNKNOWN;
+    m_active_texture = STATE_CACHE_UNKNOWN;
+
+    for (GLuint &bound : m_textures)
+      bound = STATE_CACHE_UNKNOWN;
+
+    m_buffers.clear();        // Missing targets are treated as unknown
+    m_framebuffers.clear();
+  }
+
+  GLuint StateCache::GetIssuedChanges() const {
+    return m_last_issued;
+  }
+
+  GLuint StateCache::GetSkippedChanges() const {
+    return m_last_skipped;
+  }
+
+}
@@ -30,7 +30,7 @@ namespace elgar {
 
   bool TextureStorage::Save(const std::string &name, const Texture *texture) {
     if (m_textures.find(name) != m_textures.end()) {
-      LOG("Error: TextureStorage already contains a texture under name: %s\n", name.c_str());
+      LOG_ERROR("TextureStorage already contains a texture under name: %s\n", name.c_str());
       return false;
     }
 
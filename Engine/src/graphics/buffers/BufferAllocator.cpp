@@ -0,0 +1,117 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/graphics/buffers/BufferAllocator.hpp"
+
+#include <iterator>
+
+namespace elgar {
+
+  // FUNCTIONS //
+
+  BufferAllocator::BufferAllocator(const GLsizei &capacity) {
+    m_capacity = capacity;
+    m_used = 0;
+
+    // The whole buffer starts out free
+    if (capacity > 0)
+      m_free_list.insert(std::pair<GLsizei, GLsizei>(0, capacity));
+  }
+
+  BufferAllocator::~BufferAllocator() {
+    // Do nothing
+  }
+
+  GLint BufferAllocator::Allocate(const GLsizei &size) {
+    if (size <= 0)
+      return -1;
+
+    // Find the first free range large enough
+    for (auto it = m_free_list.begin(); it != m_free_list.end(); it++) {
+      if (it->second < size)
+        continue;
+
+      const GLsizei offset = it->first;
+      const GLsizei remaining = it->second - size;
+
+      m_free_list.erase(it);
+
+      // Put whatever is left of the range back
+      if (remaining > 0)
+        m_free_list.insert(std::pair<GLsizei, GLsizei>(offset + size, remaining));
+
+      m_used += size;
+
+      return offset;
+    }
+
+    return -1;  // Out of space
+  }
+
+  void BufferAllocator::Free(const GLint &offset, const GLsizei &size) {
+    if (offset < 0 || size <= 0)
+      return;
+
+    GLsizei start = offset;
+    GLsizei length = size;
+
+    // Merge with the following free range if adjacent
+    auto next = m_free_list.lower_bound(start);
+    if (next != m_free_list.end() && next->first == start + length) {
+      length += next->second;
+      next = m_free_list.erase(next);
+    }
+
+    // Merge with the preceding free range if adjacent
+    if (next != m_free_list.begin()) {
+      auto prev = std::prev(next);
+
+      if (prev->first + prev->second == start) {
+        start = prev->first;
+        length += prev->second;
+        m_free_list.erase(prev);
+      }
+    }
+
+    m_free_list.insert(std::pair<GLsizei, GLsizei>(start, length));
+
+    m_used -= size;
+  }
+
+  void BufferAllocator::Grow(const GLsizei &capacity) {
+    if (capacity <= m_capacity)
+      return;
+
+    GLsizei start = m_capacity;
+    GLsizei length = capacity - m_capacity;
+
+    // Merge with a free range running up to the old end
+    if (!m_free_list.empty()) {
+      auto last = std::prev(m_free_list.end());
+
+      if (last->first + last->second == start) {
+        start = last->first;
+        length += last->second;
+        m_free_list.erase(last);
+      }
+    }
+
+    m_free_list.insert(std::pair<GLsizei, GLsizei>(start, length));
+
+    m_capacity = capacity;
+  }
+
+  const GLsizei &BufferAllocator::GetUsed() const {
+    return m_used;
+  }
+
+  const GLsizei &BufferAllocator::GetCapacity() const {
+    return m_capacity;
+  }
+
+}
@@ -7,27 +7,47 @@
 // INCLUDES //
 
 #include "elgar/graphics/buffers/BufferObject.hpp"
+#include "elgar/graphics/StateCache.hpp"
+#include "elgar/graphics/RenderThread.hpp"
+#include "elgar/core/MemoryTracker.hpp"
 
 namespace elgar {
 
   // FUNCTIONS //
 
   BufferObject::BufferObject(const GLenum &target) {
-    glGenBuffers(1, &m_id);
+    RenderThread::Invoke([this]() { glGenBuffers(1, &m_id); });
 
     m_target = target;
+    m_size = 0;
   }
 
   BufferObject::~BufferObject() {
-    glDeleteBuffers(1, &m_id);
+    // Frames still in flight may read the buffer, so it goes once they are presented
+    const GLuint id = m_id;
+    RenderThread::Defer([id]() {
+      if (StateCache::GetInstance())
+        StateCache::GetInstance()->ForgetBuffer(id);
+
+      glDeleteBuffers(1, &id);
+    });
+
+    if (m_size > 0)
+      MemoryTracker::Get().Release(MEMORY_BUFFERS, m_size);
   }
 
   void BufferObject::Bind() const {
-    glBindBuffer(m_target, m_id);
+    if (StateCache::GetInstance())
+      StateCache::GetInstance()->BindBuffer(m_target, m_id);
+    else
+      glBindBuffer(m_target, m_id);
   }
 
   void BufferObject::Unbind() const {
-    glBindBuffer(m_target, 0);
+    if (StateCache::GetInstance())
+      StateCache::GetInstance()->BindBuffer(m_target, 0);
+    else
+      glBindBuffer(m_target, 0);
   }
 
   void BufferObject::FillData(
@@ -35,6 +55,17 @@ namespace elgar {
     const GLsizeiptr &size, 
     const GLenum &usage) const {
     glBufferData(m_target, size, data, usage);
+
+    // The old storage is orphaned in favour of the new one
+    MemoryTracker &tracker = MemoryTracker::Get();
+
+    if (m_size > 0)
+      tracker.Release(MEMORY_BUFFERS, m_size);
+
+    m_size = size;
+
+    if (m_size > 0)
+      tracker.Allocate(MEMORY_BUFFERS, m_size);
   }
 
   void BufferObject::FillSubData(
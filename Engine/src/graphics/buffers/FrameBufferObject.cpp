@@ -7,27 +7,42 @@
 // INCLUDES //
 
 #include "elgar/graphics/buffers/FrameBufferObject.hpp"
+#include "elgar/graphics/StateCache.hpp"
+#include "elgar/graphics/RenderThread.hpp"
 
 namespace elgar {
 
   // FUNCTIONS //
 
   FrameBufferObject::FrameBufferObject(const GLenum &target) {
-    glGenFramebuffers(1, &m_id);  // Generate the fbo
+    RenderThread::Invoke([this]() { glGenFramebuffers(1, &m_id); });  // Generate the fbo
 
     m_target = target;
   }
 
   FrameBufferObject::~FrameBufferObject() {
-    glDeleteFramebuffers(1, &m_id);
+    // Frames still in flight may render into the fbo, so it goes once they are presented
+    const GLuint id = m_id;
+    RenderThread::Defer([id]() {
+      if (StateCache::GetInstance())
+        StateCache::GetInstance()->ForgetFramebuffer(id);
+
+      glDeleteFramebuffers(1, &id);
+    });
   }
 
   void FrameBufferObject::Bind() const {
-    glBindFramebuffer(m_target, m_id);
+    if (StateCache::GetInstance())
+      StateCache::GetInstance()->BindFramebuffer(m_target, m_id);
+    else
+      glBindFramebuffer(m_target, m_id);
   }
 
   void FrameBufferObject::Unbind() const {
-    glBindFramebuffer(m_target, 0);
+    if (StateCache::GetInstance())
+      StateCache::GetInstance()->BindFramebuffer(m_target, 0);
+    else
+      glBindFramebuffer(m_target, 0);
   }
 
 }
\ No newline at end of file
@@ -0,0 +1,175 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/graphics/buffers/StreamBufferObject.hpp"
+#include "elgar/graphics/StateCache.hpp"
+#include "elgar/graphics/RenderThread.hpp"
+#include "elgar/core/Exception.hpp"
+#include "elgar/core/Macros.hpp"
+#include "elgar/core/MemoryTracker.hpp"
+
+// DEFINES //
+
+#define STREAM_BUFFER_WAIT_TIMEOUT    1000000   // Nanoseconds to wait on a fence before flushing again
+
+namespace elgar {
+
+  // FUNCTIONS //
+
+  StreamBufferObject::StreamBufferObject(
+    const GLenum &target,
+    const GLsizeiptr &stride,
+    const GLsizei &region_capacity,
+    const GLsizei &region_count
+  ) : m_fences(region_count, nullptr) {
+    if (stride <= 0 || region_capacity <= 0 || region_count <= 0)
+      throw Exception("ERROR: StreamBufferObject requires a positive stride, region capacity and region count!");
+
+    m_target = target;
+    m_stride = stride;
+    m_region_capacity = region_capacity;
+    m_region_count = region_count;
+
+    m_region = 0;
+    m_head = 0;
+    m_mapped = nullptr;
+
+    m_size = m_stride * m_region_capacity * m_region_count;
+
+    // The storage is created by whichever thread owns the context
+    RenderThread::Invoke([this]() {
+      glGenBuffers(1, &m_id);
+      Bind();
+
+      if (GLEW_ARB_buffer_storage) {
+        // Allocate immutable storage and keep it mapped for the lifetime of the buffer
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        glBufferStorage(m_target, m_size, NULL, flags);
+        m_mapped = (GLubyte *)glMapBufferRange(m_target, 0, m_size, flags);
+      }
+
+      if (!m_mapped) {
+        LOG_WARNING("Persistent buffer mapping unavailable, StreamBufferObject falling back to buffer uploads!\n");
+
+        glBufferData(m_target, m_size, NULL, GL_STREAM_DRAW);   // Allocate mutable storage instead
+        m_staging.resize(m_stride * m_region_capacity);
+      }
+
+      Unbind();
+    });
+
+    MemoryTracker::Get().Allocate(MEMORY_BUFFERS, m_size);
+  }
+
+  StreamBufferObject::~StreamBufferObject() {
+    // Frames still in flight may read the buffer, so it goes once they are presented
+    const GLuint id = m_id;
+    const GLenum target = m_target;
+    const bool mapped = m_mapped != nullptr;
+    const std::vector<GLsync> fences = m_fences;
+
+    RenderThread::Defer([id, target, mapped, fences]() {
+      for (GLsync fence : fences) {
+        if (fence)
+          glDeleteSync(fence);
+      }
+
+      if (mapped) {
+        if (StateCache::GetInstance())
+          StateCache::GetInstance()->BindBuffer(target, id);
+        else
+          glBindBuffer(target, id);
+
+        glUnmapBuffer(target);
+      }
+
+      // Deleting the buffer also unbinds it
+      if (StateCache::GetInstance())
+        StateCache::GetInstance()->ForgetBuffer(id);
+
+      glDeleteBuffers(1, &id);
+    });
+
+    MemoryTracker::Get().Release(MEMORY_BUFFERS, m_size);
+  }
+
+  void StreamBufferObject::Bind() const {
+    if (StateCache::GetInstance())
+      StateCache::GetInstance()->BindBuffer(m_target, m_id);
+    else
+      glBindBuffer(m_target, m_id);
+  }
+
+  void StreamBufferObject::Unbind() const {
+    if (StateCache::GetInstance())
+      StateCache::GetInstance()->BindBuffer(m_target, 0);
+    else
+      glBindBuffer(m_target, 0);
+  }
+
+  GLvoid *StreamBufferObject::Reserve(const GLsizei &count) {
+    if (count > m_region_capacity)
+      throw Exception("ERROR: Attempted to reserve more elements than a StreamBufferObject region can hold!");
+
+    // Move on to a fresh region if this one cannot fit the request
+    if (m_head + count > m_region_capacity)
+      NextRegion();
+
+    if (!m_mapped)
+      return &m_staging[0];
+
+    return m_mapped + (m_region * m_region_capacity + m_head) * m_stride;
+  }
+
+  GLuint StreamBufferObject::Commit(const GLsizei &count) {
+    const GLuint first = m_region * m_region_capacity + m_head;  // Index of the first element written
+
+    // Upload the staged elements if the buffer could not be mapped
+    if (!m_mapped && count > 0)
+      glBufferSubData(m_target, first * m_stride, count * m_stride, &m_staging[0]);
+
+    m_head += count;
+
+    return first;
+  }
+
+  const GLsizei &StreamBufferObject::GetRegionCapacity() const {
+    return m_region_capacity;
+  }
+
+  bool StreamBufferObject::IsPersistent() const {
+    return m_mapped != nullptr;
+  }
+
+  void StreamBufferObject::NextRegion() {
+    if (m_mapped) {
+      // Guard the region we are leaving until the GPU is done reading it
+      m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    m_region = (m_region + 1) % m_region_count;
+    m_head = 0;
+
+    GLsync fence = m_fences[m_region];
+    if (!fence)
+      return;
+
+    // Wait until the GPU has finished with the region we are about to overwrite
+    GLenum status = GL_TIMEOUT_EXPIRED;
+    while (status == GL_TIMEOUT_EXPIRED)
+      status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, STREAM_BUFFER_WAIT_TIMEOUT);
+
+    if (status == GL_WAIT_FAILED)
+      LOG_WARNING("StreamBufferObject failed to wait on region fence!\n");
+
+    glDeleteSync(fence);
+    m_fences[m_region] = nullptr;
+  }
+
+}
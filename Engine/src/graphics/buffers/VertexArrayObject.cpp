@@ -7,25 +7,40 @@
 // INCLUDES //
 
 #include "elgar/graphics/buffers/VertexArrayObject.hpp"
+#include "elgar/graphics/StateCache.hpp"
+#include "elgar/graphics/RenderThread.hpp"
 
 namespace elgar {
 
   // FUNCTIONS //
 
   VertexArrayObject::VertexArrayObject() {
-    glGenVertexArrays(1, &m_id);
+    RenderThread::Invoke([this]() { glGenVertexArrays(1, &m_id); });
   }
 
   VertexArrayObject::~VertexArrayObject() {
-    glDeleteVertexArrays(1, &m_id);
+    // Frames still in flight may draw with the vao, so it goes once they are presented
+    const GLuint id = m_id;
+    RenderThread::Defer([id]() {
+      if (StateCache::GetInstance())
+        StateCache::GetInstance()->ForgetVertexArray(id);
+
+      glDeleteVertexArrays(1, &id);
+    });
   }
 
   void VertexArrayObject::Bind() const {
-    glBindVertexArray(m_id);
+    if (StateCache::GetInstance())
+      StateCache::GetInstance()->BindVertexArray(m_id);
+    else
+      glBindVertexArray(m_id);
   }
 
   void VertexArrayObject::Unbind() const {
-    glBindVertexArray(0);
+    if (StateCache::GetInstance())
+      StateCache::GetInstance()->BindVertexArray(0);
+    else
+      glBindVertexArray(0);
   }
 
   void VertexArrayObject::EnableAttribute(const GLuint &attrib_id) const {
@@ -8,9 +8,17 @@
 
 #include "elgar/graphics/data/Mesh.hpp"
 #include "elgar/core/Exception.hpp"
+#include "elgar/core/MemoryTracker.hpp"
+#include "elgar/graphics/renderers/MeshRenderer.hpp"
+
+#include <atomic>
 
 namespace elgar {
 
+  // LOCAL DATA //
+
+  static std::atomic<uint64_t> s_next_id(1);   // Id handed to the next Mesh
+
   // FUNCTIONS //
 
   Mesh::Mesh(
@@ -33,10 +41,77 @@ namespace elgar {
 
     // Copy the textures
     m_textures = textures;
+
+    m_id = s_next_id++;
+
+    ComputeBounds();
+    Track();
+  }
+
+  Mesh::Mesh(const Mesh &mesh) {
+    m_vertices = mesh.m_vertices;
+    m_indices = mesh.m_indices;
+    m_textures = mesh.m_textures;
+    m_bounds = mesh.m_bounds;
+
+    m_id = s_next_id++;
+
+    Track();
   }
 
   Mesh::~Mesh() {
-    // Do nothing
+    Untrack();
+
+    // Give any cached geometry back to the renderer
+    if (MeshRenderer::GetInstance())
+      MeshRenderer::GetInstance()->ReleaseMesh(m_id);
+  }
+
+  Mesh &Mesh::operator =(const Mesh &mesh) {
+    if (this == &mesh)
+      return *this;
+
+    // Cached geometry is stale once the contents change
+    if (MeshRenderer::GetInstance())
+      MeshRenderer::GetInstance()->ReleaseMesh(m_id);
+
+    Untrack();
+
+    m_vertices = mesh.m_vertices;
+    m_indices = mesh.m_indices;
+    m_textures = mesh.m_textures;
+    m_bounds = mesh.m_bounds;
+
+    m_id = s_next_id++;
+
+    Track();
+
+    return *this;
+  }
+
+  void Mesh::ComputeBounds() {
+    if (m_vertices.empty()) {
+      m_bounds = AABB{glm::vec3(0.0f), glm::vec3(0.0f)};
+      return;
+    }
+
+    m_bounds = AABB{m_vertices[0].pos, m_vertices[0].pos};
+    for (const Vertex &vertex : m_vertices) {
+      m_bounds.min = glm::min(m_bounds.min, vertex.pos);
+      m_bounds.max = glm::max(m_bounds.max, vertex.pos);
+    }
+  }
+
+  void Mesh::Track() {
+    m_bytes = m_vertices.capacity() * sizeof(Vertex)
+      + m_indices.capacity() * sizeof(GLuint)
+      + m_textures.capacity() * sizeof(const Texture *);
+
+    MemoryTracker::Get().Allocate(MEMORY_MESHES, m_bytes);
+  }
+
+  void Mesh::Untrack() {
+    MemoryTracker::Get().Release(MEMORY_MESHES, m_bytes);
   }
 
   const std::vector<Vertex> &Mesh::GetVertices() const {
@@ -51,4 +126,12 @@ namespace elgar {
     return m_textures;
   }
 
+  const AABB &Mesh::GetBounds() const {
+    return m_bounds;
+  }
+
+  const uint64_t &Mesh::GetId() const {
+    return m_id;
+  }
+
 }
\ No newline at end of file
@@ -19,6 +19,13 @@ namespace elgar {
     m_alpha = a;
   }
 
+  RGBA::RGBA(const RGBA &color) {
+    m_red = color.m_red;
+    m_green = color.m_green;
+    m_blue = color.m_blue;
+    m_alpha = color.m_alpha;
+  }
+
   RGBA::~RGBA() {
     // Do nothing
   }
@@ -7,59 +7,90 @@
 // INCLUDES //
 
 #include "elgar/graphics/data/Texture.hpp"
+#include "elgar/graphics/StateCache.hpp"
+#include "elgar/graphics/RenderThread.hpp"
+#include "elgar/core/MemoryTracker.hpp"
 
 namespace elgar {
 
   // FUNCTIONS //
 
   Texture::Texture(const Image &image, const TextureType &type, const TextureParams &params) {
-    glGenTextures(1, &m_id);  // Generate a new OpenGL texture
-    this->Bind(); // Bind the texture
-
     m_type = type;  // Copy the type
 
-    // Set the texture parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, params.wrap_mode);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, params.wrap_mode);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, params.min_filter_mode);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, params.mag_filter_mode);
+    // The texture is created by whichever thread owns the context
+    RenderThread::Invoke([this, &image, &params]() {
+      glGenTextures(1, &m_id);  // Generate a new OpenGL texture
+      this->Bind(); // Bind the texture
 
-    GLint mode = GL_RGB;
-    if (image.channels == 1) {
-      mode = GL_RED;
-      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);  // Set the pixel storage mode
-    }
-    else if (image.channels == 4)
-      mode = GL_RGBA;
+      // Set the texture parameters
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, params.wrap_mode);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, params.wrap_mode);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, params.min_filter_mode);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, params.mag_filter_mode);
+
+      GLint mode = GL_RGB;
+      if (image.channels == 1) {
+        mode = GL_RED;
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);  // Set the pixel storage mode
+      }
+      else if (image.channels == 4)
+        mode = GL_RGBA;
+
+      // Send OpenGL the texture data
+      glTexImage2D(GL_TEXTURE_2D, 0, mode, image.width, image.height, 0, mode, GL_UNSIGNED_BYTE, image.data);
 
-    // Send OpenGL the texture data
-    glTexImage2D(GL_TEXTURE_2D, 0, mode, image.width, image.height, 0, mode, GL_UNSIGNED_BYTE, image.data);
+      // Generate mipmaps for the texture
+      glGenerateMipmap(GL_TEXTURE_2D);
 
-    // Generate mipmaps for the texture
-    glGenerateMipmap(GL_TEXTURE_2D);
+      // Reset pixel storage mode if necessary
+      if (image.channels == 1) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);  // Back to default value
+      }
+
+      this->Unbind(); // Unbind the texture
+    });
 
     // Copy the width and height
     m_width = image.width;
     m_height = image.height;
 
-    // Reset pixel storage mode if necessary
-    if (image.channels == 1) {
-      glPixelStorei(GL_UNPACK_ALIGNMENT, 4);  // Back to default value
-    }
+    // Drivers pad RGB texels out to four bytes, and the mipmap chain adds another third
+    const size_t texel_size = image.channels == 3 ? 4 : image.channels;
+    m_bytes = (size_t)m_width * m_height * texel_size * 4 / 3;
 
-    this->Unbind(); // Unbind the texture
+    MemoryTracker::Get().Allocate(MEMORY_TEXTURES, m_bytes);
   }
 
   Texture::~Texture() {
-    glDeleteTextures(1, &m_id); // Delete the texture
+    // Frames still in flight may sample the texture, so it goes once they are presented
+    const GLuint id = m_id;
+    RenderThread::Defer([id]() {
+      if (StateCache::GetInstance())
+        StateCache::GetInstance()->ForgetTexture(id);
+
+      glDeleteTextures(1, &id); // Delete the texture
+    });
+
+    MemoryTracker::Get().Release(MEMORY_TEXTURES, m_bytes);
   }
 
   void Texture::Bind(const GLuint &index) const {
+    if (StateCache::GetInstance()) {
+      StateCache::GetInstance()->BindTexture(index, m_id);
+      return;
+    }
+
     glActiveTexture(GL_TEXTURE0 + index);
     glBindTexture(GL_TEXTURE_2D, m_id);
   }
 
   void Texture::Unbind(const GLuint &index) const {
+    if (StateCache::GetInstance()) {
+      StateCache::GetInstance()->BindTexture(index, 0);
+      return;
+    }
+
     glActiveTexture(GL_TEXTURE0 + index);
     glBindTexture(GL_TEXTURE_2D, 0);
   }
@@ -80,6 +111,10 @@ namespace elgar {
     return m_height;
   }
 
+  const GLuint &Texture::GetId() const {
+    return m_id;
+  }
+
   const TextureType &Texture::GetType() const {
     return m_type;
   }
@@ -0,0 +1,340 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/graphics/groups/RenderGroup.hpp"
+#include "elgar/core/Macros.hpp"
+#include "elgar/graphics/renderers/SpriteRenderer.hpp"
+#include "elgar/graphics/renderers/MeshRenderer.hpp"
+#include "elgar/graphics/renderers/TextRenderer.hpp"
+
+#include <cstring>
+
+// DEFINES //
+
+#define RENDER_KEY_ID_MASK      0xFFF       // Shader and texture ids are folded into 12 bits
+#define RENDER_KEY_DEPTH_MASK   0xFFFFFF    // Depth is quantized to 24 bits
+#define RENDER_KEY_RADIX_BITS   8           // Bits sorted per radix pass
+#define RENDER_KEY_RADIX_SIZE   (1 << RENDER_KEY_RADIX_BITS)
+
+namespace elgar {
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief Map a distance onto 24 bits such that the integer order matches the float order
+   *
+   * @param distance  The distance from the camera
+   * @return The quantized depth
+   */
+  static GLuint64 QuantizeDepth(const GLfloat &distance) {
+    GLuint bits;
+    std::memcpy(&bits, &distance, sizeof(GLuint));
+
+    // Flip negative floats entirely and positive floats' sign bit so the bits sort as unsigned
+    bits = (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+
+    return (bits >> 8) & RENDER_KEY_DEPTH_MASK;
+  }
+
+  // FUNCTIONS //
+
+  RenderGroup::RenderGroup() : m_view_matrix(1.0f) {
+    m_draw_count = 0;
+  }
+
+  RenderGroup::~RenderGroup() {
+    // Do nothing
+  }
+
+  void RenderGroup::SetViewMatrix(const glm::mat4 &view) {
+    m_view_matrix = view;
+  }
+
+  void RenderGroup::Queue(
+    const RenderCommand &command,
+    const GLubyte &layer,
+    const bool &translucent,
+    const glm::vec3 &position
+  ) {
+    const GLuint64 shader = command.shader->GetId() & RENDER_KEY_ID_MASK;
+    const GLuint64 texture = command.texture ? (command.texture->GetId() & RENDER_KEY_ID_MASK) : 0;
+
+    // Distance in front of the camera
+    const GLfloat distance = -(m_view_matrix * glm::vec4(position, 1.0f)).z;
+    const GLuint64 depth = QuantizeDepth(distance);
+
+    GLuint64 key = ((GLuint64)layer << 56);
+
+    if (!translucent) {
+      // Opaque: layer | 0 | shader | texture | depth (front to back)
+      key |= (shader << 43) | (texture << 31) | (depth << 7);
+    }
+    else {
+      // Translucent: layer | 1 | depth (back to front) | shader | texture
+      key |= ((GLuint64)1 << 55) | ((RENDER_KEY_DEPTH_MASK - depth) << 31) | (shader << 19) | (texture << 7);
+    }
+
+    m_keys.push_back(std::pair<GLuint64, GLuint>(key, m_commands.size()));
+    m_commands.push_back(command);
+  }
+
+  void RenderGroup::Sort() {
+    const size_t count = m_keys.size();
+    if (count < 2)
+      return;
+
+    m_scratch.resize(count);
+
+    for (GLuint shift = 0; shift < 64; shift += RENDER_KEY_RADIX_BITS) {
+      size_t histogram[RENDER_KEY_RADIX_SIZE] = {0};
+
+      for (size_t i = 0; i < count; i++)
+        histogram[(m_keys[i].first >> shift) & (RENDER_KEY_RADIX_SIZE - 1)]++;
+
+      // Every key shares this byte, so the pass would not change anything
+      if (histogram[(m_keys[0].first >> shift) & (RENDER_KEY_RADIX_SIZE - 1)] == count)
+        continue;
+
+      // Turn the histogram into starting offsets
+      size_t offset = 0;
+      for (size_t b = 0; b < RENDER_KEY_RADIX_SIZE; b++) {
+        const size_t size = histogram[b];
+        histogram[b] = offset;
+        offset += size;
+      }
+
+      for (size_t i = 0; i < count; i++)
+        m_scratch[histogram[(m_keys[i].first >> shift) & (RENDER_KEY_RADIX_SIZE - 1)]++] = m_keys[i];
+
+      m_keys.swap(m_scratch);
+    }
+  }
+
+  void RenderGroup::SubmitSprite(
+    const Shader &shader,
+    const glm::mat4 &model,
+    const RGBA &color,
+    const Texture *texture,
+    const RenderLayer &layer,
+    const bool &translucent
+  ) {
+    RenderCommand command;
+    command.type = RENDER_COMMAND_SPRITE;
+    command.shader = &shader;
+    command.texture = texture;
+    command.mesh = nullptr;
+    command.models = nullptr;
+    command.model = model;
+    command.color = color;
+
+    Queue(command, layer, translucent || color.GetAlphaChannel() < 0xFF, glm::vec3(model[3]));
+  }
+
+  void RenderGroup::SubmitSpriteInstanced(
+    const Shader &shader,
+    const std::vector<glm::mat4> &models,
+    const RGBA &color,
+    const Texture *texture,
+    const RenderLayer &layer,
+    const bool &translucent
+  ) {
+    if (models.empty())
+      return;
+
+    RenderCommand command;
+    command.type = RENDER_COMMAND_SPRITE_INSTANCED;
+    command.shader = &shader;
+    command.texture = texture;
+    command.mesh = nullptr;
+    command.models = &models;
+    command.color = color;
+
+    Queue(command, layer, translucent || color.GetAlphaChannel() < 0xFF, glm::vec3(models[0][3]));
+  }
+
+  void RenderGroup::SubmitMesh(
+    const Mesh &mesh,
+    const Shader &shader,
+    const RGBA &color,
+    const glm::mat4 &model,
+    const RenderLayer &layer,
+    const bool &translucent
+  ) {
+    const std::vector<const Texture *> &textures = mesh.GetTextures();
+
+    RenderCommand command;
+    command.type = RENDER_COMMAND_MESH;
+    command.shader = &shader;
+    command.texture = textures.empty() ? nullptr : textures[0];   // Sort on the first texture
+    command.mesh = &mesh;
+    command.models = nullptr;
+    command.model = model;
+    command.color = color;
+
+    Queue(command, layer, translucent || color.GetAlphaChannel() < 0xFF, glm::vec3(model[3]));
+  }
+
+  void RenderGroup::SubmitMeshInstanced(
+    const Mesh &mesh,
+    const Shader &shader,
+    const RGBA &color,
+    const std::vector<glm::mat4> &models,
+    const RenderLayer &layer,
+    const bool &translucent
+  ) {
+    if (models.empty())
+      return;
+
+    const std::vector<const Texture *> &textures = mesh.GetTextures();
+
+    RenderCommand command;
+    command.type = RENDER_COMMAND_MESH_INSTANCED;
+    command.shader = &shader;
+    command.texture = textures.empty() ? nullptr : textures[0];   // Sort on the first texture
+    command.mesh = &mesh;
+    command.models = &models;
+    command.color = color;
+
+    Queue(command, layer, translucent || color.GetAlphaChannel() < 0xFF, glm::vec3(models[0][3]));
+  }
+
+  void RenderGroup::SubmitText(
+    const Shader &shader,
+    const std::string &text,
+    const RGBA &color,
+    const glm::mat4 &model,
+    const GLfloat &scale,
+    const RenderLayer &layer
+  ) {
+    RenderCommand command;
+    command.type = RENDER_COMMAND_TEXT;
+    command.shader = &shader;
+    command.texture = nullptr;    // Every glyph lives in the same atlas
+    command.mesh = nullptr;
+    command.models = nullptr;
+    command.model = model;
+    command.color = color;
+    command.text = m_text.size();
+    command.scale = scale;
+
+    m_text.push_back(text);
+
+    Queue(command, layer, true, glm::vec3(model[3]));
+  }
+
+  void RenderGroup::Flush() {
+    PROFILE_ZONE("RenderGroup::Flush");
+
+    SpriteRenderer *sprite_renderer = SpriteRenderer::GetInstance();
+    MeshRenderer *mesh_renderer = MeshRenderer::GetInstance();
+    TextRenderer *text_renderer = TextRenderer::GetInstance();
+
+    Sort();   // Put the commands in state-minimizing order
+
+    m_draw_count = 0;
+
+    const size_t count = m_keys.size();
+    size_t i = 0;
+
+    while (i < count) {
+      const RenderCommand &command = m_commands[m_keys[i].second];
+      size_t next = i + 1;
+
+      switch (command.type) {
+        case RENDER_COMMAND_SPRITE: {
+          if (!sprite_renderer)
+            break;
+
+          // Gather the run of sprites that only differ in their model matrix
+          while (next < count) {
+            const RenderCommand &other = m_commands[m_keys[next].second];
+
+            if (other.type != RENDER_COMMAND_SPRITE || other.shader != command.shader ||
+                other.texture != command.texture || other.color.GetPackedData() != command.color.GetPackedData())
+              break;
+
+            next++;
+          }
+
+          if (next - i == 1) {
+            sprite_renderer->Draw(*command.shader, command.model, command.color, command.texture);
+          }
+          else {
+            // Draw the whole run with one instanced call
+            m_batch.clear();
+            for (size_t j = i; j < next; j++)
+              m_batch.push_back(m_commands[m_keys[j].second].model);
+
+            sprite_renderer->DrawInstanced(*command.shader, m_batch, command.color, command.texture);
+          }
+
+          m_draw_count++;
+          break;
+        }
+        case RENDER_COMMAND_SPRITE_INSTANCED:
+          if (!sprite_renderer)
+            break;
+
+          sprite_renderer->DrawInstanced(*command.shader, *command.models, command.color, command.texture);
+          m_draw_count++;
+          break;
+        case RENDER_COMMAND_MESH:
+          if (!mesh_renderer)
+            break;
+
+          mesh_renderer->Draw(*command.mesh, *command.shader, command.color, command.model);
+          m_draw_count++;
+          break;
+        case RENDER_COMMAND_MESH_INSTANCED:
+          if (!mesh_renderer)
+            break;
+
+          mesh_renderer->DrawInstanced(*command.mesh, *command.shader, command.color, *command.models);
+          m_draw_count++;
+          break;
+        case RENDER_COMMAND_TEXT: {
+          if (!text_renderer)
+            break;
+
+          text_renderer->Submit(m_text[command.text], command.color, command.model, command.scale);
+
+          // Keep batching until the shader changes or something else has to be drawn in between
+          if (next < count) {
+            const RenderCommand &other = m_commands[m_keys[next].second];
+
+            if (other.type == RENDER_COMMAND_TEXT && other.shader == command.shader)
+              break;
+          }
+
+          text_renderer->Flush(*command.shader);
+          m_draw_count++;
+          break;
+        }
+      }
+
+      i = next;
+    }
+
+    Clear();
+  }
+
+  void RenderGroup::Clear() {
+    m_commands.clear();
+    m_text.clear();
+    m_keys.clear();
+  }
+
+  GLsizei RenderGroup::GetCommandCount() const {
+    return m_commands.size();
+  }
+
+  const GLsizei &RenderGroup::GetDrawCount() const {
+    return m_draw_count;
+  }
+
+}
@@ -0,0 +1,319 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/graphics/groups/TransformationGroup.hpp"
+#include "elgar/core/Exception.hpp"
+#include "elgar/core/Macros.hpp"
+#include "elgar/graphics/renderers/SpriteRenderer.hpp"
+#include "elgar/graphics/renderers/MeshRenderer.hpp"
+#include "elgar/physics/TransformKernel.hpp"
+
+#include <algorithm>
+
+namespace elgar {
+
+  // FUNCTIONS //
+
+  TransformationGroup::TransformationGroup(const glm::mat4 &transform) {
+    m_group_transform = transform;
+    m_first_dirty = TRANSFORM_NODE_NONE;
+    m_reorder = false;
+    m_node_count = 0;
+    m_update_count = 0;
+  }
+
+  TransformationGroup::~TransformationGroup() {
+
+  }
+
+  GLuint TransformationGroup::GetSlot(const TransformNode &node) const {
+    if (node >= m_slots.size() || m_slots[node] == TRANSFORM_NODE_NONE)
+      throw Exception("ERROR: Transform node does not exist!");
+
+    return m_slots[node];
+  }
+
+  void TransformationGroup::MarkDirty(const GLuint &slot) {
+    m_dirty[slot] = 1;
+
+    if (m_first_dirty == TRANSFORM_NODE_NONE || slot < m_first_dirty)
+      m_first_dirty = slot;
+  }
+
+  void TransformationGroup::Reorder() {
+    PROFILE_ZONE("TransformationGroup::Reorder");
+
+    const GLuint slot_count = m_parents.size();
+
+    // List the children of every slot (compressed, in slot order)
+    std::vector<GLuint> child_start(slot_count + 1, 0);
+    std::vector<GLuint> children(m_node_count);
+
+    for (GLuint slot = 0; slot < slot_count; slot++) {
+      if (m_nodes[slot] != TRANSFORM_NODE_NONE && m_parents[slot] != TRANSFORM_NODE_NONE)
+        child_start[m_parents[slot] + 1]++;
+    }
+
+    for (GLuint slot = 0; slot < slot_count; slot++)
+      child_start[slot + 1] += child_start[slot];
+
+    std::vector<GLuint> fill(child_start.begin(), child_start.end() - 1);
+    for (GLuint slot = 0; slot < slot_count; slot++) {
+      if (m_nodes[slot] != TRANSFORM_NODE_NONE && m_parents[slot] != TRANSFORM_NODE_NONE)
+        children[fill[m_parents[slot]]++] = slot;
+    }
+
+    // Breadth-first walk from the roots
+    std::vector<GLuint> order;
+    order.reserve(m_node_count);
+
+    for (GLuint slot = 0; slot < slot_count; slot++) {
+      if (m_nodes[slot] != TRANSFORM_NODE_NONE && m_parents[slot] == TRANSFORM_NODE_NONE)
+        order.push_back(slot);
+    }
+
+    for (size_t i = 0; i < order.size(); i++) {
+      const GLuint slot = order[i];
+      order.insert(order.end(), children.begin() + child_start[slot], children.begin() + child_start[slot + 1]);
+    }
+
+    // Move every array into the new order
+    std::vector<GLuint> new_slots(slot_count, TRANSFORM_NODE_NONE);
+    for (GLuint i = 0; i < order.size(); i++)
+      new_slots[order[i]] = i;
+
+    std::vector<GLuint> parents(order.size());
+    std::vector<glm::mat4> local(order.size());
+    std::vector<glm::mat4> world(order.size());
+    std::vector<GLubyte> dirty(order.size());
+    std::vector<TransformNode> nodes(order.size());
+
+    m_first_dirty = TRANSFORM_NODE_NONE;
+
+    for (GLuint i = 0; i < order.size(); i++) {
+      const GLuint slot = order[i];
+      const GLuint parent = m_parents[slot];
+
+      parents[i] = parent == TRANSFORM_NODE_NONE ? TRANSFORM_NODE_NONE : new_slots[parent];
+      local[i] = m_local[slot];
+      world[i] = m_world[slot];
+      dirty[i] = m_dirty[slot];
+      nodes[i] = m_nodes[slot];
+
+      m_slots[nodes[i]] = i;
+
+      if (dirty[i] && m_first_dirty == TRANSFORM_NODE_NONE)
+        m_first_dirty = i;
+    }
+
+    m_parents.swap(parents);
+    m_local.swap(local);
+    m_world.swap(world);
+    m_dirty.swap(dirty);
+    m_nodes.swap(nodes);
+
+    m_reorder = false;
+  }
+
+  TransformNode TransformationGroup::CreateNode(const TransformNode &parent, const glm::mat4 &local) {
+    const GLuint parent_slot = parent == TRANSFORM_NODE_NONE ? TRANSFORM_NODE_NONE : GetSlot(parent);
+    const GLuint slot = m_parents.size();
+
+    if (slot == TRANSFORM_NODE_NONE)
+      throw Exception("ERROR: TransformationGroup is full!");
+
+    // Reuse a handle if possible
+    TransformNode node;
+    if (!m_free_nodes.empty()) {
+      node = m_free_nodes.back();
+      m_free_nodes.pop_back();
+      m_slots[node] = slot;
+    } else {
+      node = m_slots.size();
+      m_slots.push_back(slot);
+    }
+
+    // Appending keeps parents ahead of their children, but no longer breadth-first
+    m_parents.push_back(parent_slot);
+    m_local.push_back(local);
+    m_world.push_back(local);
+    m_dirty.push_back(0);
+    m_nodes.push_back(node);
+
+    MarkDirty(slot);
+
+    m_reorder = true;
+    m_node_count++;
+
+    return node;
+  }
+
+  void TransformationGroup::DestroyNode(const TransformNode &node) {
+    const GLuint first = GetSlot(node);
+    const GLuint slot_count = m_parents.size();
+
+    // Descendants always come after their ancestors, so one pass finds the whole subtree
+    for (GLuint slot = first; slot < slot_count; slot++) {
+      if (m_nodes[slot] == TRANSFORM_NODE_NONE)
+        continue;
+
+      const GLuint parent = m_parents[slot];
+      if (slot != first && (parent == TRANSFORM_NODE_NONE || m_nodes[parent] != TRANSFORM_NODE_NONE))
+        continue;
+
+      m_slots[m_nodes[slot]] = TRANSFORM_NODE_NONE;
+      m_free_nodes.push_back(m_nodes[slot]);
+      m_nodes[slot] = TRANSFORM_NODE_NONE;
+      m_node_count--;
+    }
+
+    m_reorder = true;
+  }
+
+  bool TransformationGroup::IsAlive(const TransformNode &node) const {
+    return node < m_slots.size() && m_slots[node] != TRANSFORM_NODE_NONE;
+  }
+
+  void TransformationGroup::SetParent(const TransformNode &node, const TransformNode &parent) {
+    const GLuint slot = GetSlot(node);
+    const GLuint parent_slot = parent == TRANSFORM_NODE_NONE ? TRANSFORM_NODE_NONE : GetSlot(parent);
+
+    // Make sure the node is not becoming its own ancestor
+    for (GLuint ancestor = parent_slot; ancestor != TRANSFORM_NODE_NONE; ancestor = m_parents[ancestor]) {
+      if (ancestor == slot)
+        throw Exception("ERROR: Transform node cannot be attached to its own descendant!");
+    }
+
+    m_parents[slot] = parent_slot;
+    MarkDirty(slot);
+
+    m_reorder = true;
+
+    // Restore parents ahead of children right away, DestroyNode relies on it
+    if (parent_slot != TRANSFORM_NODE_NONE && parent_slot > slot)
+      Reorder();
+  }
+
+  TransformNode TransformationGroup::GetParent(const TransformNode &node) const {
+    const GLuint parent = m_parents[GetSlot(node)];
+    return parent == TRANSFORM_NODE_NONE ? TRANSFORM_NODE_NONE : m_nodes[parent];
+  }
+
+  void TransformationGroup::SetLocalTransform(const TransformNode &node, const glm::mat4 &local) {
+    const GLuint slot = GetSlot(node);
+
+    m_local[slot] = local;
+    MarkDirty(slot);
+  }
+
+  void TransformationGroup::SetLocalTransform(
+    const TransformNode &node,
+    const glm::vec3 &position,
+    const glm::vec3 &scale,
+    const glm::vec3 &rotation
+  ) {
+    SetLocalTransform(node, ComputeInterpolatedMatrix(position, position, scale, scale, rotation, rotation, 1.0f));
+  }
+
+  const glm::mat4 &TransformationGroup::GetLocalTransform(const TransformNode &node) const {
+    return m_local[GetSlot(node)];
+  }
+
+  const glm::mat4 &TransformationGroup::GetWorldTransform(const TransformNode &node) const {
+    return m_world[GetSlot(node)];
+  }
+
+  void TransformationGroup::SetGroupTransform(const glm::mat4 &transform) {
+    m_group_transform = transform;
+
+    // Every root moves with the group
+    const GLuint slot_count = m_parents.size();
+    for (GLuint slot = 0; slot < slot_count; slot++) {
+      if (m_parents[slot] == TRANSFORM_NODE_NONE && m_nodes[slot] != TRANSFORM_NODE_NONE)
+        MarkDirty(slot);
+    }
+  }
+
+  const glm::mat4 &TransformationGroup::GetGroupTransform() const {
+    return m_group_transform;
+  }
+
+  void TransformationGroup::Update() {
+    PROFILE_ZONE("TransformationGroup::Update");
+
+    if (m_reorder)
+      Reorder();
+
+    m_update_count = 0;
+
+    if (m_first_dirty == TRANSFORM_NODE_NONE)
+      return;
+
+    const GLuint slot_count = m_parents.size();
+
+    // Parents come first, so a dirty parent is always recomputed before its children read it
+    for (GLuint slot = m_first_dirty; slot < slot_count; slot++) {
+      const GLuint parent = m_parents[slot];
+
+      if (parent == TRANSFORM_NODE_NONE) {
+        if (m_dirty[slot]) {
+          m_world[slot] = m_group_transform * m_local[slot];
+          m_update_count++;
+        }
+      } else if (m_dirty[slot] || m_dirty[parent]) {
+        m_dirty[slot] = 1;    // Pass the change down to the children
+        m_world[slot] = m_world[parent] * m_local[slot];
+        m_update_count++;
+      }
+    }
+
+    std::fill(m_dirty.begin() + m_first_dirty, m_dirty.end(), 0);
+    m_first_dirty = TRANSFORM_NODE_NONE;
+  }
+
+  const glm::mat4 *TransformationGroup::GetWorldTransforms() const {
+    return m_world.data();
+  }
+
+  GLuint TransformationGroup::GetNodeIndex(const TransformNode &node) const {
+    if (m_reorder)
+      throw Exception("ERROR: TransformationGroup must be updated before its nodes can be indexed!");
+
+    return GetSlot(node);
+  }
+
+  void TransformationGroup::GatherWorldTransforms(const TransformNode *nodes, const size_t &count, glm::mat4 *matrices) const {
+    for (size_t i = 0; i < count; i++)
+      matrices[i] = m_world[GetSlot(nodes[i])];
+  }
+
+  void TransformationGroup::DrawSprites(const Shader &shader, const RGBA &color, const Texture *texture) {
+    Update();
+
+    SpriteRenderer *sprite_renderer = SpriteRenderer::GetInstance();
+    if (sprite_renderer && m_node_count)
+      sprite_renderer->DrawInstanced(shader, m_world.data(), m_node_count, color, texture);
+  }
+
+  void TransformationGroup::DrawMeshes(const Mesh &mesh, const Shader &shader, const RGBA &color) {
+    Update();
+
+    MeshRenderer *mesh_renderer = MeshRenderer::GetInstance();
+    if (mesh_renderer && m_node_count)
+      mesh_renderer->DrawInstanced(mesh, shader, color, m_world.data(), m_node_count);
+  }
+
+  const size_t &TransformationGroup::GetNodeCount() const {
+    return m_node_count;
+  }
+
+  const size_t &TransformationGroup::GetUpdateCount() const {
+    return m_update_count;
+  }
+
+}
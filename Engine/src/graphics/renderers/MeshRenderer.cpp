@@ -8,12 +8,33 @@
 
 #include "elgar/graphics/renderers/MeshRenderer.hpp"
 #include "elgar/core/Macros.hpp"
+#include "elgar/graphics/GPUTimer.hpp"
+#include "elgar/graphics/CommandList.hpp"
+#include "elgar/graphics/RenderThread.hpp"
+
+#include <algorithm>
+#include <cstring>
 
 namespace elgar {
 
   // FUNCTIONS //
 
-  MeshRenderer::MeshRenderer() : Singleton<MeshRenderer>(this), m_vbo(GL_ARRAY_BUFFER), m_ebo(GL_ELEMENT_ARRAY_BUFFER) {
+  MeshRenderer::MeshRenderer() : 
+    Singleton<MeshRenderer>(this), 
+    m_vbo(GL_ARRAY_BUFFER), 
+    m_ebo(GL_ELEMENT_ARRAY_BUFFER),
+    m_vertex_allocator(MESH_RENDERER_VERTEX_CAPACITY),
+    m_index_allocator(MESH_RENDERER_INDEX_CAPACITY),
+    m_instance_buffer(GL_ARRAY_BUFFER, sizeof(glm::mat4), MESH_RENDERER_INSTANCE_CAPACITY),
+    m_last_upload_bytes(0),
+    m_frame_tested(0),
+    m_frame_culled(0)
+  {
+    m_frame_upload_bytes = 0;
+
+    m_culling_camera = nullptr;
+    m_last_cull_stats = CullStats{0, 0};
+
     // Setup VAO
     m_vao.Bind();
 
@@ -21,16 +42,16 @@ namespace elgar {
     m_vbo.Bind(); 
     m_vbo.FillData(
       NULL,   // Orphan the buffer
-      sizeof(Vertex) * MESH_MAX_VERTEX_COUNT,   // Allocate bytes
-      GL_DYNAMIC_DRAW   // Buffer will be modified frequently
+      sizeof(Vertex) * MESH_RENDERER_VERTEX_CAPACITY,   // Allocate bytes for every cached mesh
+      GL_DYNAMIC_DRAW   // Buffer will be modified as meshes come and go
     );
 
     // Setup element buffer
     m_ebo.Bind();
     m_ebo.FillData(
       NULL,   // Orphan the buffer
-      sizeof(GLuint) * MESH_MAX_INDEX_COUNT,   // Allocate bytes (TODO: Precisely calculate)
-      GL_DYNAMIC_DRAW   // Buffer will be modified frequently
+      sizeof(GLuint) * MESH_RENDERER_INDEX_CAPACITY,   // Allocate bytes for every cached mesh
+      GL_DYNAMIC_DRAW   // Buffer will be modified as meshes come and go
     );
 
     // Setup vertex attribs
@@ -47,7 +68,17 @@ namespace elgar {
 
     m_vao.EnableAttribute(1);   // Bind location 1
     m_vao.AttributePointer(
-      1,    // Location 1
+      1,        // Location 1
+      2,        // u,v
+      GL_FLOAT, // Data type
+      GL_FALSE,
+      sizeof(Vertex),
+      (GLvoid *)offsetof(Vertex, uv)
+    );
+
+    m_vao.EnableAttribute(6);   // Bind location 6 (2 - 5 are taken by the instanced model matrix)
+    m_vao.AttributePointer(
+      6,    // Location 6
       3,    // normal
       GL_FLOAT,   // Data type
       GL_FALSE,   // Do not normalize the data
@@ -55,15 +86,20 @@ namespace elgar {
       (GLvoid *)offsetof(Vertex, normal)    // Offset to the next normal
     );
 
-    m_vao.EnableAttribute(2);   // Bind location 2
-    m_vao.AttributePointer(
-      2,        // Location 2
-      2,        // u,v
-      GL_FLOAT, // Data type
-      GL_FALSE,
-      sizeof(Vertex),
-      (GLvoid *)offsetof(Vertex, uv)
-    );
+    // Tell OpenGL how the instanced model matrix data is formatted (one mat4 spans attribs 2 - 5)
+    m_instance_buffer.Bind();
+    for (GLuint i = 0; i < 4; i++) {
+      m_vao.EnableAttribute(2 + i);   // Bind attrib for the ith column of the matrix
+      m_vao.AttributePointer(
+        2 + i,      // Location 2 + i
+        4,          // 1 column of the matrix
+        GL_FLOAT,   // Data type
+        GL_FALSE,   // Do not normalize
+        sizeof(glm::mat4),  // Number of bytes until next equivalent attribute
+        (GLvoid *)(sizeof(glm::vec4) * i)   // Offset to the ith column
+      );
+      m_vao.AttributeDivisor(2 + i, 1);   // Use 1 matrix per instance
+    }
 
     m_vao.Unbind();   // Unbind the vao
 
@@ -74,66 +110,321 @@ namespace elgar {
     LOG("MeshRenderer offline...\n");
   }
 
-  void MeshRenderer::RegisterMesh(const Mesh &mesh) const {
-    m_vao.Bind();   // Bind the vao
+  const MeshRenderer::MeshAllocation *MeshRenderer::RegisterMesh(const Mesh &mesh) {
+    // Nothing to upload if the mesh is already resident
+    auto it = m_resident_meshes.find(mesh.GetId());
+    if (it != m_resident_meshes.end())
+      return &it->second;
 
     const std::vector<Vertex> &vertices = mesh.GetVertices();
     const std::vector<GLuint> &indices = mesh.GetIndices();
 
+    if (vertices.empty() || indices.empty())
+      return nullptr;
+
+    MeshAllocation allocation;
+    allocation.vertex_count = vertices.size();
+    allocation.index_count = indices.size();
+
+    // Find room for the mesh in the shared buffers, growing them if they are full
+    allocation.base_vertex = m_vertex_allocator.Allocate(allocation.vertex_count);
+    if (allocation.base_vertex < 0 && GrowBuffer(
+      m_vbo, GL_ARRAY_BUFFER, m_vertex_allocator, sizeof(Vertex), allocation.vertex_count,
+      MESH_RENDERER_VERTEX_CAPACITY * MESH_RENDERER_GROWTH_LIMIT
+    ))
+      allocation.base_vertex = m_vertex_allocator.Allocate(allocation.vertex_count);
+
+    allocation.first_index = m_index_allocator.Allocate(allocation.index_count);
+    if (allocation.first_index < 0 && GrowBuffer(
+      m_ebo, GL_ELEMENT_ARRAY_BUFFER, m_index_allocator, sizeof(GLuint), allocation.index_count,
+      MESH_RENDERER_INDEX_CAPACITY * MESH_RENDERER_GROWTH_LIMIT
+    ))
+      allocation.first_index = m_index_allocator.Allocate(allocation.index_count);
+
+    if (allocation.base_vertex < 0 || allocation.first_index < 0) {
+      m_vertex_allocator.Free(allocation.base_vertex, allocation.vertex_count);
+      m_index_allocator.Free(allocation.first_index, allocation.index_count);
+
+      // The mesh is retried on every draw, only report it the first time
+      if (m_rejected_meshes.insert(mesh.GetId()).second)
+        LOG_ERROR("MeshRenderer cache is full, cannot upload mesh of %d vertices!\n", (int)allocation.vertex_count);
+
+      return nullptr;
+    }
+
+    m_rejected_meshes.erase(mesh.GetId());
+
+    m_vao.Bind();   // Bind the vao
+
     m_vbo.Bind();   // Bind the vbo
     m_vbo.FillSubData(
       &vertices[0],     // Pointer to the vertex data
       vertices.size() * sizeof(Vertex),   // Number of bytes
-      0   // No offset
+      allocation.base_vertex * sizeof(Vertex)   // Start of the allocated range
     );
 
     m_ebo.Bind();   // Bind the ebo
     m_ebo.FillSubData(
       &indices[0],      // Pointer to the index data
       indices.size() * sizeof(GLuint),    // Number of bytes
-      0   // No offset
+      allocation.first_index * sizeof(GLuint)   // Start of the allocated range
     );
 
     m_vao.Unbind();   // Unbind our vao
+
+    m_frame_upload_bytes += vertices.size() * sizeof(Vertex) + indices.size() * sizeof(GLuint);
+
+    // Remember where the mesh lives
+    return &m_resident_meshes.insert(std::pair<uint64_t, MeshAllocation>(mesh.GetId(), allocation)).first->second;
   }
 
-  void MeshRenderer::Draw(const Mesh &mesh, const Shader &shader, const RGBA &color, const glm::mat4 &model) const {
-    shader.Use();   // Enable the shader program
+  bool MeshRenderer::GrowBuffer(
+    const BufferObject &buffer,
+    const GLenum &target,
+    BufferAllocator &allocator,
+    const GLsizeiptr &element_size,
+    const GLsizei &size,
+    const GLsizei &limit
+  ) {
+    const GLsizei old_capacity = allocator.GetCapacity();
+    const GLsizei capacity = std::max(old_capacity * 2, old_capacity + size);
 
-    RegisterMesh(mesh); // Register the mesh for rendering
+    if (capacity > limit)
+      return false;
 
-    // Set shader uniforms
-    shader.SetVec4("color", color.GetData());
-    shader.SetMat4("model_matrix", model);
-    shader.SetBool("use_instancing", GL_FALSE);
+    PROFILE_ZONE("MeshRenderer::GrowBuffer");
+
+    const GLsizeiptr old_bytes = old_capacity * element_size;
+
+    // Park the resident meshes in a scratch buffer while the storage is reallocated
+    BufferObject scratch(GL_COPY_WRITE_BUFFER);
+    scratch.Bind();
+    scratch.FillData(NULL, old_bytes, GL_STREAM_COPY);
+
+    m_vao.Bind();   // The element array binding is part of the vao
+    buffer.Bind();
+    glCopyBufferSubData(target, GL_COPY_WRITE_BUFFER, 0, 0, old_bytes);
+
+    // Same buffer name, new storage (the vao keeps pointing at it)
+    buffer.FillData(NULL, capacity * element_size, GL_DYNAMIC_DRAW);
+    glCopyBufferSubData(GL_COPY_WRITE_BUFFER, target, 0, 0, old_bytes);
+
+    m_vao.Unbind();
+
+    allocator.Grow(capacity);
+
+    LOG("MeshRenderer grew a mesh cache buffer to %d elements...\n", (int)capacity);
+
+    return true;
+  }
+
+  void MeshRenderer::ReleaseMesh(const uint64_t &id) {
+    // The cache belongs to the render thread, and queued frames may still draw the mesh
+    RenderThread::Defer([this, id]() {
+      m_rejected_meshes.erase(id);
+
+      auto it = m_resident_meshes.find(id);
+      if (it == m_resident_meshes.end())
+        return;
+
+      const MeshAllocation &allocation = it->second;
+
+      // Hand the ranges back to the allocators
+      m_vertex_allocator.Free(allocation.base_vertex, allocation.vertex_count);
+      m_index_allocator.Free(allocation.first_index, allocation.index_count);
+
+      m_resident_meshes.erase(it);
+    });
+  }
+
+  void MeshRenderer::EndFrame() {
+    m_last_upload_bytes = m_frame_upload_bytes;
+    m_frame_upload_bytes = 0;
+  }
+
+  void MeshRenderer::EndCullFrame() {
+    m_last_cull_stats = CullStats{m_frame_tested, m_frame_culled};
 
+    m_frame_tested = 0;
+    m_frame_culled = 0;
+  }
+
+  const glm::mat4 *MeshRenderer::Cull(const Mesh &mesh, const glm::mat4 *models, size_t &count) {
+    if (!m_culling_camera || count == 0)
+      return models;
+
+    PROFILE_ZONE("MeshRenderer::Cull");
+
+    // Bound every instance by the sphere around the mesh's box
+    const AABB &bounds = mesh.GetBounds();
+    const glm::vec4 mesh_sphere(bounds.GetCenter(), glm::length(bounds.GetExtents()));
+
+    m_visible_indices.resize(count);
+    const size_t visible_count = CullInstances(
+      m_culling_camera->GetFrustum(), models, count, mesh_sphere, m_visible_indices.data()
+    );
+
+    m_frame_tested += count;
+    m_frame_culled += count - visible_count;
+
+    // Nothing was culled, draw straight from the caller's matrices
+    if (visible_count == count)
+      return models;
+
+    m_visible_models.resize(visible_count);
+    for (size_t i = 0; i < visible_count; i++)
+      m_visible_models[i] = models[m_visible_indices[i]];
+
+    count = visible_count;
+    return m_visible_models.data();
+  }
+
+  void MeshRenderer::BindTextures(const Mesh &mesh, const Shader &shader, const RendererUniforms &uniforms) const {
     const std::vector<const Texture *> &textures = mesh.GetTextures();
 
-    if (textures.empty())
-      shader.SetBool("use_texture", GL_FALSE);
-    else {
-      shader.SetBool("use_texture", GL_TRUE);
+    if (textures.empty()) {
+      shader.SetBool(uniforms.use_texture, GL_FALSE);
+      return;
+    }
 
-      // Grab reference to the mesh textures
-      const std::vector<const Texture *> &textures = mesh.GetTextures();
+    shader.SetBool(uniforms.use_texture, GL_TRUE);
 
-      // TODO: Bind the textures of the mesh
-      for (unsigned int i = 0; i < textures.size(); i++) {
-        
-      }
+    // Bind each texture of the mesh to its own unit
+    for (unsigned int i = 0; i < textures.size(); i++)
+      textures[i]->Bind(i);
+  }
+
+  void MeshRenderer::Draw(const Mesh &mesh, const Shader &shader, const RGBA &color, const glm::mat4 &model) {
+    // Defer the draw to the render thread
+    CommandList *list = CommandList::GetRecording();
+    if (list) {
+      list->RecordMesh(mesh, shader, color, model);
+      return;
     }
 
+    PROFILE_ZONE("MeshRenderer::Draw");
+    GPU_ZONE("MeshRenderer");
+
+    const MeshAllocation *allocation = RegisterMesh(mesh); // Make sure the mesh is resident
+    if (!allocation)
+      return;
+
+    const RendererUniforms &uniforms = m_uniforms.Get(shader);
+
+    shader.Use();   // Enable the shader program
+
+    // Set shader uniforms
+    shader.SetVec4(uniforms.color, color.GetData());
+    shader.SetMat4(uniforms.model_matrix, model);
+    shader.SetBool(uniforms.use_instancing, GL_FALSE);
+
+    BindTextures(mesh, shader, uniforms);   // Bind the textures of the mesh
+
     // Draw the mesh
     m_vao.Bind();
 
-    // Draw the mesh
-    glDrawElements(GL_TRIANGLES, mesh.GetIndices().size(), GL_UNSIGNED_INT, 0);
+    // Draw the mesh out of its range of the shared buffers
+    glDrawElementsBaseVertex(
+      GL_TRIANGLES, 
+      allocation->index_count, 
+      GL_UNSIGNED_INT, 
+      (GLvoid *)(allocation->first_index * sizeof(GLuint)), 
+      allocation->base_vertex
+    );
+  }
 
-    m_vao.Unbind();
+  void MeshRenderer::DrawInstanced(const Mesh &mesh, const Shader &shader, const RGBA &color, const std::vector<glm::mat4> &models) {
+    DrawInstanced(mesh, shader, color, models.data(), models.size());
   }
 
-  void MeshRenderer::DrawInstanced(const Mesh &mesh, const Shader &shader, const RGBA &color, const std::vector<glm::mat4> &models) const {
+  void MeshRenderer::DrawInstanced(
+    const Mesh &mesh, 
+    const Shader &shader, 
+    const RGBA &color, 
+    const glm::mat4 *models, 
+    const size_t &count
+  ) {
+    size_t visible_count = count;
+    const glm::mat4 *visible_models = Cull(mesh, models, visible_count);
+
+    if (visible_count == 0)
+      return;
+
+    // Defer the draw to the render thread
+    CommandList *list = CommandList::GetRecording();
+    if (list) {
+      list->RecordMeshInstanced(mesh, shader, color, visible_models, visible_count);
+      return;
+    }
+
+    DrawInstancedVisible(mesh, shader, color, visible_models, visible_count);
+  }
+
+  void MeshRenderer::DrawInstancedVisible(
+    const Mesh &mesh, 
+    const Shader &shader, 
+    const RGBA &color, 
+    const glm::mat4 *models, 
+    const size_t &count
+  ) {
+    PROFILE_ZONE("MeshRenderer::DrawInstanced");
+    GPU_ZONE("MeshRenderer");
+
+    const MeshAllocation *allocation = RegisterMesh(mesh); // Make sure the mesh is resident
+    if (!allocation)
+      return;
+
+    const RendererUniforms &uniforms = m_uniforms.Get(shader);
+
+    shader.Use();   // Enable the shader program
+
+    // Set shader uniforms once for every instance
+    shader.SetVec4(uniforms.color, color.GetData());
+    shader.SetBool(uniforms.use_instancing, GL_TRUE);
+
+    BindTextures(mesh, shader, uniforms);   // Bind the textures of the mesh
+
+    m_vao.Bind();
+    m_instance_buffer.Bind();   // Bind the instance ring for streaming
+
+    // Stream the model matrices through the instance ring one region at a time
+    const GLsizei capacity = m_instance_buffer.GetRegionCapacity();
+
+    for (size_t offset = 0; offset < count; offset += capacity) {
+      const GLsizei region_count = (GLsizei)std::min(count - offset, (size_t)capacity);
+
+      // Write the matrices straight into the mapped buffer
+      GLvoid *dst = m_instance_buffer.Reserve(region_count);
+      std::memcpy(dst, &models[offset], sizeof(glm::mat4) * region_count);
+      const GLuint base_instance = m_instance_buffer.Commit(region_count);
+
+      // Draw every instance of the mesh out of its range of the shared buffers
+      glDrawElementsInstancedBaseVertexBaseInstance(
+        GL_TRIANGLES,
+        allocation->index_count,
+        GL_UNSIGNED_INT,
+        (GLvoid *)(allocation->first_index * sizeof(GLuint)),
+        region_count,
+        allocation->base_vertex,
+        base_instance
+      );
+    }
+  }
+
+  GLsizeiptr MeshRenderer::GetUploadedBytes() const {
+    return m_last_upload_bytes;
+  }
+
+  void MeshRenderer::SetCullingCamera(const Camera *camera) {
+    m_culling_camera = camera;
+  }
+
+  const Camera *MeshRenderer::GetCullingCamera() const {
+    return m_culling_camera;
+  }
 
+  const CullStats &MeshRenderer::GetCullStats() const {
+    return m_last_cull_stats;
   }
 
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/graphics/renderers/RendererUniforms.hpp"
+
+namespace elgar {
+
+  // FUNCTIONS //
+
+  RendererUniformCache::RendererUniformCache() {
+    m_last_program = 0;
+    m_last_handles = RendererUniforms{-1, -1, -1, -1};
+  }
+
+  RendererUniformCache::~RendererUniformCache() {
+    // Do nothing
+  }
+
+  const RendererUniforms &RendererUniformCache::Get(const Shader &shader) {
+    const GLuint program = shader.GetId();
+
+    if (program == m_last_program)
+      return m_last_handles;
+
+    auto it = m_handles.find(program);
+
+    if (it == m_handles.end()) {
+      const RendererUniforms handles = {
+        shader.GetUniformHandle("use_texture"),
+        shader.GetUniformHandle("use_instancing"),
+        shader.GetUniformHandle("color"),
+        shader.GetUniformHandle("model_matrix")
+      };
+
+      it = m_handles.insert(std::pair<GLuint, RendererUniforms>(program, handles)).first;
+    }
+
+    m_last_program = program;
+    m_last_handles = it->second;
+
+    return m_last_handles;
+  }
+
+}
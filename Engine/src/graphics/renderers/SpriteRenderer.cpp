@@ -7,8 +7,13 @@
 // INCLUDES //
 
 #include "elgar/graphics/renderers/SpriteRenderer.hpp"
+#include "elgar/graphics/CommandList.hpp"
 
 #include "elgar/core/Macros.hpp"
+#include "elgar/graphics/GPUTimer.hpp"
+
+#include <algorithm>
+#include <cstring>
 
 namespace elgar {
 
@@ -33,7 +38,12 @@ namespace elgar {
   SpriteRenderer::SpriteRenderer() : 
     Singleton<SpriteRenderer>(this), 
     m_vertex_buffer(GL_ARRAY_BUFFER), 
-    m_uv_buffer(GL_ARRAY_BUFFER) 
+    m_uv_buffer(GL_ARRAY_BUFFER),
+    m_instance_buffer(GL_ARRAY_BUFFER, sizeof(glm::mat4), SPRITE_RENDERER_INSTANCE_CAPACITY),
+    m_culling_camera(nullptr),
+    m_frame_tested(0),
+    m_frame_culled(0),
+    m_last_cull_stats{0, 0}
   {
     LOG("Initializing Sprite Renderer...\n");
 
@@ -77,6 +87,21 @@ namespace elgar {
       (GLvoid *)0   // No stride
     );
 
+    // Tell OpenGL how the instanced model matrix data is formatted (one mat4 spans attribs 2 - 5)
+    m_instance_buffer.Bind();
+    for (GLuint i = 0; i < 4; i++) {
+      m_vao.EnableAttribute(2 + i);   // Bind attrib for the ith column of the matrix
+      m_vao.AttributePointer(
+        2 + i,      // Location 2 + i
+        4,          // 1 column of the matrix
+        GL_FLOAT,   // Data type
+        GL_FALSE,   // Do not normalize
+        sizeof(glm::mat4),  // Number of bytes until next equivalent attribute
+        (GLvoid *)(sizeof(glm::vec4) * i)   // Offset to the ith column
+      );
+      m_vao.AttributeDivisor(2 + i, 1);   // Use 1 matrix per instance
+    }
+
     m_vao.Unbind(); // Unbind the vao
 
     LOG("Sprite Renderer online...\n");
@@ -88,6 +113,18 @@ namespace elgar {
   }
 
   void SpriteRenderer::Draw(const Shader &shader, const glm::mat4 &model, const RGBA &color, const Texture *texture) {
+    // Defer the draw to the render thread
+    CommandList *list = CommandList::GetRecording();
+    if (list) {
+      list->RecordSprite(shader, model, color, texture);
+      return;
+    }
+
+    PROFILE_ZONE("SpriteRenderer::Draw");
+    GPU_ZONE("SpriteRenderer");
+
+    const RendererUniforms &uniforms = m_uniforms.Get(shader);
+
     // Draw the Sprite
 
     shader.Use();   // Use the shader program
@@ -95,21 +132,19 @@ namespace elgar {
     // Check for texture
     if (texture) {
       texture->Bind(0);   // Bind texture to location 0
-      shader.SetBool("use_texture", GL_TRUE);   // Tell the shader to sample the texture
+      shader.SetBool(uniforms.use_texture, GL_TRUE);    // Tell the shader to sample the texture
     }
     else {
-      shader.SetBool("use_texture", GL_FALSE);  // Tell the shader to ignore texture
+      shader.SetBool(uniforms.use_texture, GL_FALSE);   // Tell the shader to ignore texture
     }
 
-    shader.SetVec4("color", color.GetData());   // Send color to shader
-    shader.SetMat4("model_matrix", model);      // Set the model matrix
-    shader.SetBool("use_instancing", GL_FALSE); // We are not instancing
+    shader.SetVec4(uniforms.color, color.GetData());    // Send color to shader
+    shader.SetMat4(uniforms.model_matrix, model);       // Set the model matrix
+    shader.SetBool(uniforms.use_instancing, GL_FALSE);  // We are not instancing
 
     m_vao.Bind();   // Bind the VAO for rendering
 
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);    // Draw the sprite
-
-    m_vao.Unbind(); // Unbind the VAO
   }
 
   void SpriteRenderer::DrawInstanced(
@@ -118,6 +153,44 @@ namespace elgar {
     const RGBA &color, 
     const Texture *texture
   ) {
+    DrawInstanced(shader, models.data(), models.size(), color, texture);
+  }
+
+  void SpriteRenderer::DrawInstanced(
+    const Shader &shader, 
+    const glm::mat4 *models, 
+    const size_t &count,
+    const RGBA &color, 
+    const Texture *texture
+  ) {
+    size_t visible_count = count;
+    const glm::mat4 *visible_models = Cull(models, visible_count);
+
+    if (visible_count == 0)
+      return;
+
+    // Defer the draw to the render thread
+    CommandList *list = CommandList::GetRecording();
+    if (list) {
+      list->RecordSpriteInstanced(shader, visible_models, visible_count, color, texture);
+      return;
+    }
+
+    DrawInstancedVisible(shader, visible_models, visible_count, color, texture);
+  }
+
+  void SpriteRenderer::DrawInstancedVisible(
+    const Shader &shader, 
+    const glm::mat4 *models, 
+    const size_t &count,
+    const RGBA &color, 
+    const Texture *texture
+  ) {
+    PROFILE_ZONE("SpriteRenderer::DrawInstanced");
+    GPU_ZONE("SpriteRenderer");
+
+    const RendererUniforms &uniforms = m_uniforms.Get(shader);
+
     // Draw the Sprites
 
     shader.Use();   // Use the shader program
@@ -125,79 +198,80 @@ namespace elgar {
     // Check for texture
     if (texture) {
       texture->Bind(0);   // Bind the texture to location 0
-      shader.SetBool("use_texture", GL_TRUE); // Tell OpenGL to sample the texture
+      shader.SetBool(uniforms.use_texture, GL_TRUE);  // Tell OpenGL to sample the texture
     }
     else {
-      shader.SetBool("use_texture", GL_FALSE);
+      shader.SetBool(uniforms.use_texture, GL_FALSE);
     }
 
-    shader.SetVec4("color", color.GetData());   // Send color to shader
-    shader.SetBool("use_instancing", GL_TRUE);  // Enable instancing
+    shader.SetVec4(uniforms.color, color.GetData());    // Send color to shader
+    shader.SetBool(uniforms.use_instancing, GL_TRUE);   // Enable instancing
 
     m_vao.Bind(); // Bind the vao to draw with
+    m_instance_buffer.Bind();   // Bind the instance ring for streaming
 
-    // Send model matrices to the vao
+    // Stream the model matrices through the instance ring one region at a time
+    const GLsizei capacity = m_instance_buffer.GetRegionCapacity();
 
-    // Create a new buffer for the model data and fill it with the model matrix data
-    BufferObject model_buffer(GL_ARRAY_BUFFER);
-    model_buffer.Bind();
-    model_buffer.FillData(
-      &models[0][0][0],
-      sizeof(glm::mat4) * models.size(),
-      GL_STATIC_DRAW
-    );
+    for (size_t offset = 0; offset < count; offset += capacity) {
+      const GLsizei region_count = (GLsizei)std::min(count - offset, (size_t)capacity);
 
-    // Tell OpenGL how the model matrix data is formatted
-    m_vao.EnableAttribute(2); // Bind attrib 2 for 1st row of matrix
-    m_vao.AttributePointer(
-      2,  // Location 2
-      4,  // 1 row of matrix
-      GL_FLOAT, // Data type
-      GL_FALSE, // Do not normalize
-      sizeof(glm::mat4),  // Number of bytes until next equivalent attribute
-      (GLvoid *)0 // No offset
-    );
+      // Write the matrices straight into the mapped buffer
+      GLvoid *dst = m_instance_buffer.Reserve(region_count);
+      std::memcpy(dst, &models[offset], sizeof(glm::mat4) * region_count);
+      const GLuint base_instance = m_instance_buffer.Commit(region_count);
 
-    m_vao.EnableAttribute(3);
-    m_vao.AttributePointer(
-      3,  // Location 3
-      4,  // 2nd row of matrix
-      GL_FLOAT,
-      GL_FALSE,
-      sizeof(glm::mat4),
-      (GLvoid *)sizeof(glm::vec4)
-    );
+      // Draw the Sprites
+      glDrawArraysInstancedBaseInstance(GL_TRIANGLE_STRIP, 0, 4, region_count, base_instance);
+    }
+  }
 
-    m_vao.EnableAttribute(4);
-    m_vao.AttributePointer(
-      4,  // Location 4
-      4,  // 3rd row of matrix
-      GL_FLOAT,
-      GL_FALSE,
-      sizeof(glm::mat4),
-      (GLvoid *)(sizeof(glm::vec4) * 2)
-    );
+  const glm::mat4 *SpriteRenderer::Cull(const glm::mat4 *models, size_t &count) {
+    if (!m_culling_camera || count == 0)
+      return models;
 
-    m_vao.EnableAttribute(5);
-    m_vao.AttributePointer(
-      5,  // Location 5
-      4,  // 4th row of matrix
-      GL_FLOAT,
-      GL_FALSE,
-      sizeof(glm::mat4),
-      (GLvoid *)(sizeof(glm::vec4) * 3)
+    PROFILE_ZONE("SpriteRenderer::Cull");
+
+    // Every sprite is the unit quad, bounded by the sphere through its corners
+    static const glm::vec4 sprite_sphere(0.0f, 0.0f, 0.0f, SPRITE_RENDERER_BOUNDING_RADIUS);
+
+    m_visible_indices.resize(count);
+    const size_t visible_count = CullInstances(
+      m_culling_camera->GetFrustum(), models, count, sprite_sphere, m_visible_indices.data()
     );
 
-    // Tell OpenGL to use 1 matrix per instance
-    m_vao.AttributeDivisor(2, 1);
-    m_vao.AttributeDivisor(3, 1);
-    m_vao.AttributeDivisor(4, 1);
-    m_vao.AttributeDivisor(5, 1);
+    m_frame_tested += count;
+    m_frame_culled += count - visible_count;
 
-    // Draw the Sprites
-    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, models.size());
+    // Nothing was culled, draw straight from the caller's matrices
+    if (visible_count == count)
+      return models;
+
+    m_visible_models.resize(visible_count);
+    for (size_t i = 0; i < visible_count; i++)
+      m_visible_models[i] = models[m_visible_indices[i]];
+
+    count = visible_count;
+    return m_visible_models.data();
+  }
+
+  void SpriteRenderer::EndCullFrame() {
+    m_last_cull_stats = CullStats{m_frame_tested, m_frame_culled};
+
+    m_frame_tested = 0;
+    m_frame_culled = 0;
+  }
+
+  void SpriteRenderer::SetCullingCamera(const Camera *camera) {
+    m_culling_camera = camera;
+  }
+
+  const Camera *SpriteRenderer::GetCullingCamera() const {
+    return m_culling_camera;
+  }
 
-    m_vao.Unbind(); // Unbind the vao since we are done drawing
+  const CullStats &SpriteRenderer::GetCullStats() const {
+    return m_last_cull_stats;
   }
 
 }
\ No newline at end of file
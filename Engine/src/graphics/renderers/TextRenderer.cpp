@@ -19,71 +19,87 @@
 
 #include "elgar/graphics/renderers/TextRenderer.hpp"
 #include "elgar/core/Macros.hpp"
+#include "elgar/graphics/GPUTimer.hpp"
+#include "elgar/graphics/CommandList.hpp"
+#include "elgar/graphics/RenderThread.hpp"
 #include "elgar/core/Exception.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
 // DEFINES //
 
-#define ASCII_VERTEX_COUNT    4
+#define ASCII_VERTEX_COUNT    6   // Two triangles per glyph
+#define ATLAS_PADDING         1   // Empty pixels between glyphs in the atlas
 
 namespace elgar {
 
   // LOCAL DATA //
 
-  const glm::vec2 default_uvs[ASCII_VERTEX_COUNT] = {
-    {0.0f, 1.0f},   // Top left
-    {1.0f, 1.0f},   // Top right
-    {0.0f, 0.0f},   // Bottom left
-    {1.0f, 0.0f}    // Bottom right
+  /**
+   * @brief A rasterized glyph waiting to be packed into the atlas
+   * 
+   */
+  struct PendingGlyph {
+    GLubyte                     code;     // The code point of the glyph
+    glm::ivec2                  origin;   // Position of the glyph in the atlas
+    std::vector<unsigned char>  pixels;   // Tightly packed 8-bit coverage (row 0 is the glyph top)
   };
 
   // FUNCTIONS //
 
-  TextRenderer::TextRenderer() : Singleton<TextRenderer>(this), m_vertex_buffer(GL_ARRAY_BUFFER), m_uv_buffer(GL_ARRAY_BUFFER) {
-    if (FT_Init_FreeType(&m_context) != 0) {
+  TextRenderer::TextRenderer(FT_Library library) : 
+    Singleton<TextRenderer>(this), 
+    m_vertex_buffer(GL_ARRAY_BUFFER, sizeof(TextVertex), TEXT_RENDERER_VERTEX_CAPACITY) {
+    // FreeType may have been started ahead of time off the main thread
+    m_context = library;
+
+    if (!m_context && FT_Init_FreeType(&m_context) != 0) {
       throw Exception("ERROR: Failed to initialize FreeType library!");
     }
 
-    // Setup vao and vbo
+    m_glyph_count = 0;
+    m_atlas = nullptr;
+
+    for (GLuint i = 0; i < TEXT_RENDERER_GLYPH_COUNT; i++)
+      m_ascii_table[i].loaded = GL_FALSE;
+
+    // Setup vao and the vertex ring
     m_vao.Bind();
     m_vertex_buffer.Bind();
-    m_vertex_buffer.FillData(
-      NULL,       // Orphan the vbo
-      sizeof(glm::vec3) * ASCII_VERTEX_COUNT,   // Size to expect in bytes
-      GL_DYNAMIC_DRAW   // Buffer will be updated frequently
-    );
-
-    // Setup texture coordinates buffer
-    m_uv_buffer.Bind();
-    m_uv_buffer.FillData(
-      default_uvs,    // Send OpenGL the uv data
-      sizeof(glm::vec2) * ASCII_VERTEX_COUNT,   // Size in bytes
-      GL_STATIC_DRAW    // Buffer will never be modified
-    );
 
     // Configure attributes
-    m_vertex_buffer.Bind(); // Bind vbo
     m_vao.EnableAttribute(0); // Bind to location 0
     m_vao.AttributePointer(
       0,    // Location 0
       3,    // x, y, z
       GL_FLOAT,   // Data type
       GL_FALSE,   // Do not normalize
-      0,    // Data is tightly packed
-      (GLvoid *)0   // No offset
+      sizeof(TextVertex),   // Vertices are interleaved
+      (GLvoid *)offsetof(TextVertex, pos)
     );
 
-    m_uv_buffer.Bind(); // Bind the uv buffer
     m_vao.EnableAttribute(1); // Bind to location 1
     m_vao.AttributePointer(
       1,    // Location 1
       2,    // u, v
       GL_FLOAT,   // Data type
       GL_FALSE,   // Do not normalize
-      0,    // Data is tightly packed
-      (GLvoid *)0 // No offset
+      sizeof(TextVertex),   // Vertices are interleaved
+      (GLvoid *)offsetof(TextVertex, uv)
+    );
+
+    m_vao.EnableAttribute(2); // Bind to location 2
+    m_vao.AttributePointer(
+      2,    // Location 2
+      4,    // r, g, b, a
+      GL_FLOAT,   // Data type
+      GL_FALSE,   // Do not normalize
+      sizeof(TextVertex),   // Vertices are interleaved
+      (GLvoid *)offsetof(TextVertex, color)
     );
 
-    m_uv_buffer.Unbind(); // Unbind the uv buffer
     m_vao.Unbind(); // Unbind the vao
 
     LOG("TextRenderer online...\n");
@@ -97,8 +113,17 @@ namespace elgar {
   }
 
   GLboolean TextRenderer::BindFont(const std::string &path, const GLuint &size) {
+    GLboolean bound = GL_FALSE;
+
+    // The render thread draws from the atlas and the glyph table, so they are rebuilt there
+    RenderThread::Invoke([this, &bound, &path, &size]() { bound = BuildAtlas(path, size); });
+
+    return bound;
+  }
+
+  GLboolean TextRenderer::BuildAtlas(const std::string &path, const GLuint &size) {
     if (IsBound()) {
-      LOG("Error: Cannot bind new TTF while one is already bound! Make sure to unbind first!\n");
+      LOG_ERROR("Cannot bind new TTF while one is already bound! Make sure to unbind first!\n");
       return GL_FALSE;
     }
 
@@ -106,108 +131,166 @@ namespace elgar {
 
     // Load the font
     if (FT_New_Face(m_context, path.c_str(), 0, &font) != 0) {
-      LOG("Error: Failed to load font %s! Make sure path is correct...\n", path.c_str());
+      LOG_ERROR("Failed to load font %s! Make sure path is correct...\n", path.c_str());
       return GL_FALSE;
     }
 
     // Set font size
     FT_Set_Pixel_Sizes(font, 0, size);
 
-    // Build the alphabet
+    // Rasterize each character and pack it onto a shelf of the atlas
+    std::vector<PendingGlyph> glyphs;
+    glm::ivec2 cursor(ATLAS_PADDING, ATLAS_PADDING);  // Where the next glyph goes
+    GLint shelf_height = 0;   // Height of the tallest glyph on the current shelf
 
-    // Iterate through each character
-    for (GLubyte c = 0; c < 128; c++) {
+    for (GLubyte c = 0; c < TEXT_RENDERER_GLYPH_COUNT; c++) {
       if (FT_Load_Char(font, c, FT_LOAD_RENDER) != 0) {
-        LOG("ERROR: Failed to load %c from %s!\n", c, path.c_str());
+        LOG_ERROR("Failed to load %c from %s!\n", c, path.c_str());
         continue;
       }
 
-      // Build an image for the character
-      Image char_img;
-      char_img.channels = 1;
-      char_img.width    = font->glyph->bitmap.width;
-      char_img.height   = font->glyph->bitmap.rows;
-      char_img.data     = font->glyph->bitmap.buffer;
-
-      // Texture params
-      TextureParams tex_params;
-      tex_params.wrap_mode = GL_CLAMP_TO_EDGE;
-      tex_params.min_filter_mode = GL_LINEAR;
-      tex_params.mag_filter_mode = GL_LINEAR;
-
-      // Create a new texture
-      const Texture *tex = new Texture(char_img, TEXTURE_DIFFUSE, tex_params);
-
-      // Create an ASCII character to store relevant data
-      ASCII character;
-      character.texture = tex;  // Copy pointer to texture
-      character.size = glm::ivec2(char_img.width, char_img.height);   // Set the size of the character
+      const FT_Bitmap &bitmap = font->glyph->bitmap;
+      const GLint width = bitmap.width;
+      const GLint height = bitmap.rows;
+
+      if (width + 2 * ATLAS_PADDING > TEXT_RENDERER_ATLAS_WIDTH) {
+        LOG_ERROR("Glyph %c from %s is too wide for the atlas!\n", c, path.c_str());
+        continue;
+      }
+
+      // Start a new shelf if the glyph does not fit on this one
+      if (cursor.x + width + ATLAS_PADDING > TEXT_RENDERER_ATLAS_WIDTH) {
+        cursor.x = ATLAS_PADDING;
+        cursor.y += shelf_height + ATLAS_PADDING;
+        shelf_height = 0;
+      }
+
+      PendingGlyph glyph;
+      glyph.code = c;
+      glyph.origin = cursor;
+      glyph.pixels.resize(width * height);
+
+      // Copy the coverage out of FreeType's buffer, which may have a row pitch
+      for (GLint row = 0; row < height; row++)
+        std::memcpy(&glyph.pixels[row * width], bitmap.buffer + row * bitmap.pitch, width);
+
+      glyphs.push_back(glyph);
+
+      // Record everything but the atlas coordinates, which depend on the final atlas height
+      ASCII &character = m_ascii_table[c];
+      character.loaded = GL_TRUE;
+      character.size = glm::ivec2(width, height);   // Set the size of the character
       character.bearing = glm::ivec2(font->glyph->bitmap_left, font->glyph->bitmap_top);  // Set the bearing
       character.advance = font->glyph->advance.x;   // Set the advance
 
-      // Add the characters to the table
-      m_ascii_table.insert(std::pair<GLchar, ASCII>(c, character));
+      cursor.x += width + ATLAS_PADDING;
+      shelf_height = std::max(shelf_height, height);
     }
 
     FT_Done_Face(font); // Destroy the font since we no longer need it
 
+    if (glyphs.empty())
+      return GL_FALSE;
+
+    // Blit every glyph into the atlas
+    const GLint atlas_width = TEXT_RENDERER_ATLAS_WIDTH;
+    const GLint atlas_height = cursor.y + shelf_height + ATLAS_PADDING;
+    std::vector<unsigned char> pixels(atlas_width * atlas_height, 0);
+
+    for (const PendingGlyph &glyph : glyphs) {
+      ASCII &character = m_ascii_table[glyph.code];
+
+      for (GLint row = 0; row < character.size.y; row++) {
+        std::memcpy(
+          &pixels[(glyph.origin.y + row) * atlas_width + glyph.origin.x], 
+          &glyph.pixels[row * character.size.x], 
+          character.size.x
+        );
+      }
+
+      character.uv_min = glm::vec2(glyph.origin) / glm::vec2(atlas_width, atlas_height);
+      character.uv_max = glm::vec2(glyph.origin + character.size) / glm::vec2(atlas_width, atlas_height);
+    }
+
+    // Build an image for the atlas
+    Image atlas_img;
+    atlas_img.channels = 1;
+    atlas_img.width    = atlas_width;
+    atlas_img.height   = atlas_height;
+    atlas_img.data     = &pixels[0];
+
+    // Texture params
+    TextureParams tex_params;
+    tex_params.wrap_mode = GL_CLAMP_TO_EDGE;
+    tex_params.min_filter_mode = GL_LINEAR;
+    tex_params.mag_filter_mode = GL_LINEAR;
+
+    m_atlas = new Texture(atlas_img, TEXTURE_DIFFUSE, tex_params);
+    m_glyph_count = glyphs.size();
+
+    LOG("Packed %d glyphs from %s into a %dx%d atlas\n", m_glyph_count, path.c_str(), atlas_width, atlas_height);
+
     return GL_TRUE;
   }
 
   void TextRenderer::UnbindFont() {
-    // Delete all the textures created by OpenGL
-    for (auto it = m_ascii_table.begin(); it != m_ascii_table.end(); it++) {
-      ASCII &c = it->second;
-      delete c.texture; // Delete the OpenGL texture
-    }
+    RenderThread::Invoke([this]() {
+      // Delete the atlas created by OpenGL
+      if (m_atlas) {
+        delete m_atlas;
+        m_atlas = nullptr;
+      }
 
-    m_ascii_table.clear();
+      for (GLuint i = 0; i < TEXT_RENDERER_GLYPH_COUNT; i++)
+        m_ascii_table[i].loaded = GL_FALSE;
+
+      m_glyph_count = 0;
+      m_batch.clear();
+    });
   }
 
   GLboolean TextRenderer::IsBound() const {
-    return !m_ascii_table.empty();
+    return m_atlas != nullptr;
   }
 
   GLsizei TextRenderer::GetAlphabetSize() const {
-    return m_ascii_table.size();
+    return m_glyph_count;
   }
 
-  void TextRenderer::Draw(
-      const Shader &shader,
+  void TextRenderer::Submit(
       const std::string &text,
       const RGBA &color,
       const glm::mat4 &model,
       const GLfloat &scale
-  ) const 
+  ) 
   {
-    shader.Use(); // Use the shader program
+    // Defer the text to the render thread
+    CommandList *list = CommandList::GetRecording();
+    if (list) {
+      list->RecordText(text, color, model, scale);
+      return;
+    }
 
-    shader.SetBool("use_texture", GL_TRUE);     // We are going to be sampling
-    shader.SetBool("use_instancing", GL_FALSE); // We are using separate draw calls
+    PROFILE_ZONE("TextRenderer::Submit");
 
-    shader.SetVec4("color", color.GetData());   // Set the text color
-    shader.SetMat4("model_matrix", model);      // Set the model matrix
+    if (!IsBound())
+      return;
+
+    const glm::vec4 rgba = color.GetData();
 
     // Offset for representing the cursor
     GLfloat x_offset = 0.0f;
 
-    // Bind the vao for drawing
-    m_vao.Bind();
-
-    // Enable alpha blending
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    // Draw each character
+    // Build each character
     std::string::const_iterator c;
     for (c = text.begin(); c != text.end(); c++) {
-      GLchar index = *c;
+      const GLubyte index = (GLubyte)*c;
 
       // Dont bother rendering if not in table
-      if (m_ascii_table.find(index) == m_ascii_table.end())
+      if (index >= TEXT_RENDERER_GLYPH_COUNT || !m_ascii_table[index].loaded)
         continue;
 
-      const ASCII &character = m_ascii_table.at(index);
+      const ASCII &character = m_ascii_table[index];
 
       GLfloat xpos = x_offset + character.bearing.x * scale;
       GLfloat ypos = -1 * (character.size.y - character.bearing.y) * scale;
@@ -216,38 +299,93 @@ namespace elgar {
       GLfloat width = character.size.x * scale;
       GLfloat height = character.size.y * scale;
 
+      // Transform the corners of the quad
+      const glm::vec3 bottom_left  = glm::vec3(model * glm::vec4(xpos, ypos, 0.0f, 1.0f));
+      const glm::vec3 bottom_right = glm::vec3(model * glm::vec4(xpos + width, ypos, 0.0f, 1.0f));
+      const glm::vec3 top_left     = glm::vec3(model * glm::vec4(xpos, ypos + height, 0.0f, 1.0f));
+      const glm::vec3 top_right    = glm::vec3(model * glm::vec4(xpos + width, ypos + height, 0.0f, 1.0f));
+
       // Build the vertices
-      const glm::vec3 vertices[ASCII_VERTEX_COUNT] = {
-        {xpos, ypos, 0.0f},     // Bottom left
-        {xpos + width, ypos, 0.0f},    // Bottom right
-        {xpos, ypos + height, 0.0f},   // Top left
-        {xpos + width, ypos + height, 0.0f}   // Top right
+      const TextVertex vertices[ASCII_VERTEX_COUNT] = {
+        {bottom_left,  {character.uv_min.x, character.uv_max.y}, rgba},
+        {bottom_right, {character.uv_max.x, character.uv_max.y}, rgba},
+        {top_left,     {character.uv_min.x, character.uv_min.y}, rgba},
+        {top_left,     {character.uv_min.x, character.uv_min.y}, rgba},
+        {bottom_right, {character.uv_max.x, character.uv_max.y}, rgba},
+        {top_right,    {character.uv_max.x, character.uv_min.y}, rgba}
       };
 
-      // Bind the character texture
-      character.texture->Bind();
-
-      // Send the vertex buffer the vertex data
-      m_vertex_buffer.Bind();
-      m_vertex_buffer.FillSubData(
-        vertices, // The vertex data
-        sizeof(glm::vec3) * ASCII_VERTEX_COUNT, // The size in bytes
-        0         // No offset
-      );
-      m_vertex_buffer.Unbind(); // Unbind vbo
-
-      // Draw the character
-      glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+      m_batch.insert(m_batch.end(), vertices, vertices + ASCII_VERTEX_COUNT);
 
       // Advance the cursor
       x_offset += (character.advance >> 6) * scale;
     }
+  }
+
+  void TextRenderer::Flush(const Shader &shader) {
+    // Defer the draw to the render thread
+    CommandList *list = CommandList::GetRecording();
+    if (list) {
+      list->RecordTextFlush(shader);
+      return;
+    }
+
+    PROFILE_ZONE("TextRenderer::Flush");
+    GPU_ZONE("TextRenderer");
+
+    if (m_batch.empty() || !IsBound())
+      return;
+
+    const RendererUniforms &uniforms = m_uniforms.Get(shader);
+
+    shader.Use(); // Use the shader program
+
+    shader.SetBool(uniforms.use_texture, GL_TRUE);      // We are going to be sampling
+    shader.SetBool(uniforms.use_instancing, GL_FALSE);  // Glyphs are already in world space
+
+    shader.SetMat4(uniforms.model_matrix, glm::mat4(1.0f));   // Glyphs were transformed on submission
+
+    m_atlas->Bind(0);   // Every glyph lives in the atlas
+
+    // Bind the vao for drawing
+    m_vao.Bind();
+    m_vertex_buffer.Bind();   // Glyph quads are streamed through the vertex ring
+
+    // Enable alpha blending
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Stream the batch one region at a time (regions hold a whole number of glyphs)
+    const GLsizei capacity = m_vertex_buffer.GetRegionCapacity();
+
+    for (size_t offset = 0; offset < m_batch.size(); offset += capacity) {
+      const GLsizei count = (GLsizei)std::min(m_batch.size() - offset, (size_t)capacity);
+
+      // Write the vertices straight into the mapped buffer
+      GLvoid *dst = m_vertex_buffer.Reserve(count);
+      std::memcpy(dst, &m_batch[offset], sizeof(TextVertex) * count);
+      const GLuint first = m_vertex_buffer.Commit(count);
+
+      // Draw every queued glyph in one call
+      glDrawArrays(GL_TRIANGLES, first, count);
+    }
 
     // Disable alpha blending
     glDisable(GL_BLEND);
 
-    // Unbind the vao
-    m_vao.Unbind();
+    m_batch.clear();
+  }
+
+  void TextRenderer::Draw(
+      const Shader &shader,
+      const std::string &text,
+      const RGBA &color,
+      const glm::mat4 &model,
+      const GLfloat &scale
+  ) 
+  {
+    Submit(text, color, model, scale);
+    Flush(shader);
   }
 
-}
\ No newline at end of file
+}
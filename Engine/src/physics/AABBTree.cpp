@@ -0,0 +1,356 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/physics/AABBTree.hpp"
+#include "elgar/core/Exception.hpp"
+
+#include <cstdlib>
+
+namespace elgar {
+
+  // FUNCTIONS //
+
+  AABBTree::AABBTree(const float &margin) {
+    m_root = AABB_TREE_NULL;
+    m_free_list = AABB_TREE_NULL;
+    m_proxy_count = 0;
+    m_margin = margin;
+  }
+
+  AABBTree::~AABBTree() {
+
+  }
+
+  int32_t AABBTree::AllocateNode() {
+    // Grow the pool and thread the new nodes onto the free list
+    if (m_free_list == AABB_TREE_NULL) {
+      const int32_t first = m_nodes.size();
+      const int32_t count = first ? first : 16;
+
+      m_nodes.resize(first + count);
+
+      for (int32_t i = first; i < first + count; i++) {
+        m_nodes[i].parent = i + 1 < first + count ? i + 1 : AABB_TREE_NULL;
+        m_nodes[i].height = -1;
+      }
+
+      m_free_list = first;
+    }
+
+    const int32_t node = m_free_list;
+    m_free_list = m_nodes[node].parent;
+
+    AABBTreeNode &data = m_nodes[node];
+    data.user_data = nullptr;
+    data.parent = AABB_TREE_NULL;
+    data.child1 = AABB_TREE_NULL;
+    data.child2 = AABB_TREE_NULL;
+    data.height = 0;
+    data.moved = false;
+
+    return node;
+  }
+
+  void AABBTree::FreeNode(const int32_t &node) {
+    m_nodes[node].parent = m_free_list;
+    m_nodes[node].height = -1;
+    m_nodes[node].moved = false;
+
+    m_free_list = node;
+  }
+
+  void AABBTree::InsertLeaf(const int32_t &leaf) {
+    if (m_root == AABB_TREE_NULL) {
+      m_root = leaf;
+      m_nodes[leaf].parent = AABB_TREE_NULL;
+      return;
+    }
+
+    const AABB leaf_aabb = m_nodes[leaf].aabb;
+
+    // Walk down to the sibling that adds the least surface area to the tree
+    int32_t index = m_root;
+    while (!m_nodes[index].IsLeaf()) {
+      const AABBTreeNode &node = m_nodes[index];
+
+      const float cost = node.aabb.GetCost();
+      const float combined_cost = AABB::Combine(node.aabb, leaf_aabb).GetCost();
+
+      // Cost of making a new parent for this node and the leaf
+      const float sibling_cost = 2.0f * combined_cost;
+
+      // Every ancestor grows if the leaf goes further down
+      const float inheritance_cost = 2.0f * (combined_cost - cost);
+
+      float child_costs[2];
+      const int32_t children[2] = {node.child1, node.child2};
+
+      for (int i = 0; i < 2; i++) {
+        const AABBTreeNode &child = m_nodes[children[i]];
+        const float grown_cost = AABB::Combine(child.aabb, leaf_aabb).GetCost();
+
+        if (child.IsLeaf())
+          child_costs[i] = grown_cost + inheritance_cost;
+        else
+          child_costs[i] = (grown_cost - child.aabb.GetCost()) + inheritance_cost;
+      }
+
+      if (sibling_cost < child_costs[0] && sibling_cost < child_costs[1])
+        break;
+
+      index = child_costs[0] < child_costs[1] ? children[0] : children[1];
+    }
+
+    const int32_t sibling = index;
+
+    // Make a new parent for the sibling and the leaf
+    const int32_t old_parent = m_nodes[sibling].parent;
+    const int32_t new_parent = AllocateNode();
+
+    m_nodes[new_parent].parent = old_parent;
+    m_nodes[new_parent].aabb = AABB::Combine(leaf_aabb, m_nodes[sibling].aabb);
+    m_nodes[new_parent].height = m_nodes[sibling].height + 1;
+    m_nodes[new_parent].child1 = sibling;
+    m_nodes[new_parent].child2 = leaf;
+
+    m_nodes[sibling].parent = new_parent;
+    m_nodes[leaf].parent = new_parent;
+
+    if (old_parent == AABB_TREE_NULL) {
+      m_root = new_parent;
+    } else if (m_nodes[old_parent].child1 == sibling) {
+      m_nodes[old_parent].child1 = new_parent;
+    } else {
+      m_nodes[old_parent].child2 = new_parent;
+    }
+
+    // Refit and rebalance the ancestors
+    index = m_nodes[leaf].parent;
+    while (index != AABB_TREE_NULL) {
+      index = Balance(index);
+
+      AABBTreeNode &node = m_nodes[index];
+      const AABBTreeNode &child1 = m_nodes[node.child1];
+      const AABBTreeNode &child2 = m_nodes[node.child2];
+
+      node.height = 1 + std::max(child1.height, child2.height);
+      node.aabb = AABB::Combine(child1.aabb, child2.aabb);
+
+      index = node.parent;
+    }
+  }
+
+  void AABBTree::RemoveLeaf(const int32_t &leaf) {
+    if (leaf == m_root) {
+      m_root = AABB_TREE_NULL;
+      return;
+    }
+
+    const int32_t parent = m_nodes[leaf].parent;
+    const int32_t grand_parent = m_nodes[parent].parent;
+    const int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    // The sibling takes the place of the parent
+    FreeNode(parent);
+
+    if (grand_parent == AABB_TREE_NULL) {
+      m_root = sibling;
+      m_nodes[sibling].parent = AABB_TREE_NULL;
+      return;
+    }
+
+    if (m_nodes[grand_parent].child1 == parent)
+      m_nodes[grand_parent].child1 = sibling;
+    else
+      m_nodes[grand_parent].child2 = sibling;
+
+    m_nodes[sibling].parent = grand_parent;
+
+    // Refit and rebalance the ancestors
+    int32_t index = grand_parent;
+    while (index != AABB_TREE_NULL) {
+      index = Balance(index);
+
+      AABBTreeNode &node = m_nodes[index];
+      const AABBTreeNode &child1 = m_nodes[node.child1];
+      const AABBTreeNode &child2 = m_nodes[node.child2];
+
+      node.aabb = AABB::Combine(child1.aabb, child2.aabb);
+      node.height = 1 + std::max(child1.height, child2.height);
+
+      index = node.parent;
+    }
+  }
+
+  int32_t AABBTree::Balance(const int32_t &a) {
+    AABBTreeNode &node_a = m_nodes[a];
+
+    if (node_a.IsLeaf() || node_a.height < 2)
+      return a;
+
+    const int32_t b = node_a.child1;
+    const int32_t c = node_a.child2;
+    AABBTreeNode &node_b = m_nodes[b];
+    AABBTreeNode &node_c = m_nodes[c];
+
+    const int32_t balance = node_c.height - node_b.height;
+
+    // The taller child is rotated up and A takes its shorter grandchild
+    if (balance > 1 || balance < -1) {
+      const bool rotate_c = balance > 0;
+
+      const int32_t up = rotate_c ? c : b;
+      const int32_t other = rotate_c ? b : c;
+      AABBTreeNode &node_up = m_nodes[up];
+      AABBTreeNode &node_other = m_nodes[other];
+
+      const int32_t f = node_up.child1;
+      const int32_t g = node_up.child2;
+      AABBTreeNode &node_f = m_nodes[f];
+      AABBTreeNode &node_g = m_nodes[g];
+
+      // Swap A and the rising child
+      node_up.child1 = a;
+      node_up.parent = node_a.parent;
+      node_a.parent = up;
+
+      if (node_up.parent == AABB_TREE_NULL) {
+        m_root = up;
+      } else if (m_nodes[node_up.parent].child1 == a) {
+        m_nodes[node_up.parent].child1 = up;
+      } else {
+        m_nodes[node_up.parent].child2 = up;
+      }
+
+      // The taller grandchild stays with the rising child
+      const bool keep_f = node_f.height > node_g.height;
+      const int32_t kept = keep_f ? f : g;
+      const int32_t given = keep_f ? g : f;
+
+      node_up.child2 = kept;
+
+      if (rotate_c)
+        node_a.child2 = given;
+      else
+        node_a.child1 = given;
+
+      m_nodes[given].parent = a;
+
+      node_a.aabb = AABB::Combine(node_other.aabb, m_nodes[given].aabb);
+      node_up.aabb = AABB::Combine(node_a.aabb, m_nodes[kept].aabb);
+
+      node_a.height = 1 + std::max(node_other.height, m_nodes[given].height);
+      node_up.height = 1 + std::max(node_a.height, m_nodes[kept].height);
+
+      return up;
+    }
+
+    return a;
+  }
+
+  const AABBTreeNode &AABBTree::GetProxyNode(const int32_t &proxy) const {
+    if (proxy < 0 || proxy >= (int32_t)m_nodes.size() || m_nodes[proxy].height != 0)
+      throw Exception("ERROR: AABBTree proxy does not exist!");
+
+    return m_nodes[proxy];
+  }
+
+  int32_t AABBTree::CreateProxy(const AABB &aabb, void *user_data) {
+    const int32_t proxy = AllocateNode();
+    const glm::vec3 margin(m_margin);
+
+    AABBTreeNode &node = m_nodes[proxy];
+    node.aabb = AABB{aabb.min - margin, aabb.max + margin};
+    node.user_data = user_data;
+    node.moved = true;
+
+    InsertLeaf(proxy);
+
+    m_moved.push_back(proxy);
+    m_proxy_count++;
+
+    return proxy;
+  }
+
+  void AABBTree::DestroyProxy(const int32_t &proxy) {
+    GetProxyNode(proxy);
+
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+
+    m_proxy_count--;
+  }
+
+  bool AABBTree::MoveProxy(const int32_t &proxy, const AABB &aabb, const glm::vec3 &displacement) {
+    const AABB &tree_aabb = GetProxyNode(proxy).aabb;
+    const glm::vec3 margin(m_margin);
+
+    // Fatten the box and stretch it in the direction of motion
+    AABB fat_aabb{aabb.min - margin, aabb.max + margin};
+
+    const glm::vec3 stretch = displacement * AABB_TREE_DISPLACEMENT_MULTIPLIER;
+    fat_aabb.min += glm::min(stretch, glm::vec3(0.0f));
+    fat_aabb.max += glm::max(stretch, glm::vec3(0.0f));
+
+    if (tree_aabb.Contains(aabb)) {
+      // Keep the old box unless it has become much larger than needed (the object slowed down)
+      const glm::vec3 slack = margin * 4.0f;
+      const AABB huge_aabb{fat_aabb.min - slack, fat_aabb.max + slack};
+
+      if (huge_aabb.Contains(tree_aabb))
+        return false;
+    }
+
+    RemoveLeaf(proxy);
+
+    m_nodes[proxy].aabb = fat_aabb;
+
+    InsertLeaf(proxy);
+
+    if (!m_nodes[proxy].moved) {
+      m_nodes[proxy].moved = true;
+      m_moved.push_back(proxy);
+    }
+
+    return true;
+  }
+
+  void *AABBTree::GetUserData(const int32_t &proxy) const {
+    return GetProxyNode(proxy).user_data;
+  }
+
+  const AABB &AABBTree::GetFatAABB(const int32_t &proxy) const {
+    return GetProxyNode(proxy).aabb;
+  }
+
+  int32_t AABBTree::GetHeight() const {
+    return m_root == AABB_TREE_NULL ? 0 : m_nodes[m_root].height;
+  }
+
+  const size_t &AABBTree::GetProxyCount() const {
+    return m_proxy_count;
+  }
+
+  float AABBTree::GetAreaRatio() const {
+    if (m_root == AABB_TREE_NULL)
+      return 0.0f;
+
+    const float root_cost = m_nodes[m_root].aabb.GetCost();
+    if (root_cost <= 0.0f)
+      return 0.0f;
+
+    float total_cost = 0.0f;
+    for (const AABBTreeNode &node : m_nodes) {
+      if (node.height > 0)
+        total_cost += node.aabb.GetCost();
+    }
+
+    return total_cost / root_cost;
+  }
+
+}
@@ -0,0 +1,227 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/physics/Culling.hpp"
+#include "elgar/core/CPUFeatures.hpp"
+#include "elgar/core/Exception.hpp"
+#include "elgar/core/Macros.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ELGAR_X86
+#endif
+
+namespace elgar {
+
+  // The SIMD kernels work on raw floats, make sure the types are tightly packed
+  static_assert(sizeof(Frustum) == FRUSTUM_PLANE_COUNT * 4 * sizeof(float), "Frustum must be packed planes!");
+  static_assert(sizeof(AABB) == 6 * sizeof(float), "AABB must be 6 packed floats!");
+
+  #ifdef ELGAR_X86
+  // Defined in CullingSSE.cpp and CullingAVX2.cpp (built for their instruction sets)
+  size_t CullSpheresSSE(const float *planes, const float *spheres, const size_t &count, uint32_t *visible);
+  size_t CullAABBsSSE(const float *planes, const float *boxes, const size_t &count, uint32_t *visible);
+  size_t CullInstancesSSE(const float *planes, const float *models, const size_t &count, const float *sphere, uint32_t *visible);
+
+  size_t CullSpheresAVX2(const float *planes, const float *spheres, const size_t &count, uint32_t *visible);
+  size_t CullAABBsAVX2(const float *planes, const float *boxes, const size_t &count, uint32_t *visible);
+  size_t CullInstancesAVX2(const float *planes, const float *models, const size_t &count, const float *sphere, uint32_t *visible);
+  #endif
+
+  // LOCAL DATA //
+
+  static std::atomic<int> s_kernel(-1);   // The kernel in use (-1 until picked)
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief Pick the fastest kernel the CPU supports
+   *
+   * @return The kernel
+   */
+  static CullKernelType PickKernel() {
+    CullKernelType type = CULL_KERNEL_SCALAR;
+
+    if (IsCullKernelSupported(CULL_KERNEL_AVX2))
+      type = CULL_KERNEL_AVX2;
+    else if (IsCullKernelSupported(CULL_KERNEL_SSE))
+      type = CULL_KERNEL_SSE;
+
+    LOG("Cull kernel: %s\n", GetCullKernelName(type));
+
+    return type;
+  }
+
+  /**
+   * @brief Get the world space bounding sphere of an instance
+   *
+   * @param model   The model matrix of the instance
+   * @param sphere  The local bounding sphere
+   * @return The world space sphere
+   */
+  static glm::vec4 TransformSphere(const glm::mat4 &model, const glm::vec4 &sphere) {
+    const glm::vec3 center(model * glm::vec4(glm::vec3(sphere), 1.0f));
+
+    // The largest axis scale bounds the scaled sphere
+    const float scale = std::sqrt(std::max(
+      std::max(glm::dot(glm::vec3(model[0]), glm::vec3(model[0])), glm::dot(glm::vec3(model[1]), glm::vec3(model[1]))),
+      glm::dot(glm::vec3(model[2]), glm::vec3(model[2]))
+    ));
+
+    return glm::vec4(center, sphere.w * scale);
+  }
+
+  // FUNCTIONS //
+
+  size_t CullSpheres(const Frustum &frustum, const glm::vec4 *spheres, const size_t &count, uint32_t *visible) {
+    if (count == 0)
+      return 0;
+
+    size_t done = 0, visible_count = 0;
+
+    #ifdef ELGAR_X86
+    switch (GetCullKernel()) {
+      case CULL_KERNEL_AVX2:
+        visible_count = CullSpheresAVX2(&frustum.planes[0].x, &spheres[0].x, count, visible);
+        done = count & ~size_t(7);
+        break;
+      case CULL_KERNEL_SSE:
+        visible_count = CullSpheresSSE(&frustum.planes[0].x, &spheres[0].x, count, visible);
+        done = count & ~size_t(3);
+        break;
+      default:
+        break;
+    }
+    #endif
+
+    // The SIMD kernels handle whole groups and leave the remainder here
+    for (size_t i = done; i < count; i++) {
+      if (frustum.TestSphere(glm::vec3(spheres[i]), spheres[i].w) != FRUSTUM_OUTSIDE)
+        visible[visible_count++] = i;
+    }
+
+    return visible_count;
+  }
+
+  size_t CullAABBs(const Frustum &frustum, const AABB *boxes, const size_t &count, uint32_t *visible) {
+    if (count == 0)
+      return 0;
+
+    size_t done = 0, visible_count = 0;
+
+    #ifdef ELGAR_X86
+    switch (GetCullKernel()) {
+      case CULL_KERNEL_AVX2:
+        visible_count = CullAABBsAVX2(&frustum.planes[0].x, &boxes[0].min.x, count, visible);
+        done = count & ~size_t(7);
+        break;
+      case CULL_KERNEL_SSE:
+        visible_count = CullAABBsSSE(&frustum.planes[0].x, &boxes[0].min.x, count, visible);
+        done = count & ~size_t(3);
+        break;
+      default:
+        break;
+    }
+    #endif
+
+    for (size_t i = done; i < count; i++) {
+      if (frustum.TestAABB(boxes[i]) != FRUSTUM_OUTSIDE)
+        visible[visible_count++] = i;
+    }
+
+    return visible_count;
+  }
+
+  size_t CullInstances(
+    const Frustum &frustum,
+    const glm::mat4 *models,
+    const size_t &count,
+    const glm::vec4 &sphere,
+    uint32_t *visible
+  ) {
+    if (count == 0)
+      return 0;
+
+    size_t done = 0, visible_count = 0;
+
+    #ifdef ELGAR_X86
+    switch (GetCullKernel()) {
+      case CULL_KERNEL_AVX2:
+        visible_count = CullInstancesAVX2(&frustum.planes[0].x, &models[0][0][0], count, &sphere.x, visible);
+        done = count & ~size_t(7);
+        break;
+      case CULL_KERNEL_SSE:
+        visible_count = CullInstancesSSE(&frustum.planes[0].x, &models[0][0][0], count, &sphere.x, visible);
+        done = count & ~size_t(3);
+        break;
+      default:
+        break;
+    }
+    #endif
+
+    for (size_t i = done; i < count; i++) {
+      const glm::vec4 world = TransformSphere(models[i], sphere);
+
+      if (frustum.TestSphere(glm::vec3(world), world.w) != FRUSTUM_OUTSIDE)
+        visible[visible_count++] = i;
+    }
+
+    return visible_count;
+  }
+
+  CullKernelType GetCullKernel() {
+    int kernel = s_kernel.load(std::memory_order_relaxed);
+
+    if (kernel < 0) {
+      kernel = PickKernel();
+      s_kernel.store(kernel, std::memory_order_relaxed);
+    }
+
+    return (CullKernelType)kernel;
+  }
+
+  void SetCullKernel(const CullKernelType &type) {
+    if (!IsCullKernelSupported(type))
+      throw Exception(std::string("ERROR: Cull kernel ") + GetCullKernelName(type) + " is not supported by this CPU!");
+
+    s_kernel.store(type, std::memory_order_relaxed);
+  }
+
+  bool IsCullKernelSupported(const CullKernelType &type) {
+    #ifdef ELGAR_X86
+    const CPUFeatures &features = GetCPUFeatures();
+
+    switch (type) {
+      // CullingAVX2.cpp is built without FMA, so AVX2 alone is enough
+      case CULL_KERNEL_AVX2:
+        return features.avx2;
+      case CULL_KERNEL_SSE:
+        return features.sse2;
+      default:
+        return true;
+    }
+    #else
+    return type == CULL_KERNEL_SCALAR;
+    #endif
+  }
+
+  const char *GetCullKernelName(const CullKernelType &type) {
+    switch (type) {
+      case CULL_KERNEL_AVX2:
+        return "AVX2";
+      case CULL_KERNEL_SSE:
+        return "SSE";
+      default:
+        return "Scalar";
+    }
+  }
+
+}
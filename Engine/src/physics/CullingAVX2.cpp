@@ -0,0 +1,230 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+// This file is built with -mavx2 -ffp-contract=off (no FMA, so no multiply and add is fused and the
+// results match the scalar path bit for bit) and is only called once CPUID reports AVX2.
+// Only intrinsics in here, so no inline function from another header gets compiled for AVX2.
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#define CULL_PLANE_COUNT  6
+
+namespace elgar {
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief Load a 4 float row of object i into the low lane and of object i + 4 into the high lane
+   *
+   * @param data    The row of object i
+   * @param stride  Floats between the rows of consecutive objects
+   * @return The rows
+   */
+  static inline __m256 LoadPair(const float *data, const size_t &stride) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(data)), _mm_loadu_ps(data + stride * 4), 1);
+  }
+
+  /**
+   * @brief Transpose the 4x4 blocks in both lanes (like _MM_TRANSPOSE4_PS)
+   *
+   * @param a   Rows 0, transposed into column 0
+   * @param b   Rows 1, transposed into column 1
+   * @param c   Rows 2, transposed into column 2
+   * @param d   Rows 3, transposed into column 3
+   */
+  static inline void Transpose(__m256 &a, __m256 &b, __m256 &c, __m256 &d) {
+    const __m256 t0 = _mm256_unpacklo_ps(a, b);
+    const __m256 t1 = _mm256_unpacklo_ps(c, d);
+    const __m256 t2 = _mm256_unpackhi_ps(a, b);
+    const __m256 t3 = _mm256_unpackhi_ps(c, d);
+
+    a = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+    b = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+    c = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    d = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  }
+
+  /**
+   * @brief Find the spheres outside any plane
+   *
+   * @param planes  The frustum planes
+   * @param x       The x of the centers
+   * @param y       The y of the centers
+   * @param z       The z of the centers
+   * @param r       The radii
+   * @return Bit i is set if sphere i is visible
+   */
+  static inline int TestSpheres(const float *planes, const __m256 &x, const __m256 &y, const __m256 &z, const __m256 &r) {
+    const __m256 neg_r = _mm256_sub_ps(_mm256_setzero_ps(), r);
+    __m256 outside = _mm256_setzero_ps();
+
+    for (int i = 0; i < CULL_PLANE_COUNT; i++) {
+      const float *plane = planes + i * 4;
+
+      __m256 d = _mm256_mul_ps(_mm256_set1_ps(plane[0]), x);
+      d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(plane[1]), y));
+      d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(plane[2]), z));
+      d = _mm256_add_ps(d, _mm256_set1_ps(plane[3]));
+
+      outside = _mm256_or_ps(outside, _mm256_cmp_ps(d, neg_r, _CMP_LT_OQ));
+    }
+
+    return ~_mm256_movemask_ps(outside) & 0xFF;
+  }
+
+  /**
+   * @brief Append the indices of a group's visible objects
+   *
+   * @param mask      Bit i is set if object i of the group is visible
+   * @param first     Index of the first object of the group
+   * @param visible   The visible indices
+   * @param count     The number of visible indices (updated)
+   */
+  static inline void Emit(int mask, const size_t &first, uint32_t *visible, size_t &count) {
+    while (mask) {
+      visible[count++] = first + __builtin_ctz(mask);
+      mask &= mask - 1;
+    }
+  }
+
+  // FUNCTIONS //
+
+  size_t CullSpheresAVX2(const float *planes, const float *spheres, const size_t &count, uint32_t *visible) {
+    const size_t groups = count / 8;
+    size_t visible_count = 0;
+
+    for (size_t group = 0; group < groups; group++) {
+      const float *data = spheres + group * 32;
+
+      // Spheres 0-3 go in the low lanes and 4-7 in the high lanes
+      __m256 x = LoadPair(data, 4);
+      __m256 y = LoadPair(data + 4, 4);
+      __m256 z = LoadPair(data + 8, 4);
+      __m256 r = LoadPair(data + 12, 4);
+      Transpose(x, y, z, r);
+
+      Emit(TestSpheres(planes, x, y, z, r), group * 8, visible, visible_count);
+    }
+
+    return visible_count;
+  }
+
+  size_t CullAABBsAVX2(const float *planes, const float *boxes, const size_t &count, uint32_t *visible) {
+    const size_t groups = count / 8;
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+
+    size_t visible_count = 0;
+
+    for (size_t group = 0; group < groups; group++) {
+      const float *b = boxes + group * 48;   // Eight boxes of min xyz, max xyz
+
+      __m256 bounds[6];
+      for (int i = 0; i < 6; i++)
+        bounds[i] = _mm256_setr_ps(b[i], b[6 + i], b[12 + i], b[18 + i], b[24 + i], b[30 + i], b[36 + i], b[42 + i]);
+
+      const __m256 cx = _mm256_mul_ps(_mm256_add_ps(bounds[0], bounds[3]), half);
+      const __m256 cy = _mm256_mul_ps(_mm256_add_ps(bounds[1], bounds[4]), half);
+      const __m256 cz = _mm256_mul_ps(_mm256_add_ps(bounds[2], bounds[5]), half);
+      const __m256 ex = _mm256_mul_ps(_mm256_sub_ps(bounds[3], bounds[0]), half);
+      const __m256 ey = _mm256_mul_ps(_mm256_sub_ps(bounds[4], bounds[1]), half);
+      const __m256 ez = _mm256_mul_ps(_mm256_sub_ps(bounds[5], bounds[2]), half);
+
+      __m256 outside = _mm256_setzero_ps();
+
+      for (int i = 0; i < CULL_PLANE_COUNT; i++) {
+        const float *plane = planes + i * 4;
+
+        const __m256 nx = _mm256_set1_ps(plane[0]);
+        const __m256 ny = _mm256_set1_ps(plane[1]);
+        const __m256 nz = _mm256_set1_ps(plane[2]);
+
+        // Distance of the center and the box's reach along the plane normal
+        __m256 d = _mm256_mul_ps(nx, cx);
+        d = _mm256_add_ps(d, _mm256_mul_ps(ny, cy));
+        d = _mm256_add_ps(d, _mm256_mul_ps(nz, cz));
+        d = _mm256_add_ps(d, _mm256_set1_ps(plane[3]));
+
+        __m256 r = _mm256_mul_ps(_mm256_and_ps(nx, abs_mask), ex);
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_and_ps(ny, abs_mask), ey));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_and_ps(nz, abs_mask), ez));
+
+        outside = _mm256_or_ps(outside, _mm256_cmp_ps(d, _mm256_sub_ps(_mm256_setzero_ps(), r), _CMP_LT_OQ));
+      }
+
+      Emit(~_mm256_movemask_ps(outside) & 0xFF, group * 8, visible, visible_count);
+    }
+
+    return visible_count;
+  }
+
+  size_t CullInstancesAVX2(const float *planes, const float *models, const size_t &count, const float *sphere, uint32_t *visible) {
+    const size_t groups = count / 8;
+
+    const __m256 lx = _mm256_set1_ps(sphere[0]);
+    const __m256 ly = _mm256_set1_ps(sphere[1]);
+    const __m256 lz = _mm256_set1_ps(sphere[2]);
+    const __m256 lr = _mm256_set1_ps(sphere[3]);
+
+    size_t visible_count = 0;
+
+    for (size_t group = 0; group < groups; group++) {
+      const float *m = models + group * 128;
+
+      // Column c of the eight matrices, transposed into one row per register
+      __m256 col[4][4];
+      for (int c = 0; c < 4; c++) {
+        col[c][0] = LoadPair(m + c * 4, 16);
+        col[c][1] = LoadPair(m + 16 + c * 4, 16);
+        col[c][2] = LoadPair(m + 32 + c * 4, 16);
+        col[c][3] = LoadPair(m + 48 + c * 4, 16);
+        Transpose(col[c][0], col[c][1], col[c][2], col[c][3]);
+      }
+
+      // Center: model * (local center, 1)
+      __m256 x = _mm256_mul_ps(col[0][0], lx);
+      x = _mm256_add_ps(x, _mm256_mul_ps(col[1][0], ly));
+      x = _mm256_add_ps(x, _mm256_mul_ps(col[2][0], lz));
+      x = _mm256_add_ps(x, col[3][0]);
+
+      __m256 y = _mm256_mul_ps(col[0][1], lx);
+      y = _mm256_add_ps(y, _mm256_mul_ps(col[1][1], ly));
+      y = _mm256_add_ps(y, _mm256_mul_ps(col[2][1], lz));
+      y = _mm256_add_ps(y, col[3][1]);
+
+      __m256 z = _mm256_mul_ps(col[0][2], lx);
+      z = _mm256_add_ps(z, _mm256_mul_ps(col[1][2], ly));
+      z = _mm256_add_ps(z, _mm256_mul_ps(col[2][2], lz));
+      z = _mm256_add_ps(z, col[3][2]);
+
+      // Radius: local radius times the largest axis scale
+      __m256 scale = _mm256_setzero_ps();
+      for (int c = 0; c < 3; c++) {
+        __m256 length = _mm256_mul_ps(col[c][0], col[c][0]);
+        length = _mm256_add_ps(length, _mm256_mul_ps(col[c][1], col[c][1]));
+        length = _mm256_add_ps(length, _mm256_mul_ps(col[c][2], col[c][2]));
+
+        scale = _mm256_max_ps(scale, length);
+      }
+
+      const __m256 r = _mm256_mul_ps(lr, _mm256_sqrt_ps(scale));
+
+      Emit(TestSpheres(planes, x, y, z, r), group * 8, visible, visible_count);
+    }
+
+    return visible_count;
+  }
+
+}
+
+#endif
@@ -0,0 +1,202 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+// SSE2 is part of x86-64, so these kernels build without extra compiler flags
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <emmintrin.h>
+
+#define CULL_PLANE_COUNT  6
+
+namespace elgar {
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief Find the spheres outside any plane
+   *
+   * @param planes  The frustum planes
+   * @param x       The x of the centers
+   * @param y       The y of the centers
+   * @param z       The z of the centers
+   * @param r       The radii
+   * @return Bit i is set if sphere i is visible
+   */
+  static inline int TestSpheres(const float *planes, const __m128 &x, const __m128 &y, const __m128 &z, const __m128 &r) {
+    const __m128 neg_r = _mm_sub_ps(_mm_setzero_ps(), r);
+    __m128 outside = _mm_setzero_ps();
+
+    for (int i = 0; i < CULL_PLANE_COUNT; i++) {
+      const float *plane = planes + i * 4;
+
+      __m128 d = _mm_mul_ps(_mm_set1_ps(plane[0]), x);
+      d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(plane[1]), y));
+      d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(plane[2]), z));
+      d = _mm_add_ps(d, _mm_set1_ps(plane[3]));
+
+      outside = _mm_or_ps(outside, _mm_cmplt_ps(d, neg_r));
+    }
+
+    return ~_mm_movemask_ps(outside) & 0xF;
+  }
+
+  /**
+   * @brief Append the indices of a group's visible objects
+   *
+   * @param mask      Bit i is set if object i of the group is visible
+   * @param first     Index of the first object of the group
+   * @param visible   The visible indices
+   * @param count     The number of visible indices (updated)
+   */
+  static inline void Emit(int mask, const size_t &first, uint32_t *visible, size_t &count) {
+    while (mask) {
+      visible[count++] = first + __builtin_ctz(mask);
+      mask &= mask - 1;
+    }
+  }
+
+  // FUNCTIONS //
+
+  size_t CullSpheresSSE(const float *planes, const float *spheres, const size_t &count, uint32_t *visible) {
+    const size_t groups = count / 4;
+    size_t visible_count = 0;
+
+    for (size_t group = 0; group < groups; group++) {
+      const float *data = spheres + group * 16;
+
+      // One sphere per register, transposed into one component per register
+      __m128 x = _mm_loadu_ps(data);
+      __m128 y = _mm_loadu_ps(data + 4);
+      __m128 z = _mm_loadu_ps(data + 8);
+      __m128 r = _mm_loadu_ps(data + 12);
+      _MM_TRANSPOSE4_PS(x, y, z, r);
+
+      Emit(TestSpheres(planes, x, y, z, r), group * 4, visible, visible_count);
+    }
+
+    return visible_count;
+  }
+
+  size_t CullAABBsSSE(const float *planes, const float *boxes, const size_t &count, uint32_t *visible) {
+    const size_t groups = count / 4;
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+    size_t visible_count = 0;
+
+    for (size_t group = 0; group < groups; group++) {
+      const float *b = boxes + group * 24;   // Four boxes of min xyz, max xyz
+
+      const __m128 min_x = _mm_setr_ps(b[0], b[6], b[12], b[18]);
+      const __m128 min_y = _mm_setr_ps(b[1], b[7], b[13], b[19]);
+      const __m128 min_z = _mm_setr_ps(b[2], b[8], b[14], b[20]);
+      const __m128 max_x = _mm_setr_ps(b[3], b[9], b[15], b[21]);
+      const __m128 max_y = _mm_setr_ps(b[4], b[10], b[16], b[22]);
+      const __m128 max_z = _mm_setr_ps(b[5], b[11], b[17], b[23]);
+
+      const __m128 cx = _mm_mul_ps(_mm_add_ps(min_x, max_x), half);
+      const __m128 cy = _mm_mul_ps(_mm_add_ps(min_y, max_y), half);
+      const __m128 cz = _mm_mul_ps(_mm_add_ps(min_z, max_z), half);
+      const __m128 ex = _mm_mul_ps(_mm_sub_ps(max_x, min_x), half);
+      const __m128 ey = _mm_mul_ps(_mm_sub_ps(max_y, min_y), half);
+      const __m128 ez = _mm_mul_ps(_mm_sub_ps(max_z, min_z), half);
+
+      __m128 outside = _mm_setzero_ps();
+
+      for (int i = 0; i < CULL_PLANE_COUNT; i++) {
+        const __m128 plane = _mm_loadu_ps(planes + i * 4);
+        const __m128 abs_plane = _mm_and_ps(plane, abs_mask);
+
+        const __m128 nx = _mm_shuffle_ps(plane, plane, _MM_SHUFFLE(0, 0, 0, 0));
+        const __m128 ny = _mm_shuffle_ps(plane, plane, _MM_SHUFFLE(1, 1, 1, 1));
+        const __m128 nz = _mm_shuffle_ps(plane, plane, _MM_SHUFFLE(2, 2, 2, 2));
+        const __m128 nw = _mm_shuffle_ps(plane, plane, _MM_SHUFFLE(3, 3, 3, 3));
+
+        // Distance of the center and the box's reach along the plane normal
+        __m128 d = _mm_mul_ps(nx, cx);
+        d = _mm_add_ps(d, _mm_mul_ps(ny, cy));
+        d = _mm_add_ps(d, _mm_mul_ps(nz, cz));
+        d = _mm_add_ps(d, nw);
+
+        __m128 r = _mm_mul_ps(_mm_shuffle_ps(abs_plane, abs_plane, _MM_SHUFFLE(0, 0, 0, 0)), ex);
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(abs_plane, abs_plane, _MM_SHUFFLE(1, 1, 1, 1)), ey));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(abs_plane, abs_plane, _MM_SHUFFLE(2, 2, 2, 2)), ez));
+
+        outside = _mm_or_ps(outside, _mm_cmplt_ps(d, _mm_sub_ps(_mm_setzero_ps(), r)));
+      }
+
+      Emit(~_mm_movemask_ps(outside) & 0xF, group * 4, visible, visible_count);
+    }
+
+    return visible_count;
+  }
+
+  size_t CullInstancesSSE(const float *planes, const float *models, const size_t &count, const float *sphere, uint32_t *visible) {
+    const size_t groups = count / 4;
+
+    const __m128 lx = _mm_set1_ps(sphere[0]);
+    const __m128 ly = _mm_set1_ps(sphere[1]);
+    const __m128 lz = _mm_set1_ps(sphere[2]);
+    const __m128 lr = _mm_set1_ps(sphere[3]);
+
+    size_t visible_count = 0;
+
+    for (size_t group = 0; group < groups; group++) {
+      const float *m = models + group * 64;
+
+      // Column c of the four matrices, transposed into one row per register
+      __m128 col[4][4];
+      for (int c = 0; c < 4; c++) {
+        col[c][0] = _mm_loadu_ps(m + c * 4);
+        col[c][1] = _mm_loadu_ps(m + 16 + c * 4);
+        col[c][2] = _mm_loadu_ps(m + 32 + c * 4);
+        col[c][3] = _mm_loadu_ps(m + 48 + c * 4);
+        _MM_TRANSPOSE4_PS(col[c][0], col[c][1], col[c][2], col[c][3]);
+      }
+
+      // Center: model * (local center, 1)
+      __m128 x = _mm_mul_ps(col[0][0], lx);
+      x = _mm_add_ps(x, _mm_mul_ps(col[1][0], ly));
+      x = _mm_add_ps(x, _mm_mul_ps(col[2][0], lz));
+      x = _mm_add_ps(x, col[3][0]);
+
+      __m128 y = _mm_mul_ps(col[0][1], lx);
+      y = _mm_add_ps(y, _mm_mul_ps(col[1][1], ly));
+      y = _mm_add_ps(y, _mm_mul_ps(col[2][1], lz));
+      y = _mm_add_ps(y, col[3][1]);
+
+      __m128 z = _mm_mul_ps(col[0][2], lx);
+      z = _mm_add_ps(z, _mm_mul_ps(col[1][2], ly));
+      z = _mm_add_ps(z, _mm_mul_ps(col[2][2], lz));
+      z = _mm_add_ps(z, col[3][2]);
+
+      // Radius: local radius times the largest axis scale
+      __m128 scale = _mm_setzero_ps();
+      for (int c = 0; c < 3; c++) {
+        __m128 length = _mm_mul_ps(col[c][0], col[c][0]);
+        length = _mm_add_ps(length, _mm_mul_ps(col[c][1], col[c][1]));
+        length = _mm_add_ps(length, _mm_mul_ps(col[c][2], col[c][2]));
+
+        scale = _mm_max_ps(scale, length);
+      }
+
+      const __m128 r = _mm_mul_ps(lr, _mm_sqrt_ps(scale));
+
+      Emit(TestSpheres(planes, x, y, z, r), group * 4, visible, visible_count);
+    }
+
+    return visible_count;
+  }
+
+}
+
+#endif
@@ -0,0 +1,88 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/physics/Frustum.hpp"
+
+namespace elgar {
+
+  // FUNCTIONS //
+
+  Frustum Frustum::FromMatrix(const glm::mat4 &matrix) {
+    Frustum frustum;
+
+    // Rows of the (column-major) matrix
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++)
+      rows[i] = glm::vec4(matrix[0][i], matrix[1][i], matrix[2][i], matrix[3][i]);
+
+    // Clip space is -w <= x, y, z <= w
+    frustum.planes[0] = rows[3] + rows[0];  // Left
+    frustum.planes[1] = rows[3] - rows[0];  // Right
+    frustum.planes[2] = rows[3] + rows[1];  // Bottom
+    frustum.planes[3] = rows[3] - rows[1];  // Top
+    frustum.planes[4] = rows[3] + rows[2];  // Near
+    frustum.planes[5] = rows[3] - rows[2];  // Far
+
+    // Normalize so the plane equation gives real distances
+    for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++) {
+      const float length = glm::length(glm::vec3(frustum.planes[i]));
+
+      if (length > 0.0f)
+        frustum.planes[i] = frustum.planes[i] / length;
+    }
+
+    return frustum;
+  }
+
+  bool Frustum::ContainsPoint(const glm::vec3 &point) const {
+    for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++) {
+      if (glm::dot(glm::vec3(planes[i]), point) + planes[i].w < 0.0f)
+        return false;
+    }
+
+    return true;
+  }
+
+  FrustumTest Frustum::TestSphere(const glm::vec3 &center, const float &radius) const {
+    FrustumTest result = FRUSTUM_INSIDE;
+
+    for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++) {
+      const float distance = glm::dot(glm::vec3(planes[i]), center) + planes[i].w;
+
+      if (distance < -radius)
+        return FRUSTUM_OUTSIDE;
+      if (distance < radius)
+        result = FRUSTUM_INTERSECTS;
+    }
+
+    return result;
+  }
+
+  FrustumTest Frustum::TestAABB(const AABB &aabb) const {
+    const glm::vec3 center = aabb.GetCenter();
+    const glm::vec3 extents = aabb.GetExtents();
+
+    FrustumTest result = FRUSTUM_INSIDE;
+
+    for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++) {
+      const glm::vec3 normal(planes[i]);
+
+      // Distance of the center and the box's reach along the plane normal
+      const float distance = glm::dot(normal, center) + planes[i].w;
+      const float radius = glm::dot(glm::abs(normal), extents);
+
+      if (distance < -radius)
+        return FRUSTUM_OUTSIDE;
+      if (distance < radius)
+        result = FRUSTUM_INTERSECTS;
+    }
+
+    return result;
+  }
+
+}
@@ -11,6 +11,7 @@
 #include <glm/gtx/quaternion.hpp>
 
 #include "elgar/physics/Interpolated.hpp"
+#include "elgar/physics/TransformKernel.hpp"
 #include "elgar/timers/FrameTimer.hpp"
 
 namespace elgar {
@@ -103,19 +104,19 @@ namespace elgar {
   }
 
   glm::mat4 Interpolated::GetMatrix() {
-    glm::mat4 model_matrix;   // The model matrix for the Interpolated
-
-    // Translate the model matrix by the position
-    model_matrix = glm::translate(model_matrix, GetInterpolatedPosition());
-
-    // Scale the matrix
-    model_matrix = glm::scale(model_matrix, GetInterpolatedScale());
+    float alpha = 0.0f;
 
-    // Create quaternion for rotation
-    glm::quat quaternion(GetInterpolatedEulerAngles()); // Create a quaternion from angles
+    // Fetch the alpha once for all three interpolations
+    FrameTimer *frame_timer = FrameTimer::GetInstance();
+    if (frame_timer)
+      alpha = frame_timer->GetAlpha();
 
-    // Rotate the model matrix
-    return model_matrix * glm::toMat4(quaternion);
+    return ComputeInterpolatedMatrix(
+      m_prev_pos, GetPosition(),
+      m_prev_scale, GetScale(),
+      m_prev_rot, GetEulerAngles(),
+      alpha
+    );
   }
 
 }
\ No newline at end of file
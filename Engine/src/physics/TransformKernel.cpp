@@ -0,0 +1,217 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/physics/TransformKernel.hpp"
+#include "elgar/core/CPUFeatures.hpp"
+#include "elgar/core/Exception.hpp"
+#include "elgar/core/Macros.hpp"
+
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ELGAR_X86
+#endif
+
+namespace elgar {
+
+  // The SIMD kernels work on raw floats, make sure the glm types are tightly packed
+  static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 must be 3 packed floats!");
+  static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "glm::mat4 must be 16 packed floats!");
+
+  #ifdef ELGAR_X86
+  // Defined in TransformKernelSSE.cpp and TransformKernelAVX2.cpp (built for their instruction sets)
+  size_t ComputeInterpolatedMatricesSSE(const float *const arrays[6], const size_t &count, const float &alpha, float *matrices);
+  size_t ComputeInterpolatedMatricesAVX2(const float *const arrays[6], const size_t &count, const float &alpha, float *matrices);
+  #endif
+
+  // LOCAL DATA //
+
+  static std::atomic<int> s_kernel(-1);   // The kernel in use (-1 until picked)
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief Compute matrices one at a time
+   *
+   * @param arrays    The transforms
+   * @param first     The first transform to compute
+   * @param count     The number of transforms
+   * @param alpha     Interpolation alpha
+   * @param matrices  Filled with the matrices
+   */
+  static void ComputeScalar(
+    const TransformArrays &arrays,
+    const size_t &first,
+    const size_t &count,
+    const float &alpha,
+    glm::mat4 *matrices
+  ) {
+    for (size_t i = first; i < count; i++) {
+      matrices[i] = ComputeInterpolatedMatrix(
+        arrays.prev_positions[i], arrays.positions[i],
+        arrays.prev_scales[i], arrays.scales[i],
+        arrays.prev_rotations[i], arrays.rotations[i],
+        alpha
+      );
+    }
+  }
+
+  /**
+   * @brief Pick the fastest kernel the CPU supports
+   *
+   * @return The kernel
+   */
+  static TransformKernelType PickKernel() {
+    TransformKernelType type = TRANSFORM_KERNEL_SCALAR;
+
+    if (IsTransformKernelSupported(TRANSFORM_KERNEL_AVX2))
+      type = TRANSFORM_KERNEL_AVX2;
+    else if (IsTransformKernelSupported(TRANSFORM_KERNEL_SSE))
+      type = TRANSFORM_KERNEL_SSE;
+
+    LOG("Transform kernel: %s\n", GetTransformKernelName(type));
+
+    return type;
+  }
+
+  // FUNCTIONS //
+
+  glm::mat4 ComputeInterpolatedMatrix(
+    const glm::vec3 &prev_position,
+    const glm::vec3 &position,
+    const glm::vec3 &prev_scale,
+    const glm::vec3 &scale,
+    const glm::vec3 &prev_rotation,
+    const glm::vec3 &rotation,
+    const float &alpha
+  ) {
+    const glm::vec3 p = position * alpha + prev_position * (1.0f - alpha);
+    const glm::vec3 s = scale * alpha + prev_scale * (1.0f - alpha);
+    const glm::vec3 r = rotation * alpha + prev_rotation * (1.0f - alpha);
+
+    // Quaternion from the Euler angles (as glm::quat does it)
+    const float cx = std::cos(r.x * 0.5f), sx = std::sin(r.x * 0.5f);
+    const float cy = std::cos(r.y * 0.5f), sy = std::sin(r.y * 0.5f);
+    const float cz = std::cos(r.z * 0.5f), sz = std::sin(r.z * 0.5f);
+
+    const float qw = cx * cy * cz + sx * sy * sz;
+    const float qx = sx * cy * cz - cx * sy * sz;
+    const float qy = cx * sy * cz + sx * cy * sz;
+    const float qz = cx * cy * sz - sx * sy * cz;
+
+    // translate(position) * scale(scale) * toMat4(quaternion), multiplied out
+    glm::mat4 matrix;
+
+    matrix[0] = glm::vec4(
+      s.x * (1.0f - 2.0f * (qy * qy + qz * qz)),
+      s.y * (2.0f * (qx * qy + qw * qz)),
+      s.z * (2.0f * (qx * qz - qw * qy)),
+      0.0f
+    );
+
+    matrix[1] = glm::vec4(
+      s.x * (2.0f * (qx * qy - qw * qz)),
+      s.y * (1.0f - 2.0f * (qx * qx + qz * qz)),
+      s.z * (2.0f * (qy * qz + qw * qx)),
+      0.0f
+    );
+
+    matrix[2] = glm::vec4(
+      s.x * (2.0f * (qx * qz + qw * qy)),
+      s.y * (2.0f * (qy * qz - qw * qx)),
+      s.z * (1.0f - 2.0f * (qx * qx + qy * qy)),
+      0.0f
+    );
+
+    matrix[3] = glm::vec4(p, 1.0f);
+
+    return matrix;
+  }
+
+  void ComputeInterpolatedMatrices(
+    const TransformArrays &arrays,
+    const size_t &count,
+    const float &alpha,
+    glm::mat4 *matrices
+  ) {
+    if (count == 0)
+      return;
+
+    size_t done = 0;
+
+    #ifdef ELGAR_X86
+    const float *const raw[6] = {
+      &arrays.prev_positions[0].x, &arrays.positions[0].x,
+      &arrays.prev_scales[0].x, &arrays.scales[0].x,
+      &arrays.prev_rotations[0].x, &arrays.rotations[0].x
+    };
+
+    // The SIMD kernels handle whole groups and leave the remainder to the scalar one
+    switch (GetTransformKernel()) {
+      case TRANSFORM_KERNEL_AVX2:
+        done = ComputeInterpolatedMatricesAVX2(raw, count, alpha, &matrices[0][0][0]);
+        break;
+      case TRANSFORM_KERNEL_SSE:
+        done = ComputeInterpolatedMatricesSSE(raw, count, alpha, &matrices[0][0][0]);
+        break;
+      default:
+        break;
+    }
+    #endif
+
+    ComputeScalar(arrays, done, count, alpha, matrices);
+  }
+
+  TransformKernelType GetTransformKernel() {
+    int kernel = s_kernel.load(std::memory_order_relaxed);
+
+    if (kernel < 0) {
+      kernel = PickKernel();
+      s_kernel.store(kernel, std::memory_order_relaxed);
+    }
+
+    return (TransformKernelType)kernel;
+  }
+
+  void SetTransformKernel(const TransformKernelType &type) {
+    if (!IsTransformKernelSupported(type))
+      throw Exception(std::string("ERROR: Transform kernel ") + GetTransformKernelName(type) + " is not supported by this CPU!");
+
+    s_kernel.store(type, std::memory_order_relaxed);
+  }
+
+  bool IsTransformKernelSupported(const TransformKernelType &type) {
+    #ifdef ELGAR_X86
+    const CPUFeatures &features = GetCPUFeatures();
+
+    switch (type) {
+      case TRANSFORM_KERNEL_AVX2:
+        return features.avx2 && features.fma;
+      case TRANSFORM_KERNEL_SSE:
+        return features.sse2;
+      default:
+        return true;
+    }
+    #else
+    return type == TRANSFORM_KERNEL_SCALAR;
+    #endif
+  }
+
+  const char *GetTransformKernelName(const TransformKernelType &type) {
+    switch (type) {
+      case TRANSFORM_KERNEL_AVX2:
+        return "AVX2";
+      case TRANSFORM_KERNEL_SSE:
+        return "SSE";
+      default:
+        return "Scalar";
+    }
+  }
+
+}
@@ -0,0 +1,238 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+// This file is built with -mavx2 -mfma and is only called once CPUID says the CPU can run it.
+// Only intrinsics in here: inline functions from other headers would be compiled for AVX2 too
+// and could be picked by the linker for the rest of the engine.
+
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+namespace elgar {
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief Load eight packed vec3s and split them into x, y and z vectors
+   *
+   * @param data  The first float of the eight vec3s
+   * @param x     Filled with the x components
+   * @param y     Filled with the y components
+   * @param z     Filled with the z components
+   */
+  static inline void Load3(const float *data, __m256 &x, __m256 &y, __m256 &z) {
+    // Each 128 bit lane holds four vec3s, split them the same way the SSE kernel does
+    const __m256 a = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(data)), _mm_loadu_ps(data + 12), 1);
+    const __m256 b = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(data + 4)), _mm_loadu_ps(data + 16), 1);
+    const __m256 c = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(data + 8)), _mm_loadu_ps(data + 20), 1);
+
+    x = _mm256_shuffle_ps(
+      _mm256_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 0)),
+      _mm256_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)),
+      _MM_SHUFFLE(2, 0, 1, 0)
+    );
+
+    y = _mm256_shuffle_ps(
+      _mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+      _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+      _MM_SHUFFLE(2, 0, 2, 0)
+    );
+
+    z = _mm256_shuffle_ps(
+      _mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+      _mm256_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),
+      _MM_SHUFFLE(2, 0, 2, 0)
+    );
+  }
+
+  /**
+   * @brief Compute the sine and cosine of eight angles (Cephes single precision polynomials)
+   *
+   * @param x   The angles in radians
+   * @param s   Filled with the sines
+   * @param c   Filled with the cosines
+   */
+  static inline void SinCos(__m256 x, __m256 &s, __m256 &c) {
+    const __m256 sign_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x80000000));
+
+    __m256 sign_sin = _mm256_and_ps(x, sign_mask);
+    x = _mm256_andnot_ps(sign_mask, x);
+
+    // Reduce to an octant (j is rounded up to an even number)
+    __m256i j = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(1.27323954473516f)));
+    j = _mm256_and_si256(_mm256_add_epi32(j, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+    const __m256 y = _mm256_cvtepi32_ps(j);
+
+    const __m256 swap_sign_sin = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, _mm256_set1_epi32(4)), 29));
+    const __m256 poly_mask = _mm256_castsi256_ps(
+      _mm256_cmpeq_epi32(_mm256_and_si256(j, _mm256_set1_epi32(2)), _mm256_setzero_si256())
+    );
+    const __m256 sign_cos = _mm256_castsi256_ps(
+      _mm256_slli_epi32(_mm256_andnot_si256(_mm256_sub_epi32(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29)
+    );
+
+    sign_sin = _mm256_xor_ps(sign_sin, swap_sign_sin);
+
+    // Extended precision modular arithmetic
+    x = _mm256_fnmadd_ps(y, _mm256_set1_ps(0.78515625f), x);
+    x = _mm256_fnmadd_ps(y, _mm256_set1_ps(2.4187564849853515625e-4f), x);
+    x = _mm256_fnmadd_ps(y, _mm256_set1_ps(3.77489497744594108e-8f), x);
+
+    const __m256 z = _mm256_mul_ps(x, x);
+
+    // Cosine polynomial
+    __m256 cos_poly = _mm256_set1_ps(2.443315711809948e-5f);
+    cos_poly = _mm256_fmadd_ps(cos_poly, z, _mm256_set1_ps(-1.388731625493765e-3f));
+    cos_poly = _mm256_fmadd_ps(cos_poly, z, _mm256_set1_ps(4.166664568298827e-2f));
+    cos_poly = _mm256_mul_ps(_mm256_mul_ps(cos_poly, z), z);
+    cos_poly = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), cos_poly);
+    cos_poly = _mm256_add_ps(cos_poly, _mm256_set1_ps(1.0f));
+
+    // Sine polynomial
+    __m256 sin_poly = _mm256_set1_ps(-1.9515295891e-4f);
+    sin_poly = _mm256_fmadd_ps(sin_poly, z, _mm256_set1_ps(8.3321608736e-3f));
+    sin_poly = _mm256_fmadd_ps(sin_poly, z, _mm256_set1_ps(-1.6666654611e-1f));
+    sin_poly = _mm256_fmadd_ps(_mm256_mul_ps(sin_poly, z), x, x);
+
+    // Pick the right polynomial for each octant
+    s = _mm256_blendv_ps(cos_poly, sin_poly, poly_mask);
+    c = _mm256_blendv_ps(sin_poly, cos_poly, poly_mask);
+
+    s = _mm256_xor_ps(s, sign_sin);
+    c = _mm256_xor_ps(c, sign_cos);
+  }
+
+  /**
+   * @brief Interpolate between two vectors
+   *
+   * @param prev    The previous values
+   * @param curr    The current values
+   * @param alpha   The alpha
+   * @param beta    One minus the alpha
+   * @return The interpolated values
+   */
+  static inline __m256 Lerp(const __m256 &prev, const __m256 &curr, const __m256 &alpha, const __m256 &beta) {
+    return _mm256_fmadd_ps(curr, alpha, _mm256_mul_ps(prev, beta));
+  }
+
+  /**
+   * @brief Write a column of eight matrices
+   *
+   * @param matrices  The first matrix
+   * @param column    The column
+   * @param x         The first row of the column of every matrix
+   * @param y         The second row of the column of every matrix
+   * @param z         The third row of the column of every matrix
+   * @param w         The fourth row of the column of every matrix
+   */
+  static inline void StoreColumn(float *matrices, const int &column, __m256 x, __m256 y, __m256 z, __m256 w) {
+    // Interleave within the 128 bit lanes (same as _MM_TRANSPOSE4_PS on both halves)
+    const __m256 t0 = _mm256_unpacklo_ps(x, y);
+    const __m256 t1 = _mm256_unpacklo_ps(z, w);
+    const __m256 t2 = _mm256_unpackhi_ps(x, y);
+    const __m256 t3 = _mm256_unpackhi_ps(z, w);
+
+    const __m256 m0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 m1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 m2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 m3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+    // The low lanes hold matrices 0-3, the high lanes matrices 4-7
+    float *out = matrices + column * 4;
+
+    _mm_storeu_ps(out, _mm256_castps256_ps128(m0));
+    _mm_storeu_ps(out + 16, _mm256_castps256_ps128(m1));
+    _mm_storeu_ps(out + 32, _mm256_castps256_ps128(m2));
+    _mm_storeu_ps(out + 48, _mm256_castps256_ps128(m3));
+    _mm_storeu_ps(out + 64, _mm256_extractf128_ps(m0, 1));
+    _mm_storeu_ps(out + 80, _mm256_extractf128_ps(m1, 1));
+    _mm_storeu_ps(out + 96, _mm256_extractf128_ps(m2, 1));
+    _mm_storeu_ps(out + 112, _mm256_extractf128_ps(m3, 1));
+  }
+
+  // FUNCTIONS //
+
+  size_t ComputeInterpolatedMatricesAVX2(const float *const arrays[6], const size_t &count, const float &alpha, float *matrices) {
+    const __m256 a = _mm256_set1_ps(alpha);
+    const __m256 b = _mm256_set1_ps(1.0f - alpha);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 zero = _mm256_setzero_ps();
+
+    const size_t groups = count / 8;
+
+    for (size_t group = 0; group < groups; group++) {
+      const size_t offset = group * 24;   // Eight vec3s per group
+
+      __m256 ppx, ppy, ppz, cpx, cpy, cpz;
+      __m256 psx, psy, psz, csx, csy, csz;
+      __m256 prx, pry, prz, crx, cry, crz;
+
+      Load3(arrays[0] + offset, ppx, ppy, ppz);
+      Load3(arrays[1] + offset, cpx, cpy, cpz);
+      Load3(arrays[2] + offset, psx, psy, psz);
+      Load3(arrays[3] + offset, csx, csy, csz);
+      Load3(arrays[4] + offset, prx, pry, prz);
+      Load3(arrays[5] + offset, crx, cry, crz);
+
+      const __m256 px = Lerp(ppx, cpx, a, b), py = Lerp(ppy, cpy, a, b), pz = Lerp(ppz, cpz, a, b);
+      const __m256 sx = Lerp(psx, csx, a, b), sy = Lerp(psy, csy, a, b), sz = Lerp(psz, csz, a, b);
+      const __m256 rx = Lerp(prx, crx, a, b), ry = Lerp(pry, cry, a, b), rz = Lerp(prz, crz, a, b);
+
+      // Quaternion from the Euler angles
+      __m256 sin_x, cos_x, sin_y, cos_y, sin_z, cos_z;
+      SinCos(_mm256_mul_ps(rx, half), sin_x, cos_x);
+      SinCos(_mm256_mul_ps(ry, half), sin_y, cos_y);
+      SinCos(_mm256_mul_ps(rz, half), sin_z, cos_z);
+
+      const __m256 cc = _mm256_mul_ps(cos_y, cos_z), ss = _mm256_mul_ps(sin_y, sin_z);
+      const __m256 cs = _mm256_mul_ps(cos_y, sin_z), sc = _mm256_mul_ps(sin_y, cos_z);
+
+      const __m256 qw = _mm256_fmadd_ps(cos_x, cc, _mm256_mul_ps(sin_x, ss));
+      const __m256 qx = _mm256_fmsub_ps(sin_x, cc, _mm256_mul_ps(cos_x, ss));
+      const __m256 qy = _mm256_fmadd_ps(cos_x, sc, _mm256_mul_ps(sin_x, cs));
+      const __m256 qz = _mm256_fmsub_ps(cos_x, cs, _mm256_mul_ps(sin_x, sc));
+
+      const __m256 xx = _mm256_mul_ps(qx, qx), yy = _mm256_mul_ps(qy, qy), zz = _mm256_mul_ps(qz, qz);
+      const __m256 xy = _mm256_mul_ps(qx, qy), xz = _mm256_mul_ps(qx, qz), yz = _mm256_mul_ps(qy, qz);
+      const __m256 wx = _mm256_mul_ps(qw, qx), wy = _mm256_mul_ps(qw, qy), wz = _mm256_mul_ps(qw, qz);
+
+      // translate * scale * rotate, one column at a time
+      float *out = matrices + group * 128;
+
+      StoreColumn(out, 0,
+        _mm256_mul_ps(sx, _mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one)),
+        _mm256_mul_ps(sy, _mm256_mul_ps(two, _mm256_add_ps(xy, wz))),
+        _mm256_mul_ps(sz, _mm256_mul_ps(two, _mm256_sub_ps(xz, wy))),
+        zero);
+
+      StoreColumn(out, 1,
+        _mm256_mul_ps(sx, _mm256_mul_ps(two, _mm256_sub_ps(xy, wz))),
+        _mm256_mul_ps(sy, _mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one)),
+        _mm256_mul_ps(sz, _mm256_mul_ps(two, _mm256_add_ps(yz, wx))),
+        zero);
+
+      StoreColumn(out, 2,
+        _mm256_mul_ps(sx, _mm256_mul_ps(two, _mm256_add_ps(xz, wy))),
+        _mm256_mul_ps(sy, _mm256_mul_ps(two, _mm256_sub_ps(yz, wx))),
+        _mm256_mul_ps(sz, _mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one)),
+        zero);
+
+      StoreColumn(out, 3, px, py, pz, one);
+    }
+
+    return groups * 8;
+  }
+
+}
+
+#endif
@@ -0,0 +1,217 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+// SSE2 is part of x86-64, so this kernel builds without extra compiler flags
+
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <emmintrin.h>
+
+namespace elgar {
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief Load four packed vec3s and split them into x, y and z vectors
+   *
+   * @param data  The first float of the four vec3s
+   * @param x     Filled with the x components
+   * @param y     Filled with the y components
+   * @param z     Filled with the z components
+   */
+  static inline void Load3(const float *data, __m128 &x, __m128 &y, __m128 &z) {
+    const __m128 a = _mm_loadu_ps(data);      // x0 y0 z0 x1
+    const __m128 b = _mm_loadu_ps(data + 4);  // y1 z1 x2 y2
+    const __m128 c = _mm_loadu_ps(data + 8);  // z2 x3 y3 z3
+
+    x = _mm_shuffle_ps(
+      _mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 0)),
+      _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)),
+      _MM_SHUFFLE(2, 0, 1, 0)
+    );
+
+    y = _mm_shuffle_ps(
+      _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+      _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+      _MM_SHUFFLE(2, 0, 2, 0)
+    );
+
+    z = _mm_shuffle_ps(
+      _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+      _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),
+      _MM_SHUFFLE(2, 0, 2, 0)
+    );
+  }
+
+  /**
+   * @brief Compute the sine and cosine of four angles (Cephes single precision polynomials)
+   *
+   * @param x   The angles in radians
+   * @param s   Filled with the sines
+   * @param c   Filled with the cosines
+   */
+  static inline void SinCos(__m128 x, __m128 &s, __m128 &c) {
+    const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+
+    __m128 sign_sin = _mm_and_ps(x, sign_mask);
+    x = _mm_andnot_ps(sign_mask, x);
+
+    // Reduce to an octant (j is rounded up to an even number)
+    __m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+    j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+    const __m128 y = _mm_cvtepi32_ps(j);
+
+    const __m128 swap_sign_sin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29));
+    const __m128 poly_mask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+    const __m128 sign_cos = _mm_castsi128_ps(
+      _mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29)
+    );
+
+    sign_sin = _mm_xor_ps(sign_sin, swap_sign_sin);
+
+    // Extended precision modular arithmetic
+    x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(0.78515625f)));
+    x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4f)));
+    x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8f)));
+
+    const __m128 z = _mm_mul_ps(x, x);
+
+    // Cosine polynomial
+    __m128 cos_poly = _mm_set1_ps(2.443315711809948e-5f);
+    cos_poly = _mm_add_ps(_mm_mul_ps(cos_poly, z), _mm_set1_ps(-1.388731625493765e-3f));
+    cos_poly = _mm_add_ps(_mm_mul_ps(cos_poly, z), _mm_set1_ps(4.166664568298827e-2f));
+    cos_poly = _mm_mul_ps(_mm_mul_ps(cos_poly, z), z);
+    cos_poly = _mm_sub_ps(cos_poly, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+    cos_poly = _mm_add_ps(cos_poly, _mm_set1_ps(1.0f));
+
+    // Sine polynomial
+    __m128 sin_poly = _mm_set1_ps(-1.9515295891e-4f);
+    sin_poly = _mm_add_ps(_mm_mul_ps(sin_poly, z), _mm_set1_ps(8.3321608736e-3f));
+    sin_poly = _mm_add_ps(_mm_mul_ps(sin_poly, z), _mm_set1_ps(-1.6666654611e-1f));
+    sin_poly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sin_poly, z), x), x);
+
+    // Pick the right polynomial for each octant
+    s = _mm_or_ps(_mm_and_ps(poly_mask, sin_poly), _mm_andnot_ps(poly_mask, cos_poly));
+    c = _mm_or_ps(_mm_and_ps(poly_mask, cos_poly), _mm_andnot_ps(poly_mask, sin_poly));
+
+    s = _mm_xor_ps(s, sign_sin);
+    c = _mm_xor_ps(c, sign_cos);
+  }
+
+  /**
+   * @brief Interpolate between two vectors
+   *
+   * @param prev    The previous values
+   * @param curr    The current values
+   * @param alpha   The alpha
+   * @param beta    One minus the alpha
+   * @return The interpolated values
+   */
+  static inline __m128 Lerp(const __m128 &prev, const __m128 &curr, const __m128 &alpha, const __m128 &beta) {
+    return _mm_add_ps(_mm_mul_ps(curr, alpha), _mm_mul_ps(prev, beta));
+  }
+
+  /**
+   * @brief Write a column of four matrices
+   *
+   * @param matrices  The first matrix
+   * @param column    The column
+   * @param x         The first row of the column of every matrix
+   * @param y         The second row of the column of every matrix
+   * @param z         The third row of the column of every matrix
+   * @param w         The fourth row of the column of every matrix
+   */
+  static inline void StoreColumn(float *matrices, const int &column, __m128 x, __m128 y, __m128 z, __m128 w) {
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+
+    _mm_storeu_ps(matrices + column * 4, x);
+    _mm_storeu_ps(matrices + 16 + column * 4, y);
+    _mm_storeu_ps(matrices + 32 + column * 4, z);
+    _mm_storeu_ps(matrices + 48 + column * 4, w);
+  }
+
+  // FUNCTIONS //
+
+  size_t ComputeInterpolatedMatricesSSE(const float *const arrays[6], const size_t &count, const float &alpha, float *matrices) {
+    const __m128 a = _mm_set1_ps(alpha);
+    const __m128 b = _mm_set1_ps(1.0f - alpha);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    const size_t groups = count / 4;
+
+    for (size_t group = 0; group < groups; group++) {
+      const size_t offset = group * 12;   // Four vec3s per group
+
+      __m128 ppx, ppy, ppz, cpx, cpy, cpz;
+      __m128 psx, psy, psz, csx, csy, csz;
+      __m128 prx, pry, prz, crx, cry, crz;
+
+      Load3(arrays[0] + offset, ppx, ppy, ppz);
+      Load3(arrays[1] + offset, cpx, cpy, cpz);
+      Load3(arrays[2] + offset, psx, psy, psz);
+      Load3(arrays[3] + offset, csx, csy, csz);
+      Load3(arrays[4] + offset, prx, pry, prz);
+      Load3(arrays[5] + offset, crx, cry, crz);
+
+      const __m128 px = Lerp(ppx, cpx, a, b), py = Lerp(ppy, cpy, a, b), pz = Lerp(ppz, cpz, a, b);
+      const __m128 sx = Lerp(psx, csx, a, b), sy = Lerp(psy, csy, a, b), sz = Lerp(psz, csz, a, b);
+      const __m128 rx = Lerp(prx, crx, a, b), ry = Lerp(pry, cry, a, b), rz = Lerp(prz, crz, a, b);
+
+      // Quaternion from the Euler angles
+      __m128 sin_x, cos_x, sin_y, cos_y, sin_z, cos_z;
+      SinCos(_mm_mul_ps(rx, half), sin_x, cos_x);
+      SinCos(_mm_mul_ps(ry, half), sin_y, cos_y);
+      SinCos(_mm_mul_ps(rz, half), sin_z, cos_z);
+
+      const __m128 cc = _mm_mul_ps(cos_y, cos_z), ss = _mm_mul_ps(sin_y, sin_z);
+      const __m128 cs = _mm_mul_ps(cos_y, sin_z), sc = _mm_mul_ps(sin_y, cos_z);
+
+      const __m128 qw = _mm_add_ps(_mm_mul_ps(cos_x, cc), _mm_mul_ps(sin_x, ss));
+      const __m128 qx = _mm_sub_ps(_mm_mul_ps(sin_x, cc), _mm_mul_ps(cos_x, ss));
+      const __m128 qy = _mm_add_ps(_mm_mul_ps(cos_x, sc), _mm_mul_ps(sin_x, cs));
+      const __m128 qz = _mm_sub_ps(_mm_mul_ps(cos_x, cs), _mm_mul_ps(sin_x, sc));
+
+      const __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+      const __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+      const __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+      // translate * scale * rotate, one column at a time
+      float *out = matrices + group * 64;
+
+      StoreColumn(out, 0,
+        _mm_mul_ps(sx, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)))),
+        _mm_mul_ps(sy, _mm_mul_ps(two, _mm_add_ps(xy, wz))),
+        _mm_mul_ps(sz, _mm_mul_ps(two, _mm_sub_ps(xz, wy))),
+        zero);
+
+      StoreColumn(out, 1,
+        _mm_mul_ps(sx, _mm_mul_ps(two, _mm_sub_ps(xy, wz))),
+        _mm_mul_ps(sy, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz)))),
+        _mm_mul_ps(sz, _mm_mul_ps(two, _mm_add_ps(yz, wx))),
+        zero);
+
+      StoreColumn(out, 2,
+        _mm_mul_ps(sx, _mm_mul_ps(two, _mm_add_ps(xz, wy))),
+        _mm_mul_ps(sy, _mm_mul_ps(two, _mm_sub_ps(yz, wx))),
+        _mm_mul_ps(sz, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)))),
+        zero);
+
+      StoreColumn(out, 3, px, py, pz, one);
+    }
+
+    return groups * 4;
+  }
+
+}
+
+#endif
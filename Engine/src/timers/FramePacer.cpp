@@ -0,0 +1,220 @@
+/*
+  Elgar Game Engine
+  Author: Joseph St. Pierre
+  Year: 2019
+*/
+
+// INCLUDES //
+
+#include "elgar/timers/FramePacer.hpp"
+#include "elgar/core/Window.hpp"
+#include "elgar/core/Macros.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace elgar {
+
+  // LOCAL DATA //
+
+  static const uint32_t s_bucket_bounds[FRAME_PACER_BUCKET_COUNT] = {
+    10, 25, 50, 100, 250, 500, 1000, 2000, UINT32_MAX
+  };
+
+  // LOCAL FUNCTIONS //
+
+  /**
+   * @brief Read the steady clock
+   *
+   * @return Nanoseconds since an arbitrary epoch
+   */
+  static uint64_t Now() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+  }
+
+  /**
+   * @brief Apply a frame rate cap
+   *
+   * @param rate  The frame rate (0 for unlimited)
+   * @param cap   The cap (0 for none)
+   * @return The capped frame rate
+   */
+  static float CapFrameRate(const float &rate, const float &cap) {
+    if (cap <= 0.0f)
+      return rate;
+
+    return rate > 0.0f ? std::min(rate, cap) : cap;
+  }
+
+  // FUNCTIONS //
+
+  FramePacer::FramePacer() : Singleton<FramePacer>(this) {
+    m_target_rate = 0.0f;
+    m_unfocused_rate = DEFAULT_UNFOCUSED_FRAME_RATE;
+    m_minimized_rate = DEFAULT_MINIMIZED_FRAME_RATE;
+    m_spin_threshold = (uint64_t)(DEFAULT_SPIN_THRESHOLD * 1000000.0f);
+
+    m_period = 0;
+    m_deadline = 0;
+    m_oversleep = 0;
+
+    ResetStats();
+
+    LOG("FramePacer online...\n");
+  }
+
+  FramePacer::~FramePacer() {
+    if (m_paced_frames > 0)
+      LogStats();
+
+    LOG("FramePacer offline...\n");
+  }
+
+  float FramePacer::GetEffectiveFrameRate() const {
+    float rate = m_target_rate;
+
+    Window *window = Window::GetInstance();
+
+    if (window) {
+      if (window->IsMinimized())
+        rate = CapFrameRate(rate, m_minimized_rate);
+      else if (!window->HasFocus())
+        rate = CapFrameRate(rate, m_unfocused_rate);
+    }
+
+    return rate;
+  }
+
+  void FramePacer::Wait() {
+    const float rate = GetEffectiveFrameRate();
+
+    // Nothing to pace to, start from scratch once there is
+    if (rate <= 0.0f) {
+      m_period = 0;
+      return;
+    }
+
+    PROFILE_ZONE("FramePacer::Wait");
+
+    const uint64_t period = (uint64_t)(1000000000.0 / rate);
+    uint64_t now = Now();
+
+    // The frame that starts pacing (or changes the rate) gets a full period from now
+    if (period != m_period) {
+      m_period = period;
+      m_deadline = now + m_period;
+    }
+
+    if (now >= m_deadline) {
+      m_late_frames++;
+
+      // Drop the schedule if we fell a whole frame behind rather than rushing to catch up
+      if (now - m_deadline >= m_period)
+        m_deadline = now;
+
+      m_deadline += m_period;
+      return;
+    }
+
+    // Sleep through most of the wait, leaving room for the sleep to wake up late
+    const uint64_t margin = m_spin_threshold + m_oversleep;
+    if (m_deadline - now > margin) {
+      const uint64_t sleep = m_deadline - now - margin;
+
+      std::this_thread::sleep_for(std::chrono::nanoseconds(sleep));
+
+      const uint64_t woke = Now();
+      const uint64_t oversleep = woke - now > sleep ? woke - now - sleep : 0;
+
+      // Average rather than track the worst case so a rare slow wake up does not turn the following
+      // frames into spins
+      m_oversleep = (m_oversleep * 7 + oversleep) / 8;
+      now = woke;
+    }
+
+    // Spin out the rest
+    while (now < m_deadline) {
+      std::this_thread::yield();
+      now = Now();
+    }
+
+    // Record how far past the deadline we woke up
+    const uint64_t error = now - m_deadline;
+    const uint32_t error_us = (uint32_t)std::min(error / 1000, (uint64_t)UINT32_MAX - 1);
+
+    size_t bucket = 0;
+    while (error_us >= s_bucket_bounds[bucket])
+      bucket++;
+
+    m_buckets[bucket]++;
+    m_paced_frames++;
+    m_total_error += error;
+    m_max_error = std::max(m_max_error, error);
+
+    m_deadline += m_period;
+  }
+
+  void FramePacer::SetTargetFrameRate(const float &rate) {
+    m_target_rate = std::max(rate, 0.0f);
+  }
+
+  const float &FramePacer::GetTargetFrameRate() const {
+    return m_target_rate;
+  }
+
+  void FramePacer::SetUnfocusedFrameRate(const float &rate) {
+    m_unfocused_rate = std::max(rate, 0.0f);
+  }
+
+  void FramePacer::SetMinimizedFrameRate(const float &rate) {
+    m_minimized_rate = std::max(rate, 0.0f);
+  }
+
+  void FramePacer::SetSpinThreshold(const float &milliseconds) {
+    m_spin_threshold = (uint64_t)(std::max(milliseconds, 0.0f) * 1000000.0f);
+  }
+
+  FramePacingStats FramePacer::GetStats() const {
+    FramePacingStats stats;
+
+    for (size_t i = 0; i < FRAME_PACER_BUCKET_COUNT; i++) {
+      stats.buckets[i] = m_buckets[i];
+      stats.bucket_bounds[i] = s_bucket_bounds[i];
+    }
+
+    stats.paced_frames = m_paced_frames;
+    stats.late_frames = m_late_frames;
+    stats.mean_error = m_paced_frames > 0 ? (m_total_error / 1000.0) / m_paced_frames : 0.0;
+    stats.max_error = m_max_error / 1000.0;
+
+    return stats;
+  }
+
+  void FramePacer::ResetStats() {
+    for (uint64_t &bucket : m_buckets)
+      bucket = 0;
+
+    m_paced_frames = 0;
+    m_late_frames = 0;
+    m_total_error = 0;
+    m_max_error = 0;
+  }
+
+  void FramePacer::LogStats() const {
+    const FramePacingStats stats = GetStats();
+
+    LOG("Frame pacing: %llu frames paced (%llu late), error mean %.1f us, max %.1f us\n",
+      (unsigned long long)stats.paced_frames, (unsigned long long)stats.late_frames,
+      stats.mean_error, stats.max_error);
+
+    for (size_t i = 0; i < FRAME_PACER_BUCKET_COUNT; i++) {
+      if (i + 1 < FRAME_PACER_BUCKET_COUNT)
+        LOG("  < %5u us: %llu\n", stats.bucket_bounds[i], (unsigned long long)stats.buckets[i]);
+      else
+        LOG("  >= %4u us: %llu\n", stats.bucket_bounds[i - 1], (unsigned long long)stats.buckets[i]);
+    }
+  }
+
+}
@@ -22,6 +22,13 @@ namespace elgar {
 
     m_alpha = 0.0f;
 
+    m_frequency = 1;
+    m_steps_per_second = 1;
+    m_last_ticks = 0;
+    m_accumulator = 0;
+    m_elapsed = 0;
+    m_step_count = 0;
+
     LOG("FrameTimer online...\n");
   }
 
@@ -31,16 +38,62 @@ namespace elgar {
     LOG("FrameTimer offline...\n");
   }
 
-  void FrameTimer::SetDeltaTime(const float &dt) {
-    m_delta_time = dt;
+  void FrameTimer::Start(const uint64_t &ticks, const uint64_t &frequency, const uint64_t &steps_per_second) {
+    m_frequency = frequency > 0 ? frequency : 1;
+    m_steps_per_second = steps_per_second > 0 ? steps_per_second : 1;
+    m_last_ticks = ticks;
+
+    m_fixed_delta_time = (float)(1.0 / m_steps_per_second);
+    m_delta_time = 0.0f;
+
+    m_accumulator = 0;
+    m_elapsed = 0;
+    m_step_count = 0;
+
+    UpdateAlpha();
   }
 
-  void FrameTimer::SetFixedDeltaTime(const float &fixed_dt) {
-    m_fixed_delta_time = fixed_dt;
+  void FrameTimer::Tick(const uint64_t &ticks) {
+    uint64_t frame_ticks = ticks - m_last_ticks;
+    m_last_ticks = ticks;
+
+    // Never simulate more than a quarter second per frame (avoids the spiral of death)
+    const uint64_t max_ticks = m_frequency / 4;
+    if (frame_ticks > max_ticks)
+      frame_ticks = max_ticks;
+
+    m_delta_time = (float)((double)frame_ticks / (double)m_frequency);
+
+    // Scaling by the step rate keeps the step length exact: a step costs exactly m_frequency
+    m_accumulator += frame_ticks * m_steps_per_second;
+    m_elapsed += frame_ticks * m_steps_per_second;
+
+    UpdateAlpha();
   }
 
-  void FrameTimer::SetAlpha(const float &alpha) {
-    m_alpha = alpha;
+  void FrameTimer::TickFixedStep() {
+    m_delta_time = m_fixed_delta_time;
+
+    m_accumulator += m_frequency;
+    m_elapsed += m_frequency;
+
+    UpdateAlpha();
+  }
+
+  bool FrameTimer::ConsumeFixedStep() {
+    if (m_accumulator < m_frequency)
+      return false;
+
+    m_accumulator -= m_frequency;
+    m_step_count++;
+
+    UpdateAlpha();
+
+    return true;
+  }
+
+  void FrameTimer::UpdateAlpha() {
+    m_alpha = (float)((double)m_accumulator / (double)m_frequency);
   }
 
   void FrameTimer::SetTimescale(const float &time_scale) {
@@ -71,6 +124,18 @@ namespace elgar {
     return m_alpha;
   }
 
+  double FrameTimer::GetElapsedTime() const {
+    // Split into whole and fractional seconds so the division stays exact over long sessions
+    const uint64_t units_per_second = m_frequency * m_steps_per_second;
+
+    return (double)(m_elapsed / units_per_second) + 
+      (double)(m_elapsed % units_per_second) / (double)units_per_second;
+  }
+
+  const uint64_t &FrameTimer::GetFixedStepCount() const {
+    return m_step_count;
+  }
+
   unsigned int FrameTimer::GetFPS() const {
     return (unsigned int)(1.f / m_delta_time);
   }
@@ -51,16 +51,16 @@ void update() {
   if (!keyboard)
     return;
 
-  if (keyboard->IsKeyPressed(SDLK_ESCAPE))
+  if (keyboard->WasKeyPressedThisFrame(SDL_SCANCODE_ESCAPE))
     engine->SetRunning(false);
 
-  if (keyboard->IsKeyPressed(SDLK_RIGHT))
+  if (keyboard->IsKeyDown(SDL_SCANCODE_RIGHT))
     camera.ChangePosition({100.0f * frame_timer->GetDeltaTime(), 0.0f, 0.0f});
-  if (keyboard->IsKeyPressed(SDLK_LEFT))
+  if (keyboard->IsKeyDown(SDL_SCANCODE_LEFT))
     camera.ChangePosition({-100.0f * frame_timer->GetDeltaTime(), 0.0f, 0.0f});
-  if (keyboard->IsKeyPressed(SDLK_UP))
+  if (keyboard->IsKeyDown(SDL_SCANCODE_UP))
     camera.ChangePosition({0.0f, 100.0f * frame_timer->GetDeltaTime(), 0.0f});
-  if (keyboard->IsKeyPressed(SDLK_DOWN))
+  if (keyboard->IsKeyDown(SDL_SCANCODE_DOWN))
     camera.ChangePosition({0.0f, -100.0f * frame_timer->GetDeltaTime(), 0.0f});
 }
 